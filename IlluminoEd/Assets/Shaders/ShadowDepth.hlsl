@@ -0,0 +1,32 @@
+// Depth only pass for the shadow cascades, reads the position out of the regular interleaved vertex stream
+struct VertexIn
+{
+	float4 Position : POSITION;
+};
+
+cbuffer Camera : register (b0)
+{
+	row_major float4x4 u_ViewProjection;
+	float4 u_CameraPosition;
+}
+
+struct InstanceData
+{
+	row_major float4x4 Model;
+	uint MaterialIndex;
+};
+
+// Every cascade has its own slot list with only its casters, the instance data is shared with the forward pass
+StructuredBuffer<InstanceData> u_Instances : register (t4);
+StructuredBuffer<uint> u_InstanceSlots : register (t5);
+
+cbuffer DrawData : register (b1)
+{
+	uint u_BaseInstance;
+}
+
+float4 VS_main(VertexIn v, uint instanceID : SV_InstanceID) : SV_POSITION
+{
+	InstanceData instance = u_Instances[u_InstanceSlots[u_BaseInstance + instanceID]];
+	return mul(mul(v.Position, instance.Model), u_ViewProjection);
+}
@@ -14,10 +14,12 @@ struct VertexOut
 {
 	float4 CameraPosition : CAMERA_POSITION;
 	float4 WorldPosition : WORLD_POSITION;
+	float4 ClipPosition : CLIP_POSITION;
 	float4 Position : SV_POSITION;
 	float3x3 WorldNormal : WORLD_NORMAL;
 	float3 Normal : NORMAL;
 	float2 UV : TEXCOORD;
+	nointerpolation float4 MRAO : MRAO;
 };
 
 cbuffer Camera : register (b0)
@@ -26,18 +28,41 @@ cbuffer Camera : register (b0)
 	float4 u_CameraPosition;
 }
 
-cbuffer Properties : register (b1)
+struct InstanceData
 {
-	row_major float4x4 u_Model;
+	row_major float4x4 Model;
+	uint MaterialIndex;
+};
+
+struct MaterialData
+{
+	// Metalness, roughness, alpha cutoff and opacity
+	float4 MRAO;
+};
+
+// Instance data stays in its submission slot, draws index it through the sorted slot list
+StructuredBuffer<InstanceData> u_Instances : register (t4);
+StructuredBuffer<uint> u_InstanceSlots : register (t5);
+// One entry per submesh, shared by all of its instances
+StructuredBuffer<MaterialData> u_Materials : register (t9);
+
+cbuffer DrawData : register (b1)
+{
+	uint u_BaseInstance;
 }
 
-VertexOut VS_main(VertexIn v)
+VertexOut VS_main(VertexIn v, uint instanceID : SV_InstanceID)
 {
 	VertexOut output;
 
+	InstanceData instance = u_Instances[u_InstanceSlots[u_BaseInstance + instanceID]];
+	float4x4 u_Model = instance.Model;
+	output.MRAO = u_Materials[instance.MaterialIndex].MRAO;
+
 	output.CameraPosition = u_CameraPosition;
 	output.WorldPosition = mul(v.Position, u_Model);
 	output.Position = mul(output.WorldPosition, u_ViewProjection);
+	output.ClipPosition = output.Position;
 
 	float3 T = normalize(mul(u_Model, v.Tangent).xyz);
 	float3 B = normalize(mul(u_Model, v.Bitangent).xyz);
@@ -64,14 +89,69 @@ struct DirectionalLight
 StructuredBuffer<DirectionalLight> u_DirectionalLights : register (t0);
 StructuredBuffer<PointLight> u_PointLights : register (t1);
 
+// Froxel grid built on the CPU, every cluster is an offset and count into the light index list
+cbuffer ClusterData : register (b2)
+{
+	uint3 u_ClusterCount;
+	float u_ClusterDepthScale;
+	float u_ClusterDepthBias;
+}
+
+StructuredBuffer<uint2> u_ClusterGrid : register (t6);
+StructuredBuffer<uint> u_ClusterLightIndices : register (t7);
+
 Texture2D u_Albedo : register(t2);
 Texture2D u_NormalMap : register(t3);
 
 SamplerState u_Sampler : register(s0);
 
-cbuffer MaterialData : register (b2)
+// Cascaded shadows of one directional light, the cascades are tiles next to each other in u_ShadowMap
+static const uint MAX_CASCADES = 4;
+
+cbuffer ShadowData : register (b3)
 {
-	float4 u_MRAO;
+	row_major float4x4 u_CascadeViewProjection[MAX_CASCADES];
+	float4 u_CascadeSplits;		// View depth where each cascade ends
+	float4 u_CascadeTexelSizes;	// World space size of a texel in each cascade
+	uint u_CascadeCount;		// 0 when no light casts shadows
+	uint u_ShadowLightIndex;	// Index into u_DirectionalLights
+	float u_ShadowTexelSize;	// 1 / resolution of one cascade
+}
+
+Texture2D u_ShadowMap : register(t8);
+SamplerComparisonState u_ShadowSampler : register(s1);
+
+float SampleShadow(const float3 worldPosition, const float3 normal, const float viewDepth)
+{
+	if (viewDepth > u_CascadeSplits[u_CascadeCount - 1])
+		return 1.0;
+
+	uint cascade = 0;
+	for (uint i = 0; i + 1 < u_CascadeCount; ++i)
+	{
+		if (viewDepth > u_CascadeSplits[i])
+			cascade = i + 1;
+	}
+
+	// Pushed along the normal by about a texel of the cascade, against acne on surfaces facing away from the light
+	float3 offset = normal * u_CascadeTexelSizes[cascade] * 1.5;
+	float4 lightPosition = mul(float4(worldPosition + offset, 1.0), u_CascadeViewProjection[cascade]);
+	float3 uvz = lightPosition.xyz / lightPosition.w;
+	float2 uv = float2(uvz.x * 0.5 + 0.5, 0.5 - uvz.y * 0.5);
+	uv.x = (uv.x + cascade) / u_CascadeCount;
+
+	// 3x3 PCF with the bilinear compare sampler
+	float shadow = 0.0;
+	float2 texel = float2(u_ShadowTexelSize / u_CascadeCount, u_ShadowTexelSize);
+	[unroll]
+	for (int y = -1; y <= 1; ++y)
+	{
+		[unroll]
+		for (int x = -1; x <= 1; ++x)
+			shadow += u_ShadowMap.SampleCmpLevelZero(u_ShadowSampler, uv + float2(x, y) * texel, uvz.z);
+	}
+
+	return shadow / 9.0;
 }
 
 // N: Normal, H: Halfway, a2: pow(roughness, 2)
@@ -116,13 +196,15 @@ float3 Uncharted2Tonemap(const float3 x)
 float4 PS_main(VertexOut input) : SV_TARGET
 {
 	float4 albedo = u_Albedo.Sample(u_Sampler, input.UV);
-	if (albedo.a < 0.05)
+#ifdef ALPHA_TEST
+	if (albedo.a < input.MRAO.b)
 		discard;
+#endif
 
 	float3 tangentNormal = u_NormalMap.Sample(u_Sampler, input.UV).rgb * 2.0 - 1.0;
 	float3 normal = normalize(mul(input.WorldNormal, tangentNormal));
-	float metalness = u_MRAO.r;
-	float roughness = u_MRAO.g;
+	float metalness = input.MRAO.r;
+	float roughness = input.MRAO.g;
 
 	float3 view = normalize(input.CameraPosition.xyz - input.WorldPosition.xyz);
 	float NdotV = max(dot(normal, view), 0.0);
@@ -151,6 +233,8 @@ float4 PS_main(VertexOut input) : SV_TARGET
 		float NdotL = max(dot(normal, L), 0.0);
 
 		float3 radiance = light.Color.rgb * light.Color.a;
+		if (i == u_ShadowLightIndex && u_CascadeCount > 0)
+			radiance *= SampleShadow(input.WorldPosition.xyz, input.Normal, input.ClipPosition.w);
 
 		float3 H = normalize(L + view);
 		float NDF = DistributionGGX(normal, H, a2);
@@ -165,11 +249,15 @@ float4 PS_main(VertexOut input) : SV_TARGET
 		Lo += (kD * (albedo.rgb / PI) + specular) * radiance * NdotL;
 	}
 
-	// Point Lights
-	u_PointLights.GetDimensions(lightCount, lightStride);
-	for (uint i = 1; i < lightStride; ++i)
+	// Point Lights, only the ones assigned to this pixel's cluster
+	float2 ndc = input.ClipPosition.xy / input.ClipPosition.w;
+	uint2 tile = (uint2)clamp((ndc * 0.5 + 0.5) * u_ClusterCount.xy, 0.0, u_ClusterCount.xy - 1.0);
+	uint slice = (uint)clamp(log(input.ClipPosition.w) * u_ClusterDepthScale + u_ClusterDepthBias, 0.0, u_ClusterCount.z - 1.0);
+	uint2 cluster = u_ClusterGrid[(slice * u_ClusterCount.y + tile.y) * u_ClusterCount.x + tile.x];
+	for (uint i = 0; i < cluster.y; ++i)
 	{
-		PointLight light = u_PointLights.Load(i);
+		// Light indices skip the reserved first entry
+		PointLight light = u_PointLights.Load(u_ClusterLightIndices[cluster.x + i] + 1);
 		float3 L = normalize(light.Position.xyz - input.WorldPosition.xyz);
 		float NdotL = max(dot(normal, L), 0.0);
 		float lightDistance2 = LengthSq(light.Position.xyz - input.WorldPosition.xyz);
@@ -206,5 +294,9 @@ float4 PS_main(VertexOut input) : SV_TARGET
 
 	color = curr * whiteScale;
 
+#ifdef ALPHA_BLEND
+	return float4(color, albedo.a * input.MRAO.a);
+#else
 	return float4(color, 1.0);
+#endif
 }
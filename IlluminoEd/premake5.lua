@@ -37,6 +37,7 @@ project "IlluminoEd"
 
 	filter "system:windows"
 		systemversion "latest"
+		defines "ILLUMINO_PLATFORM_WINDOWS"
 
 	filter "configurations:Debug"
 		defines "ILLUMINO_DEBUG"
@@ -36,6 +36,7 @@ namespace IlluminoEngine
 
 		m_SceneHierarchyPanel.SetSelectionContext(m_ActiveScene.get());
 		m_ViewportPanel.SetContext(m_ActiveScene.get(), &m_SceneHierarchyPanel);
+		m_StatsPanel.SetContext(m_ActiveScene.get());
 	}
 
 	void EditorLayer::OnDetach()
@@ -128,6 +129,16 @@ namespace IlluminoEngine
 					ImGui::EndMenu();
 				}
 
+				if (ImGui::BeginMenu("Scene"))
+				{
+					if (ImGui::MenuItem("Play", nullptr, false, !m_PlaySnapshot))
+						OnPlay();
+					if (ImGui::MenuItem("Stop", nullptr, false, m_PlaySnapshot != nullptr))
+						OnStop();
+
+					ImGui::EndMenu();
+				}
+
 				if (ImGui::BeginMenu("View"))
 				{
 					ImGui::MenuItem("Viewport", nullptr, &m_ViewportPanel.Showing());
@@ -154,4 +165,17 @@ namespace IlluminoEngine
 		}
 		EndDockspace();
 	}
+
+	void EditorLayer::OnPlay()
+	{
+		m_PlaySnapshot = m_ActiveScene->CreateSnapshot();
+	}
+
+	void EditorLayer::OnStop()
+	{
+		// Entities created while playing are gone after the restore
+		m_SceneHierarchyPanel.SetSelection({});
+		m_ActiveScene->RestoreSnapshot(*m_PlaySnapshot);
+		m_PlaySnapshot = nullptr;
+	}
 }
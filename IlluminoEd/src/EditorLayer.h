@@ -22,6 +22,10 @@ namespace IlluminoEngine
 		virtual void OnUpdate(Timestep ts) override;
 		virtual void OnImGuiRender() override;
 
+	private:
+		void OnPlay();
+		void OnStop();
+
 	private:
 		SceneHierarchyPanel m_SceneHierarchyPanel;
 		PropertiesPanel m_PropertiesPanel;
@@ -30,5 +34,6 @@ namespace IlluminoEngine
 		ViewportPanel m_ViewportPanel;
 		
 		Ref<Scene> m_ActiveScene;
+		Ref<SceneSnapshot> m_PlaySnapshot;
 	};
 }
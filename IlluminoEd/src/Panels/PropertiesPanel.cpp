@@ -56,12 +56,20 @@ namespace IlluminoEngine
 			if (opened)
 			{
 				ImGui::SetCursorPosX(ImGui::GetCursorPosX() - ImGui::GetStyle().IndentSpacing / 2);
-				fn(entity.GetComponent<T>());
+				// Only edits are reported to the scene's change tracking, and they keep the component on prefab instances
+				if (fn(entity.GetComponent<T>()))
+				{
+					entity.PatchComponent<T>();
+					entity.SetPrefabOverride(GetPrefabOverride<T>());
+				}
 				ImGui::TreePop();
 			}
 
 			if (removeComponent)
+			{
 				entity.RemoveComponent<T>();
+				entity.SetPrefabOverride(GetPrefabOverride<T>());
+			}
 		}
 	}
 
@@ -83,53 +91,93 @@ namespace IlluminoEngine
 			char buffer[256];
 			strcpy(buffer, tagComponent.Tag.c_str());
 			if (ImGui::InputText("##Tag", buffer, 256))
+			{
 				tagComponent.Tag = buffer;
+				entity.SetPrefabOverride(PrefabOverride_Tag);
+			}
+		}
+
+		// Active and Visible flags
+		{
+			bool active = entity.IsActive();
+			if (ImGui::Checkbox("Active", &active))
+				entity.SetActive(active);
+
+			ImGui::SameLine();
+
+			bool visible = entity.IsVisible();
+			if (ImGui::Checkbox("Visible", &visible))
+				entity.SetVisible(visible);
 		}
 
 		ImGui::Spacing();
 
 		DrawComponent<TransformComponent>("Transform", entity, [](TransformComponent& component)
 		{
+			bool modified = false;
 			UI::BeginProperties();
-			UI::DrawVec3Control("Translation", component.Translation);
-			UI::DrawVec3Control("Rotation", component.Rotation);
-			UI::DrawVec3Control("Scale", component.Scale);
+			modified |= UI::DrawVec3Control("Translation", component.Translation);
+			modified |= UI::DrawVec3Control("Rotation", component.Rotation);
+			modified |= UI::DrawVec3Control("Scale", component.Scale);
 			UI::EndProperties();
+			return modified;
 		}, false);
 
+		// Material edits change the shared submesh, they are reported as a mesh change so the instance data is uploaded again
 		DrawComponent<MeshComponent>("Mesh", entity, [](MeshComponent& component)
 		{
+			bool modified = false;
 			UI::BeginProperties();
 			if (component.MeshGeometry)
 			{
-				UI::Property("Submesh Index", component.SubmeshIndex, 0, component.MeshGeometry->GetSubmeshCount() - 1);
+				modified |= UI::Property("Submesh Index", component.SubmeshIndex, 0, component.MeshGeometry->GetSubmeshCount() - 1);
+				modified |= UI::Property("Occluder", component.Occluder);
 
 				Submesh& submesh = component.MeshGeometry->GetSubmesh(component.SubmeshIndex);
 
-				UI::Property("Albedo Map", submesh.Albedo);
-				UI::Property("Normal Map", submesh.Normal);
+				modified |= UI::Property("Albedo Map", submesh.Albedo);
+				modified |= UI::Property("Normal Map", submesh.Normal);
+
+				modified |= UI::Property("Roughness", submesh.Roughness, 0.0f, 1.0f);
+				modified |= UI::Property("Metalness", submesh.Metalness, 0.0f, 1.0f);
+
+				const char* blendModes[] = { "Opaque", "Masked", "Transparent" };
+				int blend = (int)submesh.Blend;
+				if (UI::Property("Blend Mode", blend, blendModes, 3))
+				{
+					submesh.Blend = (BlendMode)blend;
+					modified = true;
+				}
 
-				UI::Property("Roughness", submesh.Roughness, 0.0f, 1.0f);
-				UI::Property("Metalness", submesh.Metalness, 0.0f, 1.0f);
+				if (submesh.Blend == BlendMode::Masked)
+					modified |= UI::Property("Alpha Cutoff", submesh.AlphaCutoff, 0.0f, 1.0f);
+				else if (submesh.Blend == BlendMode::Transparent)
+					modified |= UI::Property("Opacity", submesh.Opacity, 0.0f, 1.0f);
 			}
 			UI::EndProperties();
+			return modified;
 		}, true);
 
 		DrawComponent<PointLightComponent>("Point Light", entity, [](PointLightComponent& component)
 		{
+			bool modified = false;
 			UI::BeginProperties();
-			UI::Property("Intensity", component.Intensity);
-			UI::PropertyColor3("Color", component.Color);
-			UI::Property("Radius", component.Radius);
+			modified |= UI::Property("Intensity", component.Intensity);
+			modified |= UI::PropertyColor3("Color", component.Color);
+			modified |= UI::Property("Radius", component.Radius);
 			UI::EndProperties();
+			return modified;
 		}, true);
 
 		DrawComponent<DirectionalLightComponent>("Directional Light", entity, [](DirectionalLightComponent& component)
 		{
+			bool modified = false;
 			UI::BeginProperties();
-			UI::Property("Intensity", component.Intensity);
-			UI::PropertyColor3("Color", component.Color);
+			modified |= UI::Property("Intensity", component.Intensity);
+			modified |= UI::PropertyColor3("Color", component.Color);
+			modified |= UI::Property("Cast Shadows", component.CastShadows);
 			UI::EndProperties();
+			return modified;
 		}, true);
 
 		// AddComponent
@@ -155,6 +203,7 @@ namespace IlluminoEngine
 			if (ImGui::MenuItem(entryName))
 			{
 				m_SelectedEntity.AddComponent<Component>();
+				m_SelectedEntity.SetPrefabOverride(GetPrefabOverride<Component>());
 				ImGui::CloseCurrentPopup();
 			}
 		}
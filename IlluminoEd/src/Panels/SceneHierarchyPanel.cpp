@@ -16,7 +16,7 @@ namespace IlluminoEngine
 			if (m_SelectedEntity == m_DeleteEntity)
 				m_SelectedEntity = {};
 
-			m_SelectionContext->DeleteEntity(m_DeleteEntity);
+			m_SelectionContext->DestroyEntity(m_DeleteEntity);
 			m_DeleteEntity = {};
 		}
 	}
@@ -108,7 +108,12 @@ namespace IlluminoEngine
 
 		static const eastl::string icon = ICON_MDI_CUBE_OUTLINE + eastl::string(" ");
 		eastl::string name = icon + entity.GetComponent<TagComponent>().Tag.c_str();
+		const bool inactive = !m_SelectionContext->IsActiveInHierarchy(entity);
+		if (inactive)
+			ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_TextDisabled));
 		bool opened = ImGui::TreeNodeEx((void*)(uint32_t)entity, treeFlags, name.c_str());
+		if (inactive)
+			ImGui::PopStyleColor();
 		
 		if (highlight)
 			ImGui::PopStyleColor(2);
@@ -43,6 +43,90 @@ namespace IlluminoEngine
 			const float fps = (1.0f / avg) * 1000.0f;
 			ImGui::Text("Frame time (ms): %f", fps);
 
+			const SceneRendererStats& rendererStats = SceneRenderer::GetStats();
+			ImGui::Text("Renderer");
+			ImGui::Separator();
+			ImGui::Text("Upload bytes: %llu", rendererStats.UploadBytes);
+			ImGui::Text("Uploaded instances: %u", rendererStats.UploadedInstances);
+			ImGui::Text("Uploaded materials: %u", rendererStats.UploadedMaterials);
+			ImGui::Text("Uploaded lights: %u", rendererStats.UploadedLights);
+			ImGui::Text("Clustered light indices: %u", rendererStats.ClusteredLightIndices);
+			ImGui::Text("Light clustering (ms): build %.3f, transform %.3f, assign %.3f, compact %.3f", rendererStats.LightClustering.BuildClusters,
+				rendererStats.LightClustering.TransformLights, rendererStats.LightClustering.AssignLights, rendererStats.LightClustering.Compact);
+			ImGui::Text("Visible meshes: %u", rendererStats.VisibleMeshes);
+			ImGui::Text("Culled meshes: %u", rendererStats.CulledMeshes);
+			ImGui::Text("Shadow only meshes: %u", rendererStats.ShadowOnlyMeshes);
+			ImGui::Text("Occluded meshes: %u", rendererStats.OccludedMeshes);
+			ImGui::Text("Occluder triangles: %u", rendererStats.OccluderTriangles);
+			ImGui::Text("Occlusion (ms): binning %.3f, rasterization %.3f", rendererStats.Occlusion.Binning, rendererStats.Occlusion.Rasterization);
+			if (ImGui::Button("Dump Occlusion Depth"))
+				SceneRenderer::SaveOcclusionDepthImage("OcclusionDepth.pgm");
+			ImGui::Text("Render graph: %u passes, %u culled, %u barriers", rendererStats.Graph.PassCount, rendererStats.Graph.CulledPassCount, rendererStats.Graph.BarrierCount);
+			ImGui::Text("Transient memory (KB): %.1f, %.1f without aliasing", rendererStats.Graph.TransientMemory / 1024.0f, rendererStats.Graph.UnaliasedMemory / 1024.0f);
+			if (ImGui::Button("Export Render Graph"))
+				SceneRenderer::SaveRenderGraph("RenderGraph.dot");
+			ImGui::Text("Triangles: %llu, %llu in shadows", rendererStats.Triangles, rendererStats.ShadowTriangles);
+			ImGui::Text("Reduced LOD meshes: %u", rendererStats.ReducedLODMeshes);
+			ImGui::Text("LOD selection (ms): %.3f", rendererStats.LODSelection);
+			LODSettings lodSettings = SceneRenderer::GetLODSettings();
+			bool lodSettingsChanged = ImGui::DragFloat("LOD pixel error", &lodSettings.PixelError, 0.05f, 0.1f, 32.0f);
+			lodSettingsChanged |= ImGui::SliderFloat("LOD hysteresis", &lodSettings.Hysteresis, 0.0f, 0.9f);
+			lodSettingsChanged |= ImGui::SliderInt("LOD bias", &lodSettings.Bias, -(int)Submesh::MaxLODs, Submesh::MaxLODs);
+			if (lodSettingsChanged)
+				SceneRenderer::SetLODSettings(lodSettings);
+			ImGui::Text("Queues: %u opaque, %u masked, %u transparent", rendererStats.QueueMeshes[(size_t)BlendMode::Opaque],
+				rendererStats.QueueMeshes[(size_t)BlendMode::Masked], rendererStats.QueueMeshes[(size_t)BlendMode::Transparent]);
+			ImGui::Text("Pipeline binds: %u", rendererStats.PipelineBinds);
+			ImGui::Text("Draw calls: %u", rendererStats.DrawCalls);
+			ImGui::Text("Binds issued: %u", rendererStats.BindsIssued);
+			ImGui::Text("Binds skipped: %u", rendererStats.BindsSkipped);
+			ImGui::Text("Recorded commands: %u (%u bytes)", rendererStats.RecordedCommands, rendererStats.CommandBytes);
+			ImGui::Text("Draw recording (ms): %.3f in %u chunks", rendererStats.DrawRecording, rendererStats.RecordingChunks);
+			if (ImGui::SliderInt("Max recording chunks", &m_MaxRecordingChunks, 0, 32))
+				SceneRenderer::SetMaxRecordingChunks((uint32_t)m_MaxRecordingChunks);
+			ImGui::Text("Shadow casters: %u, %u, %u, %u in %u cascades", rendererStats.ShadowCasters[0], rendererStats.ShadowCasters[1],
+				rendererStats.ShadowCasters[2], rendererStats.ShadowCasters[3], rendererStats.ShadowCascadeCount);
+			ImGui::Text("Shadow draw calls: %u", rendererStats.ShadowDrawCalls);
+			ImGui::Text("Shadows (ms): setup %.3f, caster culling %.3f", rendererStats.Shadows.Setup, rendererStats.Shadows.CasterCulling);
+			ShadowSettings shadowSettings = SceneRenderer::GetShadowSettings();
+			bool shadowSettingsChanged = ImGui::SliderInt("Shadow cascades", (int*)&shadowSettings.CascadeCount, 0, ShadowCascades::MaxCascades);
+			shadowSettingsChanged |= ImGui::DragFloat("Shadow distance", &shadowSettings.MaxDistance, 1.0f, 1.0f, 1000.0f);
+			shadowSettingsChanged |= ImGui::SliderFloat("Cascade split lambda", &shadowSettings.SplitLambda, 0.0f, 1.0f);
+			if (shadowSettingsChanged)
+				SceneRenderer::SetShadowSettings(shadowSettings);
+			ImGui::Text("Heap allocations: %u", rendererStats.HeapAllocations);
+			ImGui::Text("Frame memory (KB): %.1f / %.1f", rendererStats.FrameMemoryBytes / 1024.0f, FrameAllocator::GetBlockSize() / 1024.0f);
+			ImGui::Text("Frame memory overflows: %u", FrameAllocator::GetOverflowCount());
+
+			if (m_Scene)
+			{
+				const SystemScheduler& scheduler = m_Scene->GetSystemScheduler();
+				ImGui::Text("Systems");
+				ImGui::Separator();
+				ImGui::Text("Total (ms): %f", scheduler.GetLastRunTime());
+				for (const auto& timing : scheduler.GetTimings())
+					ImGui::Text("%s [%u] (ms): %f", timing.Name.c_str(), timing.Level, timing.Time);
+
+				const DynamicBVH& spatialIndex = m_Scene->GetSpatialIndex();
+				ImGui::Text("Spatial Index");
+				ImGui::Separator();
+				ImGui::Text("Proxies: %u", spatialIndex.GetProxyCount());
+				ImGui::Text("Height: %d", spatialIndex.GetHeight());
+				ImGui::Text("Area ratio: %.1f", spatialIndex.GetAreaRatio());
+
+				const SceneMemoryStats memoryStats = m_Scene->GetMemoryStats();
+				ImGui::Text("Scene Memory");
+				ImGui::Separator();
+				ImGui::Text("Total (KB): %.1f", memoryStats.TotalBytes / 1024.0f);
+				ImGui::Text("Entities (KB): %.1f", memoryStats.EntityBytes / 1024.0f);
+				ImGui::Text("Entity map (KB): %.1f", memoryStats.EntityMapBytes / 1024.0f);
+				for (const auto& component : memoryStats.Components)
+				{
+					ImGui::Text("%s [%llu]: dense %.1f KB, sparse %.1f KB, slack %.1f KB, heap %.1f KB", component.Name, (uint64_t)component.Count,
+						component.DenseBytes / 1024.0f, component.SparseBytes / 1024.0f, component.SlackBytes / 1024.0f, component.HeapBytes / 1024.0f);
+				}
+			}
+
 			OnEnd();
 		}
 	}
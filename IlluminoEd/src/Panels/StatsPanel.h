@@ -12,12 +12,17 @@ namespace IlluminoEngine
 		StatsPanel() = default;
 		virtual ~StatsPanel() = default;
 
+		void SetContext(Scene* scene) { m_Scene = scene; }
+
 		void OnUpdate(Timestep ts) {}
 		void OnImGuiRender();
 
 	private:
+		Scene* m_Scene = nullptr;
 		float m_Time = 0.0f;
 		float m_FpsValues[50];
 		eastl::vector<float> m_FrameTimes;
+		// 0 lets the renderer use every job system thread
+		int m_MaxRecordingChunks = 0;
 	};
 }
@@ -13,6 +13,7 @@ namespace IlluminoEngine
 		spec.Width = 1920;
 		spec.Height = 1080;
 		m_RenderTexture = RenderTexture::Create(spec);
+		SceneRenderer::SetViewportHeight(spec.Height);
 
 		m_EditorCamera = CreateRef<EditorCamera>(glm::radians(45.0f), (float)spec.Width / (float)spec.Height, 0.001f, 1000.0f);
 	}
@@ -26,6 +27,7 @@ namespace IlluminoEngine
 		{
 			m_RenderTexture->Resize(width, height);
 			m_EditorCamera->SetViewportSize(width, height);
+			SceneRenderer::SetViewportHeight(height);
 		}
 
 		m_MousePosition = *((glm::vec2*)&(ImGui::GetMousePos()));
@@ -104,14 +106,19 @@ namespace IlluminoEngine
 					{
 						Ref<Mesh> mesh = CreateRef<Mesh>(path);
 
-						Entity parent = m_Scene->CreateEntity(mesh->GetName());
-
+						// The mesh's root and one child per submesh, created in one batch
 						uint32_t meshCount = mesh->GetSubmeshCount();
+						eastl::vector<uint32_t> parents(meshCount + 1, 0);
+						eastl::vector<const char*> names(meshCount + 1);
+						parents[0] = Scene::k_InvalidIndex;
+						names[0] = mesh->GetName();
+						for (size_t i = 0; i < meshCount; i++)
+							names[i + 1] = mesh->GetSubmesh(i).Name.c_str();
+
+						eastl::vector<Entity> entities = m_Scene->CreateEntities(parents, names);
 						for (size_t i = 0; i < meshCount; i++)
 						{
-							auto& submesh = mesh->GetSubmesh(i);
-							Entity entity = m_Scene->CreateEntity(submesh.Name.c_str());
-							entity.SetParent(parent);
+							Entity entity = entities[i + 1];
 							auto& meshComponent = entity.AddComponent<MeshComponent>();
 							meshComponent.MeshGeometry = mesh;
 							meshComponent.SubmeshIndex = i;
@@ -159,6 +166,8 @@ namespace IlluminoEngine
 						const glm::vec3 deltaRotation = rotation - tc.Rotation;
 						tc.Rotation += deltaRotation;
 						tc.Scale = scale;
+						selectedEntity.PatchComponent<TransformComponent>();
+						selectedEntity.SetPrefabOverride(PrefabOverride_Transform);
 					}
 				}
 			}
@@ -454,8 +454,10 @@ namespace IlluminoEngine
 		return changed;
 	}
 
-	void UI::DrawVec3Control(const char* label, glm::vec3& values, float resetValue, float columnWidth)
+	bool UI::DrawVec3Control(const char* label, glm::vec3& values, float resetValue, float columnWidth)
 	{
+		bool modified = false;
+
 		ImGuiIO& io = ImGui::GetIO();
 		auto boldFont = io.Fonts->Fonts[1];
 
@@ -477,12 +479,15 @@ namespace IlluminoEngine
 			ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4{ 0.8f, 0.1f, 0.15f, 1.0f });
 			ImGui::PushFont(boldFont);
 			if (ImGui::Button("X", buttonSize))
+			{
 				values.x = resetValue;
+				modified = true;
+			}
 			ImGui::PopFont();
 			ImGui::PopStyleColor(3);
 
 			ImGui::SameLine();
-			ImGui::DragFloat("##X", &values.x, 0.1f, 0.0f, 0.0f, "%.2f");
+			modified |= ImGui::DragFloat("##X", &values.x, 0.1f, 0.0f, 0.0f, "%.2f");
 			ImGui::PopItemWidth();
 			ImGui::PopStyleVar();
 		}
@@ -497,13 +502,16 @@ namespace IlluminoEngine
 			ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4{ 0.2f, 0.7f, 0.2f, 1.0f });
 			ImGui::PushFont(boldFont);
 			if (ImGui::Button("Y", buttonSize))
+			{
 				values.y = resetValue;
+				modified = true;
+			}
 			ImGui::PopFont();
 
 			ImGui::PopStyleColor(3);
 
 			ImGui::SameLine();
-			ImGui::DragFloat("##Y", &values.y, 0.1f, 0.0f, 0.0f, "%.2f");
+			modified |= ImGui::DragFloat("##Y", &values.y, 0.1f, 0.0f, 0.0f, "%.2f");
 			ImGui::PopItemWidth();
 			ImGui::PopStyleVar();
 		}
@@ -518,18 +526,23 @@ namespace IlluminoEngine
 			ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4{ 0.1f, 0.25f, 0.8f, 1.0f });
 			ImGui::PushFont(boldFont);
 			if (ImGui::Button("Z", buttonSize))
+			{
 				values.z = resetValue;
+				modified = true;
+			}
 			ImGui::PopFont();
 			ImGui::PopStyleColor(3);
 
 			ImGui::SameLine();
-			ImGui::DragFloat("##Z", &values.z, 0.1f, 0.0f, 0.0f, "%.2f");
+			modified |= ImGui::DragFloat("##Z", &values.z, 0.1f, 0.0f, 0.0f, "%.2f");
 			ImGui::PopItemWidth();
 			ImGui::PopStyleVar();
 		}
 		
 		ImGui::PopStyleVar();
 		EndPropertyGrid();
+
+		return modified;
 	}
 
 	void UI::DrawRowsBackground(int row_count, float line_height, float x1, float x2, float y_offset, uint32_t col_even, uint32_t col_odd)
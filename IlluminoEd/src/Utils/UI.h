@@ -35,7 +35,7 @@ namespace IlluminoEngine
 
 		static bool Property(const char* label, Ref<Texture2D>& texture, uint64_t overrideTextureID = 0);
 
-		static void DrawVec3Control(const char* label, glm::vec3& values, float resetValue = 0.0f, float columnWidth = 100.0f);
+		static bool DrawVec3Control(const char* label, glm::vec3& values, float resetValue = 0.0f, float columnWidth = 100.0f);
 
 		static void DrawRowsBackground(int row_count, float line_height, float x1, float x2, float y_offset, uint32_t col_even, uint32_t col_odd);
 
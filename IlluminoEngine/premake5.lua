@@ -50,11 +50,6 @@ project "IlluminoEngine"
 
 	links
 	{
-        "d3dcompiler",
-        "dxguid",
-        "d3d12",
-        "dxgi",
-		
 		"optick",
 		"assimp",
 		"imgui",
@@ -66,6 +61,20 @@ project "IlluminoEngine"
 
 	filter "system:windows"
 		systemversion "latest"
+		defines "ILLUMINO_PLATFORM_WINDOWS"
+		links
+		{
+			"d3dcompiler",
+			"dxguid",
+			"d3d12",
+			"dxgi",
+		}
+
+	-- Linux only builds the engine core with the null renderer backend
+	filter "system:linux"
+		defines { "ILLUMINO_PLATFORM_LINUX", "ILLUMINO_HEADLESS" }
+		removefiles { "src/Platform/D3D12/**" }
+		links { "pthread" }
 
 	filter "configurations:Debug"
 		defines "ILLUMINO_DEBUG"
@@ -3,6 +3,8 @@
 
 #include "Window.h"
 #include "Timestep.h"
+#include "JobSystem.h"
+#include "FrameAllocator.h"
 #include "Illumino/ImGui/ImGuiLayer.h"
 #include "Illumino/Renderer/RenderCommand.h"
 #include "Illumino/Renderer/SceneRenderer.h"
@@ -19,6 +21,8 @@ namespace IlluminoEngine
 		s_Instance = this;
 
 		ILLUMINO_INFO("Application Started");
+		JobSystem::Init();
+		FrameAllocator::Init();
 		m_Window = CreateRef<Window>("Illumino Engine", 1920, 1080);
 		m_Window->Init();
 		RenderCommand::Init();
@@ -37,6 +41,8 @@ namespace IlluminoEngine
 		SceneRenderer::Shutdown();
 		m_LayerStack.PopOverlay(m_ImGuiLayer);
 		delete m_ImGuiLayer;
+		FrameAllocator::Shutdown();
+		JobSystem::Shutdown();
 
 		ILLUMINO_INFO("Application Ended");
 
@@ -65,13 +71,15 @@ namespace IlluminoEngine
 		{
 			OPTICK_FRAME("MainThread");
 
-			auto time = std::chrono::high_resolution_clock::now();
+			auto time = std::chrono::steady_clock::now();
 			Timestep timestep = std::chrono::duration<float>(time - m_LastFrameTime).count();
 			m_LastFrameTime = time;
 			
 			if (m_Window->ShouldClose())
 				break;
 
+			FrameAllocator::NextFrame();
+
 			if (!m_Window->Minimized())
 			{
 				{
@@ -8,7 +8,12 @@
 #define STRINGIFY(x) #x
 
 #ifdef ILLUMINO_DEBUG
-	#define ILLUMINO_DEBUGBREAK() __debugbreak()
+	#ifdef ILLUMINO_PLATFORM_WINDOWS
+		#define ILLUMINO_DEBUGBREAK() __debugbreak()
+	#else
+		#include <csignal>
+		#define ILLUMINO_DEBUGBREAK() raise(SIGTRAP)
+	#endif
 	#define ILLUMINO_ENABLE_ASSERTS
 #else
 	#define ILLUMINO_DEBUGBREAK()
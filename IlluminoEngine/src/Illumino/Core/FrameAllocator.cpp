@@ -0,0 +1,122 @@
+#include "ipch.h"
+#include "FrameAllocator.h"
+
+#include <mutex>
+
+namespace IlluminoEngine
+{
+	struct FrameBlock
+	{
+		char* Data = nullptr;
+		std::atomic<size_t> Offset = 0;
+		eastl::vector<void*> Overflow;
+	};
+
+	struct FrameAllocatorData
+	{
+		FrameBlock Blocks[g_QueueSlotCount];
+		size_t BlockSize = 0;
+		uint32_t Current = 0;
+		std::mutex OverflowMutex;
+	};
+
+	static FrameAllocatorData s_Data;
+
+	std::atomic<uint64_t> FrameAllocator::s_HeapAllocationCount = 0;
+
+	static void* AlignedAlloc(size_t size, size_t alignment)
+	{
+#ifdef ILLUMINO_PLATFORM_WINDOWS
+		return _aligned_malloc(size, alignment);
+#else
+		// aligned_alloc wants a multiple of the alignment and at least the size of a pointer
+		alignment = std::max(alignment, sizeof(void*));
+		return aligned_alloc(alignment, ALIGN(alignment, size));
+#endif
+	}
+
+	static void AlignedFree(void* allocation)
+	{
+#ifdef ILLUMINO_PLATFORM_WINDOWS
+		_aligned_free(allocation);
+#else
+		free(allocation);
+#endif
+	}
+
+	static void ResetBlock(FrameBlock& block)
+	{
+		for (void* allocation : block.Overflow)
+			AlignedFree(allocation);
+
+		block.Overflow.clear();
+		block.Offset.store(0, std::memory_order_relaxed);
+	}
+
+	void FrameAllocator::Init(size_t blockSize)
+	{
+		OPTICK_EVENT();
+
+		s_Data.BlockSize = blockSize;
+		for (FrameBlock& block : s_Data.Blocks)
+			block.Data = (char*)AlignedAlloc(blockSize, 64);
+
+		s_Data.Current = 0;
+	}
+
+	void FrameAllocator::Shutdown()
+	{
+		OPTICK_EVENT();
+
+		for (FrameBlock& block : s_Data.Blocks)
+		{
+			ResetBlock(block);
+			AlignedFree(block.Data);
+			block.Data = nullptr;
+		}
+	}
+
+	void FrameAllocator::NextFrame()
+	{
+		OPTICK_EVENT();
+
+		s_Data.Current = (s_Data.Current + 1) % g_QueueSlotCount;
+		ResetBlock(s_Data.Blocks[s_Data.Current]);
+	}
+
+	void* FrameAllocator::Allocate(size_t size, size_t alignment)
+	{
+		ILLUMINO_ASSERT((alignment & (alignment - 1)) == 0, "Alignment must be a power of two!");
+
+		FrameBlock& block = s_Data.Blocks[s_Data.Current];
+
+		// The block is 64 byte aligned, so aligning the offset aligns the address.
+		// Reserve the worst case padding up front so the bump stays a single atomic add
+		const size_t reserved = size + alignment - 1;
+		const size_t offset = block.Offset.fetch_add(reserved, std::memory_order_relaxed);
+		if (offset + reserved <= s_Data.BlockSize)
+			return block.Data + ALIGN(alignment, offset);
+
+		CountHeapAllocation();
+		std::lock_guard<std::mutex> lock(s_Data.OverflowMutex);
+		void* allocation = AlignedAlloc(size, alignment);
+		block.Overflow.push_back(allocation);
+		return allocation;
+	}
+
+	size_t FrameAllocator::GetUsedBytes()
+	{
+		return std::min<size_t>(s_Data.Blocks[s_Data.Current].Offset.load(std::memory_order_relaxed), s_Data.BlockSize);
+	}
+
+	size_t FrameAllocator::GetBlockSize()
+	{
+		return s_Data.BlockSize;
+	}
+
+	uint32_t FrameAllocator::GetOverflowCount()
+	{
+		std::lock_guard<std::mutex> lock(s_Data.OverflowMutex);
+		return (uint32_t)s_Data.Blocks[s_Data.Current].Overflow.size();
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <EASTL/vector.h>
+
+#include "Illumino/Renderer/GraphicsContext.h"
+
+namespace IlluminoEngine
+{
+	// Linear allocator for data that only lives until the end of the frame. Every frame in flight has
+	// its own block, NextFrame() moves on to the oldest one and resets it. Freeing is a no-op.
+	// Allocations that do not fit go to the heap and are released on the next reset of the block.
+	class FrameAllocator
+	{
+	public:
+		static void Init(size_t blockSize = 4 * 1024 * 1024);
+		static void Shutdown();
+		static void NextFrame();
+
+		// Safe to call from any thread
+		static void* Allocate(size_t size, size_t alignment = 16);
+
+		static size_t GetUsedBytes();
+		static size_t GetBlockSize();
+		static uint32_t GetOverflowCount();
+
+		// Number of heap allocations since startup: EASTL operator new in ipch.cpp and frame overflows. Executables can
+		// count more by calling CountHeapAllocation() from their own allocation hooks, the tests replace global operator new
+		static uint64_t GetHeapAllocationCount() { return s_HeapAllocationCount.load(std::memory_order_relaxed); }
+		static void CountHeapAllocation() { s_HeapAllocationCount.fetch_add(1, std::memory_order_relaxed); }
+
+	private:
+		static std::atomic<uint64_t> s_HeapAllocationCount;
+	};
+
+	// EASTL allocator backed by the FrameAllocator, containers using it must be reset with
+	// reset_lose_memory() instead of being kept across frames
+	class EASTLFrameAllocator
+	{
+	public:
+		EASTLFrameAllocator(const char* name = "FrameAllocator") {}
+		EASTLFrameAllocator(const EASTLFrameAllocator& other, const char* name) {}
+
+		void* allocate(size_t n, int flags = 0) { return FrameAllocator::Allocate(n); }
+		void* allocate(size_t n, size_t alignment, size_t offset, int flags = 0) { return FrameAllocator::Allocate(n, alignment > 16 ? alignment : 16); }
+		void deallocate(void* p, size_t n) {}
+
+		const char* get_name() const { return "FrameAllocator"; }
+		void set_name(const char* name) {}
+	};
+
+	inline bool operator==(const EASTLFrameAllocator&, const EASTLFrameAllocator&) { return true; }
+	inline bool operator!=(const EASTLFrameAllocator&, const EASTLFrameAllocator&) { return false; }
+
+	template<typename T>
+	using FrameVector = eastl::vector<T, EASTLFrameAllocator>;
+}
@@ -0,0 +1,152 @@
+#include "ipch.h"
+#include "JobSystem.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <EASTL/vector.h>
+
+namespace IlluminoEngine
+{
+	struct JobSystemData
+	{
+		eastl::vector<std::thread> Workers;
+
+		// Ring of jobs, Head is the oldest one
+		JobSystem::Job Queue[JobSystem::k_QueueCapacity];
+		uint32_t Head = 0;
+		uint32_t Count = 0;
+
+		std::mutex QueueMutex;
+		std::condition_variable WakeCondition;
+		bool Running = false;
+	};
+
+	static JobSystemData s_Data;
+
+	static void RunJob(const JobSystem::Job& job)
+	{
+		job.Invoke(job.Data, job.Start, job.End);
+		job.Counter->Value.fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	// Expects the queue mutex to be held
+	static JobSystem::Job PopJob()
+	{
+		const JobSystem::Job job = s_Data.Queue[s_Data.Head];
+		s_Data.Head = (s_Data.Head + 1) % JobSystem::k_QueueCapacity;
+		--s_Data.Count;
+		return job;
+	}
+
+	static bool TryRunQueuedJob()
+	{
+		JobSystem::Job job;
+		{
+			std::lock_guard<std::mutex> lock(s_Data.QueueMutex);
+			if (s_Data.Count == 0)
+				return false;
+
+			job = PopJob();
+		}
+
+		RunJob(job);
+		return true;
+	}
+
+	static void WorkerLoop(uint32_t index)
+	{
+		OPTICK_THREAD("Worker");
+
+		while (true)
+		{
+			JobSystem::Job job;
+			{
+				std::unique_lock<std::mutex> lock(s_Data.QueueMutex);
+				s_Data.WakeCondition.wait(lock, [] { return s_Data.Count > 0 || !s_Data.Running; });
+				if (s_Data.Count == 0)
+					return;
+
+				job = PopJob();
+			}
+
+			RunJob(job);
+		}
+	}
+
+	void JobSystem::Init(uint32_t threadCount)
+	{
+		OPTICK_EVENT();
+
+		ILLUMINO_ASSERT(!s_Data.Running, "JobSystem is already initialized!");
+
+		if (threadCount == 0)
+		{
+			const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+		}
+
+		s_Data.Running = true;
+		s_Data.Head = 0;
+		s_Data.Count = 0;
+		s_Data.Workers.reserve(threadCount);
+		for (uint32_t i = 0; i < threadCount; ++i)
+			s_Data.Workers.emplace_back(WorkerLoop, i);
+
+		ILLUMINO_INFO("JobSystem started with {0} worker threads", threadCount);
+	}
+
+	void JobSystem::Shutdown()
+	{
+		OPTICK_EVENT();
+
+		{
+			std::lock_guard<std::mutex> lock(s_Data.QueueMutex);
+			s_Data.Running = false;
+		}
+		s_Data.WakeCondition.notify_all();
+
+		for (auto& worker : s_Data.Workers)
+			worker.join();
+		s_Data.Workers.clear();
+	}
+
+	void JobSystem::Submit(Job& job, JobCounter& counter)
+	{
+		counter.Value.fetch_add(1, std::memory_order_acq_rel);
+		job.Counter = &counter;
+
+		if (!s_Data.Workers.empty())
+		{
+			std::unique_lock<std::mutex> lock(s_Data.QueueMutex);
+			if (s_Data.Count < k_QueueCapacity)
+			{
+				s_Data.Queue[(s_Data.Head + s_Data.Count) % k_QueueCapacity] = job;
+				++s_Data.Count;
+				lock.unlock();
+
+				s_Data.WakeCondition.notify_one();
+				return;
+			}
+		}
+
+		// A full ring is drained by running the job here, the workers keep making progress on the rest
+		RunJob(job);
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		OPTICK_EVENT();
+
+		while (!counter.IsDone())
+		{
+			if (!TryRunQueuedJob())
+				std::this_thread::yield();
+		}
+	}
+
+	uint32_t JobSystem::GetWorkerCount()
+	{
+		return (uint32_t)s_Data.Workers.size();
+	}
+}
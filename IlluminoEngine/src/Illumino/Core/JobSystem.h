@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+#include "Core.h"
+
+namespace IlluminoEngine
+{
+	// Counts the jobs in flight, a counter can be waited on until all of its jobs are done
+	struct JobCounter
+	{
+		std::atomic<uint32_t> Value = 0;
+
+		bool IsDone() const { return Value.load(std::memory_order_acquire) == 0; }
+	};
+
+	// Jobs are copied into a fixed ring of preallocated entries, queuing one never touches the heap. Callables are
+	// stored inline, so they must be trivially copyable and fit in k_JobDataSize: capture pointers, references and
+	// small values, not containers or std::function.
+	class JobSystem
+	{
+	public:
+		static constexpr size_t k_JobDataSize = 48;
+		static constexpr uint32_t k_QueueCapacity = 4096;
+
+		// threadCount = 0 uses every hardware thread except the main thread
+		static void Init(uint32_t threadCount = 0);
+		static void Shutdown();
+
+		// Jobs run inline on the calling thread when the system has no workers or the queue is full
+		template<typename Fn>
+		static void Execute(const Fn& fn, JobCounter& counter)
+		{
+			Job job = MakeJob(fn, [](const void* data, uint32_t, uint32_t) { (*static_cast<const Fn*>(data))(); });
+			Submit(job, counter);
+		}
+
+		// Splits [0, count) into ranges of groupSize and runs fn(start, end) for each range as a job
+		template<typename Fn>
+		static void Dispatch(uint32_t count, uint32_t groupSize, const Fn& fn, JobCounter& counter)
+		{
+			OPTICK_EVENT();
+
+			if (count == 0)
+				return;
+
+			Job job = MakeJob(fn, [](const void* data, uint32_t start, uint32_t end) { (*static_cast<const Fn*>(data))(start, end); });
+
+			groupSize = groupSize ? groupSize : count;
+			for (uint32_t start = 0; start < count; start += groupSize)
+			{
+				job.Start = start;
+				job.End = start + groupSize < count ? start + groupSize : count;
+				Submit(job, counter);
+			}
+		}
+
+		// The waiting thread keeps executing queued jobs until the counter reaches zero
+		static void Wait(JobCounter& counter);
+
+		static uint32_t GetWorkerCount();
+
+		// One ring entry, the callable is copied into Data and called through Invoke
+		struct Job
+		{
+			alignas(16) uint8_t Data[k_JobDataSize];
+			void (*Invoke)(const void* data, uint32_t start, uint32_t end) = nullptr;
+			JobCounter* Counter = nullptr;
+			uint32_t Start = 0;
+			uint32_t End = 0;
+		};
+
+	private:
+		template<typename Fn>
+		static Job MakeJob(const Fn& fn, void (*invoke)(const void*, uint32_t, uint32_t))
+		{
+			static_assert(sizeof(Fn) <= k_JobDataSize, "Job captures too much, capture pointers or references instead");
+			static_assert(alignof(Fn) <= 16, "Job callable is over-aligned");
+			static_assert(std::is_trivially_copyable<Fn>::value && std::is_trivially_destructible<Fn>::value,
+				"Jobs are stored inline without destructors, capture only trivially copyable data");
+
+			Job job;
+			memcpy(job.Data, &fn, sizeof(Fn));
+			job.Invoke = invoke;
+			return job;
+		}
+
+		static void Submit(Job& job, JobCounter& counter);
+	};
+}
@@ -1,4 +1,6 @@
 #include "ipch.h"
 
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 #include <backends/imgui_impl_win32.cpp>
 #include <backends/imgui_impl_dx12.cpp>
+#endif
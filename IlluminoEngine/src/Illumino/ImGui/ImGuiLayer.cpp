@@ -2,12 +2,14 @@
 #include "ImGuiLayer.h"
 
 #include <imgui.h>
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 #include <backends/imgui_impl_win32.h>
 #include <backends/imgui_impl_dx12.h>
 #include <d3d12.h>
 
 #include "Platform/D3D12/Dx12GraphicsContext.h"
 #include "Platform/D3D12/Dx12Resources.h"
+#endif
 #include "Illumino/Core/Application.h"
 #include "Window.h"
 
@@ -22,24 +24,22 @@ namespace IlluminoEngine
 	{
 	}
 
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 	static DescriptorHandle s_ImGuiDescriptorHandle;
+#endif
 	void ImGuiLayer::OnAttach()
 	{
 		OPTICK_EVENT();
 
-		Ref<Window> window = Application::GetApplication()->GetWindow();
-		Dx12GraphicsContext* context = (Dx12GraphicsContext*)window->GetGraphicsContext().get();
-
-		HWND hWnd = window->GetHwnd();
-		ID3D12Device* device = reinterpret_cast<ID3D12Device*>(context->GetDevice());
-
 		IMGUI_CHECKVERSION();
 		ImGui::CreateContext();
 		ImGuiIO& io = ImGui::GetIO(); (void)io;
 		io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;       // Enable Keyboard Controls
 		io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;           // Enable Docking
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 		io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;         // Enable Multi-Viewport / Platform Windows
 		io.ConfigFlags |= ImGuiConfigFlags_DpiEnableScaleViewports;
+#endif
 
 		io.ConfigDockingTransparentPayload = true;
 		io.ConfigWindowsMoveFromTitleBarOnly = true;
@@ -57,6 +57,13 @@ namespace IlluminoEngine
 			style.Colors[ImGuiCol_WindowBg].w = 1.0f;
 		}
 
+#ifdef ILLUMINO_PLATFORM_WINDOWS
+		Ref<Window> window = Application::GetApplication()->GetWindow();
+		Dx12GraphicsContext* context = (Dx12GraphicsContext*)window->GetGraphicsContext().get();
+
+		HWND hWnd = window->GetHwnd();
+		ID3D12Device* device = reinterpret_cast<ID3D12Device*>(context->GetDevice());
+
 		DescriptorHeap& heap = context->GetSRVDescriptorHeap();
 		s_ImGuiDescriptorHandle = heap.Allocate();
 
@@ -66,12 +73,19 @@ namespace IlluminoEngine
 			DXGI_FORMAT_R8G8B8A8_UNORM, heap.GetHeap(),
 			s_ImGuiDescriptorHandle.CPU,
 			s_ImGuiDescriptorHandle.GPU);
+#else
+		// Without a renderer backend the font atlas has to be built here, NewFrame asserts on an unbuilt one
+		unsigned char* pixels;
+		int width, height;
+		io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+#endif
 	}
 
 	void ImGuiLayer::OnDetach()
 	{
 		OPTICK_EVENT();
 
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 		ImGui_ImplDX12_Shutdown();
 		ImGui_ImplWin32_Shutdown();
 		ImGui::DestroyContext();
@@ -80,14 +94,25 @@ namespace IlluminoEngine
 		Dx12GraphicsContext* context = (Dx12GraphicsContext*)window->GetGraphicsContext().get();
 		DescriptorHeap& heap = context->GetSRVDescriptorHeap();
 		heap.Free(s_ImGuiDescriptorHandle);
+#else
+		ImGui::DestroyContext();
+#endif
 	}
 
 	void ImGuiLayer::Begin()
 	{
 		OPTICK_EVENT();
 
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 		ImGui_ImplDX12_NewFrame();
 		ImGui_ImplWin32_NewFrame();
+#else
+		// The platform backend normally provides these
+		Ref<Window> window = Application::GetApplication()->GetWindow();
+		ImGuiIO& io = ImGui::GetIO();
+		io.DisplaySize = ImVec2((float)window->GetWidth(), (float)window->GetHeight());
+		io.DeltaTime = 1.0f / 60.0f;
+#endif
 
 		ImGui::NewFrame();
 	}
@@ -97,12 +122,13 @@ namespace IlluminoEngine
 		OPTICK_EVENT();
 
 		Ref<Window> window = Application::GetApplication()->GetWindow();
-		Dx12GraphicsContext* context = (Dx12GraphicsContext*) window->GetGraphicsContext().get();
-		ID3D12GraphicsCommandList* commandList = context->GetCommandList();
-
 		ImGuiIO& io = ImGui::GetIO(); (void)io;
 		io.DisplaySize = ImVec2((float)window->GetWidth(), (float)window->GetHeight());
 
+#ifdef ILLUMINO_PLATFORM_WINDOWS
+		Dx12GraphicsContext* context = (Dx12GraphicsContext*) window->GetGraphicsContext().get();
+		ID3D12GraphicsCommandList* commandList = context->GetCommandList();
+
 		ImGui::Render();
 		ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), commandList);
 
@@ -112,5 +138,9 @@ namespace IlluminoEngine
 			ImGui::UpdatePlatformWindows();
 			ImGui::RenderPlatformWindowsDefault(NULL, commandList);
 		}
+#else
+		// Still builds the draw lists, so the cost of the UI shows up in headless runs
+		ImGui::Render();
+#endif
 	}
 }
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace IlluminoEngine
+{
+	struct AABB
+	{
+		glm::vec3 Min = glm::vec3(0.0f);
+		glm::vec3 Max = glm::vec3(0.0f);
+
+		glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+		glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+	};
+
+	struct BoundingSphere
+	{
+		glm::vec3 Center = glm::vec3(0.0f);
+		float Radius = 0.0f;
+	};
+
+	struct Frustum
+	{
+		// Left, right, bottom, top, near, far. xyz is the inward facing normal, w the distance
+		glm::vec4 Planes[6];
+
+		Frustum() = default;
+		Frustum(const glm::mat4& viewProjection)
+		{
+			// Gribb-Hartmann extraction, rows of the column major matrix
+			const glm::vec4 row0 = { viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0] };
+			const glm::vec4 row1 = { viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1] };
+			const glm::vec4 row2 = { viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2] };
+			const glm::vec4 row3 = { viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3] };
+
+			Planes[0] = row3 + row0;
+			Planes[1] = row3 - row0;
+			Planes[2] = row3 + row1;
+			Planes[3] = row3 - row1;
+			// -w <= z also holds for a [0, 1] depth range, so this is conservative for both conventions
+			Planes[4] = row3 + row2;
+			Planes[5] = row3 - row2;
+
+			for (glm::vec4& plane : Planes)
+				plane /= glm::length(glm::vec3(plane));
+		}
+	};
+
+	namespace Math
+	{
+		inline AABB TransformAABB(const AABB& aabb, const glm::mat4& transform)
+		{
+			const glm::vec3 center = glm::vec3(transform * glm::vec4(aabb.GetCenter(), 1.0f));
+			const glm::vec3 extents = aabb.GetExtents();
+			const glm::mat3 absolute = glm::mat3(glm::abs(glm::vec3(transform[0])), glm::abs(glm::vec3(transform[1])), glm::abs(glm::vec3(transform[2])));
+			const glm::vec3 worldExtents = absolute * extents;
+			return { center - worldExtents, center + worldExtents };
+		}
+
+		inline BoundingSphere TransformSphere(const BoundingSphere& sphere, const glm::mat4& transform)
+		{
+			const float scale = glm::sqrt(glm::max(glm::max(glm::dot(glm::vec3(transform[0]), glm::vec3(transform[0])),
+				glm::dot(glm::vec3(transform[1]), glm::vec3(transform[1]))), glm::dot(glm::vec3(transform[2]), glm::vec3(transform[2]))));
+			return { glm::vec3(transform * glm::vec4(sphere.Center, 1.0f)), sphere.Radius * scale };
+		}
+	}
+}
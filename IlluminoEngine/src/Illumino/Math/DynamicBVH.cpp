@@ -0,0 +1,492 @@
+#include "ipch.h"
+#include "DynamicBVH.h"
+
+namespace IlluminoEngine
+{
+	static constexpr uint32_t k_SAHBinCount = 12;
+
+	static AABB Combine(const AABB& a, const AABB& b)
+	{
+		return { glm::min(a.Min, b.Min), glm::max(a.Max, b.Max) };
+	}
+
+	static bool Contains(const AABB& outer, const AABB& inner)
+	{
+		return outer.Min.x <= inner.Min.x && outer.Min.y <= inner.Min.y && outer.Min.z <= inner.Min.z
+			&& outer.Max.x >= inner.Max.x && outer.Max.y >= inner.Max.y && outer.Max.z >= inner.Max.z;
+	}
+
+	static float GetSurfaceArea(const AABB& bounds)
+	{
+		const glm::vec3 size = bounds.Max - bounds.Min;
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	DynamicBVH::DynamicBVH(float margin)
+		: m_Margin(margin)
+	{
+	}
+
+	int32_t DynamicBVH::AllocateNode()
+	{
+		int32_t index;
+		if (m_FreeList == NullNode)
+		{
+			index = (int32_t)m_Nodes.size();
+			m_Nodes.push_back();
+		}
+		else
+		{
+			index = m_FreeList;
+			m_FreeList = m_Nodes[index].Parent;
+		}
+
+		Node& node = m_Nodes[index];
+		node = Node();
+		node.Height = 0;
+		++m_NodeCount;
+		return index;
+	}
+
+	void DynamicBVH::FreeNode(int32_t index)
+	{
+		Node& node = m_Nodes[index];
+		node.Parent = m_FreeList;
+		node.Height = -1;
+		m_FreeList = index;
+		--m_NodeCount;
+	}
+
+	int32_t DynamicBVH::CreateProxy(const AABB& bounds, uint32_t userData)
+	{
+		OPTICK_EVENT();
+
+		const int32_t proxy = AllocateNode();
+		Node& node = m_Nodes[proxy];
+		node.Bounds = { bounds.Min - m_Margin, bounds.Max + m_Margin };
+		node.UserData = userData;
+		++m_ProxyCount;
+
+		InsertLeaf(proxy);
+		return proxy;
+	}
+
+	void DynamicBVH::DestroyProxy(int32_t proxy)
+	{
+		OPTICK_EVENT();
+
+		ILLUMINO_ASSERT(proxy >= 0 && proxy < (int32_t)m_Nodes.size() && m_Nodes[proxy].IsLeaf() && m_Nodes[proxy].Height == 0, "Invalid BVH proxy");
+
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+		--m_ProxyCount;
+	}
+
+	bool DynamicBVH::MoveProxy(int32_t proxy, const AABB& bounds)
+	{
+		ILLUMINO_ASSERT(proxy >= 0 && proxy < (int32_t)m_Nodes.size() && m_Nodes[proxy].IsLeaf() && m_Nodes[proxy].Height == 0, "Invalid BVH proxy");
+
+		if (Contains(m_Nodes[proxy].Bounds, bounds))
+			return false;
+
+		RemoveLeaf(proxy);
+		m_Nodes[proxy].Bounds = { bounds.Min - m_Margin, bounds.Max + m_Margin };
+		InsertLeaf(proxy);
+		return true;
+	}
+
+	void DynamicBVH::Clear()
+	{
+		m_Nodes.clear();
+		m_Root = NullNode;
+		m_FreeList = NullNode;
+		m_NodeCount = 0;
+		m_ProxyCount = 0;
+	}
+
+	float DynamicBVH::GetAreaRatio() const
+	{
+		if (m_Root == NullNode)
+			return 0.0f;
+
+		const float rootArea = GetSurfaceArea(m_Nodes[m_Root].Bounds);
+		if (rootArea <= 0.0f)
+			return 0.0f;
+
+		float totalArea = 0.0f;
+		for (const Node& node : m_Nodes)
+		{
+			if (node.Height > 0)
+				totalArea += GetSurfaceArea(node.Bounds);
+		}
+
+		return totalArea / rootArea;
+	}
+
+	void DynamicBVH::InsertLeaf(int32_t leaf)
+	{
+		if (m_Root == NullNode)
+		{
+			m_Root = leaf;
+			m_Nodes[leaf].Parent = NullNode;
+			return;
+		}
+
+		// Descend towards the sibling with the lowest cost of the new parent plus the area added to its ancestors
+		const AABB leafBounds = m_Nodes[leaf].Bounds;
+		int32_t index = m_Root;
+		while (!m_Nodes[index].IsLeaf())
+		{
+			const Node& node = m_Nodes[index];
+			const float area = GetSurfaceArea(node.Bounds);
+			const float combinedArea = GetSurfaceArea(Combine(node.Bounds, leafBounds));
+
+			const float cost = 2.0f * combinedArea;
+			const float inheritanceCost = 2.0f * (combinedArea - area);
+
+			auto childCost = [&](int32_t child)
+			{
+				const Node& childNode = m_Nodes[child];
+				const float newArea = GetSurfaceArea(Combine(childNode.Bounds, leafBounds));
+				return (childNode.IsLeaf() ? newArea : newArea - GetSurfaceArea(childNode.Bounds)) + inheritanceCost;
+			};
+
+			const float cost1 = childCost(node.Child1);
+			const float cost2 = childCost(node.Child2);
+			if (cost < cost1 && cost < cost2)
+				break;
+
+			index = cost1 < cost2 ? node.Child1 : node.Child2;
+		}
+
+		const int32_t sibling = index;
+		const int32_t oldParent = m_Nodes[sibling].Parent;
+		const int32_t newParent = AllocateNode();
+		{
+			Node& parent = m_Nodes[newParent];
+			parent.Parent = oldParent;
+			parent.Bounds = Combine(leafBounds, m_Nodes[sibling].Bounds);
+			parent.Height = m_Nodes[sibling].Height + 1;
+			parent.Child1 = sibling;
+			parent.Child2 = leaf;
+		}
+
+		if (oldParent != NullNode)
+		{
+			if (m_Nodes[oldParent].Child1 == sibling)
+				m_Nodes[oldParent].Child1 = newParent;
+			else
+				m_Nodes[oldParent].Child2 = newParent;
+		}
+		else
+		{
+			m_Root = newParent;
+		}
+
+		m_Nodes[sibling].Parent = newParent;
+		m_Nodes[leaf].Parent = newParent;
+
+		Refit(newParent);
+	}
+
+	void DynamicBVH::RemoveLeaf(int32_t leaf)
+	{
+		if (leaf == m_Root)
+		{
+			m_Root = NullNode;
+			return;
+		}
+
+		const int32_t parent = m_Nodes[leaf].Parent;
+		const int32_t grandParent = m_Nodes[parent].Parent;
+		const int32_t sibling = m_Nodes[parent].Child1 == leaf ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+		m_Nodes[sibling].Parent = grandParent;
+		FreeNode(parent);
+
+		if (grandParent == NullNode)
+		{
+			m_Root = sibling;
+			return;
+		}
+
+		if (m_Nodes[grandParent].Child1 == parent)
+			m_Nodes[grandParent].Child1 = sibling;
+		else
+			m_Nodes[grandParent].Child2 = sibling;
+
+		Refit(grandParent);
+	}
+
+	// Walks up from index, rebalancing and recomputing bounds and heights
+	void DynamicBVH::Refit(int32_t index)
+	{
+		while (index != NullNode)
+		{
+			index = Balance(index);
+
+			Node& node = m_Nodes[index];
+			const Node& child1 = m_Nodes[node.Child1];
+			const Node& child2 = m_Nodes[node.Child2];
+			node.Height = 1 + glm::max(child1.Height, child2.Height);
+			node.Bounds = Combine(child1.Bounds, child2.Bounds);
+
+			index = node.Parent;
+		}
+	}
+
+	// Rotates the taller grandchild up if a is unbalanced, returns the new root of the subtree
+	int32_t DynamicBVH::Balance(int32_t iA)
+	{
+		Node& a = m_Nodes[iA];
+		if (a.IsLeaf() || a.Height < 2)
+			return iA;
+
+		const int32_t iB = a.Child1;
+		const int32_t iC = a.Child2;
+		Node& b = m_Nodes[iB];
+		Node& c = m_Nodes[iC];
+
+		const int32_t balance = c.Height - b.Height;
+
+		auto replaceChild = [this](int32_t parent, int32_t oldChild, int32_t newChild)
+		{
+			if (parent == NullNode)
+				m_Root = newChild;
+			else if (m_Nodes[parent].Child1 == oldChild)
+				m_Nodes[parent].Child1 = newChild;
+			else
+				m_Nodes[parent].Child2 = newChild;
+		};
+
+		// Rotate c up
+		if (balance > 1)
+		{
+			const int32_t iF = c.Child1;
+			const int32_t iG = c.Child2;
+			Node& f = m_Nodes[iF];
+			Node& g = m_Nodes[iG];
+
+			c.Child1 = iA;
+			c.Parent = a.Parent;
+			a.Parent = iC;
+			replaceChild(c.Parent, iA, iC);
+
+			if (f.Height > g.Height)
+			{
+				c.Child2 = iF;
+				a.Child2 = iG;
+				g.Parent = iA;
+				a.Bounds = Combine(b.Bounds, g.Bounds);
+				c.Bounds = Combine(a.Bounds, f.Bounds);
+				a.Height = 1 + glm::max(b.Height, g.Height);
+				c.Height = 1 + glm::max(a.Height, f.Height);
+			}
+			else
+			{
+				c.Child2 = iG;
+				a.Child2 = iF;
+				f.Parent = iA;
+				a.Bounds = Combine(b.Bounds, f.Bounds);
+				c.Bounds = Combine(a.Bounds, g.Bounds);
+				a.Height = 1 + glm::max(b.Height, f.Height);
+				c.Height = 1 + glm::max(a.Height, g.Height);
+			}
+
+			return iC;
+		}
+
+		// Rotate b up
+		if (balance < -1)
+		{
+			const int32_t iD = b.Child1;
+			const int32_t iE = b.Child2;
+			Node& d = m_Nodes[iD];
+			Node& e = m_Nodes[iE];
+
+			b.Child1 = iA;
+			b.Parent = a.Parent;
+			a.Parent = iB;
+			replaceChild(b.Parent, iA, iB);
+
+			if (d.Height > e.Height)
+			{
+				b.Child2 = iD;
+				a.Child1 = iE;
+				e.Parent = iA;
+				a.Bounds = Combine(c.Bounds, e.Bounds);
+				b.Bounds = Combine(a.Bounds, d.Bounds);
+				a.Height = 1 + glm::max(c.Height, e.Height);
+				b.Height = 1 + glm::max(a.Height, d.Height);
+			}
+			else
+			{
+				b.Child2 = iE;
+				a.Child1 = iD;
+				d.Parent = iA;
+				a.Bounds = Combine(c.Bounds, d.Bounds);
+				b.Bounds = Combine(a.Bounds, e.Bounds);
+				a.Height = 1 + glm::max(c.Height, d.Height);
+				b.Height = 1 + glm::max(a.Height, e.Height);
+			}
+
+			return iB;
+		}
+
+		return iA;
+	}
+
+	void DynamicBVH::Build(const eastl::vector<AABB>& bounds, const eastl::vector<uint32_t>& userData, eastl::vector<int32_t>& outProxies)
+	{
+		OPTICK_EVENT();
+
+		ILLUMINO_ASSERT(bounds.size() == userData.size(), "Every proxy needs bounds and user data");
+
+		Clear();
+		m_Nodes.reserve(bounds.size() * 2);
+		outProxies.resize(bounds.size());
+		for (size_t i = 0; i < bounds.size(); ++i)
+		{
+			const int32_t proxy = AllocateNode();
+			m_Nodes[proxy].Bounds = { bounds[i].Min - m_Margin, bounds[i].Max + m_Margin };
+			m_Nodes[proxy].UserData = userData[i];
+			outProxies[i] = proxy;
+		}
+		m_ProxyCount = (uint32_t)bounds.size();
+
+		Rebuild();
+	}
+
+	void DynamicBVH::Rebuild()
+	{
+		OPTICK_EVENT();
+
+		// Leaves keep their indices so proxies stay valid, only internal nodes are rebuilt
+		eastl::vector<int32_t> leaves;
+		leaves.reserve(m_ProxyCount);
+		for (int32_t i = 0; i < (int32_t)m_Nodes.size(); ++i)
+		{
+			if (m_Nodes[i].Height == 0)
+				leaves.push_back(i);
+			else if (m_Nodes[i].Height > 0)
+				FreeNode(i);
+		}
+
+		if (leaves.empty())
+		{
+			m_Root = NullNode;
+			return;
+		}
+
+		m_Root = BuildRange(leaves, 0, (uint32_t)leaves.size());
+		m_Nodes[m_Root].Parent = NullNode;
+	}
+
+	int32_t DynamicBVH::BuildRange(eastl::vector<int32_t>& leaves, uint32_t begin, uint32_t end)
+	{
+		if (end - begin == 1)
+			return leaves[begin];
+
+		AABB centroidBounds = { m_Nodes[leaves[begin]].Bounds.GetCenter(), m_Nodes[leaves[begin]].Bounds.GetCenter() };
+		for (uint32_t i = begin + 1; i < end; ++i)
+		{
+			const glm::vec3 centroid = m_Nodes[leaves[i]].Bounds.GetCenter();
+			centroidBounds.Min = glm::min(centroidBounds.Min, centroid);
+			centroidBounds.Max = glm::max(centroidBounds.Max, centroid);
+		}
+
+		const glm::vec3 centroidSize = centroidBounds.Max - centroidBounds.Min;
+		int axis = 0;
+		if (centroidSize.y > centroidSize[axis])
+			axis = 1;
+		if (centroidSize.z > centroidSize[axis])
+			axis = 2;
+
+		uint32_t mid = begin + (end - begin) / 2;
+		const float axisMin = centroidBounds.Min[axis];
+		const float axisSize = centroidSize[axis];
+		if (axisSize > 0.0f)
+		{
+			struct Bin
+			{
+				AABB Bounds;
+				uint32_t Count = 0;
+			};
+			Bin bins[k_SAHBinCount];
+
+			const float binScale = k_SAHBinCount / axisSize;
+			auto getBin = [&](int32_t leaf)
+			{
+				const uint32_t bin = (uint32_t)((m_Nodes[leaf].Bounds.GetCenter()[axis] - axisMin) * binScale);
+				return glm::min(bin, k_SAHBinCount - 1);
+			};
+
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				Bin& bin = bins[getBin(leaves[i])];
+				const AABB& leafBounds = m_Nodes[leaves[i]].Bounds;
+				bin.Bounds = bin.Count == 0 ? leafBounds : Combine(bin.Bounds, leafBounds);
+				++bin.Count;
+			}
+
+			// Sweep from the right to get the cost of every right hand side, then from the left to pick the split
+			float rightCosts[k_SAHBinCount];
+			AABB rightBounds;
+			uint32_t rightCount = 0;
+			for (uint32_t i = k_SAHBinCount - 1; i > 0; --i)
+			{
+				if (bins[i].Count > 0)
+				{
+					rightBounds = rightCount == 0 ? bins[i].Bounds : Combine(rightBounds, bins[i].Bounds);
+					rightCount += bins[i].Count;
+				}
+				rightCosts[i] = rightCount > 0 ? GetSurfaceArea(rightBounds) * rightCount : 0.0f;
+			}
+
+			float bestCost = std::numeric_limits<float>::max();
+			uint32_t bestSplit = 0;
+			AABB leftBounds;
+			uint32_t leftCount = 0;
+			for (uint32_t i = 1; i < k_SAHBinCount; ++i)
+			{
+				const Bin& bin = bins[i - 1];
+				if (bin.Count > 0)
+				{
+					leftBounds = leftCount == 0 ? bin.Bounds : Combine(leftBounds, bin.Bounds);
+					leftCount += bin.Count;
+				}
+
+				const float cost = (leftCount > 0 ? GetSurfaceArea(leftBounds) * leftCount : 0.0f) + rightCosts[i];
+				if (leftCount > 0 && leftCount < end - begin && cost < bestCost)
+				{
+					bestCost = cost;
+					bestSplit = i;
+				}
+			}
+
+			if (bestSplit > 0)
+			{
+				int32_t* split = std::partition(leaves.begin() + begin, leaves.begin() + end, [&](int32_t leaf) { return getBin(leaf) < bestSplit; });
+				mid = (uint32_t)(split - leaves.begin());
+			}
+		}
+
+		// All centroids in one spot, split in the middle of the range
+		if (mid == begin || mid == end)
+			mid = begin + (end - begin) / 2;
+
+		const int32_t child1 = BuildRange(leaves, begin, mid);
+		const int32_t child2 = BuildRange(leaves, mid, end);
+
+		const int32_t index = AllocateNode();
+		Node& node = m_Nodes[index];
+		node.Child1 = child1;
+		node.Child2 = child2;
+		node.Bounds = Combine(m_Nodes[child1].Bounds, m_Nodes[child2].Bounds);
+		node.Height = 1 + glm::max(m_Nodes[child1].Height, m_Nodes[child2].Height);
+		m_Nodes[child1].Parent = index;
+		m_Nodes[child2].Parent = index;
+
+		return index;
+	}
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <EASTL/vector.h>
+#include <EASTL/fixed_vector.h>
+
+#include "BoundingVolume.h"
+
+namespace IlluminoEngine
+{
+	// Dynamic AABB tree. Leaves store fattened bounds so small moves don't touch the tree,
+	// inserts descend by surface area cost and rotations keep it balanced. Rebuild() rebuilds
+	// the internal nodes top down with a binned SAH, proxy ids stay valid across rebuilds.
+	// Queries test the fattened bounds, so their results are conservative.
+	class DynamicBVH
+	{
+	public:
+		static constexpr int32_t NullNode = -1;
+
+		DynamicBVH(float margin = 0.1f);
+
+		int32_t CreateProxy(const AABB& bounds, uint32_t userData);
+		void DestroyProxy(int32_t proxy);
+		// Refits the proxy, returns true if it left its fattened bounds and was reinserted
+		bool MoveProxy(int32_t proxy, const AABB& bounds);
+
+		// Clears the tree and builds it in one go, proxies are returned in input order
+		void Build(const eastl::vector<AABB>& bounds, const eastl::vector<uint32_t>& userData, eastl::vector<int32_t>& outProxies);
+		void Rebuild();
+		void Clear();
+
+		uint32_t GetUserData(int32_t proxy) const { return m_Nodes[proxy].UserData; }
+		const AABB& GetFatBounds(int32_t proxy) const { return m_Nodes[proxy].Bounds; }
+		uint32_t GetProxyCount() const { return m_ProxyCount; }
+		uint32_t GetNodeCount() const { return m_NodeCount; }
+		int32_t GetHeight() const { return m_Root == NullNode ? 0 : m_Nodes[m_Root].Height; }
+		// Summed surface area of the internal nodes relative to the root, lower is better
+		float GetAreaRatio() const;
+
+		// Callbacks receive the proxy's user data
+		template<typename Fn>
+		void QueryAABB(const AABB& bounds, Fn&& callback) const
+		{
+			Traverse([&bounds](const AABB& node) { return Overlaps(node, bounds) ? 1 : -1; }, callback);
+		}
+
+		template<typename Fn>
+		void QuerySphere(const BoundingSphere& sphere, Fn&& callback) const
+		{
+			Traverse([&sphere](const AABB& node)
+			{
+				const glm::vec3 closest = glm::clamp(sphere.Center, node.Min, node.Max);
+				const glm::vec3 delta = closest - sphere.Center;
+				return glm::dot(delta, delta) <= sphere.Radius * sphere.Radius ? 1 : -1;
+			}, callback);
+		}
+
+		template<typename Fn>
+		void QueryFrustum(const Frustum& frustum, Fn&& callback) const
+		{
+			Traverse([&frustum](const AABB& node)
+			{
+				const glm::vec3 center = node.GetCenter();
+				const glm::vec3 extents = node.GetExtents();
+				int result = 0;
+				for (const glm::vec4& plane : frustum.Planes)
+				{
+					const float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+					const float radius = glm::dot(glm::abs(glm::vec3(plane)), extents);
+					if (distance + radius < 0.0f)
+						return -1;
+					if (distance - radius < 0.0f)
+						result = 1;
+				}
+				return result;
+			}, callback);
+		}
+
+		// The callback receives the user data and the distance to the proxy's bounds and returns the new
+		// max distance, returning the hit distance finds the closest proxy and maxDistance keeps all of them
+		template<typename Fn>
+		void Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Fn&& callback) const
+		{
+			if (m_Root == NullNode)
+				return;
+
+			const glm::vec3 inverseDirection = 1.0f / direction;
+			eastl::fixed_vector<int32_t, 256> stack;
+			stack.push_back(m_Root);
+			while (!stack.empty())
+			{
+				const int32_t index = stack.back();
+				stack.pop_back();
+
+				const Node& node = m_Nodes[index];
+				float distance;
+				if (!IntersectRay(node.Bounds, origin, inverseDirection, maxDistance, distance))
+					continue;
+
+				if (node.IsLeaf())
+				{
+					maxDistance = glm::min(maxDistance, callback(node.UserData, distance));
+				}
+				else
+				{
+					stack.push_back(node.Child1);
+					stack.push_back(node.Child2);
+				}
+			}
+		}
+
+	private:
+		struct Node
+		{
+			AABB Bounds;
+			// Next free node while the node is on the free list
+			int32_t Parent = NullNode;
+			int32_t Child1 = NullNode;
+			int32_t Child2 = NullNode;
+			// Leaves are 0, free nodes -1
+			int32_t Height = -1;
+			uint32_t UserData = 0;
+
+			bool IsLeaf() const { return Child1 == NullNode; }
+		};
+
+		// classify returns -1 for outside, 0 for fully inside and 1 for intersecting bounds
+		template<typename Classify, typename Fn>
+		void Traverse(Classify&& classify, Fn&& callback) const
+		{
+			if (m_Root == NullNode)
+				return;
+
+			eastl::fixed_vector<int32_t, 256> stack;
+			stack.push_back(m_Root);
+			while (!stack.empty())
+			{
+				const int32_t index = stack.back();
+				stack.pop_back();
+
+				const Node& node = m_Nodes[index];
+				const int result = classify(node.Bounds);
+				if (result < 0)
+					continue;
+
+				if (node.IsLeaf())
+				{
+					callback(node.UserData);
+				}
+				else if (result == 0)
+				{
+					ReportSubtree(index, callback);
+				}
+				else
+				{
+					stack.push_back(node.Child1);
+					stack.push_back(node.Child2);
+				}
+			}
+		}
+
+		template<typename Fn>
+		void ReportSubtree(int32_t root, Fn&& callback) const
+		{
+			eastl::fixed_vector<int32_t, 256> stack;
+			stack.push_back(root);
+			while (!stack.empty())
+			{
+				const Node& node = m_Nodes[stack.back()];
+				stack.pop_back();
+
+				if (node.IsLeaf())
+				{
+					callback(node.UserData);
+				}
+				else
+				{
+					stack.push_back(node.Child1);
+					stack.push_back(node.Child2);
+				}
+			}
+		}
+
+		static bool Overlaps(const AABB& a, const AABB& b)
+		{
+			return a.Min.x <= b.Max.x && a.Max.x >= b.Min.x
+				&& a.Min.y <= b.Max.y && a.Max.y >= b.Min.y
+				&& a.Min.z <= b.Max.z && a.Max.z >= b.Min.z;
+		}
+
+		static bool IntersectRay(const AABB& bounds, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance, float& outDistance)
+		{
+			const glm::vec3 t0 = (bounds.Min - origin) * inverseDirection;
+			const glm::vec3 t1 = (bounds.Max - origin) * inverseDirection;
+			const glm::vec3 tMin = glm::min(t0, t1);
+			const glm::vec3 tMax = glm::max(t0, t1);
+			const float enter = glm::max(glm::max(tMin.x, tMin.y), glm::max(tMin.z, 0.0f));
+			const float exit = glm::min(glm::min(tMax.x, tMax.y), glm::min(tMax.z, maxDistance));
+			outDistance = enter;
+			return enter <= exit;
+		}
+
+		int32_t AllocateNode();
+		void FreeNode(int32_t index);
+		void InsertLeaf(int32_t leaf);
+		void RemoveLeaf(int32_t leaf);
+		void Refit(int32_t index);
+		int32_t Balance(int32_t index);
+		int32_t BuildRange(eastl::vector<int32_t>& leaves, uint32_t begin, uint32_t end);
+
+	private:
+		eastl::vector<Node> m_Nodes;
+		int32_t m_Root = NullNode;
+		int32_t m_FreeList = NullNode;
+		uint32_t m_NodeCount = 0;
+		uint32_t m_ProxyCount = 0;
+		float m_Margin;
+	};
+}
@@ -2,7 +2,10 @@
 #include "Buffer.h"
 
 #include "RendererAPI.h"
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 #include "Platform/D3D12/Dx12Buffer.h"
+#endif
+#include "Platform/Null/NullBuffer.h"
 
 namespace IlluminoEngine
 {
@@ -12,7 +15,10 @@ namespace IlluminoEngine
 		{
 			case RendererAPI::API::None:	ILLUMINO_ASSERT(false, "RendererAPI::None is currently not supported");
 											return nullptr;
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 			case RendererAPI::API::DX12:	return CreateRef<Dx12MeshBuffer>(vertexData, indexData, verticesSize, indicesSize, strideSize);
+#endif
+			case RendererAPI::API::Null:	return CreateRef<NullMeshBuffer>(vertexData, indexData, verticesSize, indicesSize, strideSize);
 		}
 
 		ILLUMINO_ASSERT(false, "Unknown Shader");
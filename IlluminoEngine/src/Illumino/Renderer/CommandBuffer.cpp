@@ -0,0 +1,100 @@
+#include "ipch.h"
+#include "CommandBuffer.h"
+
+namespace IlluminoEngine
+{
+	void CommandBuffer::Reset()
+	{
+		m_Size = 0;
+		m_CommandCount = 0;
+		m_DrawCount = 0;
+	}
+
+	void CommandBuffer::ClearColor(const glm::vec4& color)
+	{
+		Emplace<ClearColorCommand>().Color = color;
+	}
+
+	void CommandBuffer::BindPipeline(const Ref<Shader>& shader)
+	{
+		Emplace<BindPipelineCommand>().PipelineShader = shader.get();
+	}
+
+	void CommandBuffer::BindConstantBuffer(uint32_t slot, uint64_t handle)
+	{
+		BindConstantBufferCommand& command = Emplace<BindConstantBufferCommand>();
+		command.Slot = slot;
+		command.Handle = handle;
+	}
+
+	void CommandBuffer::BindStructuredBuffer(uint32_t slot, uint64_t handle)
+	{
+		BindStructuredBufferCommand& command = Emplace<BindStructuredBufferCommand>();
+		command.Slot = slot;
+		command.Handle = handle;
+	}
+
+	void CommandBuffer::BindShaderResource(uint32_t slot, uint64_t address)
+	{
+		BindShaderResourceCommand& command = Emplace<BindShaderResourceCommand>();
+		command.Slot = slot;
+		command.Handle = address;
+	}
+
+	void CommandBuffer::BindTexture(uint32_t slot, const Ref<Texture2D>& texture)
+	{
+		BindTextureCommand& command = Emplace<BindTextureCommand>();
+		command.Slot = slot;
+		command.Texture = texture.get();
+	}
+
+	void CommandBuffer::SetConstant(uint32_t slot, uint32_t value)
+	{
+		SetConstantCommand& command = Emplace<SetConstantCommand>();
+		command.Slot = slot;
+		command.Value = value;
+	}
+
+	void CommandBuffer::DrawIndexed(const Ref<MeshBuffer>& meshBuffer)
+	{
+		Emplace<DrawIndexedCommand>().Mesh = meshBuffer.get();
+		++m_DrawCount;
+	}
+
+	void CommandBuffer::DrawIndexedInstanced(const Ref<MeshBuffer>& meshBuffer, uint32_t instanceCount, uint32_t startInstance)
+	{
+		DrawIndexedInstancedCommand& command = Emplace<DrawIndexedInstancedCommand>();
+		command.Mesh = meshBuffer.get();
+		command.InstanceCount = instanceCount;
+		command.StartInstance = startInstance;
+		++m_DrawCount;
+	}
+
+	void CommandBuffer::BeginShadowMap(const Ref<ShadowMap>& shadowMap)
+	{
+		BeginShadowMapCommand& command = Emplace<BeginShadowMapCommand>();
+		command.Map = shadowMap.get();
+		command.Cascade = 0;
+	}
+
+	void CommandBuffer::SetShadowCascade(const Ref<ShadowMap>& shadowMap, uint32_t cascade)
+	{
+		SetShadowCascadeCommand& command = Emplace<SetShadowCascadeCommand>();
+		command.Map = shadowMap.get();
+		command.Cascade = cascade;
+	}
+
+	void CommandBuffer::EndShadowMap(const Ref<ShadowMap>& shadowMap)
+	{
+		EndShadowMapCommand& command = Emplace<EndShadowMapCommand>();
+		command.Map = shadowMap.get();
+		command.Cascade = 0;
+	}
+
+	void CommandBuffer::BindShadowMap(uint32_t slot, const Ref<ShadowMap>& shadowMap)
+	{
+		BindShadowMapCommand& command = Emplace<BindShadowMapCommand>();
+		command.Slot = slot;
+		command.Map = shadowMap.get();
+	}
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <EASTL/vector.h>
+
+#include "Illumino/Core/Core.h"
+
+namespace IlluminoEngine
+{
+	class Shader;
+	class Texture2D;
+	class MeshBuffer;
+	class ShadowMap;
+
+	enum class CommandType : uint8_t
+	{
+		ClearColor,
+		BindPipeline,
+		BindConstantBuffer,
+		BindStructuredBuffer,
+		BindShaderResource,
+		BindTexture,
+		SetConstant,
+		DrawIndexed,
+		DrawIndexedInstanced,
+		BeginShadowMap,
+		SetShadowCascade,
+		EndShadowMap,
+		BindShadowMap
+	};
+
+	// Every packet starts with a header, Size is the distance to the next packet in bytes
+	struct alignas(8) CommandHeader
+	{
+		CommandType Type;
+		uint16_t Size;
+	};
+
+	struct ClearColorCommand : CommandHeader
+	{
+		static constexpr CommandType k_Type = CommandType::ClearColor;
+		glm::vec4 Color;
+	};
+
+	struct BindPipelineCommand : CommandHeader
+	{
+		static constexpr CommandType k_Type = CommandType::BindPipeline;
+		Shader* PipelineShader;
+	};
+
+	// Shared by the buffer binds, Handle is a GPU address or a descriptor handle like in the Shader::Bind* functions
+	struct BindBufferCommand : CommandHeader
+	{
+		uint32_t Slot;
+		uint64_t Handle;
+	};
+
+	struct BindConstantBufferCommand : BindBufferCommand
+	{
+		static constexpr CommandType k_Type = CommandType::BindConstantBuffer;
+	};
+
+	struct BindStructuredBufferCommand : BindBufferCommand
+	{
+		static constexpr CommandType k_Type = CommandType::BindStructuredBuffer;
+	};
+
+	struct BindShaderResourceCommand : BindBufferCommand
+	{
+		static constexpr CommandType k_Type = CommandType::BindShaderResource;
+	};
+
+	struct BindTextureCommand : CommandHeader
+	{
+		static constexpr CommandType k_Type = CommandType::BindTexture;
+		uint32_t Slot;
+		Texture2D* Texture;
+	};
+
+	struct SetConstantCommand : CommandHeader
+	{
+		static constexpr CommandType k_Type = CommandType::SetConstant;
+		uint32_t Slot;
+		uint32_t Value;
+	};
+
+	struct DrawIndexedCommand : CommandHeader
+	{
+		static constexpr CommandType k_Type = CommandType::DrawIndexed;
+		MeshBuffer* Mesh;
+	};
+
+	struct DrawIndexedInstancedCommand : CommandHeader
+	{
+		static constexpr CommandType k_Type = CommandType::DrawIndexedInstanced;
+		MeshBuffer* Mesh;
+		uint32_t InstanceCount;
+		uint32_t StartInstance;
+	};
+
+	// Shared by the shadow map commands, Cascade is only read by SetShadowCascade
+	struct ShadowMapCommand : CommandHeader
+	{
+		ShadowMap* Map;
+		uint32_t Cascade;
+	};
+
+	struct BeginShadowMapCommand : ShadowMapCommand
+	{
+		static constexpr CommandType k_Type = CommandType::BeginShadowMap;
+	};
+
+	struct SetShadowCascadeCommand : ShadowMapCommand
+	{
+		static constexpr CommandType k_Type = CommandType::SetShadowCascade;
+	};
+
+	struct EndShadowMapCommand : ShadowMapCommand
+	{
+		static constexpr CommandType k_Type = CommandType::EndShadowMap;
+	};
+
+	struct BindShadowMapCommand : CommandHeader
+	{
+		static constexpr CommandType k_Type = CommandType::BindShadowMap;
+		uint32_t Slot;
+		ShadowMap* Map;
+	};
+
+	// Records rendering commands as plain packets in linear memory, the backend translates them when the
+	// buffer is submitted with RenderCommand::Submit. Command buffers don't share any state, so several can be
+	// recorded on different threads at once. Shaders, textures and meshes are referenced by raw pointer and
+	// have to stay alive until the buffer was submitted. Bindings are not inherited from previously submitted
+	// buffers, every buffer binds its own pipeline and resources.
+	class CommandBuffer
+	{
+	public:
+		// Keeps the memory for the next recording
+		void Reset();
+
+		void ClearColor(const glm::vec4& color);
+		void BindPipeline(const Ref<Shader>& shader);
+		void BindConstantBuffer(uint32_t slot, uint64_t handle);
+		void BindStructuredBuffer(uint32_t slot, uint64_t handle);
+		void BindShaderResource(uint32_t slot, uint64_t address);
+		void BindTexture(uint32_t slot, const Ref<Texture2D>& texture);
+		void SetConstant(uint32_t slot, uint32_t value);
+		void DrawIndexed(const Ref<MeshBuffer>& meshBuffer);
+		void DrawIndexedInstanced(const Ref<MeshBuffer>& meshBuffer, uint32_t instanceCount, uint32_t startInstance = 0);
+
+		// Draws between BeginShadowMap and EndShadowMap only write the shadow map's depth, SetShadowCascade picks the tile
+		void BeginShadowMap(const Ref<ShadowMap>& shadowMap);
+		void SetShadowCascade(const Ref<ShadowMap>& shadowMap, uint32_t cascade);
+		void EndShadowMap(const Ref<ShadowMap>& shadowMap);
+		void BindShadowMap(uint32_t slot, const Ref<ShadowMap>& shadowMap);
+
+		// Walks the packets in recording order, fn gets a const CommandHeader& to cast by its Type
+		template<typename Fn>
+		void ForEach(Fn fn) const
+		{
+			const uint8_t* data = (const uint8_t*)m_Data.data();
+			const uint8_t* end = data + m_Size;
+			while (data < end)
+			{
+				const CommandHeader& header = *(const CommandHeader*)data;
+				fn(header);
+				data += header.Size;
+			}
+		}
+
+		bool IsEmpty() const { return m_CommandCount == 0; }
+		uint32_t GetCommandCount() const { return m_CommandCount; }
+		size_t GetSize() const { return m_Size; }
+		uint32_t GetDrawCount() const { return m_DrawCount; }
+
+	private:
+		template<typename T>
+		T& Emplace()
+		{
+			static_assert(sizeof(T) % sizeof(uint64_t) == 0, "Packets have to keep the next one 8 byte aligned");
+
+			const size_t offset = m_Size;
+			m_Size += sizeof(T);
+			if (m_Size > m_Data.size() * sizeof(uint64_t))
+				m_Data.resize(eastl::max(m_Data.size() * 2, m_Size / sizeof(uint64_t)));
+
+			T& command = *(T*)((uint8_t*)m_Data.data() + offset);
+			command.Type = T::k_Type;
+			command.Size = (uint16_t)sizeof(T);
+			++m_CommandCount;
+			return command;
+		}
+
+	private:
+		// 64 bit words keep the packets aligned for their pointers and handles
+		eastl::vector<uint64_t> m_Data;
+		size_t m_Size = 0;
+		uint32_t m_CommandCount = 0;
+		uint32_t m_DrawCount = 0;
+	};
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstring>
+
+#include "Illumino/Core/Core.h"
+
+namespace IlluminoEngine
+{
+	// 64 bit draw sort key, most significant bits first:
+	//   opaque:      pass:2 | pipeline:6 | material:16 | mesh:16 | depth:24
+	//   transparent: pass:2 | ~depth:24  | pipeline:6 | material:16 | mesh:16
+	// Opaque draws group by state and go front to back inside a group, transparent draws go back to front.
+	// Adjacent draws with the same batch bits can be drawn as one instanced draw.
+	class DrawKey
+	{
+	public:
+		enum class Pass : uint8_t
+		{
+			Opaque = 0,
+			Transparent = 1
+		};
+
+		inline static uint64_t Encode(Pass pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float viewDepth)
+		{
+			const uint64_t state = ((uint64_t)(pipeline & 0x3F) << 32) | ((uint64_t)(material & 0xFFFF) << 16) | (mesh & 0xFFFF);
+			const uint64_t depth = QuantizeDepth(viewDepth);
+
+			uint64_t key = (uint64_t)pass << 62;
+			if (pass == Pass::Transparent)
+				key |= ((~depth & 0xFFFFFF) << 38) | state;
+			else
+				key |= (state << 24) | depth;
+
+			return key;
+		}
+
+		inline static Pass GetPass(uint64_t key) { return (Pass)(key >> 62); }
+
+		// Pass and state without the depth
+		inline static uint64_t GetBatch(uint64_t key)
+		{
+			if (GetPass(key) == Pass::Transparent)
+				return (key & (3ull << 62)) | (key & 0x3FFFFFFFFF);
+
+			return key >> 24;
+		}
+
+	private:
+		// Positive floats order the same as their bit patterns, the top 24 bits keep the exponent and 15 mantissa bits
+		inline static uint32_t QuantizeDepth(float viewDepth)
+		{
+			const float depth = viewDepth > 0.0f ? viewDepth : 0.0f;
+			uint32_t bits;
+			memcpy(&bits, &depth, sizeof(float));
+			return bits >> 8;
+		}
+	};
+}
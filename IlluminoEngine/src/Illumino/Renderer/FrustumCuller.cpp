@@ -0,0 +1,125 @@
+#include "ipch.h"
+#include "FrustumCuller.h"
+
+#include <xmmintrin.h>
+
+namespace IlluminoEngine
+{
+	void FrustumCuller::Begin(const glm::mat4& viewProjection, size_t capacity)
+	{
+		OPTICK_EVENT();
+
+		m_Frustum = Frustum(viewProjection);
+		m_Count = 0;
+		m_VisibleCount = 0;
+
+		m_CenterX.clear();
+		m_CenterY.clear();
+		m_CenterZ.clear();
+		m_ExtentX.clear();
+		m_ExtentY.clear();
+		m_ExtentZ.clear();
+
+		// Padded to whole SSE lanes
+		const size_t paddedCapacity = (capacity + 3) & ~size_t(3);
+		m_CenterX.reserve(paddedCapacity);
+		m_CenterY.reserve(paddedCapacity);
+		m_CenterZ.reserve(paddedCapacity);
+		m_ExtentX.reserve(paddedCapacity);
+		m_ExtentY.reserve(paddedCapacity);
+		m_ExtentZ.reserve(paddedCapacity);
+	}
+
+	uint32_t FrustumCuller::Add(const AABB& localBounds, const glm::mat4& transform)
+	{
+		const AABB worldBounds = Math::TransformAABB(localBounds, transform);
+		const glm::vec3 center = worldBounds.GetCenter();
+		const glm::vec3 extents = worldBounds.GetExtents();
+
+		m_CenterX.push_back(center.x);
+		m_CenterY.push_back(center.y);
+		m_CenterZ.push_back(center.z);
+		m_ExtentX.push_back(extents.x);
+		m_ExtentY.push_back(extents.y);
+		m_ExtentZ.push_back(extents.z);
+
+		return m_Count++;
+	}
+
+	void FrustumCuller::Cull(eastl::vector<uint8_t>& outVisible)
+	{
+		OPTICK_EVENT();
+
+		const size_t paddedCount = (m_Count + 3) & ~3u;
+		m_CenterX.resize(paddedCount, 0.0f);
+		m_CenterY.resize(paddedCount, 0.0f);
+		m_CenterZ.resize(paddedCount, 0.0f);
+		m_ExtentX.resize(paddedCount, 0.0f);
+		m_ExtentY.resize(paddedCount, 0.0f);
+		m_ExtentZ.resize(paddedCount, 0.0f);
+
+		m_VisibleCount = Cull(m_Frustum, outVisible);
+	}
+
+	uint32_t FrustumCuller::Cull(const Frustum& frustum, eastl::vector<uint8_t>& outVisible) const
+	{
+		OPTICK_EVENT();
+
+		const size_t paddedCount = (m_Count + 3) & ~3u;
+		ILLUMINO_ASSERT(m_CenterX.size() >= paddedCount, "Bounds are padded by Cull(outVisible), call it first!");
+
+		outVisible.resize(m_Count);
+		uint32_t visibleCount = 0;
+
+		__m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+		__m128 absPlaneX[6], absPlaneY[6], absPlaneZ[6];
+		for (uint32_t p = 0; p < 6; ++p)
+		{
+			const glm::vec4& plane = frustum.Planes[p];
+			planeX[p] = _mm_set1_ps(plane.x);
+			planeY[p] = _mm_set1_ps(plane.y);
+			planeZ[p] = _mm_set1_ps(plane.z);
+			planeW[p] = _mm_set1_ps(plane.w);
+			absPlaneX[p] = _mm_set1_ps(glm::abs(plane.x));
+			absPlaneY[p] = _mm_set1_ps(glm::abs(plane.y));
+			absPlaneZ[p] = _mm_set1_ps(glm::abs(plane.z));
+		}
+
+		const __m128 zero = _mm_setzero_ps();
+		for (size_t i = 0; i < paddedCount; i += 4)
+		{
+			const __m128 centerX = _mm_loadu_ps(m_CenterX.data() + i);
+			const __m128 centerY = _mm_loadu_ps(m_CenterY.data() + i);
+			const __m128 centerZ = _mm_loadu_ps(m_CenterZ.data() + i);
+			const __m128 extentX = _mm_loadu_ps(m_ExtentX.data() + i);
+			const __m128 extentY = _mm_loadu_ps(m_ExtentY.data() + i);
+			const __m128 extentZ = _mm_loadu_ps(m_ExtentZ.data() + i);
+
+			// A box is outside when it is fully behind any plane: dot(n, c) + w + dot(|n|, e) < 0
+			__m128 outside = zero;
+			for (uint32_t p = 0; p < 6; ++p)
+			{
+				__m128 distance = _mm_add_ps(_mm_mul_ps(planeX[p], centerX), planeW[p]);
+				distance = _mm_add_ps(distance, _mm_mul_ps(planeY[p], centerY));
+				distance = _mm_add_ps(distance, _mm_mul_ps(planeZ[p], centerZ));
+
+				__m128 radius = _mm_mul_ps(absPlaneX[p], extentX);
+				radius = _mm_add_ps(radius, _mm_mul_ps(absPlaneY[p], extentY));
+				radius = _mm_add_ps(radius, _mm_mul_ps(absPlaneZ[p], extentZ));
+
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+			}
+
+			const int outsideMask = _mm_movemask_ps(outside);
+			const size_t laneCount = std::min<size_t>(4, m_Count - i);
+			for (size_t lane = 0; lane < laneCount; ++lane)
+			{
+				const uint8_t visible = (outsideMask & (1 << lane)) ? 0 : 1;
+				outVisible[i + lane] = visible;
+				visibleCount += visible;
+			}
+		}
+
+		return visibleCount;
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Illumino/Math/BoundingVolume.h"
+
+namespace IlluminoEngine
+{
+	// Tests world space bounds against the frustum planes four at a time.
+	// Bounds are kept as structure of arrays so each SSE lane holds a different object.
+	class FrustumCuller
+	{
+	public:
+		void Begin(const glm::mat4& viewProjection, size_t capacity = 0);
+		// Transforms the local bounds into world space, returns the index of the object
+		uint32_t Add(const AABB& localBounds, const glm::mat4& transform);
+		// Writes 1 for visible and 0 for culled objects, in the order they were added
+		void Cull(eastl::vector<uint8_t>& outVisible);
+		// Tests the bounds added for the last Cull() against another frustum, like a shadow cascade's.
+		// Only reads the bounds, so several frusta can be tested on different threads at once
+		uint32_t Cull(const Frustum& frustum, eastl::vector<uint8_t>& outVisible) const;
+
+		const Frustum& GetFrustum() const { return m_Frustum; }
+		uint32_t GetCount() const { return m_Count; }
+		uint32_t GetVisibleCount() const { return m_VisibleCount; }
+		uint32_t GetCulledCount() const { return m_Count - m_VisibleCount; }
+
+	private:
+		Frustum m_Frustum;
+		uint32_t m_Count = 0;
+		uint32_t m_VisibleCount = 0;
+
+		eastl::vector<float> m_CenterX;
+		eastl::vector<float> m_CenterY;
+		eastl::vector<float> m_CenterZ;
+		eastl::vector<float> m_ExtentX;
+		eastl::vector<float> m_ExtentY;
+		eastl::vector<float> m_ExtentZ;
+	};
+}
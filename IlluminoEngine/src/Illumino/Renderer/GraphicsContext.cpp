@@ -2,7 +2,10 @@
 #include "GraphicsContext.h"
 
 #include "RendererAPI.h"
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 #include "Platform/D3D12/Dx12GraphicsContext.h"
+#endif
+#include "Platform/Null/NullGraphicsContext.h"
 
 namespace IlluminoEngine
 {
@@ -12,7 +15,10 @@ namespace IlluminoEngine
 		{
 		case RendererAPI::API::None:	ILLUMINO_ASSERT(false, "RendererAPI::None is currently not supported");
 										return nullptr;
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 		case RendererAPI::API::DX12:	return CreateScope<Dx12GraphicsContext>(window);
+#endif
+		case RendererAPI::API::Null:	return CreateScope<NullGraphicsContext>(window);
 		}
 
 		ILLUMINO_ASSERT(false, "Unknown GraphicsContext");
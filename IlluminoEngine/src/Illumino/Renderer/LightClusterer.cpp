@@ -0,0 +1,292 @@
+#include "ipch.h"
+#include "LightClusterer.h"
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <xmmintrin.h>
+
+#include "Illumino/Core/JobSystem.h"
+
+namespace IlluminoEngine
+{
+	static_assert(LightClusterer::TilesX % 4 == 0, "Rows are tested a whole SSE register at a time");
+	static_assert(LightClusterer::TilesX * LightClusterer::TilesY <= 256, "Cluster within a slice has to fit in 8 bits");
+
+	static float GetMilliseconds(std::chrono::high_resolution_clock::time_point start)
+	{
+		return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	void LightClusterer::Begin(const glm::mat4& view, const glm::mat4& projection, size_t capacity)
+	{
+		OPTICK_EVENT();
+
+		m_View = view;
+		m_Projection = projection;
+		m_Lights.clear();
+		m_Lights.reserve(capacity);
+	}
+
+	uint32_t LightClusterer::Add(const glm::vec3& position, float radius)
+	{
+		m_Lights.push_back({ position, radius });
+		return (uint32_t)m_Lights.size() - 1;
+	}
+
+	void LightClusterer::Build()
+	{
+		OPTICK_EVENT();
+
+		m_Timings = {};
+
+		// Cluster bounds only depend on the projection
+		if (m_Projection != m_ClusterProjection)
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+			BuildClusters();
+			m_ClusterProjection = m_Projection;
+			m_Timings.BuildClusters = GetMilliseconds(start);
+		}
+
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+			TransformLights();
+			m_Timings.TransformLights = GetMilliseconds(start);
+		}
+
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+			JobCounter counter;
+			JobSystem::Dispatch(Slices, 1, [this](uint32_t start, uint32_t end)
+			{
+				for (uint32_t slice = start; slice < end; ++slice)
+					AssignSlice(slice);
+			}, counter);
+			JobSystem::Wait(counter);
+			m_Timings.AssignLights = GetMilliseconds(start);
+		}
+
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+
+			uint32_t sliceOffsets[Slices];
+			uint32_t total = 0;
+			for (uint32_t slice = 0; slice < Slices; ++slice)
+			{
+				sliceOffsets[slice] = total;
+				total += (uint32_t)m_SliceData[slice].Indices.size();
+			}
+
+			m_Grid.resize(ClusterCount);
+			m_LightIndices.resize(total);
+
+			JobCounter counter;
+			JobSystem::Dispatch(Slices, 4, [this, &sliceOffsets](uint32_t start, uint32_t end)
+			{
+				for (uint32_t slice = start; slice < end; ++slice)
+					CompactSlice(slice, sliceOffsets[slice]);
+			}, counter);
+			JobSystem::Wait(counter);
+			m_Timings.Compact = GetMilliseconds(start);
+		}
+	}
+
+	void LightClusterer::BuildClusters()
+	{
+		OPTICK_EVENT();
+
+		const glm::mat4 inverseProjection = glm::inverse(m_Projection);
+		auto unproject = [&inverseProjection](float x, float y, float z)
+		{
+			const glm::vec4 point = inverseProjection * glm::vec4(x, y, z, 1.0f);
+			return glm::vec3(point) / point.w;
+		};
+
+		// NDC depth 0 is the near plane for [0, 1] depth and a bit behind it for [-1, 1], close enough
+		// for the slicing since the first slice reaches down to the camera anyway
+		const glm::vec3 nearCenter = unproject(0.0f, 0.0f, 0.0f);
+		const glm::vec3 farCenter = unproject(0.0f, 0.0f, 1.0f);
+		m_ForwardSign = farCenter.z < 0.0f ? -1.0f : 1.0f;
+		m_Near = glm::max(nearCenter.z * m_ForwardSign, 0.0001f);
+		m_Far = farCenter.z * m_ForwardSign;
+		if (!std::isfinite(m_Far) || m_Far <= m_Near)
+			m_Far = m_Near * 100000.0f;
+
+		const float logRatio = glm::log(m_Far / m_Near);
+		m_DepthScale = Slices / logRatio;
+		m_DepthBias = -(Slices * glm::log(m_Near)) / logRatio;
+
+		for (uint32_t slice = 0; slice <= Slices; ++slice)
+			m_SliceDepths[slice] = m_Near * glm::pow(m_Far / m_Near, (float)slice / Slices);
+		m_SliceDepths[0] = 0.0f;
+
+		// View space directions through the tile corners, scaled to a depth of one
+		glm::vec3 corners[(TilesX + 1) * (TilesY + 1)];
+		for (uint32_t y = 0; y <= TilesY; ++y)
+		{
+			for (uint32_t x = 0; x <= TilesX; ++x)
+			{
+				const glm::vec3 point = unproject(-1.0f + 2.0f * x / TilesX, -1.0f + 2.0f * y / TilesY, 1.0f);
+				corners[y * (TilesX + 1) + x] = point / (point.z * m_ForwardSign);
+			}
+		}
+
+		m_MinX.resize(ClusterCount);
+		m_MinY.resize(ClusterCount);
+		m_MinZ.resize(ClusterCount);
+		m_MaxX.resize(ClusterCount);
+		m_MaxY.resize(ClusterCount);
+		m_MaxZ.resize(ClusterCount);
+		m_RowBounds.resize(Slices * TilesY);
+		m_SliceBounds.resize(Slices);
+
+		for (uint32_t slice = 0; slice < Slices; ++slice)
+		{
+			const float nearDepth = m_SliceDepths[slice];
+			const float farDepth = m_SliceDepths[slice + 1];
+			AABB& sliceBounds = m_SliceBounds[slice];
+			sliceBounds = { glm::vec3(std::numeric_limits<float>::max()), glm::vec3(-std::numeric_limits<float>::max()) };
+
+			for (uint32_t y = 0; y < TilesY; ++y)
+			{
+				AABB& row = m_RowBounds[slice * TilesY + y];
+				row = { glm::vec3(std::numeric_limits<float>::max()), glm::vec3(-std::numeric_limits<float>::max()) };
+
+				for (uint32_t x = 0; x < TilesX; ++x)
+				{
+					const glm::vec3 directions[4] =
+					{
+						corners[y * (TilesX + 1) + x],
+						corners[y * (TilesX + 1) + x + 1],
+						corners[(y + 1) * (TilesX + 1) + x],
+						corners[(y + 1) * (TilesX + 1) + x + 1]
+					};
+
+					glm::vec3 min = directions[0] * nearDepth;
+					glm::vec3 max = min;
+					for (const glm::vec3& direction : directions)
+					{
+						min = glm::min(min, glm::min(direction * nearDepth, direction * farDepth));
+						max = glm::max(max, glm::max(direction * nearDepth, direction * farDepth));
+					}
+
+					const uint32_t index = (slice * TilesY + y) * TilesX + x;
+					m_MinX[index] = min.x;
+					m_MinY[index] = min.y;
+					m_MinZ[index] = min.z;
+					m_MaxX[index] = max.x;
+					m_MaxY[index] = max.y;
+					m_MaxZ[index] = max.z;
+
+					row.Min = glm::min(row.Min, min);
+					row.Max = glm::max(row.Max, max);
+				}
+
+				sliceBounds.Min = glm::min(sliceBounds.Min, row.Min);
+				sliceBounds.Max = glm::max(sliceBounds.Max, row.Max);
+			}
+		}
+	}
+
+	void LightClusterer::TransformLights()
+	{
+		OPTICK_EVENT();
+
+		m_ViewLights.resize(m_Lights.size());
+		for (size_t i = 0; i < m_Lights.size(); ++i)
+		{
+			const BoundingSphere& light = m_Lights[i];
+			m_ViewLights[i] = glm::vec4(glm::vec3(m_View * glm::vec4(light.Center, 1.0f)), light.Radius);
+		}
+	}
+
+	void LightClusterer::AssignSlice(uint32_t slice)
+	{
+		OPTICK_EVENT();
+
+		SliceData& data = m_SliceData[slice];
+		data.Candidates.clear();
+		data.Pairs.clear();
+
+		const AABB& sliceBounds = m_SliceBounds[slice];
+		for (uint32_t i = 0; i < (uint32_t)m_ViewLights.size(); ++i)
+		{
+			const glm::vec4& light = m_ViewLights[i];
+			const glm::vec3 center = glm::vec3(light);
+			const glm::vec3 delta = glm::clamp(center, sliceBounds.Min, sliceBounds.Max) - center;
+			if (glm::dot(delta, delta) <= light.w * light.w)
+				data.Candidates.push_back(i);
+		}
+
+		const __m128 zero = _mm_setzero_ps();
+		for (uint32_t y = 0; y < TilesY; ++y)
+		{
+			const AABB& row = m_RowBounds[slice * TilesY + y];
+			const uint32_t rowStart = (slice * TilesY + y) * TilesX;
+
+			for (uint32_t lightIndex : data.Candidates)
+			{
+				const glm::vec4& light = m_ViewLights[lightIndex];
+				const glm::vec3 center = glm::vec3(light);
+				const glm::vec3 closest = glm::clamp(center, row.Min, row.Max);
+				const glm::vec3 delta = closest - center;
+				if (glm::dot(delta, delta) > light.w * light.w)
+					continue;
+
+				const __m128 centerX = _mm_set1_ps(light.x);
+				const __m128 centerY = _mm_set1_ps(light.y);
+				const __m128 centerZ = _mm_set1_ps(light.z);
+				const __m128 radius2 = _mm_set1_ps(light.w * light.w);
+
+				for (uint32_t x = 0; x < TilesX; x += 4)
+				{
+					const uint32_t index = rowStart + x;
+
+					// Distance from the sphere center to the box along each axis, zero inside
+					const __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&m_MinX[index]), centerX), _mm_sub_ps(centerX, _mm_loadu_ps(&m_MaxX[index]))), zero);
+					const __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&m_MinY[index]), centerY), _mm_sub_ps(centerY, _mm_loadu_ps(&m_MaxY[index]))), zero);
+					const __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&m_MinZ[index]), centerZ), _mm_sub_ps(centerZ, _mm_loadu_ps(&m_MaxZ[index]))), zero);
+					const __m128 distance2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+					const int mask = _mm_movemask_ps(_mm_cmple_ps(distance2, radius2));
+					if (!mask)
+						continue;
+
+					for (uint32_t lane = 0; lane < 4; ++lane)
+					{
+						if (mask & (1 << lane))
+							data.Pairs.push_back((y * TilesX + x + lane) | (lightIndex << 8));
+					}
+				}
+			}
+		}
+
+		// Counting sort by cluster, lights stay in ascending order within a cluster
+		constexpr uint32_t clustersPerSlice = TilesX * TilesY;
+		memset(data.Offsets, 0, sizeof(data.Offsets));
+		for (uint32_t pair : data.Pairs)
+			++data.Offsets[(pair & 0xFF) + 1];
+		for (uint32_t i = 1; i <= clustersPerSlice; ++i)
+			data.Offsets[i] += data.Offsets[i - 1];
+
+		uint32_t cursors[clustersPerSlice];
+		memcpy(cursors, data.Offsets, sizeof(cursors));
+		data.Indices.resize(data.Pairs.size());
+		for (uint32_t pair : data.Pairs)
+			data.Indices[cursors[pair & 0xFF]++] = pair >> 8;
+	}
+
+	void LightClusterer::CompactSlice(uint32_t slice, uint32_t offset)
+	{
+		OPTICK_EVENT();
+
+		const SliceData& data = m_SliceData[slice];
+		constexpr uint32_t clustersPerSlice = TilesX * TilesY;
+		for (uint32_t i = 0; i < clustersPerSlice; ++i)
+			m_Grid[slice * clustersPerSlice + i] = { offset + data.Offsets[i], data.Offsets[i + 1] - data.Offsets[i] };
+
+		if (!data.Indices.empty())
+			memcpy(m_LightIndices.data() + offset, data.Indices.data(), data.Indices.size() * sizeof(uint32_t));
+	}
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <EASTL/vector.h>
+
+#include "Illumino/Math/BoundingVolume.h"
+
+namespace IlluminoEngine
+{
+	// Range of a cluster in the light index list, matches the uint2 grid entries in the shader
+	struct ClusterRange
+	{
+		uint32_t Offset = 0;
+		uint32_t Count = 0;
+	};
+
+	// Milliseconds spent in each stage of the last Build()
+	struct LightClusterTimings
+	{
+		float BuildClusters = 0.0f;
+		float TransformLights = 0.0f;
+		float AssignLights = 0.0f;
+		float Compact = 0.0f;
+	};
+
+	// Splits the view frustum into screen tiles and exponential depth slices and assigns point lights
+	// to the clusters their sphere touches. Every depth slice is a job, the spheres are tested against
+	// the view space cluster bounds four clusters at a time.
+	class LightClusterer
+	{
+	public:
+		static constexpr uint32_t TilesX = 16;
+		static constexpr uint32_t TilesY = 9;
+		static constexpr uint32_t Slices = 24;
+		static constexpr uint32_t ClusterCount = TilesX * TilesY * Slices;
+
+		void Begin(const glm::mat4& view, const glm::mat4& projection, size_t capacity = 0);
+		// World space sphere, returns the index the light lists refer to
+		uint32_t Add(const glm::vec3& position, float radius);
+		void Build();
+
+		// Cluster (x, y, slice) is at (slice * TilesY + y) * TilesX + x, x and y go along NDC x and y
+		const eastl::vector<ClusterRange>& GetGrid() const { return m_Grid; }
+		const eastl::vector<uint32_t>& GetLightIndices() const { return m_LightIndices; }
+
+		// slice = log(viewDepth) * scale + bias
+		float GetDepthScale() const { return m_DepthScale; }
+		float GetDepthBias() const { return m_DepthBias; }
+
+		uint32_t GetLightCount() const { return (uint32_t)m_Lights.size(); }
+		const LightClusterTimings& GetTimings() const { return m_Timings; }
+
+	private:
+		struct SliceData
+		{
+			eastl::vector<uint32_t> Candidates;
+			// Cluster within the slice in the low 8 bits, light index above
+			eastl::vector<uint32_t> Pairs;
+			eastl::vector<uint32_t> Indices;
+			uint32_t Offsets[TilesX * TilesY + 1];
+		};
+
+		void BuildClusters();
+		void TransformLights();
+		void AssignSlice(uint32_t slice);
+		void CompactSlice(uint32_t slice, uint32_t offset);
+
+	private:
+		glm::mat4 m_View = glm::mat4(1.0f);
+		glm::mat4 m_Projection = glm::mat4(0.0f);
+		glm::mat4 m_ClusterProjection = glm::mat4(0.0f);
+		// +1 if view space depth grows along +z, -1 for right handed views looking down -z
+		float m_ForwardSign = -1.0f;
+		float m_Near = 0.1f;
+		float m_Far = 1000.0f;
+		float m_DepthScale = 0.0f;
+		float m_DepthBias = 0.0f;
+
+		eastl::vector<BoundingSphere> m_Lights;
+		eastl::vector<glm::vec4> m_ViewLights;
+
+		// View space cluster bounds as structure of arrays, rows of TilesX clusters
+		eastl::vector<float> m_MinX;
+		eastl::vector<float> m_MinY;
+		eastl::vector<float> m_MinZ;
+		eastl::vector<float> m_MaxX;
+		eastl::vector<float> m_MaxY;
+		eastl::vector<float> m_MaxZ;
+		eastl::vector<AABB> m_RowBounds;
+		eastl::vector<AABB> m_SliceBounds;
+		float m_SliceDepths[Slices + 1];
+
+		SliceData m_SliceData[Slices];
+		eastl::vector<ClusterRange> m_Grid;
+		eastl::vector<uint32_t> m_LightIndices;
+		LightClusterTimings m_Timings;
+	};
+}
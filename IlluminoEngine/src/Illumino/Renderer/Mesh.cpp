@@ -4,123 +4,104 @@
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
+#include <filesystem>
 #include <glm/glm.hpp>
+#include <stb_image.h>
 
 #include "Illumino/Utils/StringUtils.h"
 
 namespace IlluminoEngine
 {
-	Mesh::Mesh(const char* filepath)
+	static eastl::string GetTexturePath(aiMaterial *mat, aiTextureType type, unsigned int index, const char* filepath)
 	{
-		OPTICK_EVENT();
+		eastl::string path = eastl::string(filepath);
+		eastl::string dir = path.substr(0, path.find_last_of("\\"));
 
-		Load(filepath);
+		aiString str;
+		mat->GetTexture(type, index, &str);
+		return dir + '\\' + str.C_Str();
 	}
 
-	void Mesh::Load(const char* filepath)
+	// Decodes the first map of the type into the source's images, maps shared by several submeshes are decoded once.
+	// Returns the index of the image or -1
+	static int32_t LoadMaterialImage(aiMaterial *mat, aiTextureType type, const char* filepath, MeshSource& source)
 	{
 		OPTICK_EVENT();
 
-		Assimp::Importer importer;
-		importer.SetPropertyFloat("PP_GSN_MAX_SMOOTHING_ANGLE", 80.0f);
+		if (mat->GetTextureCount(type) == 0)
+			return -1;
 
-		uint32_t meshImportFlags = aiProcess_MakeLeftHanded
-			| aiProcess_FlipUVs;
-		
-		if (StringUtils::GetExtension(filepath) != "assbin")
+		const eastl::string path = GetTexturePath(mat, type, 0, filepath);
+		for (size_t i = 0; i < source.Images.size(); ++i)
 		{
-			meshImportFlags |=
-				aiProcess_CalcTangentSpace |
-				aiProcess_Triangulate |
-				aiProcess_PreTransformVertices |
-				aiProcess_SortByPType |
-				aiProcess_GenNormals |
-				aiProcess_GenUVCoords |
-				aiProcess_OptimizeMeshes |
-				aiProcess_JoinIdenticalVertices |
-				aiProcess_GlobalScale |
-				aiProcess_ImproveCacheLocality |
-				aiProcess_ValidateDataStructure;
+			if (source.Images[i].Filepath == path)
+				return (int32_t)i;
 		}
 
-		const aiScene *scene = importer.ReadFile(filepath, meshImportFlags);
-
-		if (!scene)
+		int width, height, channels;
+		stbi_uc* data = nullptr;
 		{
-			ILLUMINO_ERROR("Could not import the file: {0}. Error: {1}", filepath, importer.GetErrorString());
-			return;
-		}
+			OPTICK_EVENT("stbi_load Texture");
 
-		ProcessNode(scene->mRootNode, scene, filepath);
-		m_Name = StringUtils::GetName(filepath);
-	}
+			data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+		}
 
-	Submesh& Mesh::GetSubmesh(uint32_t index)
-	{
-		OPTICK_EVENT();
+		if (!data)
+		{
+			ILLUMINO_ERROR("Failed to load image: {0}", path.c_str());
+			return -1;
+		}
 
-		ILLUMINO_ASSERT(index < m_Submeshes.size(), "Submesh index out of bounds");
+		ImageSource& image = source.Images.push_back();
+		image.Filepath = path;
+		image.Width = (uint32_t)width;
+		image.Height = (uint32_t)height;
+		image.Channels = (uint32_t)channels;
+		image.Pixels.assign(data, data + (size_t)width * height * 4);
+		stbi_image_free(data);
 
-		return m_Submeshes[index];
+		return (int32_t)source.Images.size() - 1;
 	}
 
-	void Mesh::ProcessNode(aiNode *node, const aiScene *scene, const char* filepath)
+	// Materials with an opacity below one are blended. Every albedo alpha used to be alpha tested, so maps with
+	// an alpha channel are imported as Masked to keep cutouts working
+	static BlendMode GetBlendMode(aiMaterial *mat, const ImageSource* albedo, float& opacity)
 	{
 		OPTICK_EVENT();
 
-		for(unsigned int i = 0; i < node->mNumMeshes; i++)
-		{
-			aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
-			ProcessMesh(mesh, scene, filepath, node->mName.C_Str());
-		}
+		if (mat->Get(AI_MATKEY_OPACITY, opacity) == AI_SUCCESS && opacity < 1.0f)
+			return BlendMode::Transparent;
 
-		for(unsigned int i = 0; i < node->mNumChildren; i++)
-		{
-			ProcessNode(node->mChildren[i], scene, filepath);
-		}
-	}
+		opacity = 1.0f;
+		if (albedo && albedo->Channels == 4)
+			return BlendMode::Masked;
 
-	eastl::vector<Ref<Texture2D>> LoadMaterialTextures(aiMaterial *mat, aiTextureType type, const char* filepath)
-	{
-		OPTICK_EVENT();
-
-		eastl::string path = eastl::string(filepath);
-		eastl::string dir = path.substr(0, path.find_last_of("\\"));
-		eastl::vector<Ref<Texture2D>> textures;
-		for(unsigned int i = 0; i < mat->GetTextureCount(type); i++)
-		{
-			aiString str;
-			mat->GetTexture(type, i, &str);
-			eastl::string path = dir + '\\' + str.C_Str();
-			Ref<Texture2D> texture = Texture2D::Create(path.c_str());
-			textures.push_back(texture);
-		}
-		return textures;
+		return BlendMode::Opaque;
 	}
 
-	void Mesh::ProcessMesh(aiMesh *mesh, const aiScene *scene, const char* filepath, const char* nodeName)
+	static void ProcessMesh(aiMesh *mesh, const aiScene *scene, const char* filepath, const char* nodeName, bool loadMaterials, MeshSource& source)
 	{
 		OPTICK_EVENT();
 
-		struct Vertex
-		{
-			glm::vec3 Position;
-			glm::vec3 Normal;
-			glm::vec3 Tangent;
-			glm::vec3 Bitangent;
-			glm::vec2 UV = glm::vec2(0.0);
-		};
+		SubmeshSource& submesh = source.Submeshes.push_back();
+		submesh.Name = nodeName;
 
-		eastl::vector<Vertex> vertices;
-		eastl::vector<uint32_t> indices;
+		eastl::vector<MeshVertex>& vertices = submesh.Vertices;
+		eastl::vector<uint32_t>& indices = submesh.Indices;
+		AABB& bounds = submesh.Bounds;
+		if (mesh->mNumVertices > 0)
+			bounds.Min = bounds.Max = glm::vec3(mesh->mVertices[0].x, mesh->mVertices[0].y, mesh->mVertices[0].z);
 
+		vertices.reserve(mesh->mNumVertices);
 		for (size_t i = 0; i < mesh->mNumVertices; ++i)
 		{
-			Vertex v;
+			MeshVertex v;
 			auto& vertexPos = mesh->mVertices[i];
 			v.Position.x = vertexPos.x;
 			v.Position.y = vertexPos.y;
 			v.Position.z = vertexPos.z;
+			bounds.Min = glm::min(bounds.Min, v.Position);
+			bounds.Max = glm::max(bounds.Max, v.Position);
 
 			auto& normal = mesh->mNormals[i];
 			v.Normal.x = normal.x;
@@ -191,20 +172,254 @@ namespace IlluminoEngine
 			}
 		}
 
-		Ref<MeshBuffer> meshBuffer = MeshBuffer::Create((float*)&vertices[0], &indices[0], vertices.size() * sizeof(Vertex), indices.size() * sizeof(uint32_t), sizeof(Vertex));
+		if (loadMaterials)
+		{
+			aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+			submesh.AlbedoImage = LoadMaterialImage(material, aiTextureType_DIFFUSE, filepath, source);
+			submesh.NormalImage = LoadMaterialImage(material, aiTextureType_NORMALS, filepath, source);
+			if (submesh.NormalImage < 0)
+				submesh.NormalImage = LoadMaterialImage(material, aiTextureType_HEIGHT, filepath, source);
+
+			const ImageSource* albedo = submesh.AlbedoImage >= 0 ? &source.Images[submesh.AlbedoImage] : nullptr;
+			submesh.Blend = GetBlendMode(material, albedo, submesh.Opacity);
+		}
+
+		// Centered on the box but fitted to the vertices, which is tighter than the box diagonal
+		submesh.Sphere = { bounds.GetCenter(), 0.0f };
+		for (const MeshVertex& vertex : vertices)
+			submesh.Sphere.Radius = glm::max(submesh.Sphere.Radius, glm::distance(submesh.Sphere.Center, vertex.Position));
+	}
+
+	static void ProcessNode(aiNode *node, const aiScene *scene, const char* filepath, bool loadMaterials, MeshSource& source)
+	{
+		OPTICK_EVENT();
+
+		for(unsigned int i = 0; i < node->mNumMeshes; i++)
+		{
+			aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
+			ProcessMesh(mesh, scene, filepath, node->mName.C_Str(), loadMaterials, source);
+		}
+
+		for(unsigned int i = 0; i < node->mNumChildren; i++)
+		{
+			ProcessNode(node->mChildren[i], scene, filepath, loadMaterials, source);
+		}
+	}
+
+	// LOD files share the materials of the source, they are imported without them
+	static bool ImportFile(const char* filepath, bool loadMaterials, MeshSource& source)
+	{
+		OPTICK_EVENT();
+
+		Assimp::Importer importer;
+		importer.SetPropertyFloat("PP_GSN_MAX_SMOOTHING_ANGLE", 80.0f);
+
+		uint32_t meshImportFlags = aiProcess_MakeLeftHanded
+			| aiProcess_FlipUVs;
+		
+		if (StringUtils::GetExtension(filepath) != "assbin")
+		{
+			meshImportFlags |=
+				aiProcess_CalcTangentSpace |
+				aiProcess_Triangulate |
+				aiProcess_PreTransformVertices |
+				aiProcess_SortByPType |
+				aiProcess_GenNormals |
+				aiProcess_GenUVCoords |
+				aiProcess_OptimizeMeshes |
+				aiProcess_JoinIdenticalVertices |
+				aiProcess_GlobalScale |
+				aiProcess_ImproveCacheLocality |
+				aiProcess_ValidateDataStructure;
+		}
+
+		const aiScene *scene = importer.ReadFile(filepath, meshImportFlags);
+
+		if (!scene)
+		{
+			ILLUMINO_ERROR("Could not import the file: {0}. Error: {1}", filepath, importer.GetErrorString());
+			return false;
+		}
+
+		ProcessNode(scene->mRootNode, scene, filepath, loadMaterials, source);
+		return true;
+	}
+
+	// Without simplifier metadata the error is estimated as the level's average edge length,
+	// detail smaller than its triangles can't be represented
+	static float EstimateLODError(const eastl::vector<MeshVertex>& vertices, const eastl::vector<uint32_t>& indices)
+	{
+		const uint32_t indexCount = (uint32_t)indices.size();
+		if (indexCount < 3)
+			return 0.0f;
+
+		double edgeLength = 0.0;
+		for (uint32_t i = 0; i + 2 < indexCount; i += 3)
+		{
+			const glm::vec3& a = vertices[indices[i]].Position;
+			const glm::vec3& b = vertices[indices[i + 1]].Position;
+			const glm::vec3& c = vertices[indices[i + 2]].Position;
+			edgeLength += glm::distance(a, b) + glm::distance(b, c) + glm::distance(c, a);
+		}
+
+		return (float)(edgeLength / indexCount);
+	}
+
+	// Coarser levels are separate files next to the source, model_LOD1.fbx, model_LOD2.fbx and so on.
+	// The submeshes of a level belong to the source's submeshes with the same index
+	static void ImportLODs(const char* filepath, MeshSource& source)
+	{
+		OPTICK_EVENT();
+
+		const eastl::string path = filepath;
+		const size_t lastDot = path.rfind('.');
+		if (lastDot == eastl::string::npos)
+			return;
+
+		const eastl::string stem = path.substr(0, lastDot);
+		const eastl::string extension = path.substr(lastDot);
+		for (uint32_t level = 1; level < Submesh::MaxLODs; ++level)
+		{
+			const eastl::string lodPath(eastl::string::CtorSprintf(), "%s_LOD%u%s", stem.c_str(), level, extension.c_str());
+			if (!std::filesystem::exists(lodPath.c_str()))
+				break;
+
+			MeshSource lod;
+			if (!ImportFile(lodPath.c_str(), false, lod))
+				break;
+
+			if (lod.Submeshes.size() != source.Submeshes.size())
+			{
+				ILLUMINO_WARN("{0} has {1} submeshes but {2} has {3}, ignoring it and the levels after it", lodPath.c_str(),
+					lod.Submeshes.size(), filepath, source.Submeshes.size());
+				break;
+			}
+
+			for (size_t i = 0; i < source.Submeshes.size(); ++i)
+			{
+				SubmeshSource& submesh = source.Submeshes[i];
+				SubmeshSource& lodSubmesh = lod.Submeshes[i];
+				const float previousError = submesh.LODs.empty() ? 0.0f : submesh.LODs.back().Error;
+				const float error = glm::max(EstimateLODError(lodSubmesh.Vertices, lodSubmesh.Indices), previousError);
+				submesh.LODs.push_back({ eastl::move(lodSubmesh.Vertices), eastl::move(lodSubmesh.Indices), error });
+			}
+		}
+	}
+
+	bool MeshSource::Import(const char* filepath)
+	{
+		OPTICK_EVENT();
+
+		Filepath = filepath;
+		Submeshes.clear();
+		Images.clear();
 
-        aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-        eastl::vector<Ref<Texture2D>> diffuseMaps = LoadMaterialTextures(material, aiTextureType_DIFFUSE, filepath);
-		eastl::vector<Ref<Texture2D>> normalMaps = LoadMaterialTextures(material, aiTextureType_NORMALS, filepath);
-		eastl::vector<Ref<Texture2D>> heightMaps = LoadMaterialTextures(material, aiTextureType_HEIGHT, filepath);
-		//eastl::vector<Ref<Texture2D>> emissiveMaps = LoadMaterialTextures(material, aiTextureType_EMISSIVE, filepath);
+		if (!ImportFile(filepath, true, *this))
+			return false;
 
-		Ref<Texture2D> albedo = diffuseMaps.size() > 0 ? diffuseMaps[0] : nullptr;
-		Ref<Texture2D> normal = normalMaps.size() > 0 ? normalMaps[0] : nullptr;
-		if (!normal)
-			normal = heightMaps.size() > 0 ? heightMaps[0] : nullptr;
+		ImportLODs(filepath, *this);
+		return true;
+	}
+
+	Mesh::Mesh(const char* filepath, bool occluderGeometry)
+	{
+		OPTICK_EVENT();
+
+		Load(filepath, occluderGeometry);
+	}
 
-		uint32_t index = m_Submeshes.size();
-		m_Submeshes.push_back({ nodeName, meshBuffer, albedo, normal });
+	Mesh::Mesh(const MeshSource& source, bool occluderGeometry)
+	{
+		OPTICK_EVENT();
+
+		Load(source, occluderGeometry);
+	}
+
+	void Mesh::Load(const char* filepath, bool occluderGeometry)
+	{
+		OPTICK_EVENT();
+
+		MeshSource source;
+		if (source.Import(filepath))
+			Load(source, occluderGeometry);
+	}
+
+	static void CopyOccluderGeometry(const SubmeshSource& source, Submesh& submesh)
+	{
+		submesh.Positions.clear();
+		submesh.Positions.reserve(source.Vertices.size());
+		for (const MeshVertex& vertex : source.Vertices)
+			submesh.Positions.push_back(vertex.Position);
+		submesh.Indices = source.Indices;
+	}
+
+	static Ref<MeshBuffer> CreateGeometry(const eastl::vector<MeshVertex>& vertices, const eastl::vector<uint32_t>& indices)
+	{
+		return MeshBuffer::Create((float*)vertices.data(), (uint32_t*)indices.data(), vertices.size() * sizeof(MeshVertex), indices.size() * sizeof(uint32_t), sizeof(MeshVertex));
+	}
+
+	void Mesh::Load(const MeshSource& source, bool occluderGeometry)
+	{
+		OPTICK_EVENT();
+
+		m_Name = StringUtils::GetName(source.Filepath.c_str());
+		m_Filepath = source.Filepath;
+		m_OccluderGeometry = occluderGeometry;
+
+		eastl::vector<Ref<Texture2D>> textures;
+		textures.reserve(source.Images.size());
+		for (const ImageSource& image : source.Images)
+			textures.push_back(Texture2D::Create(image.Width, image.Height, (void*)image.Pixels.data()));
+
+		m_Submeshes.clear();
+		m_Submeshes.reserve(source.Submeshes.size());
+		for (const SubmeshSource& submeshSource : source.Submeshes)
+		{
+			Submesh& submesh = m_Submeshes.push_back();
+			submesh.Name = submeshSource.Name;
+			submesh.Geometry = CreateGeometry(submeshSource.Vertices, submeshSource.Indices);
+			submesh.Albedo = submeshSource.AlbedoImage >= 0 ? textures[submeshSource.AlbedoImage] : nullptr;
+			submesh.Normal = submeshSource.NormalImage >= 0 ? textures[submeshSource.NormalImage] : nullptr;
+			submesh.Blend = submeshSource.Blend;
+			submesh.Opacity = submeshSource.Opacity;
+			submesh.Bounds = submeshSource.Bounds;
+			submesh.Sphere = submeshSource.Sphere;
+
+			if (occluderGeometry)
+				CopyOccluderGeometry(submeshSource, submesh);
+
+			for (const SubmeshLODSource& lod : submeshSource.LODs)
+				submesh.LODs.push_back({ CreateGeometry(lod.Vertices, lod.Indices), lod.Error });
+		}
+	}
+
+	void Mesh::LoadOccluderGeometry()
+	{
+		OPTICK_EVENT();
+
+		if (m_OccluderGeometry)
+			return;
+
+		m_OccluderGeometry = true;
+
+		// Geometry only, the materials were already created from the first import
+		MeshSource source;
+		if (m_Filepath.empty() || !ImportFile(m_Filepath.c_str(), false, source) || source.Submeshes.size() != m_Submeshes.size())
+		{
+			ILLUMINO_WARN("Could not load the occluder geometry of mesh {0}", m_Name.c_str());
+			return;
+		}
+
+		for (uint32_t i = 0; i < m_Submeshes.size(); ++i)
+			CopyOccluderGeometry(source.Submeshes[i], m_Submeshes[i]);
+	}
+
+	Submesh& Mesh::GetSubmesh(uint32_t index)
+	{
+		OPTICK_EVENT();
+
+		ILLUMINO_ASSERT(index < m_Submeshes.size(), "Submesh index out of bounds");
+
+		return m_Submeshes[index];
 	}
 }
@@ -5,41 +5,138 @@
 
 #include "Buffer.h"
 #include "Texture.h"
-
-struct aiScene;
-struct aiNode;
-struct aiMesh;
+#include "Illumino/Math/BoundingVolume.h"
 
 namespace IlluminoEngine
 {
+	// How a submesh's surface covers what is behind it, every mode is drawn in its own queue and pipeline
+	enum class BlendMode : uint8_t
+	{
+		// Writes every covered pixel, no blending
+		Opaque = 0,
+		// Pixels whose albedo alpha is below the AlphaCutoff are discarded, the rest is written like Opaque
+		Masked,
+		// Blended over the scene by the albedo alpha, drawn back to front after everything else without writing depth
+		Transparent,
+
+		Count
+	};
+
+	// Coarser version of a submesh's geometry
+	struct SubmeshLOD
+	{
+		Ref<MeshBuffer> Geometry;
+		// Local space size of the detail this level no longer represents
+		float Error = 0.0f;
+	};
+
 	struct Submesh
 	{
+		static constexpr uint32_t MaxLODs = 8;
+
 		eastl::string Name;
 		Ref<MeshBuffer> Geometry;
 		Ref<Texture2D> Albedo;
 		Ref<Texture2D> Normal;
 		float Metalness = 0.0f;
 		float Roughness = 1.0f;
+		BlendMode Blend = BlendMode::Opaque;
+		// Only used by BlendMode::Masked
+		float AlphaCutoff = 0.5f;
+		// Only used by BlendMode::Transparent, multiplies the albedo alpha
+		float Opacity = 1.0f;
+		// Entry of the scalar parameters in the renderer's material buffer, assigned on first submission
+		uint32_t MaterialIndex = ~0u;
+		// Local space bounds, computed at import
+		AABB Bounds;
+		BoundingSphere Sphere;
+		// CPU copy of the triangles, only kept for meshes used as occluders, see Mesh::LoadOccluderGeometry
+		eastl::vector<glm::vec3> Positions;
+		eastl::vector<uint32_t> Indices;
+		// Levels after Geometry, their error grows with the level
+		eastl::vector<SubmeshLOD> LODs;
+	};
+
+	struct MeshVertex
+	{
+		glm::vec3 Position;
+		glm::vec3 Normal;
+		glm::vec3 Tangent;
+		glm::vec3 Bitangent;
+		glm::vec2 UV = glm::vec2(0.0f);
+	};
+
+	// Decoded pixels of a material map, always RGBA8
+	struct ImageSource
+	{
+		eastl::string Filepath;
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		// Channels stored in the file
+		uint32_t Channels = 0;
+		eastl::vector<uint8_t> Pixels;
+	};
+
+	struct SubmeshLODSource
+	{
+		eastl::vector<MeshVertex> Vertices;
+		eastl::vector<uint32_t> Indices;
+		float Error = 0.0f;
+	};
+
+	struct SubmeshSource
+	{
+		eastl::string Name;
+		eastl::vector<MeshVertex> Vertices;
+		eastl::vector<uint32_t> Indices;
+		AABB Bounds;
+		BoundingSphere Sphere;
+		BlendMode Blend = BlendMode::Opaque;
+		float Opacity = 1.0f;
+		// Indices into MeshSource::Images, -1 when the material has no such map
+		int32_t AlbedoImage = -1;
+		int32_t NormalImage = -1;
+		eastl::vector<SubmeshLODSource> LODs;
+	};
+
+	// A mesh file imported into system memory, textures included. Importing only reads and decodes files,
+	// so it is safe on any thread. GPU resources are created from it by the Mesh constructor on the main thread.
+	struct MeshSource
+	{
+		eastl::string Filepath;
+		eastl::vector<SubmeshSource> Submeshes;
+		eastl::vector<ImageSource> Images;
+
+		// Returns false if the file could not be imported
+		bool Import(const char* filepath);
 	};
 
 	class Mesh
 	{
 	public:
-		Mesh(const char* filepath);
+		// Imports the file and creates its resources, main thread only. occluderGeometry keeps a CPU copy of
+		// the triangles for the occlusion culler
+		Mesh(const char* filepath, bool occluderGeometry = false);
+		// Main thread only, the source can be imported anywhere
+		Mesh(const MeshSource& source, bool occluderGeometry = false);
 		virtual ~Mesh() = default;
 
-		void Load(const char* filepath);
+		void Load(const char* filepath, bool occluderGeometry = false);
+		void Load(const MeshSource& source, bool occluderGeometry = false);
+		// Reads the triangles from the file again for a mesh that was loaded without them and is now used as an occluder
+		void LoadOccluderGeometry();
+		// Also true once loading them was attempted and failed, so it isn't retried every frame
+		bool HasOccluderGeometry() const { return m_OccluderGeometry; }
 
 		Submesh& GetSubmesh(uint32_t index);
 		const uint32_t GetSubmeshCount() const { return m_Submeshes.size(); }
 		const char* GetName() const { return m_Name.c_str(); }
-
-	private:
-		void ProcessNode(aiNode *node, const aiScene *scene, const char* filepath);
-		void ProcessMesh(aiMesh *mesh, const aiScene *scene, const char* filepath, const char* nodeName);
+		const char* GetFilepath() const { return m_Filepath.c_str(); }
 
 	private:
 		eastl::string m_Name;
+		eastl::string m_Filepath;
 		eastl::vector<Submesh> m_Submeshes;
+		bool m_OccluderGeometry = false;
 	};
 }
@@ -0,0 +1,552 @@
+#include "ipch.h"
+#include "OcclusionCuller.h"
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <xmmintrin.h>
+#include <EASTL/sort.h>
+
+#include "Illumino/Core/JobSystem.h"
+
+namespace IlluminoEngine
+{
+	static_assert(OcclusionCuller::TileWidth % OcclusionCuller::BlockSize == 0 && OcclusionCuller::TileHeight % OcclusionCuller::BlockSize == 0, "Blocks must not straddle tiles");
+	static_assert(OcclusionCuller::BlockSize % 4 == 0, "Rows are rasterized a whole SSE register at a time");
+
+	// Triangles are clipped to a band twice the size of the screen so the edge functions keep their precision
+	constexpr static float k_GuardBand = 2.0f;
+	constexpr static uint32_t k_MaxBinGroups = 16;
+	constexpr static uint32_t k_MinTrianglesPerBinGroup = 1024;
+	// Occluders test against their own surface, the bias keeps them from hiding themselves through rounding
+	constexpr static float k_OccludeeDepthBias = 1.001f;
+	constexpr static uint32_t k_MaxClippedVertices = 8;
+	// Outcode bits of the near plane and the guard band, see GetOutcode()
+	constexpr static uint32_t k_ClipPlaneMask = 0x1F;
+	// Triangles drawn into a tile between updates of its farthest depth
+	constexpr static uint32_t k_TileDepthInterval = 32;
+
+	static float GetMilliseconds(std::chrono::high_resolution_clock::time_point start)
+	{
+		return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	// Signed distance to the clip planes, the near plane followed by the guard band sides
+	static float GetPlaneDistance(const glm::vec4& clip, uint32_t plane, float nearW)
+	{
+		switch (plane)
+		{
+			case 0: return clip.w - nearW;
+			case 1: return k_GuardBand * clip.w - clip.x;
+			case 2: return k_GuardBand * clip.w + clip.x;
+			case 3: return k_GuardBand * clip.w - clip.y;
+			default: return k_GuardBand * clip.w + clip.y;
+		}
+	}
+
+	// Matrix columns in registers, transforming a point is then four multiply adds
+	struct SSEMatrix
+	{
+		__m128 Columns[4];
+
+		SSEMatrix(const glm::mat4& matrix)
+		{
+			for (uint32_t i = 0; i < 4; ++i)
+				Columns[i] = _mm_setr_ps(matrix[i].x, matrix[i].y, matrix[i].z, matrix[i].w);
+		}
+
+		glm::vec4 Transform(const glm::vec3& point) const
+		{
+			const __m128 result = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(Columns[0], _mm_set1_ps(point.x)), _mm_mul_ps(Columns[1], _mm_set1_ps(point.y))),
+				_mm_add_ps(_mm_mul_ps(Columns[2], _mm_set1_ps(point.z)), Columns[3]));
+
+			glm::vec4 transformed;
+			_mm_storeu_ps(&transformed.x, result);
+			return transformed;
+		}
+	};
+
+	// Bits of the clip planes a point is outside of, the screen edge bits only count in front of the near plane
+	static uint32_t GetOutcode(const glm::vec4& clip, float nearW)
+	{
+		uint32_t outcode = 0;
+		outcode |= (clip.w < nearW) << 0;
+		outcode |= (k_GuardBand * clip.w < clip.x) << 1;
+		outcode |= (k_GuardBand * clip.w < -clip.x) << 2;
+		outcode |= (k_GuardBand * clip.w < clip.y) << 3;
+		outcode |= (k_GuardBand * clip.w < -clip.y) << 4;
+		if (!(outcode & 1))
+		{
+			outcode |= (clip.w < clip.x) << 5;
+			outcode |= (clip.w < -clip.x) << 6;
+			outcode |= (clip.w < clip.y) << 7;
+			outcode |= (clip.w < -clip.y) << 8;
+		}
+		return outcode;
+	}
+
+	static glm::vec3 ToScreen(const glm::vec4& clip)
+	{
+		const float inverseW = 1.0f / clip.w;
+		return
+		{
+			(clip.x * inverseW * 0.5f + 0.5f) * OcclusionCuller::Width,
+			(0.5f - clip.y * inverseW * 0.5f) * OcclusionCuller::Height,
+			inverseW
+		};
+	}
+
+	void OcclusionCuller::Begin(const glm::mat4& view, const glm::mat4& projection, size_t capacity)
+	{
+		OPTICK_EVENT();
+
+		m_ViewProjection = projection * view;
+
+		// NDC depth 0 is the near plane for [0, 1] depth and a bit beyond it for [-1, 1]
+		glm::vec4 nearPoint = glm::inverse(projection) * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+		nearPoint /= nearPoint.w;
+		m_NearW = (projection * nearPoint).w;
+		if (!std::isfinite(m_NearW) || m_NearW <= 0.0f)
+			m_NearW = 0.0001f;
+
+		m_Occluders.clear();
+		m_Occluders.reserve(capacity);
+		m_TriangleCount = 0;
+	}
+
+	void OcclusionCuller::AddOccluder(const glm::vec3* positions, const uint32_t* indices, uint32_t indexCount, const glm::mat4& transform)
+	{
+		if (indexCount < 3)
+			return;
+
+		m_Occluders.push_back({ positions, indices, indexCount / 3, 0, m_ViewProjection * transform });
+		m_TriangleCount += indexCount / 3;
+	}
+
+	void OcclusionCuller::Render()
+	{
+		OPTICK_EVENT();
+
+		m_Timings = {};
+		m_Depth.resize(Width * Height);
+		m_BlockDepth.resize(BlocksX * BlocksY);
+
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+
+			// Roughly front to back by the depth of their origin, so tiles fill up with close occluders first
+			eastl::sort(m_Occluders.begin(), m_Occluders.end(), [](const Occluder& a, const Occluder& b)
+			{
+				return a.ModelViewProjection[3].w < b.ModelViewProjection[3].w;
+			});
+
+			uint32_t triangleOffset = 0;
+			for (Occluder& occluder : m_Occluders)
+			{
+				occluder.TriangleOffset = triangleOffset;
+				triangleOffset += occluder.TriangleCount;
+			}
+
+			const uint32_t maxGroups = eastl::min(JobSystem::GetWorkerCount() + 1, k_MaxBinGroups);
+			m_ActiveBinGroups = eastl::min(maxGroups, (m_TriangleCount + k_MinTrianglesPerBinGroup - 1) / k_MinTrianglesPerBinGroup);
+			if (m_BinGroups.size() < m_ActiveBinGroups)
+				m_BinGroups.resize(m_ActiveBinGroups);
+
+			JobCounter counter;
+			JobSystem::Dispatch(m_ActiveBinGroups, 1, [this](uint32_t start, uint32_t end)
+			{
+				for (uint32_t group = start; group < end; ++group)
+				{
+					const uint32_t firstTriangle = (uint32_t)((uint64_t)m_TriangleCount * group / m_ActiveBinGroups);
+					const uint32_t lastTriangle = (uint32_t)((uint64_t)m_TriangleCount * (group + 1) / m_ActiveBinGroups);
+					BinTriangles(m_BinGroups[group], firstTriangle, lastTriangle);
+				}
+			}, counter);
+			JobSystem::Wait(counter);
+
+			m_RasterizedTriangleCount = 0;
+			for (uint32_t group = 0; group < m_ActiveBinGroups; ++group)
+				m_RasterizedTriangleCount += (uint32_t)m_BinGroups[group].Triangles.size();
+
+			m_Timings.Binning = GetMilliseconds(start);
+		}
+
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+
+			JobCounter counter;
+			JobSystem::Dispatch(TileCount, 1, [this](uint32_t start, uint32_t end)
+			{
+				for (uint32_t tile = start; tile < end; ++tile)
+					RasterizeTile(tile);
+			}, counter);
+			JobSystem::Wait(counter);
+
+			m_Timings.Rasterization = GetMilliseconds(start);
+		}
+	}
+
+	void OcclusionCuller::BinTriangles(BinGroup& group, uint32_t firstTriangle, uint32_t lastTriangle)
+	{
+		OPTICK_EVENT();
+
+		group.Triangles.clear();
+		for (eastl::vector<uint32_t>& bin : group.Bins)
+			bin.clear();
+
+		// Last occluder that starts at or before the first triangle
+		auto it = eastl::upper_bound(m_Occluders.begin(), m_Occluders.end(), firstTriangle, [](uint32_t triangle, const Occluder& occluder)
+		{
+			return triangle < occluder.TriangleOffset;
+		});
+		size_t occluderIndex = (it - m_Occluders.begin()) - 1;
+		SSEMatrix modelViewProjection(m_Occluders[occluderIndex].ModelViewProjection);
+
+		for (uint32_t triangle = firstTriangle; triangle < lastTriangle; ++triangle)
+		{
+			while (occluderIndex + 1 < m_Occluders.size() && m_Occluders[occluderIndex + 1].TriangleOffset <= triangle)
+				modelViewProjection = SSEMatrix(m_Occluders[++occluderIndex].ModelViewProjection);
+
+			const Occluder& occluder = m_Occluders[occluderIndex];
+			const uint32_t* indices = occluder.Indices + (triangle - occluder.TriangleOffset) * 3;
+
+			glm::vec4 clip[k_MaxClippedVertices];
+			for (uint32_t i = 0; i < 3; ++i)
+				clip[i] = modelViewProjection.Transform(occluder.Positions[indices[i]]);
+
+			// Triangles with all vertices outside one plane are rejected, the others are clipped against the planes they cross.
+			// The screen edges only reject, clipping is left to the guard band
+			uint32_t outcodes[3];
+			for (uint32_t i = 0; i < 3; ++i)
+				outcodes[i] = GetOutcode(clip[i], m_NearW);
+
+			if (outcodes[0] & outcodes[1] & outcodes[2])
+				continue;
+
+			const uint32_t clipPlanes = (outcodes[0] | outcodes[1] | outcodes[2]) & k_ClipPlaneMask;
+
+			uint32_t vertexCount = 3;
+			if (clipPlanes)
+			{
+				// Sutherland-Hodgman against each plane the triangle crosses
+				glm::vec4 clipped[k_MaxClippedVertices];
+				for (uint32_t plane = 0; plane < 5 && vertexCount >= 3; ++plane)
+				{
+					if (!(clipPlanes & (1 << plane)))
+						continue;
+
+					uint32_t clippedCount = 0;
+					for (uint32_t i = 0; i < vertexCount; ++i)
+					{
+						const glm::vec4& current = clip[i];
+						const glm::vec4& next = clip[(i + 1) % vertexCount];
+						const float currentDistance = GetPlaneDistance(current, plane, m_NearW);
+						const float nextDistance = GetPlaneDistance(next, plane, m_NearW);
+
+						if (currentDistance >= 0.0f)
+							clipped[clippedCount++] = current;
+						if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+							clipped[clippedCount++] = current + (next - current) * (currentDistance / (currentDistance - nextDistance));
+					}
+
+					vertexCount = clippedCount;
+					memcpy(clip, clipped, sizeof(glm::vec4) * vertexCount);
+				}
+			}
+
+			if (vertexCount < 3)
+				continue;
+
+			glm::vec3 screen[k_MaxClippedVertices];
+			for (uint32_t i = 0; i < vertexCount; ++i)
+				screen[i] = ToScreen(clip[i]);
+
+			for (uint32_t i = 2; i < vertexCount; ++i)
+			{
+				const glm::vec3 fan[3] = { screen[0], screen[i - 1], screen[i] };
+				SetupTriangle(group, fan);
+			}
+		}
+	}
+
+	void OcclusionCuller::SetupTriangle(BinGroup& group, const glm::vec3* screen)
+	{
+		const glm::vec3& v0 = screen[0];
+		const glm::vec3& v1 = screen[1];
+		const glm::vec3& v2 = screen[2];
+
+		const float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+		if (glm::abs(area) < 1e-6f)
+			return;
+
+		const float minX = glm::min(v0.x, glm::min(v1.x, v2.x));
+		const float maxX = glm::max(v0.x, glm::max(v1.x, v2.x));
+		const float minY = glm::min(v0.y, glm::min(v1.y, v2.y));
+		const float maxY = glm::max(v0.y, glm::max(v1.y, v2.y));
+
+		// Pixels whose centers can be inside the triangle
+		Triangle triangle;
+		triangle.MinX = eastl::max((int32_t)std::ceil(minX - 0.5f), 0);
+		triangle.MaxX = eastl::min((int32_t)std::floor(maxX - 0.5f), (int32_t)Width - 1);
+		triangle.MinY = eastl::max((int32_t)std::ceil(minY - 0.5f), 0);
+		triangle.MaxY = eastl::min((int32_t)std::floor(maxY - 0.5f), (int32_t)Height - 1);
+		if (triangle.MinX > triangle.MaxX || triangle.MinY > triangle.MaxY)
+			return;
+
+		// Both windings are drawn, flip the edges so the inside is always positive
+		const float sign = area > 0.0f ? 1.0f : -1.0f;
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			const glm::vec3& a = screen[i];
+			const glm::vec3& b = screen[(i + 1) % 3];
+			triangle.EdgeA[i] = (a.y - b.y) * sign;
+			triangle.EdgeB[i] = (b.x - a.x) * sign;
+			triangle.EdgeC[i] = (a.x * b.y - b.x * a.y) * sign;
+			triangle.InverseEdgeA[i] = triangle.EdgeA[i] != 0.0f ? 1.0f / triangle.EdgeA[i] : 0.0f;
+		}
+
+		// Reciprocal w is linear in screen space
+		triangle.MaxDepth = glm::max(v0.z, glm::max(v1.z, v2.z));
+
+		const float inverseArea = 1.0f / area;
+		triangle.DepthA = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) * inverseArea;
+		triangle.DepthB = ((v2.z - v0.z) * (v1.x - v0.x) - (v1.z - v0.z) * (v2.x - v0.x)) * inverseArea;
+		triangle.DepthC = v0.z - triangle.DepthA * v0.x - triangle.DepthB * v0.y;
+
+		const uint32_t index = (uint32_t)group.Triangles.size();
+		group.Triangles.push_back(triangle);
+
+		for (int32_t tileY = triangle.MinY / TileHeight; tileY <= triangle.MaxY / (int32_t)TileHeight; ++tileY)
+		{
+			for (int32_t tileX = triangle.MinX / TileWidth; tileX <= triangle.MaxX / (int32_t)TileWidth; ++tileX)
+				group.Bins[tileY * TilesX + tileX].push_back(index);
+		}
+	}
+
+	void OcclusionCuller::RasterizeTile(uint32_t tile)
+	{
+		OPTICK_EVENT();
+
+		const int32_t tileMinX = (tile % TilesX) * TileWidth;
+		const int32_t tileMinY = (tile / TilesX) * TileHeight;
+		const int32_t tileMaxX = tileMinX + TileWidth - 1;
+		const int32_t tileMaxY = tileMinY + TileHeight - 1;
+
+		for (int32_t y = tileMinY; y <= tileMaxY; ++y)
+			memset(&m_Depth[y * Width + tileMinX], 0, sizeof(float) * TileWidth);
+
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+		// Farthest depth in the tile, zero until every pixel is covered
+		float tileFarthest = 0.0f;
+		uint32_t drawnSinceUpdate = 0;
+
+		for (uint32_t groupIndex = 0; groupIndex < m_ActiveBinGroups; ++groupIndex)
+		{
+			const BinGroup& group = m_BinGroups[groupIndex];
+			for (uint32_t triangleIndex : group.Bins[tile])
+			{
+				const Triangle& triangle = group.Triangles[triangleIndex];
+				if (triangle.MaxDepth < tileFarthest)
+					continue;
+
+				if (++drawnSinceUpdate == k_TileDepthInterval)
+				{
+					__m128 farthest = _mm_loadu_ps(&m_Depth[tileMinY * Width + tileMinX]);
+					for (int32_t y = tileMinY; y <= tileMaxY; ++y)
+					{
+						for (int32_t x = tileMinX; x <= tileMaxX; x += 4)
+							farthest = _mm_min_ps(farthest, _mm_loadu_ps(&m_Depth[y * Width + x]));
+					}
+
+					farthest = _mm_min_ps(farthest, _mm_shuffle_ps(farthest, farthest, _MM_SHUFFLE(1, 0, 3, 2)));
+					farthest = _mm_min_ps(farthest, _mm_shuffle_ps(farthest, farthest, _MM_SHUFFLE(2, 3, 0, 1)));
+					tileFarthest = _mm_cvtss_f32(farthest);
+					drawnSinceUpdate = 0;
+				}
+
+				const int32_t startX = eastl::max(triangle.MinX, tileMinX);
+				const int32_t endX = eastl::min(triangle.MaxX, tileMaxX);
+				const int32_t startY = eastl::max(triangle.MinY, tileMinY);
+				const int32_t endY = eastl::min(triangle.MaxY, tileMaxY);
+
+				const __m128 edgeStep0 = _mm_set1_ps(triangle.EdgeA[0] * 4.0f);
+				const __m128 edgeStep1 = _mm_set1_ps(triangle.EdgeA[1] * 4.0f);
+				const __m128 edgeStep2 = _mm_set1_ps(triangle.EdgeA[2] * 4.0f);
+				const __m128 depthStep = _mm_set1_ps(triangle.DepthA * 4.0f);
+
+				// Edge values at x = 0 of the row, stepped down the rows
+				float rowEdges[3];
+				for (uint32_t i = 0; i < 3; ++i)
+					rowEdges[i] = triangle.EdgeB[i] * (startY + 0.5f) + triangle.EdgeC[i];
+				float rowDepth = triangle.DepthB * (startY + 0.5f) + triangle.DepthC;
+
+				for (int32_t y = startY; y <= endY; ++y)
+				{
+					// Each edge bounds the row on one side, where A * (x + 0.5) + rowEdge crosses zero
+					float spanMin = (float)startX;
+					float spanMax = (float)endX;
+					for (uint32_t i = 0; i < 3; ++i)
+					{
+						const float crossing = -rowEdges[i] * triangle.InverseEdgeA[i];
+						if (triangle.EdgeA[i] > 0.0f)
+							spanMin = glm::max(spanMin, crossing - 1.5f);
+						else if (triangle.EdgeA[i] < 0.0f)
+							spanMax = glm::min(spanMax, crossing + 0.5f);
+						else if (rowEdges[i] < 0.0f)
+							spanMax = -1.0f;
+					}
+
+					const float pixelRowEdges[3] = { rowEdges[0], rowEdges[1], rowEdges[2] };
+					const float pixelRowDepth = rowDepth;
+					for (uint32_t i = 0; i < 3; ++i)
+						rowEdges[i] += triangle.EdgeB[i];
+					rowDepth += triangle.DepthB;
+
+					if (spanMin > spanMax)
+						continue;
+
+					// Spans are widened by a pixel and start on a register boundary, the edge tests drop the pixels outside the triangle
+					const int32_t rowStartX = (int32_t)spanMin & ~3;
+					const int32_t rowEndX = (int32_t)spanMax;
+
+					const __m128 pixelX = _mm_add_ps(_mm_set1_ps((float)rowStartX), laneOffsets);
+					__m128 edge0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.EdgeA[0]), pixelX), _mm_set1_ps(pixelRowEdges[0]));
+					__m128 edge1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.EdgeA[1]), pixelX), _mm_set1_ps(pixelRowEdges[1]));
+					__m128 edge2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.EdgeA[2]), pixelX), _mm_set1_ps(pixelRowEdges[2]));
+					__m128 depth = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.DepthA), pixelX), _mm_set1_ps(pixelRowDepth));
+
+					float* row = &m_Depth[y * Width];
+					for (int32_t x = rowStartX; x <= rowEndX; x += 4)
+					{
+						const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_cmpge_ps(edge1, zero)), _mm_cmpge_ps(edge2, zero));
+						if (_mm_movemask_ps(inside))
+						{
+							const __m128 previous = _mm_loadu_ps(row + x);
+							const __m128 closest = _mm_max_ps(previous, depth);
+							_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, closest), _mm_andnot_ps(inside, previous)));
+						}
+
+						edge0 = _mm_add_ps(edge0, edgeStep0);
+						edge1 = _mm_add_ps(edge1, edgeStep1);
+						edge2 = _mm_add_ps(edge2, edgeStep2);
+						depth = _mm_add_ps(depth, depthStep);
+					}
+				}
+			}
+		}
+
+		// Farthest depth of every block in the tile
+		for (int32_t blockY = tileMinY; blockY <= tileMaxY; blockY += BlockSize)
+		{
+			for (int32_t blockX = tileMinX; blockX <= tileMaxX; blockX += BlockSize)
+			{
+				__m128 farthest = _mm_loadu_ps(&m_Depth[blockY * Width + blockX]);
+				for (uint32_t y = 0; y < BlockSize; ++y)
+				{
+					for (uint32_t x = 0; x < BlockSize; x += 4)
+						farthest = _mm_min_ps(farthest, _mm_loadu_ps(&m_Depth[(blockY + y) * Width + blockX + x]));
+				}
+
+				farthest = _mm_min_ps(farthest, _mm_shuffle_ps(farthest, farthest, _MM_SHUFFLE(1, 0, 3, 2)));
+				farthest = _mm_min_ps(farthest, _mm_shuffle_ps(farthest, farthest, _MM_SHUFFLE(2, 3, 0, 1)));
+				m_BlockDepth[(blockY / BlockSize) * BlocksX + blockX / BlockSize] = _mm_cvtss_f32(farthest);
+			}
+		}
+	}
+
+	bool OcclusionCuller::IsVisible(const AABB& localBounds, const glm::mat4& transform) const
+	{
+		if (m_Depth.empty())
+			return true;
+
+		const SSEMatrix modelViewProjection(m_ViewProjection * transform);
+
+		float minX = std::numeric_limits<float>::max();
+		float minY = std::numeric_limits<float>::max();
+		float maxX = -std::numeric_limits<float>::max();
+		float maxY = -std::numeric_limits<float>::max();
+		float closest = 0.0f;
+		for (uint32_t i = 0; i < 8; ++i)
+		{
+			const glm::vec3 corner = { i & 1 ? localBounds.Max.x : localBounds.Min.x, i & 2 ? localBounds.Max.y : localBounds.Min.y, i & 4 ? localBounds.Max.z : localBounds.Min.z };
+			const glm::vec4 clip = modelViewProjection.Transform(corner);
+
+			// Bounds reaching through the near plane cover the whole view
+			if (clip.w < m_NearW)
+				return true;
+
+			const glm::vec3 screen = ToScreen(clip);
+			minX = glm::min(minX, screen.x);
+			minY = glm::min(minY, screen.y);
+			maxX = glm::max(maxX, screen.x);
+			maxY = glm::max(maxY, screen.y);
+			closest = glm::max(closest, screen.z);
+		}
+
+		// Off screen bounds are the frustum culler's business
+		if (maxX < 0.0f || maxY < 0.0f || minX >= Width || minY >= Height)
+			return true;
+
+		const int32_t pixelMinX = (int32_t)glm::max(minX, 0.0f);
+		const int32_t pixelMinY = (int32_t)glm::max(minY, 0.0f);
+		const int32_t pixelMaxX = (int32_t)glm::min(maxX, Width - 1.0f);
+		const int32_t pixelMaxY = (int32_t)glm::min(maxY, Height - 1.0f);
+		const float occludeeDepth = closest * k_OccludeeDepthBias;
+
+		for (int32_t blockY = pixelMinY / BlockSize; blockY <= pixelMaxY / (int32_t)BlockSize; ++blockY)
+		{
+			for (int32_t blockX = pixelMinX / BlockSize; blockX <= pixelMaxX / (int32_t)BlockSize; ++blockX)
+			{
+				if (m_BlockDepth[blockY * BlocksX + blockX] > occludeeDepth)
+					continue;
+
+				// Part of the block is behind the bounds, check the pixels they actually cover
+				const int32_t startX = eastl::max(blockX * (int32_t)BlockSize, pixelMinX);
+				const int32_t endX = eastl::min((blockX + 1) * (int32_t)BlockSize - 1, pixelMaxX);
+				const int32_t startY = eastl::max(blockY * (int32_t)BlockSize, pixelMinY);
+				const int32_t endY = eastl::min((blockY + 1) * (int32_t)BlockSize - 1, pixelMaxY);
+				for (int32_t y = startY; y <= endY; ++y)
+				{
+					for (int32_t x = startX; x <= endX; ++x)
+					{
+						if (m_Depth[y * Width + x] <= occludeeDepth)
+							return true;
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+
+	bool OcclusionCuller::SaveDepthImage(const char* filepath) const
+	{
+		OPTICK_EVENT();
+
+		std::ofstream out(filepath, std::ios::out | std::ios::binary);
+		if (!out)
+		{
+			ILLUMINO_ERROR("Could not open {0} to write the occlusion depth", filepath);
+			return false;
+		}
+
+		float closest = 0.0f;
+		for (float depth : m_Depth)
+			closest = glm::max(closest, depth);
+
+		eastl::vector<uint8_t> pixels(Width * Height, 0);
+		if (closest > 0.0f && !m_Depth.empty())
+		{
+			for (uint32_t i = 0; i < Width * Height; ++i)
+				pixels[i] = (uint8_t)(m_Depth[i] / closest * 255.0f);
+		}
+
+		out << "P5\n" << Width << " " << Height << "\n255\n";
+		out.write((const char*)pixels.data(), pixels.size());
+		return true;
+	}
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <EASTL/vector.h>
+
+#include "Illumino/Math/BoundingVolume.h"
+
+namespace IlluminoEngine
+{
+	// Milliseconds spent in each stage of the last Render()
+	struct OcclusionTimings
+	{
+		float Binning = 0.0f;
+		float Rasterization = 0.0f;
+	};
+
+	// Software rasterizes occluder triangles into a small depth buffer on the CPU and tests occludee bounds
+	// against it. The screen is split into tiles, triangles are set up and binned to the tiles by one set of jobs
+	// and every tile is rasterized by its own job, four pixels at a time. Each tile also keeps the farthest depth
+	// of its blocks so most occludee tests never look at single pixels.
+	// Coverage is sampled at pixel centers like on the GPU, so gaps narrower than a pixel of the small buffer are closed.
+	// Depth is the reciprocal of clip space w, orthographic projections never cull anything.
+	class OcclusionCuller
+	{
+	public:
+		static constexpr uint32_t Width = 256;
+		static constexpr uint32_t Height = 128;
+		static constexpr uint32_t TileWidth = 32;
+		static constexpr uint32_t TileHeight = 32;
+		static constexpr uint32_t BlockSize = 8;
+		static constexpr uint32_t TilesX = Width / TileWidth;
+		static constexpr uint32_t TilesY = Height / TileHeight;
+		static constexpr uint32_t TileCount = TilesX * TilesY;
+		static constexpr uint32_t BlocksX = Width / BlockSize;
+		static constexpr uint32_t BlocksY = Height / BlockSize;
+
+		void Begin(const glm::mat4& view, const glm::mat4& projection, size_t capacity = 0);
+		// The triangles are read during Render(), they have to stay alive until then
+		void AddOccluder(const glm::vec3* positions, const uint32_t* indices, uint32_t indexCount, const glm::mat4& transform);
+		void Render();
+
+		// Thread safe once Render() returned. False only if every pixel the bounds cover is behind an occluder
+		bool IsVisible(const AABB& localBounds, const glm::mat4& transform) const;
+
+		// Writes the depth buffer as a binary PGM, brighter is closer
+		bool SaveDepthImage(const char* filepath) const;
+
+		uint32_t GetOccluderCount() const { return (uint32_t)m_Occluders.size(); }
+		uint32_t GetTriangleCount() const { return m_TriangleCount; }
+		uint32_t GetRasterizedTriangleCount() const { return m_RasterizedTriangleCount; }
+		const OcclusionTimings& GetTimings() const { return m_Timings; }
+
+	private:
+		struct Occluder
+		{
+			const glm::vec3* Positions;
+			const uint32_t* Indices;
+			uint32_t TriangleCount;
+			uint32_t TriangleOffset;
+			glm::mat4 ModelViewProjection;
+		};
+
+		// Screen space edge functions and depth plane of a triangle, evaluated at pixel centers
+		struct Triangle
+		{
+			float EdgeA[3];
+			float EdgeB[3];
+			float EdgeC[3];
+			float InverseEdgeA[3];
+			float DepthA;
+			float DepthB;
+			float DepthC;
+			// Closest vertex, a triangle behind everything already in a tile is skipped
+			float MaxDepth;
+			int32_t MinX;
+			int32_t MinY;
+			int32_t MaxX;
+			int32_t MaxY;
+		};
+
+		// Every binning job writes its own triangles and bins, tiles read all of them
+		struct BinGroup
+		{
+			eastl::vector<Triangle> Triangles;
+			eastl::vector<uint32_t> Bins[TileCount];
+		};
+
+		void BinTriangles(BinGroup& group, uint32_t firstTriangle, uint32_t lastTriangle);
+		void SetupTriangle(BinGroup& group, const glm::vec3* screen);
+		void RasterizeTile(uint32_t tile);
+
+	private:
+		glm::mat4 m_ViewProjection = glm::mat4(1.0f);
+		// Clip space w of the near plane, or slightly beyond it which keeps the culling conservative
+		float m_NearW = 0.1f;
+
+		eastl::vector<Occluder> m_Occluders;
+		uint32_t m_TriangleCount = 0;
+		uint32_t m_RasterizedTriangleCount = 0;
+		eastl::vector<BinGroup> m_BinGroups;
+		uint32_t m_ActiveBinGroups = 0;
+
+		// Reciprocal clip w per pixel, 0 where nothing was drawn. Larger is closer
+		eastl::vector<float> m_Depth;
+		// Smallest reciprocal w, the farthest depth, of every BlockSize x BlockSize block
+		eastl::vector<float> m_BlockDepth;
+		OcclusionTimings m_Timings;
+	};
+}
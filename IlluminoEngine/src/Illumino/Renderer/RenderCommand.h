@@ -28,6 +28,34 @@ namespace IlluminoEngine
 			s_RendererAPI->DrawIndexed(meshBuffer);
 		}
 
+		inline static void DrawIndexedInstanced(Ref<MeshBuffer>& meshBuffer, uint32_t instanceCount, uint32_t startInstance = 0)
+		{
+			s_RendererAPI->DrawIndexedInstanced(meshBuffer, instanceCount, startInstance);
+		}
+
+		inline static uint32_t GetFrameIndex()
+		{
+			return s_RendererAPI->GetFrameIndex();
+		}
+
+		// Constant buffers need 256 byte alignment, structured buffers their stride
+		inline static uint64_t UploadTransient(const void* data, size_t size, size_t alignment = 256)
+		{
+			return s_RendererAPI->UploadTransient(data, size, alignment);
+		}
+
+		inline static void Submit(const CommandBuffer& commandBuffer)
+		{
+			s_RendererAPI->Submit(commandBuffer);
+		}
+
+		// Buffers recorded in parallel are submitted in array order
+		inline static void Submit(const CommandBuffer* commandBuffers, uint32_t count)
+		{
+			for (uint32_t i = 0; i < count; ++i)
+				s_RendererAPI->Submit(commandBuffers[i]);
+		}
+
 	private:
 		friend class Dx12GraphicsContext;
 
@@ -0,0 +1,481 @@
+#include "ipch.h"
+#include "RenderGraph.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+#include <EASTL/sort.h>
+
+namespace IlluminoEngine
+{
+	static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	static void AppendFormat(eastl::string& out, const char* format, ...)
+	{
+		char buffer[512];
+		va_list args;
+		va_start(args, format);
+		vsnprintf(buffer, sizeof(buffer), format, args);
+		va_end(args);
+		out.append(buffer);
+	}
+
+	RenderGraphHandle RenderGraphBuilder::Read(RenderGraphHandle resource, RenderGraphState state)
+	{
+		return m_Graph.AddAccess(m_Pass, resource, state, false);
+	}
+
+	RenderGraphHandle RenderGraphBuilder::Write(RenderGraphHandle resource, RenderGraphState state)
+	{
+		return m_Graph.AddAccess(m_Pass, resource, state, true);
+	}
+
+	void RenderGraphBuilder::SetSideEffect()
+	{
+		m_Graph.m_Passes[m_Pass].SideEffect = true;
+	}
+
+	void RenderGraph::Reset()
+	{
+		OPTICK_EVENT();
+
+		m_Resources.clear();
+		m_Passes.clear();
+		m_Accesses.clear();
+		m_Dependencies.clear();
+		m_ExecutionOrder.clear();
+		m_Barriers.clear();
+		m_FinalBarrierOffset = 0;
+		m_Stats = {};
+		m_Compiled = false;
+	}
+
+	RenderGraphHandle RenderGraph::CreateTexture(const char* name, const RenderGraphTextureDesc& desc)
+	{
+		Resource& resource = m_Resources.push_back();
+		resource.Name = name;
+		resource.Desc = desc;
+		resource.Size = AlignUp((uint64_t)desc.Width * desc.Height * GetBytesPerPixel(desc.Format), PlacementAlignment);
+		return (RenderGraphHandle)m_Resources.size() - 1;
+	}
+
+	RenderGraphHandle RenderGraph::CreateBuffer(const char* name, uint64_t size)
+	{
+		Resource& resource = m_Resources.push_back();
+		resource.Name = name;
+		resource.Size = AlignUp(size, PlacementAlignment);
+		resource.IsTexture = false;
+		return (RenderGraphHandle)m_Resources.size() - 1;
+	}
+
+	RenderGraphHandle RenderGraph::ImportTexture(const char* name, RenderGraphState initialState, RenderGraphState finalState)
+	{
+		Resource& resource = m_Resources.push_back();
+		resource.Name = name;
+		resource.Imported = true;
+		resource.InitialState = initialState;
+		resource.FinalState = finalState;
+		return (RenderGraphHandle)m_Resources.size() - 1;
+	}
+
+	uint32_t RenderGraph::AddPass(const char* name, const SetupFn& setup, ExecuteFn execute)
+	{
+		OPTICK_EVENT();
+
+		ILLUMINO_ASSERT(!m_Compiled, "Passes can't be added to a compiled render graph");
+
+		const uint32_t index = (uint32_t)m_Passes.size();
+		Pass& pass = m_Passes.push_back();
+		pass.Name = name;
+		pass.Execute = eastl::move(execute);
+		pass.AccessOffset = (uint32_t)m_Accesses.size();
+		pass.DependencyOffset = (uint32_t)m_Dependencies.size();
+
+		RenderGraphBuilder builder(*this, index);
+		setup(builder);
+
+		Pass& added = m_Passes[index];
+		added.AccessCount = (uint32_t)m_Accesses.size() - added.AccessOffset;
+		added.DependencyCount = (uint32_t)m_Dependencies.size() - added.DependencyOffset;
+		return index;
+	}
+
+	RenderGraphHandle RenderGraph::AddAccess(uint32_t pass, RenderGraphHandle resource, RenderGraphState state, bool write)
+	{
+		ILLUMINO_ASSERT(resource < m_Resources.size(), "Invalid render graph resource");
+
+		Resource& res = m_Resources[resource];
+		ILLUMINO_ASSERT(write || res.Imported || res.LastWriter != ~0u, "Transient resource is read before any pass writes it");
+
+		// Reads and writes both have to wait for the previous writer, dependencies always point to earlier passes
+		if (res.LastWriter != ~0u && res.LastWriter != pass)
+		{
+			const Pass& p = m_Passes[pass];
+			bool known = false;
+			for (uint32_t i = p.DependencyOffset; i < (uint32_t)m_Dependencies.size(); ++i)
+				known |= m_Dependencies[i] == res.LastWriter;
+			if (!known)
+				m_Dependencies.push_back(res.LastWriter);
+		}
+
+		if (write)
+			res.LastWriter = pass;
+
+		m_Accesses.push_back({ resource, state, write });
+		return resource;
+	}
+
+	void RenderGraph::Compile()
+	{
+		OPTICK_EVENT();
+
+		CullPasses();
+		ComputeLifetimes();
+		PlaceTransients();
+		BuildBarriers();
+
+		m_Stats.PassCount = (uint32_t)m_ExecutionOrder.size();
+		m_Stats.CulledPassCount = (uint32_t)(m_Passes.size() - m_ExecutionOrder.size());
+		m_Stats.BarrierCount = (uint32_t)m_Barriers.size();
+		m_Compiled = true;
+	}
+
+	void RenderGraph::CullPasses()
+	{
+		OPTICK_EVENT();
+
+		// Passes with side effects or writes to imported resources are kept, so is everything they depend on
+		m_Stack.clear();
+		for (uint32_t i = 0; i < (uint32_t)m_Passes.size(); ++i)
+		{
+			Pass& pass = m_Passes[i];
+			bool root = pass.SideEffect;
+			for (uint32_t a = pass.AccessOffset; a < pass.AccessOffset + pass.AccessCount; ++a)
+				root |= m_Accesses[a].Write && m_Resources[m_Accesses[a].Resource].Imported;
+
+			pass.Culled = !root;
+			if (root)
+				m_Stack.push_back(i);
+		}
+
+		while (!m_Stack.empty())
+		{
+			const Pass& pass = m_Passes[m_Stack.back()];
+			m_Stack.pop_back();
+
+			for (uint32_t d = pass.DependencyOffset; d < pass.DependencyOffset + pass.DependencyCount; ++d)
+			{
+				Pass& dependency = m_Passes[m_Dependencies[d]];
+				if (dependency.Culled)
+				{
+					dependency.Culled = false;
+					m_Stack.push_back(m_Dependencies[d]);
+				}
+			}
+		}
+
+		// Declaration order is already a valid order since every dependency is declared before its dependents
+		m_ExecutionOrder.clear();
+		for (uint32_t i = 0; i < (uint32_t)m_Passes.size(); ++i)
+		{
+			if (!m_Passes[i].Culled)
+				m_ExecutionOrder.push_back(i);
+		}
+	}
+
+	void RenderGraph::ComputeLifetimes()
+	{
+		OPTICK_EVENT();
+
+		for (Resource& resource : m_Resources)
+		{
+			resource.FirstUse = ~0u;
+			resource.LastUse = ~0u;
+			resource.HeapOffset = 0;
+			resource.AliasedResource = k_InvalidRenderGraphHandle;
+		}
+
+		for (uint32_t order = 0; order < (uint32_t)m_ExecutionOrder.size(); ++order)
+		{
+			const Pass& pass = m_Passes[m_ExecutionOrder[order]];
+			for (uint32_t a = pass.AccessOffset; a < pass.AccessOffset + pass.AccessCount; ++a)
+			{
+				Resource& resource = m_Resources[m_Accesses[a].Resource];
+				if (resource.FirstUse == ~0u)
+					resource.FirstUse = order;
+				resource.LastUse = order;
+			}
+		}
+	}
+
+	void RenderGraph::PlaceTransients()
+	{
+		OPTICK_EVENT();
+
+		m_PlacementOrder.clear();
+		for (RenderGraphHandle i = 0; i < (RenderGraphHandle)m_Resources.size(); ++i)
+		{
+			if (!m_Resources[i].Imported && m_Resources[i].FirstUse != ~0u)
+				m_PlacementOrder.push_back(i);
+		}
+
+		// Largest first, smaller resources then fill the gaps between them
+		eastl::sort(m_PlacementOrder.begin(), m_PlacementOrder.end(), [this](RenderGraphHandle a, RenderGraphHandle b)
+		{
+			return m_Resources[a].Size != m_Resources[b].Size ? m_Resources[a].Size > m_Resources[b].Size : a < b;
+		});
+
+		uint64_t heapSize = 0;
+		uint64_t unaliased = 0;
+		for (uint32_t i = 0; i < (uint32_t)m_PlacementOrder.size(); ++i)
+		{
+			Resource& resource = m_Resources[m_PlacementOrder[i]];
+
+			// First fit: move past every placed resource that is alive at the same time and overlaps the candidate range
+			uint64_t offset = 0;
+			bool moved = true;
+			while (moved)
+			{
+				moved = false;
+				for (uint32_t j = 0; j < i; ++j)
+				{
+					const Resource& placed = m_Resources[m_PlacementOrder[j]];
+					const bool livesTogether = placed.FirstUse <= resource.LastUse && resource.FirstUse <= placed.LastUse;
+					const bool overlaps = placed.HeapOffset < offset + resource.Size && offset < placed.HeapOffset + placed.Size;
+					if (livesTogether && overlaps)
+					{
+						offset = placed.HeapOffset + placed.Size;
+						moved = true;
+					}
+				}
+			}
+
+			resource.HeapOffset = offset;
+			heapSize = eastl::max(heapSize, offset + resource.Size);
+			unaliased += resource.Size;
+		}
+
+		// The resource that used the memory last before this one needs an aliasing barrier
+		for (RenderGraphHandle handle : m_PlacementOrder)
+		{
+			Resource& resource = m_Resources[handle];
+			uint32_t latestUse = 0;
+			for (RenderGraphHandle other : m_PlacementOrder)
+			{
+				const Resource& previous = m_Resources[other];
+				const bool overlaps = previous.HeapOffset < resource.HeapOffset + resource.Size && resource.HeapOffset < previous.HeapOffset + previous.Size;
+				if (other != handle && overlaps && previous.LastUse < resource.FirstUse
+					&& (resource.AliasedResource == k_InvalidRenderGraphHandle || previous.LastUse >= latestUse))
+				{
+					resource.AliasedResource = other;
+					latestUse = previous.LastUse;
+				}
+			}
+		}
+
+		m_Stats.TransientCount = (uint32_t)m_PlacementOrder.size();
+		m_Stats.TransientMemory = heapSize;
+		m_Stats.UnaliasedMemory = unaliased;
+	}
+
+	void RenderGraph::BuildBarriers()
+	{
+		OPTICK_EVENT();
+
+		m_Barriers.clear();
+		for (Resource& resource : m_Resources)
+		{
+			resource.State = resource.Imported ? resource.InitialState : RenderGraphState::Undefined;
+			resource.LastUnorderedPass = ~0u;
+			resource.LastUnorderedWrite = false;
+		}
+
+		for (uint32_t order = 0; order < (uint32_t)m_ExecutionOrder.size(); ++order)
+		{
+			const uint32_t passIndex = m_ExecutionOrder[order];
+			Pass& pass = m_Passes[passIndex];
+			pass.BarrierOffset = (uint32_t)m_Barriers.size();
+
+			for (uint32_t a = pass.AccessOffset; a < pass.AccessOffset + pass.AccessCount; ++a)
+			{
+				const Access& access = m_Accesses[a];
+				Resource& resource = m_Resources[access.Resource];
+
+				bool seen = false;
+				for (uint32_t b = pass.AccessOffset; b < a; ++b)
+				{
+					if (m_Accesses[b].Resource == access.Resource)
+					{
+						ILLUMINO_ASSERT(m_Accesses[b].State == access.State, "A pass can only access a resource in one state");
+						seen = true;
+					}
+				}
+				if (seen)
+				{
+					resource.LastUnorderedWrite |= access.Write;
+					continue;
+				}
+
+				if (resource.FirstUse == order && resource.AliasedResource != k_InvalidRenderGraphHandle)
+				{
+					RenderGraphBarrier& barrier = m_Barriers.push_back();
+					barrier.BarrierType = RenderGraphBarrier::Type::Aliasing;
+					barrier.Resource = access.Resource;
+					barrier.AliasedResource = resource.AliasedResource;
+				}
+
+				if (resource.State != access.State)
+				{
+					RenderGraphBarrier& barrier = m_Barriers.push_back();
+					barrier.BarrierType = RenderGraphBarrier::Type::Transition;
+					barrier.Resource = access.Resource;
+					barrier.Before = resource.State;
+					barrier.After = access.State;
+					resource.State = access.State;
+				}
+				else if (access.State == RenderGraphState::UnorderedAccess && resource.LastUnorderedPass != ~0u
+					&& (resource.LastUnorderedWrite || access.Write))
+				{
+					// Consecutive unordered accesses don't need a transition but a write on either side still has to finish
+					RenderGraphBarrier& barrier = m_Barriers.push_back();
+					barrier.BarrierType = RenderGraphBarrier::Type::UnorderedAccess;
+					barrier.Resource = access.Resource;
+				}
+
+				resource.LastUnorderedPass = access.State == RenderGraphState::UnorderedAccess ? passIndex : ~0u;
+				resource.LastUnorderedWrite = access.Write;
+			}
+
+			pass.BarrierCount = (uint32_t)m_Barriers.size() - pass.BarrierOffset;
+		}
+
+		m_FinalBarrierOffset = (uint32_t)m_Barriers.size();
+		for (RenderGraphHandle i = 0; i < (RenderGraphHandle)m_Resources.size(); ++i)
+		{
+			const Resource& resource = m_Resources[i];
+			if (resource.Imported && resource.State != resource.FinalState)
+			{
+				RenderGraphBarrier& barrier = m_Barriers.push_back();
+				barrier.BarrierType = RenderGraphBarrier::Type::Transition;
+				barrier.Resource = i;
+				barrier.Before = resource.State;
+				barrier.After = resource.FinalState;
+			}
+		}
+	}
+
+	void RenderGraph::Execute(const BarrierFn& barrierFn)
+	{
+		OPTICK_EVENT();
+
+		ILLUMINO_ASSERT(m_Compiled, "Render graph has to be compiled before it is executed");
+
+		for (uint32_t passIndex : m_ExecutionOrder)
+		{
+			const Pass& pass = m_Passes[passIndex];
+			if (barrierFn && pass.BarrierCount)
+				barrierFn(m_Barriers.data() + pass.BarrierOffset, pass.BarrierCount);
+			if (pass.Execute)
+				pass.Execute();
+		}
+
+		const uint32_t finalCount = (uint32_t)m_Barriers.size() - m_FinalBarrierOffset;
+		if (barrierFn && finalCount)
+			barrierFn(m_Barriers.data() + m_FinalBarrierOffset, finalCount);
+	}
+
+	void RenderGraph::GetPassBarriers(uint32_t pass, const RenderGraphBarrier*& outBarriers, uint32_t& outCount) const
+	{
+		outBarriers = m_Barriers.data() + m_Passes[pass].BarrierOffset;
+		outCount = m_Passes[pass].Culled ? 0 : m_Passes[pass].BarrierCount;
+	}
+
+	void RenderGraph::GetFinalBarriers(const RenderGraphBarrier*& outBarriers, uint32_t& outCount) const
+	{
+		outBarriers = m_Barriers.data() + m_FinalBarrierOffset;
+		outCount = (uint32_t)m_Barriers.size() - m_FinalBarrierOffset;
+	}
+
+	eastl::string RenderGraph::ExportGraphviz() const
+	{
+		OPTICK_EVENT();
+
+		eastl::string dot = "digraph RenderGraph\n{\n\trankdir=LR;\n\tnode [fontname=\"Helvetica\"];\n\tedge [fontname=\"Helvetica\", fontsize=10];\n";
+
+		for (uint32_t i = 0; i < (uint32_t)m_Passes.size(); ++i)
+		{
+			const Pass& pass = m_Passes[i];
+			if (pass.Culled)
+				AppendFormat(dot, "\tP%u [shape=box, style=dashed, color=gray, fontcolor=gray, label=\"%s\\nculled\"];\n", i, pass.Name);
+			else
+				AppendFormat(dot, "\tP%u [shape=box, style=filled, fillcolor=lightblue, label=\"%s\\nbarriers: %u\"];\n", i, pass.Name, pass.BarrierCount);
+		}
+
+		for (uint32_t i = 0; i < (uint32_t)m_Resources.size(); ++i)
+		{
+			const Resource& resource = m_Resources[i];
+			AppendFormat(dot, "\tR%u [shape=ellipse, %slabel=\"%s\\n", i, resource.Imported ? "style=bold, " : "", resource.Name);
+			if (resource.IsTexture && !resource.Imported)
+				AppendFormat(dot, "%ux%u %u bpp\\n", resource.Desc.Width, resource.Desc.Height, GetBytesPerPixel(resource.Desc.Format) * 8);
+			if (resource.Imported)
+				dot.append("imported");
+			else if (resource.FirstUse == ~0u)
+				dot.append("unused");
+			else
+				AppendFormat(dot, "%.2f MB at %.2f MB\\npasses %u-%u", resource.Size / (1024.0 * 1024.0), resource.HeapOffset / (1024.0 * 1024.0), resource.FirstUse, resource.LastUse);
+			dot.append("\"];\n");
+		}
+
+		for (uint32_t i = 0; i < (uint32_t)m_Passes.size(); ++i)
+		{
+			const Pass& pass = m_Passes[i];
+			for (uint32_t a = pass.AccessOffset; a < pass.AccessOffset + pass.AccessCount; ++a)
+			{
+				const Access& access = m_Accesses[a];
+				if (access.Write)
+					AppendFormat(dot, "\tP%u -> R%u [color=firebrick, label=\"%s\"];\n", i, access.Resource, GetStateName(access.State));
+				else
+					AppendFormat(dot, "\tR%u -> P%u [label=\"%s\"];\n", access.Resource, i, GetStateName(access.State));
+			}
+		}
+
+		dot.append("}\n");
+		return dot;
+	}
+
+	uint32_t RenderGraph::GetBytesPerPixel(RenderGraphFormat format)
+	{
+		switch (format)
+		{
+			case RenderGraphFormat::RGBA8:		return 4;
+			case RenderGraphFormat::RGBA16F:	return 8;
+			case RenderGraphFormat::RG16F:		return 4;
+			case RenderGraphFormat::R32F:		return 4;
+			case RenderGraphFormat::D32:		return 4;
+		}
+
+		ILLUMINO_ASSERT(false, "Unknown render graph format");
+		return 0;
+	}
+
+	const char* RenderGraph::GetStateName(RenderGraphState state)
+	{
+		switch (state)
+		{
+			case RenderGraphState::Undefined:		return "Undefined";
+			case RenderGraphState::RenderTarget:	return "RenderTarget";
+			case RenderGraphState::DepthWrite:		return "DepthWrite";
+			case RenderGraphState::DepthRead:		return "DepthRead";
+			case RenderGraphState::ShaderResource:	return "ShaderResource";
+			case RenderGraphState::UnorderedAccess:	return "UnorderedAccess";
+			case RenderGraphState::CopySource:		return "CopySource";
+			case RenderGraphState::CopyDest:		return "CopyDest";
+			case RenderGraphState::Present:			return "Present";
+		}
+
+		return "Unknown";
+	}
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <functional>
+
+#include <EASTL/vector.h>
+#include <EASTL/string.h>
+
+#include "Illumino/Core/Core.h"
+
+namespace IlluminoEngine
+{
+	using RenderGraphHandle = uint32_t;
+	constexpr static RenderGraphHandle k_InvalidRenderGraphHandle = ~0u;
+
+	enum class RenderGraphFormat : uint8_t
+	{
+		RGBA8, RGBA16F, RG16F, R32F, D32
+	};
+
+	// Backend independent resource states, backends map them onto their own
+	enum class RenderGraphState : uint8_t
+	{
+		Undefined, RenderTarget, DepthWrite, DepthRead, ShaderResource, UnorderedAccess, CopySource, CopyDest, Present
+	};
+
+	struct RenderGraphTextureDesc
+	{
+		uint32_t Width = 1;
+		uint32_t Height = 1;
+		RenderGraphFormat Format = RenderGraphFormat::RGBA8;
+	};
+
+	struct RenderGraphBarrier
+	{
+		enum class Type : uint8_t
+		{
+			Transition,
+			// The resource takes over heap memory from AliasedResource
+			Aliasing,
+			// Orders two unordered access passes on the same resource
+			UnorderedAccess
+		};
+
+		Type BarrierType = Type::Transition;
+		RenderGraphHandle Resource = k_InvalidRenderGraphHandle;
+		RenderGraphHandle AliasedResource = k_InvalidRenderGraphHandle;
+		RenderGraphState Before = RenderGraphState::Undefined;
+		RenderGraphState After = RenderGraphState::Undefined;
+	};
+
+	struct RenderGraphStats
+	{
+		uint32_t PassCount = 0;
+		uint32_t CulledPassCount = 0;
+		uint32_t TransientCount = 0;
+		uint32_t BarrierCount = 0;
+		// Transient heap size with aliasing and what the resources would take without it
+		uint64_t TransientMemory = 0;
+		uint64_t UnaliasedMemory = 0;
+	};
+
+	class RenderGraph;
+
+	// Handed to a pass's setup function to declare what the pass accesses
+	class RenderGraphBuilder
+	{
+	public:
+		// The first write of a transient resource creates its contents, later writes modify them
+		RenderGraphHandle Read(RenderGraphHandle resource, RenderGraphState state = RenderGraphState::ShaderResource);
+		RenderGraphHandle Write(RenderGraphHandle resource, RenderGraphState state = RenderGraphState::RenderTarget);
+		// Keeps the pass alive even if nothing reads what it writes
+		void SetSideEffect();
+
+	private:
+		RenderGraphBuilder(RenderGraph& graph, uint32_t pass)
+			: m_Graph(graph), m_Pass(pass) {}
+
+		friend class RenderGraph;
+
+	private:
+		RenderGraph& m_Graph;
+		uint32_t m_Pass;
+	};
+
+	// Frame graph of render passes. Passes are declared in execution order with the resources they read and write,
+	// Compile() then culls passes whose results are never used, computes the lifetime of every transient resource,
+	// places transient resources with disjoint lifetimes in the same heap memory and batches the barriers each pass
+	// needs. Compiling does not touch the backend, Execute() runs the passes and hands their barriers to the backend.
+	class RenderGraph
+	{
+	public:
+		using SetupFn = std::function<void(RenderGraphBuilder& builder)>;
+		using ExecuteFn = std::function<void()>;
+		using BarrierFn = std::function<void(const RenderGraphBarrier* barriers, uint32_t count)>;
+
+		// Heap placement alignment of transient resources
+		static constexpr uint64_t PlacementAlignment = 64 * 1024;
+
+		// Drops all passes and resources but keeps their memory for the next frame
+		void Reset();
+
+		RenderGraphHandle CreateTexture(const char* name, const RenderGraphTextureDesc& desc);
+		RenderGraphHandle CreateBuffer(const char* name, uint64_t size);
+		// External resources are owned by the backend and never aliased, the graph returns them in finalState
+		RenderGraphHandle ImportTexture(const char* name, RenderGraphState initialState, RenderGraphState finalState);
+
+		uint32_t AddPass(const char* name, const SetupFn& setup, ExecuteFn execute);
+
+		void Compile();
+		// barrierFn may be empty when the backend tracks states itself
+		void Execute(const BarrierFn& barrierFn = {});
+
+		// Graphviz dot of the passes and resources, culled passes are dashed
+		eastl::string ExportGraphviz() const;
+
+		bool IsPassCulled(uint32_t pass) const { return m_Passes[pass].Culled; }
+		const eastl::vector<uint32_t>& GetExecutionOrder() const { return m_ExecutionOrder; }
+		// Barriers recorded before the pass runs
+		void GetPassBarriers(uint32_t pass, const RenderGraphBarrier*& outBarriers, uint32_t& outCount) const;
+		// Barriers that return imported resources to their final state after the last pass
+		void GetFinalBarriers(const RenderGraphBarrier*& outBarriers, uint32_t& outCount) const;
+
+		// First and last position in the execution order, ~0u for resources no live pass uses
+		uint32_t GetFirstUse(RenderGraphHandle resource) const { return m_Resources[resource].FirstUse; }
+		uint32_t GetLastUse(RenderGraphHandle resource) const { return m_Resources[resource].LastUse; }
+		uint64_t GetHeapOffset(RenderGraphHandle resource) const { return m_Resources[resource].HeapOffset; }
+		uint64_t GetSize(RenderGraphHandle resource) const { return m_Resources[resource].Size; }
+		const char* GetName(RenderGraphHandle resource) const { return m_Resources[resource].Name; }
+		const RenderGraphStats& GetStats() const { return m_Stats; }
+
+		static uint32_t GetBytesPerPixel(RenderGraphFormat format);
+		static const char* GetStateName(RenderGraphState state);
+
+	private:
+		struct Resource
+		{
+			const char* Name;
+			RenderGraphTextureDesc Desc;
+			uint64_t Size = 0;
+			bool IsTexture = true;
+			bool Imported = false;
+			RenderGraphState InitialState = RenderGraphState::Undefined;
+			RenderGraphState FinalState = RenderGraphState::Undefined;
+			// Pass that wrote the resource last while passes were being declared
+			uint32_t LastWriter = ~0u;
+
+			uint32_t FirstUse = ~0u;
+			uint32_t LastUse = ~0u;
+			uint64_t HeapOffset = 0;
+			RenderGraphHandle AliasedResource = k_InvalidRenderGraphHandle;
+
+			// State tracking while the barriers are built
+			RenderGraphState State = RenderGraphState::Undefined;
+			uint32_t LastUnorderedPass = ~0u;
+			bool LastUnorderedWrite = false;
+		};
+
+		struct Access
+		{
+			RenderGraphHandle Resource;
+			RenderGraphState State;
+			bool Write;
+		};
+
+		struct Pass
+		{
+			const char* Name;
+			ExecuteFn Execute;
+			uint32_t AccessOffset = 0;
+			uint32_t AccessCount = 0;
+			uint32_t DependencyOffset = 0;
+			uint32_t DependencyCount = 0;
+			bool SideEffect = false;
+			bool Culled = false;
+			uint32_t BarrierOffset = 0;
+			uint32_t BarrierCount = 0;
+		};
+
+		RenderGraphHandle AddAccess(uint32_t pass, RenderGraphHandle resource, RenderGraphState state, bool write);
+		void CullPasses();
+		void ComputeLifetimes();
+		void PlaceTransients();
+		void BuildBarriers();
+
+		friend class RenderGraphBuilder;
+
+	private:
+		eastl::vector<Resource> m_Resources;
+		eastl::vector<Pass> m_Passes;
+		// Accesses and dependencies of all passes, each pass owns a contiguous range
+		eastl::vector<Access> m_Accesses;
+		eastl::vector<uint32_t> m_Dependencies;
+		eastl::vector<uint32_t> m_ExecutionOrder;
+		eastl::vector<RenderGraphBarrier> m_Barriers;
+		uint32_t m_FinalBarrierOffset = 0;
+		eastl::vector<RenderGraphHandle> m_PlacementOrder;
+		eastl::vector<uint32_t> m_Stack;
+		RenderGraphStats m_Stats;
+		bool m_Compiled = false;
+	};
+}
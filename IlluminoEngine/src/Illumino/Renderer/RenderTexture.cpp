@@ -2,7 +2,10 @@
 #include "RenderTexture.h"
 
 #include "RendererAPI.h"
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 #include "Platform/D3D12/Dx12RenderTexture.h"
+#endif
+#include "Platform/Null/NullRenderTexture.h"
 
 namespace IlluminoEngine
 {
@@ -12,7 +15,10 @@ namespace IlluminoEngine
 		{
 			case RendererAPI::API::None:	ILLUMINO_ASSERT(false, "RendererAPI::None is currently not supported");
 											return nullptr;
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 			case RendererAPI::API::DX12:	return CreateRef<Dx12RenderTexture>(spec);
+#endif
+			case RendererAPI::API::Null:	return CreateRef<NullRenderTexture>(spec);
 		}
 
 		ILLUMINO_ASSERT(false, "Unknown Render Texture");
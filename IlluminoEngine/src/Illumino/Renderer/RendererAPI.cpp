@@ -1,11 +1,18 @@
 #include "ipch.h"
 #include "RendererAPI.h"
 
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 #include "Platform/D3D12/Dx12RendererAPI.h"
+#endif
+#include "Platform/Null/NullRendererAPI.h"
 
 namespace IlluminoEngine
 {
+#ifdef ILLUMINO_HEADLESS
+	RendererAPI::API RendererAPI::s_API = RendererAPI::API::Null;
+#else
 	RendererAPI::API RendererAPI::s_API = RendererAPI::API::DX12;
+#endif
 
 	Scope<RendererAPI> RendererAPI::Create()
 	{
@@ -13,7 +20,10 @@ namespace IlluminoEngine
 		{
 		case RendererAPI::API::None:	ILLUMINO_ASSERT(false, "RendererAPI::None is currently not supported");
 										return nullptr;
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 		case RendererAPI::API::DX12:	return CreateScope<Dx12RendererAPI>();
+#endif
+		case RendererAPI::API::Null:	return CreateScope<NullRendererAPI>();
 		}
 
 		ILLUMINO_ASSERT(false, "Unknown RendererAPI");
@@ -3,6 +3,7 @@
 #include <glm/glm.hpp>
 
 #include "Buffer.h"
+#include "CommandBuffer.h"
 
 namespace IlluminoEngine
 {
@@ -13,7 +14,8 @@ namespace IlluminoEngine
 	public:
 		enum class API
 		{
-			None = 0, DX12
+			// Null runs headless, it tracks resources and counts calls without a GPU
+			None = 0, DX12, Null
 		};
 
 		virtual ~RendererAPI() = default;
@@ -21,10 +23,22 @@ namespace IlluminoEngine
 		virtual void SetViewportSize(uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
 		virtual void ClearColor(const glm::vec4& color) = 0;
 		virtual void DrawIndexed(const Ref<MeshBuffer>& meshBuffer) = 0;
+		virtual void DrawIndexedInstanced(const Ref<MeshBuffer>& meshBuffer, uint32_t instanceCount, uint32_t startInstance) = 0;
+
+		// Index of the frame in flight currently being recorded, in [0, g_QueueSlotCount)
+		virtual uint32_t GetFrameIndex() = 0;
+
+		// Copies data into upload memory that stays valid until the GPU has finished the current frame, returns its GPU address
+		virtual uint64_t UploadTransient(const void* data, size_t size, size_t alignment) = 0;
+
+		// Translates the recorded packets into the backend's own command list
+		virtual void Submit(const CommandBuffer& commandBuffer) = 0;
 
 		static Scope<RendererAPI> Create();
 
 		inline static API GetAPI() { return s_API; }
+		// Must be called before the window creates its graphics context, tests use it to run headless on any platform
+		inline static void SetAPI(API api) { s_API = api; }
 		
 	private:
 		static API s_API;
@@ -1,36 +1,245 @@
 #include "ipch.h"
 #include "SceneRenderer.h"
 
+#include <fstream>
+#include <chrono>
 #include <glm/glm.hpp>
 #include <glm/gtx/transform.hpp>
+#include <EASTL/hash_map.h>
 
 #include "Illumino/Scene/Scene.h"
 #include "Illumino/Scene/Component.h"
 #include "RenderCommand.h"
+#include "CommandBuffer.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "ShadowMap.h"
+#include "GraphicsContext.h"
+#include "FrustumCuller.h"
+#include "DrawKey.h"
+#include "LightClusterer.h"
+#include "OcclusionCuller.h"
+#include "Illumino/Core/JobSystem.h"
+#include "Illumino/Utils/SortUtils.h"
 
 namespace IlluminoEngine
 {
+	struct DirectionalLight
+	{
+		glm::vec4 Direction;
+		glm::vec4 Color;
+	};
+
+	struct PointLight
+	{
+		glm::vec4 Position;
+		glm::vec4 Color;
+	};
+
+	struct InstanceData
+	{
+		glm::mat4 Transform;
+		// Entry in the material buffer
+		uint32_t MaterialIndex = 0;
+	};
+
+	// Matches MaterialData in the shader
+	struct MaterialData
+	{
+		// Metalness, roughness, alpha cutoff and opacity
+		glm::vec4 MRAO = glm::vec4(0.0, 1.0, 0.0, 1.0);
+
+		bool operator==(const MaterialData& other) const { return MRAO == other.MRAO; }
+		bool operator!=(const MaterialData& other) const { return !(*this == other); }
+	};
+
+	// The scalar parameters come from the material buffer, only the textures split batches
+	struct MaterialKey
+	{
+		const Texture2D* Albedo;
+		const Texture2D* Normal;
+
+		bool operator==(const MaterialKey& other) const { return Albedo == other.Albedo && Normal == other.Normal; }
+	};
+
+	struct MaterialKeyHash
+	{
+		size_t operator()(const MaterialKey& key) const
+		{
+			return eastl::hash<const Texture2D*>()(key.Albedo) * 31 + eastl::hash<const Texture2D*>()(key.Normal);
+		}
+	};
+
+	// Matches the ClusterData cbuffer in the shader
+	struct ClusterData
+	{
+		uint32_t TilesX = LightClusterer::TilesX;
+		uint32_t TilesY = LightClusterer::TilesY;
+		uint32_t Slices = LightClusterer::Slices;
+		float DepthScale;
+		float DepthBias;
+	};
+
+	// Matches the ShadowData cbuffer in the shader
+	struct ShadowData
+	{
+		glm::mat4 CascadeViewProjection[ShadowCascades::MaxCascades];
+		float CascadeSplits[ShadowCascades::MaxCascades];
+		float CascadeTexelSizes[ShadowCascades::MaxCascades];
+		uint32_t CascadeCount = 0;
+		uint32_t ShadowLightIndex = 0;
+		float ShadowTexelSize = 1.0f / ShadowCascades::Resolution;
+	};
+
+	// Submission indices of one cascade's casters sorted by geometry so they draw as instanced batches, kept across
+	// frames to reuse their memory
+	struct ShadowCasterDraws
+	{
+		eastl::vector<uint64_t> Keys;
+		eastl::vector<uint32_t> Indices;
+		eastl::vector<uint64_t> TempKeys;
+		eastl::vector<uint32_t> TempIndices;
+		eastl::vector<uint32_t> InstanceSlots;
+	};
+
+	// Draws opaque meshes and owns the buffers shared by every forward pipeline
 	static Ref<Shader> s_Shader;
+	static Ref<Shader> s_MaskedShader;
+	static Ref<Shader> s_TransparentShader;
+	static glm::mat4 s_View;
+	static glm::mat4 s_Projection;
 	static glm::mat4 s_ViewProjection;
 	static glm::vec4 s_CameraPosition;
-	static eastl::vector<Entity> s_DirectionalLights;
-	static eastl::vector<Entity> s_PointLights;
-	static std::vector<MeshData> s_Meshes;
+	static eastl::vector<DirectionalLight> s_DirectionalLights;
+	static eastl::vector<PointLight> s_PointLights;
+	// Submissions live in frame memory, the previous count sizes the next frame's array up front
+	static FrameVector<MeshData> s_Meshes;
+	static uint32_t s_LastMeshCount = 0;
+	static uint32_t s_ShadowOnlyCount = 0;
+	static uint64_t s_HeapAllocationsAtBegin = 0;
+
+	// Every frame in flight has its own copy of the GPU buffers, changed data is uploaded once to each of them.
+	// Each bit marks a frame in flight whose buffer is still stale.
+	constexpr static uint8_t k_AllFramesStale = (1 << g_QueueSlotCount) - 1;
+	static uint8_t s_LightsStaleFrames = 0;
+	// Indexed by instance slot and sized to the instance buffer's capacity, which only grows
+	static eastl::vector<uint8_t> s_InstanceStaleFrames;
+	// Submission index of every instance slot this frame, slots that were not submitted keep their stale bits
+	constexpr static uint32_t k_NotSubmitted = ~0u;
+	static eastl::vector<uint32_t> s_SlotSubmissions;
+	static uint32_t s_InstanceSlotCount = 0;
+	// Material of every instance slot as last written to the instance data, a slot is stale when it changes
+	static eastl::vector<uint32_t> s_SlotMaterials;
+
+	// Scalar material parameters live in their own buffer, one persistent entry per submesh. Editing a shared submesh
+	// re-uploads its entry and every instance drawing it picks the new values up. Entries of submeshes that were not
+	// submitted for k_MaterialRetireFrames are reused, the GPU is done with them by then
+	constexpr static uint32_t k_InvalidMaterial = ~0u;
+	constexpr static uint64_t k_MaterialRetireFrames = 64;
+	static eastl::vector<MaterialData> s_Materials;
+	static eastl::vector<const Submesh*> s_MaterialOwners;
+	static eastl::vector<uint64_t> s_MaterialLastUsed;
+	static eastl::vector<uint8_t> s_MaterialStaleFrames;
+	static eastl::vector<uint32_t> s_FreeMaterials;
+	static uint64_t s_FrameNumber = 0;
+	static uint64_t s_MaterialsReclaimedFrame = ~0ull;
+	static SceneRendererStats s_Stats;
+	static FrustumCuller s_FrustumCuller;
+	static OcclusionCuller s_OcclusionCuller;
+	static eastl::vector<uint8_t> s_Visible;
+
+	// Sort keys and the submission index of each visible draw, kept across frames to reuse their memory
+	static eastl::vector<uint64_t> s_DrawKeys;
+	static eastl::vector<uint32_t> s_DrawIndices;
+	static eastl::vector<uint64_t> s_SortTempKeys;
+	static eastl::vector<uint32_t> s_SortTempIndices;
+	static eastl::hash_map<MaterialKey, uint32_t, MaterialKeyHash, eastl::equal_to<MaterialKey>, EASTLFrameAllocator> s_MaterialIDs;
+	static eastl::hash_map<const MeshBuffer*, uint32_t, eastl::hash<const MeshBuffer*>, eastl::equal_to<const MeshBuffer*>, EASTLFrameAllocator> s_MeshIDs;
+	// Instance slot of every sorted draw, what the shaders index the instance data with
+	static eastl::vector<uint32_t> s_InstanceSlots;
+	// Addresses and handles every draw chunk binds before its draws
+	struct FrameBindings
+	{
+		uint64_t CameraData = 0;
+		uint64_t DirectionalLightData = 0;
+		uint64_t PointLightData = 0;
+		uint64_t ClusterData = 0;
+		uint64_t ClusterGrid = 0;
+		uint64_t LightIndices = 0;
+		uint64_t InstanceData = 0;
+		uint64_t InstanceSlots = 0;
+		uint64_t MaterialData = 0;
+		uint64_t ShadowData = 0;
+	};
+
+	// Counters of one draw chunk, summed into the frame stats once all chunks are recorded
+	struct ChunkStats
+	{
+		uint32_t DrawCalls = 0;
+		uint32_t BindsIssued = 0;
+		uint32_t BindsSkipped = 0;
+		uint32_t PipelineBinds = 0;
+		uint64_t Triangles = 0;
+	};
+
+	static LightClusterer s_LightClusterer;
+	// Light lists only change with the lights or the camera
+	static bool s_ClustersDirty = true;
+	static RenderGraph s_RenderGraph;
+	// Holds the clear, the draws are recorded into the chunk buffers and submitted after it
+	static CommandBuffer s_CommandBuffer;
+	static FrameBindings s_FrameBindings;
+	// First draw of every batch, the last entry is the draw count
+	static eastl::vector<uint32_t> s_BatchStarts;
+	// One buffer per chunk, kept across frames so recording does not allocate once they have grown
+	static eastl::vector<CommandBuffer> s_ChunkCommandBuffers;
+	static eastl::vector<ChunkStats> s_ChunkStats;
+	static uint32_t s_ChunkCount = 0;
+	static uint32_t s_MaxRecordingChunks = 0;
+	// Smaller chunks cost more in repeated bindings than recording them in parallel saves
+	constexpr static uint32_t k_MinBatchesPerChunk = 64;
+
+	static Ref<Shader> s_ShadowShader;
+	static Ref<ShadowMap> s_ShadowMap;
+	static ShadowSettings s_ShadowSettings;
+	static ShadowCascades s_ShadowCascades;
+	// Index into s_DirectionalLights, 0 when no light casts shadows
+	static uint32_t s_ShadowLightIndex = 0;
+	static ShadowCasterDraws s_ShadowCasterDraws[ShadowCascades::MaxCascades];
+	// One buffer per cascade, the first one begins the shadow map and the last one ends it
+	static CommandBuffer s_ShadowCommandBuffers[ShadowCascades::MaxCascades];
+
+	static LODSettings s_LODSettings;
+	static uint32_t s_ViewportHeight = 1080;
+	// Level of every instance slot before the bias, the hysteresis compares against it the next time the slot is drawn.
+	// A slot showing a different submesh starts over at full detail
+	static eastl::vector<uint8_t> s_MeshLODs;
+	static eastl::vector<const Submesh*> s_MeshLODOwners;
+	// Level every submission is drawn with this frame
+	static eastl::vector<uint8_t> s_DrawLODs;
 
 	void SceneRenderer::Init()
 	{
 		OPTICK_EVENT();
 		
-		s_Shader = Shader::Create("Assets/Shaders/TestShader.hlsl",
+		const BufferLayout forwardLayout =
 			{
 				{"POSITION", ShaderDataType::Float3},
 				{"NORMAL", ShaderDataType::Float3},
 				{"TANGENT", ShaderDataType::Float3},
 				{"BITANGENT", ShaderDataType::Float3},
 				{"TEXCOORD", ShaderDataType::Float2}
-			});
+			};
+		s_Shader = Shader::Create("Assets/Shaders/TestShader.hlsl", forwardLayout);
+		s_MaskedShader = Shader::Create("Assets/Shaders/TestShader.hlsl", forwardLayout, ShaderPipeline::ForwardMasked);
+		s_TransparentShader = Shader::Create("Assets/Shaders/TestShader.hlsl", forwardLayout, ShaderPipeline::ForwardTransparent);
+
+		// Only the position is read, the vertex buffers keep their interleaved layout
+		s_ShadowShader = Shader::Create("Assets/Shaders/ShadowDepth.hlsl",
+			{
+				{"POSITION", ShaderDataType::Float3}
+			}, ShaderPipeline::ShadowDepth);
+		s_ShadowMap = ShadowMap::Create(ShadowCascades::Resolution, ShadowCascades::MaxCascades);
 	}
 
 	void SceneRenderer::Shutdown()
@@ -38,51 +247,597 @@ namespace IlluminoEngine
 		OPTICK_EVENT();
 
 		s_Shader = nullptr;
+		s_MaskedShader = nullptr;
+		s_TransparentShader = nullptr;
+		s_ShadowShader = nullptr;
+		s_ShadowMap = nullptr;
+
+		// The next renderer starts with new GPU buffers, nothing in them is uploaded yet
+		s_InstanceStaleFrames.clear();
+		s_SlotMaterials.clear();
+		s_Materials.clear();
+		s_MaterialOwners.clear();
+		s_MaterialLastUsed.clear();
+		s_MaterialStaleFrames.clear();
+		s_FreeMaterials.clear();
+
+		// Frame memory is gone after the FrameAllocator shuts down, the destructors must not touch it
+		s_Meshes.reset_lose_memory();
+		s_MaterialIDs.reset_lose_memory();
+		s_MeshIDs.reset_lose_memory();
 	}
 
-	void SceneRenderer::BeginScene(const Camera& camera, const eastl::vector<Entity>& pointLights, const eastl::vector<Entity>& directionalLights)
+	void SceneRenderer::BeginScene(const Camera& camera, const FrameVector<Entity>& pointLights, const FrameVector<Entity>& directionalLights, bool lightsChanged)
 	{
 		OPTICK_EVENT();
 
+		s_HeapAllocationsAtBegin = FrameAllocator::GetHeapAllocationCount();
+
+		// Last frame's array belongs to a block that has been reset since
+		s_Meshes.reset_lose_memory();
+		s_Meshes.reserve(s_LastMeshCount);
+		s_InstanceSlotCount = 0;
+		s_ShadowOnlyCount = 0;
+
 		// TODO: setup camera, lights, etc data
-		s_ViewProjection = camera.GetProjection() * camera.GetView();
+		s_ClustersDirty |= lightsChanged || camera.GetView() != s_View || camera.GetProjection() != s_Projection;
+		s_View = camera.GetView();
+		s_Projection = camera.GetProjection();
+		s_ViewProjection = s_Projection * s_View;
 		s_CameraPosition = camera.GetTransform()[3];
 
-		s_DirectionalLights = directionalLights;
-		s_PointLights = pointLights;
+		if (lightsChanged)
+		{
+			// index 0 is reserved to check if data is present in Structured buffer or not.
+			// Fixes high GPU usage on AMD cards when nothing is bound
+			s_DirectionalLights.clear();
+			s_DirectionalLights.reserve(directionalLights.size() + 1);
+			s_DirectionalLights.push_back({});
+			s_ShadowLightIndex = 0;
+			for (const Entity& entity : directionalLights)
+			{
+				const auto& light = entity.GetComponent<DirectionalLightComponent>();
+				glm::vec4 dir = entity.GetComponent<TransformComponent>().GetTransform() * glm::vec4(0, 0, 1, 0);
+				if (light.CastShadows && s_ShadowLightIndex == 0 && glm::dot(dir, dir) > 0.0f)
+					s_ShadowLightIndex = (uint32_t)s_DirectionalLights.size();
+				s_DirectionalLights.push_back({ dir, glm::vec4(light.Color, light.Intensity) });
+			}
+
+			s_PointLights.clear();
+			s_PointLights.reserve(pointLights.size() + 1);
+			s_PointLights.push_back({});
+			for (const Entity& entity : pointLights)
+			{
+				const auto& light = entity.GetComponent<PointLightComponent>();
+				glm::vec4 pos = glm::vec4(entity.GetComponent<TransformComponent>().Translation, light.Radius);
+				s_PointLights.push_back({ pos, glm::vec4(light.Color, light.Intensity) });
+			}
+
+			s_LightsStaleFrames = k_AllFramesStale;
+		}
+
+		// Cascades follow the camera, the scene culls its shadow casters against them before submitting
+		if (s_ShadowLightIndex != 0 && s_ShadowSettings.CascadeCount > 0)
+			s_ShadowCascades.Update(s_View, s_Projection, glm::vec3(s_DirectionalLights[s_ShadowLightIndex].Direction), s_ShadowSettings);
+		else
+			s_ShadowCascades.Clear();
 	}
 
 	void SceneRenderer::EndScene()
 	{
 		OPTICK_EVENT();
 
+		// Culling and recording happen up front, the passes only submit what was recorded for them
+		s_CommandBuffer.Reset();
+		s_ChunkCount = 0;
 		RenderPass();
+
+		// The scene is drawn into whatever target the caller bound, the graph only sees it as an imported resource.
+		// The shadow map is owned by the renderer and tracks its own state, it stays readable between frames
+		s_RenderGraph.Reset();
+		const RenderGraphHandle target = s_RenderGraph.ImportTexture("Target", RenderGraphState::RenderTarget, RenderGraphState::RenderTarget);
+		const RenderGraphHandle shadowMap = s_RenderGraph.ImportTexture("ShadowMap", RenderGraphState::ShaderResource, RenderGraphState::ShaderResource);
+		if (s_Stats.ShadowCascadeCount > 0)
+		{
+			s_RenderGraph.AddPass("Shadows",
+				[shadowMap](RenderGraphBuilder& builder)
+				{
+					builder.Write(shadowMap, RenderGraphState::DepthWrite);
+				},
+				[]()
+				{
+					RenderCommand::Submit(s_ShadowCommandBuffers, s_Stats.ShadowCascadeCount);
+				});
+		}
+
+		s_RenderGraph.AddPass("Forward",
+			[target, shadowMap](RenderGraphBuilder& builder)
+			{
+				builder.Read(shadowMap);
+				builder.Write(target);
+			},
+			[]()
+			{
+				// The chunks were recorded out of order on the workers, submitting them in order keeps the sorted draw order
+				RenderCommand::Submit(s_CommandBuffer);
+				RenderCommand::Submit(s_ChunkCommandBuffers.data(), s_ChunkCount);
+
+				s_Stats.RecordedCommands = s_CommandBuffer.GetCommandCount();
+				s_Stats.CommandBytes = (uint32_t)s_CommandBuffer.GetSize();
+				for (uint32_t i = 0; i < s_ChunkCount; ++i)
+				{
+					s_Stats.RecordedCommands += s_ChunkCommandBuffers[i].GetCommandCount();
+					s_Stats.CommandBytes += (uint32_t)s_ChunkCommandBuffers[i].GetSize();
+				}
+				for (uint32_t i = 0; i < s_Stats.ShadowCascadeCount; ++i)
+				{
+					s_Stats.RecordedCommands += s_ShadowCommandBuffers[i].GetCommandCount();
+					s_Stats.CommandBytes += (uint32_t)s_ShadowCommandBuffers[i].GetSize();
+				}
+			});
+
+		s_RenderGraph.Compile();
+		s_RenderGraph.Execute();
+		s_Stats.Graph = s_RenderGraph.GetStats();
+
+		s_Stats.HeapAllocations = (uint32_t)(FrameAllocator::GetHeapAllocationCount() - s_HeapAllocationsAtBegin);
+		s_Stats.FrameMemoryBytes = FrameAllocator::GetUsedBytes();
 	}
 
-	void SceneRenderer::SubmitMesh(Submesh& submesh, glm::mat4& transform)
+	void SceneRenderer::SubmitMesh(Submesh& submesh, const glm::mat4& transform, uint32_t instanceSlot, bool changed, bool occluder, bool mainView)
 	{
 		OPTICK_EVENT();
 
 		MeshData meshData = 
 		{
 			transform,
-			submesh
+			submesh,
+			instanceSlot,
+			changed,
+			occluder,
+			mainView
 		};
 
 		s_Meshes.push_back(meshData);
+		s_InstanceSlotCount = eastl::max(s_InstanceSlotCount, instanceSlot + 1);
+		s_ShadowOnlyCount += !mainView;
+	}
+
+	const SceneRendererStats& SceneRenderer::GetStats()
+	{
+		return s_Stats;
+	}
+
+	bool SceneRenderer::SaveOcclusionDepthImage(const char* filepath)
+	{
+		return s_OcclusionCuller.SaveDepthImage(filepath);
+	}
+
+	void SceneRenderer::SetMaxRecordingChunks(uint32_t count)
+	{
+		s_MaxRecordingChunks = count;
+	}
+
+	void SceneRenderer::SetShadowSettings(const ShadowSettings& settings)
+	{
+		s_ShadowSettings = settings;
+	}
+
+	const ShadowSettings& SceneRenderer::GetShadowSettings()
+	{
+		return s_ShadowSettings;
+	}
+
+	const ShadowCascades& SceneRenderer::GetShadowCascades()
+	{
+		return s_ShadowCascades;
+	}
+
+	void SceneRenderer::SetLODSettings(const LODSettings& settings)
+	{
+		s_LODSettings = settings;
+	}
+
+	const LODSettings& SceneRenderer::GetLODSettings()
+	{
+		return s_LODSettings;
+	}
+
+	void SceneRenderer::SetViewportHeight(uint32_t height)
+	{
+		s_ViewportHeight = height;
+	}
+
+	bool SceneRenderer::SaveRenderGraph(const char* filepath)
+	{
+		std::ofstream file(filepath);
+		if (!file)
+		{
+			ILLUMINO_ERROR("Could not open {0} to write the render graph", filepath);
+			return false;
+		}
+
+		const eastl::string dot = s_RenderGraph.ExportGraphviz();
+		file.write(dot.data(), dot.size());
+		return true;
+	}
+
+	// Structured buffers grow in powers of two so a changing instance count does not recreate them every frame
+	static size_t GetBufferCapacity(size_t count)
+	{
+		size_t capacity = 64;
+		while (capacity < count)
+			capacity *= 2;
+		return capacity;
+	}
+
+	static MaterialData GetMaterialData(const Submesh& submesh)
+	{
+		MaterialData material;
+		material.MRAO = glm::vec4(submesh.Metalness, submesh.Roughness, submesh.AlphaCutoff, submesh.Opacity);
+		return material;
+	}
+
+	static uint32_t AllocateMaterial()
+	{
+		// Retired entries are only looked for once a frame, so a burst of new submeshes doesn't sweep the table every time
+		if (s_FreeMaterials.empty() && s_MaterialsReclaimedFrame != s_FrameNumber)
+		{
+			s_MaterialsReclaimedFrame = s_FrameNumber;
+			for (uint32_t i = 0; i < (uint32_t)s_MaterialOwners.size(); ++i)
+			{
+				if (s_MaterialOwners[i] && s_MaterialLastUsed[i] + k_MaterialRetireFrames < s_FrameNumber)
+				{
+					s_MaterialOwners[i] = nullptr;
+					s_FreeMaterials.push_back(i);
+				}
+			}
+		}
+
+		if (!s_FreeMaterials.empty())
+		{
+			const uint32_t index = s_FreeMaterials.back();
+			s_FreeMaterials.pop_back();
+			return index;
+		}
+
+		// A new buffer starts out stale in every entry
+		const uint32_t index = (uint32_t)s_MaterialOwners.size();
+		const size_t capacity = GetBufferCapacity(index + 1);
+		if (s_MaterialStaleFrames.size() != capacity)
+		{
+			s_Materials.resize(capacity);
+			s_MaterialLastUsed.resize(capacity, 0);
+			s_MaterialStaleFrames.assign(capacity, k_AllFramesStale);
+		}
+		s_MaterialOwners.push_back(nullptr);
+		return index;
+	}
+
+	// Returns the submesh's entry in the material buffer and marks it stale when its parameters changed.
+	// Submesh::MaterialIndex is only a hint, copies of a submesh carry it over and get their own entry here
+	static uint32_t AcquireMaterial(Submesh& submesh)
+	{
+		uint32_t index = submesh.MaterialIndex;
+		const MaterialData material = GetMaterialData(submesh);
+		if (index >= s_MaterialOwners.size() || s_MaterialOwners[index] != &submesh)
+		{
+			index = AllocateMaterial();
+			s_MaterialOwners[index] = &submesh;
+			submesh.MaterialIndex = index;
+			s_Materials[index] = material;
+			s_MaterialStaleFrames[index] = k_AllFramesStale;
+		}
+		else if (s_Materials[index] != material)
+		{
+			s_Materials[index] = material;
+			s_MaterialStaleFrames[index] = k_AllFramesStale;
+		}
+
+		s_MaterialLastUsed[index] = s_FrameNumber;
+		return index;
+	}
+
+	// Uploads the contiguous ranges of material entries that are still stale in the current frame's buffer
+	static void UploadChangedMaterials(uint8_t frameBit)
+	{
+		OPTICK_EVENT();
+
+		const uint32_t count = (uint32_t)s_MaterialOwners.size();
+		uint32_t start = 0;
+		while (start < count)
+		{
+			if (!(s_MaterialStaleFrames[start] & frameBit))
+			{
+				++start;
+				continue;
+			}
+
+			uint32_t end = start;
+			while (end < count && (s_MaterialStaleFrames[end] & frameBit))
+				s_MaterialStaleFrames[end++] &= ~frameBit;
+
+			const size_t rangeSize = sizeof(MaterialData) * (end - start);
+			s_Shader->UploadSRV("MaterialData", &s_Materials[start], rangeSize, sizeof(MaterialData) * start);
+			s_Stats.UploadBytes += rangeSize;
+			s_Stats.UploadedMaterials += end - start;
+
+			start = end;
+		}
+	}
+
+	// Uploads the contiguous ranges of submitted instance slots that are still stale in the current frame's buffer
+	template<typename Fn>
+	static void UploadChangedInstances(const char* name, size_t alignedSize, uint8_t frameBit, Fn fill)
+	{
+		OPTICK_EVENT();
+
+		const uint32_t count = s_InstanceSlotCount;
+		auto needsUpload = [frameBit](uint32_t slot)
+		{
+			return (s_InstanceStaleFrames[slot] & frameBit) && s_SlotSubmissions[slot] != k_NotSubmitted;
+		};
+
+		uint32_t start = 0;
+		while (start < count)
+		{
+			if (!needsUpload(start))
+			{
+				++start;
+				continue;
+			}
+
+			uint32_t end = start;
+			while (end < count && needsUpload(end))
+				++end;
+
+			const size_t rangeSize = alignedSize * (end - start);
+			char* staging = (char*)FrameAllocator::Allocate(rangeSize);
+			for (uint32_t i = start; i < end; ++i)
+			{
+				fill(s_Meshes[s_SlotSubmissions[i]], staging + alignedSize * (i - start));
+				s_InstanceStaleFrames[i] &= ~frameBit;
+				++s_Stats.UploadedInstances;
+			}
+
+			s_Shader->UploadSRV(name, staging, rangeSize, alignedSize * start);
+			s_Stats.UploadBytes += rangeSize;
+
+			start = end;
+		}
+	}
+
+	// Coarsest level whose error projects to at most PixelError pixels. Going coarser than the previous level
+	// needs the error to be below the threshold by the hysteresis margin, going finer happens right away
+	static uint32_t SelectLOD(const Submesh& submesh, const glm::mat4& transform, uint32_t previous, const glm::vec3& cameraPosition, float pixelsPerUnit)
+	{
+		const glm::vec3 center = glm::vec3(transform * glm::vec4(submesh.Sphere.Center, 1.0f));
+		const glm::vec3 axisX = glm::vec3(transform[0]);
+		const glm::vec3 axisY = glm::vec3(transform[1]);
+		const glm::vec3 axisZ = glm::vec3(transform[2]);
+		const float scale = glm::sqrt(glm::max(glm::dot(axisX, axisX), glm::max(glm::dot(axisY, axisY), glm::dot(axisZ, axisZ))));
+
+		// Measured at the closest point of the sphere, from inside it the full detail is used
+		const float distance = glm::distance(cameraPosition, center) - submesh.Sphere.Radius * scale;
+		if (distance <= 0.0f)
+			return 0;
+
+		const float errorToPixels = scale * pixelsPerUnit / distance;
+		const uint32_t levelCount = (uint32_t)submesh.LODs.size() + 1;
+		auto getPixelError = [&submesh, errorToPixels](uint32_t level)
+		{
+			return submesh.LODs[level - 1].Error * errorToPixels;
+		};
+
+		uint32_t lod = 0;
+		while (lod + 1 < levelCount && getPixelError(lod + 1) <= s_LODSettings.PixelError)
+			++lod;
+
+		if (lod > previous)
+		{
+			const float coarserThreshold = s_LODSettings.PixelError * (1.0f - s_LODSettings.Hysteresis);
+			uint32_t coarser = previous;
+			while (coarser < lod && getPixelError(coarser + 1) <= coarserThreshold)
+				++coarser;
+			lod = coarser;
+		}
+
+		return lod;
+	}
+
+	static const Ref<MeshBuffer>& GetDrawGeometry(uint32_t index)
+	{
+		const Submesh& submesh = s_Meshes[index].SubmeshData;
+		const uint8_t lod = s_DrawLODs[index];
+		return lod == 0 ? submesh.Geometry : submesh.LODs[lod - 1].Geometry;
+	}
+
+	static const Ref<Shader>& GetForwardShader(BlendMode blend)
+	{
+		switch (blend)
+		{
+			case BlendMode::Masked:			return s_MaskedShader;
+			case BlendMode::Transparent:	return s_TransparentShader;
+			default:						return s_Shader;
+		}
+	}
+
+	// Only reads the sorted draws and writes the chunk's own buffer and stats, so chunks can be recorded on any thread
+	static void RecordDrawChunk(CommandBuffer& commandBuffer, ChunkStats& stats, uint32_t firstBatch, uint32_t lastBatch)
+	{
+		OPTICK_EVENT();
+
+		commandBuffer.Reset();
+
+		// Bindings persist until the pipeline changes, skip the ones that are already in place
+		const Shader* boundShader = nullptr;
+		const Texture2D* boundTextures[4] = {};
+		auto bindPipeline = [&commandBuffer, &stats, &boundShader, &boundTextures](const Ref<Shader>& shader)
+		{
+			// Buffers don't inherit bindings from the ones submitted before them and every pipeline has its own
+			// root signature, so the frame data is bound again for each chunk and each queue the chunk reaches
+			commandBuffer.BindPipeline(shader);
+			commandBuffer.BindStructuredBuffer(0, s_FrameBindings.DirectionalLightData);
+			commandBuffer.BindStructuredBuffer(1, s_FrameBindings.PointLightData);
+			commandBuffer.BindConstantBuffer(4, s_FrameBindings.CameraData);
+			commandBuffer.BindStructuredBuffer(5, s_FrameBindings.InstanceData);
+			commandBuffer.BindShaderResource(6, s_FrameBindings.InstanceSlots);
+			commandBuffer.BindConstantBuffer(8, s_FrameBindings.ClusterData);
+			commandBuffer.BindShaderResource(9, s_FrameBindings.ClusterGrid);
+			commandBuffer.BindShaderResource(10, s_FrameBindings.LightIndices);
+			commandBuffer.BindConstantBuffer(11, s_FrameBindings.ShadowData);
+			commandBuffer.BindShadowMap(12, s_ShadowMap);
+			commandBuffer.BindStructuredBuffer(13, s_FrameBindings.MaterialData);
+
+			boundShader = shader.get();
+			memset(boundTextures, 0, sizeof(boundTextures));
+			++stats.PipelineBinds;
+		};
+
+		auto bindTexture = [&commandBuffer, &stats, &boundTextures](const Ref<Texture2D>& texture, uint32_t slot)
+		{
+			if (boundTextures[slot] == texture.get())
+			{
+				++stats.BindsSkipped;
+				return;
+			}
+
+			commandBuffer.BindTexture(slot, texture);
+			boundTextures[slot] = texture.get();
+			++stats.BindsIssued;
+		};
+
+		for (uint32_t batch = firstBatch; batch < lastBatch; ++batch)
+		{
+			const uint32_t batchStart = s_BatchStarts[batch];
+			const uint32_t batchEnd = s_BatchStarts[batch + 1];
+			const Submesh& submesh = s_Meshes[s_DrawIndices[batchStart]].SubmeshData;
+			const Ref<MeshBuffer>& geometry = GetDrawGeometry(s_DrawIndices[batchStart]);
+
+			// The pipeline is part of the batch, the queues follow each other in the sorted draws
+			const Ref<Shader>& shader = GetForwardShader(submesh.Blend);
+			if (boundShader != shader.get())
+				bindPipeline(shader);
+
+			if (submesh.Albedo)
+				bindTexture(submesh.Albedo, 2);
+
+			if (submesh.Normal)
+				bindTexture(submesh.Normal, 3);
+
+			commandBuffer.SetConstant(7, batchStart);
+			++stats.BindsIssued;
+
+			commandBuffer.DrawIndexedInstanced(geometry, batchEnd - batchStart, batchStart);
+			++stats.DrawCalls;
+			stats.Triangles += (uint64_t)(geometry->GetIndexCount() / 3) * (batchEnd - batchStart);
+		}
+	}
+
+	// Depth draws of every cascade's casters, each cascade gets its own camera and slot list
+	static void RecordShadowCascades(ShadowData& shadowData)
+	{
+		OPTICK_EVENT();
+
+		const uint32_t cascadeCount = s_ShadowCascades.GetCascadeCount();
+
+		JobCounter counter;
+		JobSystem::Dispatch(cascadeCount, 1, [](uint32_t start, uint32_t end)
+		{
+			for (uint32_t cascade = start; cascade < end; ++cascade)
+			{
+				ShadowCasterDraws& draws = s_ShadowCasterDraws[cascade];
+				const eastl::vector<uint32_t>& casters = s_ShadowCascades.GetCasters(cascade);
+
+				draws.Keys.clear();
+				draws.Indices.assign(casters.begin(), casters.end());
+				for (uint32_t index : casters)
+					draws.Keys.push_back((uint64_t)(uintptr_t)GetDrawGeometry(index).get());
+
+				SortUtils::RadixSort(draws.Keys, draws.Indices, draws.TempKeys, draws.TempIndices);
+
+				draws.InstanceSlots.clear();
+				for (uint32_t index : draws.Indices)
+					draws.InstanceSlots.push_back(s_Meshes[index].InstanceSlot);
+			}
+		}, counter);
+		JobSystem::Wait(counter);
+
+		// Uploads go through the ring, which is only used from this thread
+		for (uint32_t cascade = 0; cascade < cascadeCount; ++cascade)
+		{
+			const ShadowCascade& data = s_ShadowCascades.GetCascade(cascade);
+			const ShadowCasterDraws& draws = s_ShadowCasterDraws[cascade];
+			const uint32_t casterCount = (uint32_t)draws.Indices.size();
+
+			shadowData.CascadeViewProjection[cascade] = data.ViewProjection;
+			shadowData.CascadeSplits[cascade] = data.SplitDepth;
+			shadowData.CascadeTexelSizes[cascade] = data.TexelSize;
+			s_Stats.ShadowCasters[cascade] = casterCount;
+
+			CommandBuffer& commandBuffer = s_ShadowCommandBuffers[cascade];
+			commandBuffer.Reset();
+			if (cascade == 0)
+				commandBuffer.BeginShadowMap(s_ShadowMap);
+			commandBuffer.SetShadowCascade(s_ShadowMap, cascade);
+
+			if (casterCount > 0)
+			{
+				struct CameraData
+				{
+					glm::mat4x4 u_ViewProjection;
+					glm::vec4 u_CameraPosition;
+				} cameraData = { data.ViewProjection, s_CameraPosition };
+
+				const uint64_t cameraDataGpuHandle = RenderCommand::UploadTransient(&cameraData, sizeof(CameraData));
+				const uint64_t slotsGpuHandle = RenderCommand::UploadTransient(draws.InstanceSlots.data(), sizeof(uint32_t) * casterCount, sizeof(uint32_t));
+				s_Stats.UploadBytes += sizeof(CameraData) + sizeof(uint32_t) * casterCount;
+
+				commandBuffer.BindPipeline(s_ShadowShader);
+				commandBuffer.BindConstantBuffer(4, cameraDataGpuHandle);
+				commandBuffer.BindStructuredBuffer(5, s_FrameBindings.InstanceData);
+				commandBuffer.BindShaderResource(6, slotsGpuHandle);
+
+				uint32_t batchStart = 0;
+				while (batchStart < casterCount)
+				{
+					uint32_t batchEnd = batchStart + 1;
+					while (batchEnd < casterCount && draws.Keys[batchEnd] == draws.Keys[batchStart])
+						++batchEnd;
+
+					const Ref<MeshBuffer>& geometry = GetDrawGeometry(draws.Indices[batchStart]);
+					commandBuffer.SetConstant(7, batchStart);
+					commandBuffer.DrawIndexedInstanced(geometry, batchEnd - batchStart, batchStart);
+					++s_Stats.ShadowDrawCalls;
+					s_Stats.ShadowTriangles += (uint64_t)(geometry->GetIndexCount() / 3) * (batchEnd - batchStart);
+
+					batchStart = batchEnd;
+				}
+			}
+
+			if (cascade == cascadeCount - 1)
+				commandBuffer.EndShadowMap(s_ShadowMap);
+		}
+
+		shadowData.CascadeCount = cascadeCount;
+		shadowData.ShadowLightIndex = s_ShadowLightIndex;
+		s_Stats.ShadowCascadeCount = cascadeCount;
 	}
 
 	void SceneRenderer::RenderPass()
 	{
 		OPTICK_EVENT();
 
-		RenderCommand::ClearColor({ 0.042f, 0.042f, 0.042f, 1.0f });
+		s_Stats = {};
+		const uint8_t frameBit = 1 << RenderCommand::GetFrameIndex();
+		++s_FrameNumber;
+
+		s_CommandBuffer.ClearColor({ 0.042f, 0.042f, 0.042f, 1.0f });
 
+		s_LastMeshCount = (uint32_t)s_Meshes.size();
 		if (s_Meshes.empty())
 			return;
 
-		s_Shader->BindPipeline();
-
 		{
 			OPTICK_EVENT("CameraData Upload");
 
@@ -92,117 +847,357 @@ namespace IlluminoEngine
 				glm::vec4 u_CameraPosition = s_CameraPosition;
 			} cameraData;
 
-			const size_t cameraDataAlignedSize = ALIGN(256, sizeof(CameraData));
-			ILLUMINO_ASSERT(cameraDataAlignedSize <= 256, "Upload Camera Data size is greater than 256 bytes!");
-			const uint64_t cameraDataGpuHandle = s_Shader->CreateBuffer("CameraData", cameraDataAlignedSize);
-			s_Shader->UploadBuffer("CameraData", &cameraData, sizeof(CameraData), 0);
+			const uint64_t cameraDataGpuHandle = RenderCommand::UploadTransient(&cameraData, sizeof(CameraData));
+			s_Stats.UploadBytes += sizeof(CameraData);
 
-			s_Shader->BindConstantBuffer(4, cameraDataGpuHandle);
+			s_FrameBindings.CameraData = cameraDataGpuHandle;
 		}
 
 		{
 			OPTICK_EVENT("LightData Upload");
 
-			// index 0 is reserved to check if data is present in Structured buffer or not.
-			// Fixes high GPU usage on AMD cards when nothing is bound
+			const size_t dirLightDataSize = sizeof(DirectionalLight) * s_DirectionalLights.size();
+			const uint64_t dirLightDataGpuHandle = s_Shader->CreateSRV("DirectionalLightData", dirLightDataSize);
 
-			const size_t numDirectionalLights = s_DirectionalLights.size() + 1;
-			struct DirectionalLight
+			const size_t pointLightDataSize = sizeof(PointLight) * s_PointLights.size();
+			const uint64_t pointLightDataGpuHandle = s_Shader->CreateSRV("PointLightData", pointLightDataSize);
+
+			if (s_LightsStaleFrames & frameBit)
 			{
-				glm::vec4 Direction;
-				glm::vec4 Color;
-			};
+				s_Shader->UploadSRV("DirectionalLightData", s_DirectionalLights.data(), dirLightDataSize, 0);
+				s_Shader->UploadSRV("PointLightData", s_PointLights.data(), pointLightDataSize, 0);
 
-			const size_t dirLightDataSize = sizeof(DirectionalLight) * numDirectionalLights;
-			const uint64_t dirLightDataGpuHandle = s_Shader->CreateSRV("DirectionalLightData", dirLightDataSize);
-			eastl::vector<DirectionalLight> directionalLights;
-			directionalLights.reserve(numDirectionalLights);
-			directionalLights.push_back({});
-			for (size_t i = 1; i < numDirectionalLights; ++i)
+				s_Stats.UploadBytes += dirLightDataSize + pointLightDataSize;
+				s_Stats.UploadedLights = (uint32_t)(s_DirectionalLights.size() + s_PointLights.size() - 2);
+				s_LightsStaleFrames &= ~frameBit;
+			}
+
+			s_FrameBindings.DirectionalLightData = dirLightDataGpuHandle;
+			s_FrameBindings.PointLightData = pointLightDataGpuHandle;
+		}
+
+		{
+			OPTICK_EVENT("Light Clustering");
+
+			if (s_ClustersDirty)
 			{
-				auto& light = s_DirectionalLights[i - 1].GetComponent<DirectionalLightComponent>();
-				glm::vec4 dir = s_DirectionalLights[i - 1].GetComponent<TransformComponent>().GetTransform() * glm::vec4(0, 0, 1, 0);
-				directionalLights.push_back({ dir, glm::vec4(light.Color, light.Intensity) });
+				s_LightClusterer.Begin(s_View, s_Projection, s_PointLights.size() - 1);
+				for (size_t i = 1; i < s_PointLights.size(); ++i)
+					s_LightClusterer.Add(glm::vec3(s_PointLights[i].Position), s_PointLights[i].Position.w);
+				s_LightClusterer.Build();
+				s_ClustersDirty = false;
+
+				s_Stats.LightClustering = s_LightClusterer.GetTimings();
 			}
-			s_Shader->UploadSRV("DirectionalLightData", directionalLights.data(), dirLightDataSize, 0);
-			s_Shader->BindStructuredBuffer(0, dirLightDataGpuHandle);
 
-			const size_t numPointLights = s_PointLights.size() + 1;
-			struct PointLight
+			ClusterData clusterData;
+			clusterData.DepthScale = s_LightClusterer.GetDepthScale();
+			clusterData.DepthBias = s_LightClusterer.GetDepthBias();
+
+			// Root views need a valid address even without any lights
+			const eastl::vector<ClusterRange>& grid = s_LightClusterer.GetGrid();
+			const eastl::vector<uint32_t>& lightIndices = s_LightClusterer.GetLightIndices();
+			const uint32_t noLights = 0;
+			const size_t lightIndicesSize = sizeof(uint32_t) * lightIndices.size();
+
+			const uint64_t clusterDataGpuHandle = RenderCommand::UploadTransient(&clusterData, sizeof(ClusterData));
+			const uint64_t gridGpuHandle = RenderCommand::UploadTransient(grid.data(), sizeof(ClusterRange) * grid.size(), sizeof(ClusterRange));
+			const uint64_t lightIndicesGpuHandle = lightIndices.empty()
+				? RenderCommand::UploadTransient(&noLights, sizeof(uint32_t), sizeof(uint32_t))
+				: RenderCommand::UploadTransient(lightIndices.data(), lightIndicesSize, sizeof(uint32_t));
+			s_Stats.UploadBytes += sizeof(ClusterData) + sizeof(ClusterRange) * grid.size() + lightIndicesSize;
+			s_Stats.ClusteredLightIndices = (uint32_t)lightIndices.size();
+
+			s_FrameBindings.ClusterData = clusterDataGpuHandle;
+			s_FrameBindings.ClusterGrid = gridGpuHandle;
+			s_FrameBindings.LightIndices = lightIndicesGpuHandle;
+		}
+
+
+		const uint32_t meshCount = s_Meshes.size();
+
+		{
+			OPTICK_EVENT("Frustum Culling");
+
+			// Shadow only casters are added too, the cascades cull their casters against the same bounds
+			s_FrustumCuller.Begin(s_ViewProjection, meshCount);
+			for (const MeshData& mesh : s_Meshes)
+				s_FrustumCuller.Add(mesh.SubmeshData.Bounds, mesh.Transform);
+			s_FrustumCuller.Cull(s_Visible);
+
+			s_Stats.VisibleMeshes = s_FrustumCuller.GetVisibleCount();
+			s_Stats.CulledMeshes = s_FrustumCuller.GetCulledCount();
+
+			if (s_ShadowOnlyCount > 0)
 			{
-				glm::vec4 Position;
-				glm::vec4 Color;
-			};
+				for (uint32_t i = 0; i < meshCount; ++i)
+				{
+					if (!s_Meshes[i].MainView && s_Visible[i])
+					{
+						s_Visible[i] = 0;
+						--s_Stats.VisibleMeshes;
+						++s_Stats.CulledMeshes;
+					}
+				}
 
-			const size_t pointLightDataSize = sizeof(PointLight) * numPointLights;
-			const uint64_t pointLightDataGpuHandle = s_Shader->CreateSRV("PointLightData", pointLightDataSize);
-			eastl::vector<PointLight> pointLights;
-			pointLights.reserve(numPointLights);
-			pointLights.push_back({});
-			for (size_t i = 1; i < numPointLights; ++i)
+				s_Stats.CulledMeshes -= s_ShadowOnlyCount;
+				s_Stats.ShadowOnlyMeshes = s_ShadowOnlyCount;
+			}
+		}
+
+		{
+			OPTICK_EVENT("Occlusion Culling");
+
+			s_OcclusionCuller.Begin(s_View, s_Projection);
+			for (uint32_t i = 0; i < meshCount; ++i)
 			{
-				auto& light = s_PointLights[i - 1].GetComponent<PointLightComponent>();
-				glm::vec4 pos = glm::vec4(s_PointLights[i - 1].GetComponent<TransformComponent>().Translation, light.Radius);
-				pointLights.push_back({ pos, glm::vec4(light.Color, light.Intensity) });
+				const MeshData& mesh = s_Meshes[i];
+				// Masked and transparent surfaces don't hide everything behind their triangles
+				if (s_Visible[i] && mesh.Occluder && mesh.SubmeshData.Blend == BlendMode::Opaque && !mesh.SubmeshData.Indices.empty())
+					s_OcclusionCuller.AddOccluder(mesh.SubmeshData.Positions.data(), mesh.SubmeshData.Indices.data(), (uint32_t)mesh.SubmeshData.Indices.size(), mesh.Transform);
+			}
+
+			// Without occluders the buffer is empty and would not cull anything
+			if (s_OcclusionCuller.GetOccluderCount() > 0)
+			{
+				s_OcclusionCuller.Render();
+
+				// Occluders are tested as well, one behind another occluder is not drawn either
+				JobCounter counter;
+				JobSystem::Dispatch(meshCount, 256, [](uint32_t start, uint32_t end)
+				{
+					for (uint32_t i = start; i < end; ++i)
+					{
+						if (s_Visible[i] && !s_OcclusionCuller.IsVisible(s_Meshes[i].SubmeshData.Bounds, s_Meshes[i].Transform))
+							s_Visible[i] = 0;
+					}
+				}, counter);
+				JobSystem::Wait(counter);
+
+				uint32_t visibleCount = 0;
+				for (uint8_t visible : s_Visible)
+					visibleCount += visible;
+
+				s_Stats.OccludedMeshes = s_Stats.VisibleMeshes - visibleCount;
+				s_Stats.VisibleMeshes = visibleCount;
+				s_Stats.OccluderTriangles = s_OcclusionCuller.GetRasterizedTriangleCount();
+				s_Stats.Occlusion = s_OcclusionCuller.GetTimings();
 			}
-			s_Shader->UploadSRV("PointLightData", pointLights.data(), pointLightDataSize, 0);
-			s_Shader->BindStructuredBuffer(1, pointLightDataGpuHandle);
 		}
 
+		{
+			OPTICK_EVENT("LOD Selection");
+
+			const auto lodStart = std::chrono::high_resolution_clock::now();
 
-		const uint32_t meshCount = s_Meshes.size();
+			// Levels are kept per instance slot, so culling and submission order do not reset the hysteresis
+			if (s_MeshLODs.size() < s_InstanceSlotCount)
+			{
+				const size_t capacity = GetBufferCapacity(s_InstanceSlotCount);
+				s_MeshLODs.resize(capacity, 0);
+				s_MeshLODOwners.resize(capacity, nullptr);
+			}
+			s_DrawLODs.resize(meshCount);
+
+			// Every mesh gets a level, shadow casters outside the view are drawn with it too.
+			// Pixels a world unit covers at a distance of one, dividing by the distance gives its size on screen
+			const float pixelsPerUnit = s_ViewportHeight * 0.5f * glm::abs(s_Projection[1][1]);
+			const glm::vec3 cameraPosition = glm::vec3(s_CameraPosition);
 
-		const size_t meshAlignedSize = ALIGN(256, sizeof(glm::mat4));
-		const uint64_t meshGpuHandle = s_Shader->CreateBuffer("Properties", meshAlignedSize * meshCount);
-		const size_t meshBufferSize = meshAlignedSize * meshCount;
-		char* meshBuffer = new char[meshBufferSize];
-		for (size_t i = 0; i < meshCount; ++i)
+			JobCounter counter;
+			JobSystem::Dispatch(meshCount, 256, [pixelsPerUnit, cameraPosition](uint32_t start, uint32_t end)
+			{
+				for (uint32_t i = start; i < end; ++i)
+				{
+					const MeshData& mesh = s_Meshes[i];
+					const int32_t levelCount = (int32_t)mesh.SubmeshData.LODs.size() + 1;
+					if (levelCount == 1)
+					{
+						s_DrawLODs[i] = 0;
+						continue;
+					}
+
+					const uint32_t slot = mesh.InstanceSlot;
+					if (s_MeshLODOwners[slot] != &mesh.SubmeshData)
+					{
+						s_MeshLODOwners[slot] = &mesh.SubmeshData;
+						s_MeshLODs[slot] = 0;
+					}
+
+					s_MeshLODs[slot] = (uint8_t)SelectLOD(mesh.SubmeshData, mesh.Transform, s_MeshLODs[slot], cameraPosition, pixelsPerUnit);
+					s_DrawLODs[i] = (uint8_t)glm::clamp((int32_t)s_MeshLODs[slot] + s_LODSettings.Bias, 0, levelCount - 1);
+				}
+			}, counter);
+			JobSystem::Wait(counter);
+
+			s_Stats.LODSelection = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - lodStart).count();
+		}
+
+		// Instance slots belong to the objects, so culling and submission order do not shift the uploads. The buffer only
+		// grows, a new one starts out stale in every slot
+		const size_t instanceCapacity = GetBufferCapacity(eastl::max<size_t>(s_InstanceSlotCount, s_InstanceStaleFrames.size()));
+		if (s_InstanceStaleFrames.size() != instanceCapacity)
 		{
-			auto& meshData = s_Meshes[i];
-			glm::mat4 model = meshData.Transform;
-			memcpy(meshBuffer + meshAlignedSize * i, &model, sizeof(glm::mat4));
+			s_InstanceStaleFrames.assign(instanceCapacity, k_AllFramesStale);
+			s_SlotMaterials.assign(instanceCapacity, k_InvalidMaterial);
 		}
-		s_Shader->UploadBuffer("Properties", meshBuffer, meshBufferSize, 0);
-		delete[] meshBuffer;
 
+		// Material edits only touch the material buffer, a slot is rewritten when it points at a different entry
+		s_SlotSubmissions.assign(s_InstanceSlotCount, k_NotSubmitted);
+		for (uint32_t i = 0; i < meshCount; ++i)
+		{
+			const MeshData& mesh = s_Meshes[i];
+			const uint32_t slot = mesh.InstanceSlot;
+			ILLUMINO_ASSERT(s_SlotSubmissions[slot] == k_NotSubmitted, "Instance slot submitted twice in one frame!");
+			s_SlotSubmissions[slot] = i;
 
-		
-		struct Material
+			const uint32_t material = AcquireMaterial(mesh.SubmeshData);
+			if (mesh.Changed || s_SlotMaterials[slot] != material)
+			{
+				s_SlotMaterials[slot] = material;
+				s_InstanceStaleFrames[slot] = k_AllFramesStale;
+			}
+		}
+
+		s_FrameBindings.MaterialData = s_Shader->CreateSRV("MaterialData", sizeof(MaterialData) * s_Materials.size(), sizeof(MaterialData));
+		UploadChangedMaterials(frameBit);
+
+		s_FrameBindings.InstanceData = s_Shader->CreateSRV("InstanceData", sizeof(InstanceData) * instanceCapacity, sizeof(InstanceData));
+		UploadChangedInstances("InstanceData", sizeof(InstanceData), frameBit, [](const MeshData& meshData, char* dst)
 		{
-			glm::vec4 u_MRAO = glm::vec4(0.0, 1.0, 0.0, 0.0);
-		};
+			InstanceData instance;
+			instance.Transform = meshData.Transform;
+			instance.MaterialIndex = s_SlotMaterials[meshData.InstanceSlot];
+			memcpy(dst, &instance, sizeof(InstanceData));
+		});
 
-		const size_t materialAlignedSize = ALIGN(256, sizeof(Material));
-		const uint64_t materialGpuHandle = s_Shader->CreateBuffer("Material", materialAlignedSize * meshCount);
-		const size_t materialBufferSize = materialAlignedSize * meshCount;
-		char* materialBuffer = new char[materialBufferSize];
-		for (size_t i = 0; i < meshCount; ++i)
 		{
-			auto& meshData = s_Meshes[i];
-			Material material = {};
-			material.u_MRAO.r = meshData.SubmeshData.Metalness;
-			material.u_MRAO.g = meshData.SubmeshData.Roughness;
-			memcpy(materialBuffer + materialAlignedSize * i, &material, sizeof(Material));
+			OPTICK_EVENT("Sort Draws");
+
+			// Material and mesh IDs only have to be unique within the frame, their nodes live in frame memory
+			s_MaterialIDs.reset_lose_memory();
+			s_MeshIDs.reset_lose_memory();
+
+			s_DrawKeys.clear();
+			s_DrawIndices.clear();
+			for (uint32_t i = 0; i < meshCount; ++i)
+			{
+				if (!s_Visible[i])
+					continue;
+
+				const MeshData& mesh = s_Meshes[i];
+				const Submesh& submesh = mesh.SubmeshData;
+				const glm::vec4 center = mesh.Transform * glm::vec4(submesh.Bounds.GetCenter(), 1.0f);
+				const float viewDepth = (s_ViewProjection * center).w;
+
+				const MaterialKey materialKey = { submesh.Albedo.get(), submesh.Normal.get() };
+				const uint32_t materialID = s_MaterialIDs.insert(eastl::make_pair(materialKey, (uint32_t)s_MaterialIDs.size())).first->second;
+				const uint32_t meshID = s_MeshIDs.insert(eastl::make_pair(GetDrawGeometry(i).get(), (uint32_t)s_MeshIDs.size())).first->second;
+				s_Stats.ReducedLODMeshes += s_DrawLODs[i] != 0;
+
+				// Masked draws share the opaque pass and come after the opaque ones, so they are depth tested against
+				// the occluding surfaces first. Transparent draws go last, back to front
+				const DrawKey::Pass pass = submesh.Blend == BlendMode::Transparent ? DrawKey::Pass::Transparent : DrawKey::Pass::Opaque;
+				++s_Stats.QueueMeshes[(size_t)submesh.Blend];
+
+				s_DrawKeys.push_back(DrawKey::Encode(pass, (uint32_t)submesh.Blend, materialID, meshID, viewDepth));
+				s_DrawIndices.push_back(i);
+			}
+
+			SortUtils::RadixSort(s_DrawKeys, s_DrawIndices, s_SortTempKeys, s_SortTempIndices);
 		}
 
-		s_Shader->UploadBuffer("Material", materialBuffer, materialBufferSize, 0);
-		delete[] materialBuffer;
+		// The instance slots in sorted draw order are what the instanced draws index, every batch is a contiguous range of them.
+		// It changes every frame, so it goes through the upload ring instead of a persistent buffer
+		const uint32_t drawCount = (uint32_t)s_DrawIndices.size();
+		if (drawCount == 0)
+			return;
+
+		s_InstanceSlots.clear();
+		for (uint32_t index : s_DrawIndices)
+			s_InstanceSlots.push_back(s_Meshes[index].InstanceSlot);
+
+		const uint64_t instanceSlotsGpuHandle = RenderCommand::UploadTransient(s_InstanceSlots.data(), sizeof(uint32_t) * drawCount, sizeof(uint32_t));
+		s_Stats.UploadBytes += sizeof(uint32_t) * drawCount;
 
+		s_FrameBindings.InstanceSlots = instanceSlotsGpuHandle;
 
-		uint32_t index = 0;
-		for (auto& mesh : s_Meshes)
 		{
-			if (mesh.SubmeshData.Albedo)
-				mesh.SubmeshData.Albedo->Bind(2);
-			
-			if (mesh.SubmeshData.Normal)
-				mesh.SubmeshData.Normal->Bind(3);
-			
-			s_Shader->BindConstantBuffer(5, meshGpuHandle + meshAlignedSize * index);
-			s_Shader->BindConstantBuffer(6, materialGpuHandle + materialAlignedSize * index);
+			OPTICK_EVENT("Shadows");
+
+			// Casters are culled against the camera culler's bounds, so this has to run after frustum culling.
+			// Without a shadow casting light the forward pass still needs a bound ShadowData, with no cascades
+			ShadowData shadowData = {};
+			if (s_ShadowCascades.GetCascadeCount() > 0)
+			{
+				s_ShadowCascades.CullCasters(s_FrustumCuller);
+				RecordShadowCascades(shadowData);
+
+				s_Stats.Shadows = s_ShadowCascades.GetTimings();
+			}
+
+			s_FrameBindings.ShadowData = RenderCommand::UploadTransient(&shadowData, sizeof(ShadowData));
+			s_Stats.UploadBytes += sizeof(ShadowData);
+		}
+
+		{
+			OPTICK_EVENT("Find Batches");
+
+			// Material and mesh IDs are truncated to 16 bits in the key, so past 65536 of them two different ones can
+			// sort next to each other with equal bits. The real textures and geometry decide where a batch ends
+			s_BatchStarts.clear();
+			s_BatchStarts.push_back(0);
+			for (uint32_t i = 1; i < drawCount; ++i)
+			{
+				const Submesh& submesh = s_Meshes[s_DrawIndices[i]].SubmeshData;
+				const Submesh& previous = s_Meshes[s_DrawIndices[i - 1]].SubmeshData;
+				if (DrawKey::GetBatch(s_DrawKeys[i]) != DrawKey::GetBatch(s_DrawKeys[i - 1])
+					|| submesh.Albedo != previous.Albedo
+					|| submesh.Normal != previous.Normal
+					|| GetDrawGeometry(s_DrawIndices[i]) != GetDrawGeometry(s_DrawIndices[i - 1]))
+					s_BatchStarts.push_back(i);
+			}
+			s_BatchStarts.push_back(drawCount);
+		}
+
+		{
+			OPTICK_EVENT("Record Draws");
+
+			const auto recordStart = std::chrono::high_resolution_clock::now();
+
+			// Every chunk is a contiguous range of whole batches, so chunk boundaries never split an instanced draw
+			const uint32_t batchCount = (uint32_t)s_BatchStarts.size() - 1;
+			const uint32_t maxChunks = s_MaxRecordingChunks ? s_MaxRecordingChunks : JobSystem::GetWorkerCount() + 1;
+			s_ChunkCount = eastl::min(maxChunks, (batchCount + k_MinBatchesPerChunk - 1) / k_MinBatchesPerChunk);
+			const uint32_t batchesPerChunk = (batchCount + s_ChunkCount - 1) / s_ChunkCount;
+
+			if (s_ChunkCommandBuffers.size() < s_ChunkCount)
+				s_ChunkCommandBuffers.resize(s_ChunkCount);
+			s_ChunkStats.assign(s_ChunkCount, ChunkStats());
+
+			JobCounter counter;
+			JobSystem::Dispatch(s_ChunkCount, 1, [batchCount, batchesPerChunk](uint32_t start, uint32_t end)
+			{
+				for (uint32_t chunk = start; chunk < end; ++chunk)
+				{
+					const uint32_t firstBatch = eastl::min(chunk * batchesPerChunk, batchCount);
+					const uint32_t lastBatch = eastl::min(firstBatch + batchesPerChunk, batchCount);
+					RecordDrawChunk(s_ChunkCommandBuffers[chunk], s_ChunkStats[chunk], firstBatch, lastBatch);
+				}
+			}, counter);
+			JobSystem::Wait(counter);
+
+			for (const ChunkStats& chunkStats : s_ChunkStats)
+			{
+				s_Stats.DrawCalls += chunkStats.DrawCalls;
+				s_Stats.BindsIssued += chunkStats.BindsIssued;
+				s_Stats.BindsSkipped += chunkStats.BindsSkipped;
+				s_Stats.PipelineBinds += chunkStats.PipelineBinds;
+				s_Stats.Triangles += chunkStats.Triangles;
+			}
 
-			RenderCommand::DrawIndexed(mesh.SubmeshData.Geometry);
-			++index;
+			s_Stats.RecordingChunks = s_ChunkCount;
+			s_Stats.DrawRecording = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - recordStart).count();
 		}
 
 		s_Meshes.clear();
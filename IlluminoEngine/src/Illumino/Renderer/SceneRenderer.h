@@ -2,8 +2,13 @@
 
 #include <glm/glm.hpp>
 
+#include "Illumino/Core/FrameAllocator.h"
 #include "Illumino/Scene/Entity.h"
 #include "Camera.h"
+#include "LightClusterer.h"
+#include "OcclusionCuller.h"
+#include "RenderGraph.h"
+#include "ShadowCascades.h"
 #include "Mesh.h"
 
 namespace IlluminoEngine
@@ -12,6 +17,67 @@ namespace IlluminoEngine
 	{
 		glm::mat4 Transform;
 		Submesh& SubmeshData;
+		uint32_t InstanceSlot = 0;
+		bool Changed = true;
+		bool Occluder = false;
+		// False for shadow casters found outside the camera's view, they are only drawn into the shadow cascades
+		bool MainView = true;
+	};
+
+	struct LODSettings
+	{
+		// Largest on screen size in pixels the error of a coarser level may have
+		float PixelError = 1.0f;
+		// A level is only made coarser once its error is this fraction below PixelError, so objects near
+		// the threshold don't switch back and forth
+		float Hysteresis = 0.25f;
+		// Added to every selected level, positive values trade detail for speed
+		int32_t Bias = 0;
+	};
+
+	struct SceneRendererStats
+	{
+		uint64_t UploadBytes = 0;
+		uint32_t UploadedInstances = 0;
+		uint32_t UploadedMaterials = 0;
+		uint32_t UploadedLights = 0;
+		uint32_t VisibleMeshes = 0;
+		uint32_t CulledMeshes = 0;
+		// Submitted outside the main view as shadow casters, not counted in CulledMeshes
+		uint32_t ShadowOnlyMeshes = 0;
+		// Passed the frustum test but hidden behind occluders, not counted in VisibleMeshes
+		uint32_t OccludedMeshes = 0;
+		uint32_t OccluderTriangles = 0;
+		OcclusionTimings Occlusion;
+		// Visible meshes drawn with a coarser level than their full detail geometry
+		uint32_t ReducedLODMeshes = 0;
+		float LODSelection = 0.0f;
+		uint64_t Triangles = 0;
+		// Visible meshes in each queue, indexed by BlendMode
+		uint32_t QueueMeshes[(size_t)BlendMode::Count] = {};
+		uint32_t PipelineBinds = 0;
+		uint32_t DrawCalls = 0;
+		uint32_t BindsIssued = 0;
+		uint32_t BindsSkipped = 0;
+		// Packets recorded into the frame's command buffer and their size in bytes
+		uint32_t RecordedCommands = 0;
+		uint32_t CommandBytes = 0;
+		// Command buffers the draws were split into and the time it took to record them in milliseconds
+		uint32_t RecordingChunks = 0;
+		float DrawRecording = 0.0f;
+		uint32_t ClusteredLightIndices = 0;
+		// Shadow casters and depth draws of every cascade, zero when no directional light casts shadows
+		uint32_t ShadowCascadeCount = 0;
+		uint32_t ShadowCasters[ShadowCascades::MaxCascades] = {};
+		uint32_t ShadowDrawCalls = 0;
+		uint64_t ShadowTriangles = 0;
+		ShadowTimings Shadows;
+		// Only filled in on frames where the clusters were rebuilt
+		LightClusterTimings LightClustering;
+		RenderGraphStats Graph;
+		// Heap allocations between BeginScene and EndScene from any thread, zero once the renderer has warmed up
+		uint32_t HeapAllocations = 0;
+		uint64_t FrameMemoryBytes = 0;
 	};
 
 	class SceneRenderer
@@ -19,10 +85,32 @@ namespace IlluminoEngine
 	public:
 		static void Init();
 		static void Shutdown();
-		static void BeginScene(const Camera& camera, const eastl::vector<Entity>& pointLights, const eastl::vector<Entity>& directionalLight);
+		// changed hints let the renderer skip uploading data that is already on the GPU
+		static void BeginScene(const Camera& camera, const FrameVector<Entity>& pointLights, const FrameVector<Entity>& directionalLight, bool lightsChanged = true);
 		static void EndScene();
 
-		static void SubmitMesh(Submesh& mesh, glm::mat4& transform);
+		// instanceSlot is where the mesh's instance data lives in the persistent instance buffer. It must stay the same
+		// for an object across frames and be unique within a frame, changed tells the data was modified since the slot
+		// was last submitted. Occluders are also rasterized into the CPU depth buffer that hides the meshes behind them.
+		// Meshes outside the camera's view that may cast into a shadow cascade are submitted with mainView = false
+		static void SubmitMesh(Submesh& mesh, const glm::mat4& transform, uint32_t instanceSlot, bool changed = true, bool occluder = false, bool mainView = true);
+
+		static const SceneRendererStats& GetStats();
+		// Upper limit of command buffers the draws are recorded into in parallel, 0 uses one per job system thread
+		// and 1 records everything on the calling thread
+		static void SetMaxRecordingChunks(uint32_t count);
+		static void SetShadowSettings(const ShadowSettings& settings);
+		static const ShadowSettings& GetShadowSettings();
+		// Cascades of the current frame, set up by BeginScene so the caller can query the casters of each one
+		static const ShadowCascades& GetShadowCascades();
+		static void SetLODSettings(const LODSettings& settings);
+		static const LODSettings& GetLODSettings();
+		// Height in pixels of the target the scene is drawn into, LOD errors are measured against it
+		static void SetViewportHeight(uint32_t height);
+		// Debug dump of the last frame's occlusion depth buffer
+		static bool SaveOcclusionDepthImage(const char* filepath);
+		// Graphviz dot of the last frame's render graph
+		static bool SaveRenderGraph(const char* filepath);
 
 	private:
 		static void RenderPass();
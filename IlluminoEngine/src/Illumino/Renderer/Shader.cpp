@@ -2,17 +2,23 @@
 #include "Shader.h"
 
 #include "RendererAPI.h"
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 #include "Platform/D3D12/Dx12Shader.h"
+#endif
+#include "Platform/Null/NullShader.h"
 
 namespace IlluminoEngine
 {
-	Ref<Shader> Shader::Create(const char* filepath, const BufferLayout& layout)
+	Ref<Shader> Shader::Create(const char* filepath, const BufferLayout& layout, ShaderPipeline pipeline)
 	{
 		switch (RendererAPI::GetAPI())
 		{
 			case RendererAPI::API::None:	ILLUMINO_ASSERT(false, "RendererAPI::None is currently not supported");
 											return nullptr;
-			case RendererAPI::API::DX12:	return CreateRef<Dx12Shader>(filepath, layout);
+#ifdef ILLUMINO_PLATFORM_WINDOWS
+			case RendererAPI::API::DX12:	return CreateRef<Dx12Shader>(filepath, layout, pipeline);
+#endif
+			case RendererAPI::API::Null:	return CreateRef<NullShader>(filepath, layout, pipeline);
 		}
 
 		ILLUMINO_ASSERT(false, "Unknown Shader");
@@ -4,6 +4,20 @@
 
 namespace IlluminoEngine
 {
+	// Fixed function state the shader is compiled for
+	enum class ShaderPipeline
+	{
+		// VS_main and PS_main, writes color and depth without blending
+		Forward,
+		// Forward with ALPHA_TEST defined, the pixel shader discards what fails the alpha test
+		ForwardMasked,
+		// Forward with ALPHA_BLEND defined, blends over the color target by the output alpha. Depth is tested but not written
+		ForwardTransparent,
+		// Only VS_main, writes depth into a ShadowMap with slope scaled bias. Depth clipping is off, so casters
+		// in front of the light's near plane are clamped to it instead of being cut off
+		ShadowDepth
+	};
+
 	class Shader
 	{
 	public:
@@ -11,15 +25,19 @@ namespace IlluminoEngine
 
 		virtual void BindConstantBuffer(uint32_t slot, uint64_t handle) = 0;
 		virtual void BindStructuredBuffer(uint32_t slot, uint64_t handle) = 0;
+		// Binds a structured buffer by GPU address, e.g. one returned by RenderCommand::UploadTransient
+		virtual void BindShaderResource(uint32_t slot, uint64_t address) = 0;
 		virtual void BindGlobal(uint32_t slot, uint64_t handle) = 0;
+		virtual void BindConstant(uint32_t slot, uint32_t value) = 0;
 		virtual void BindPipeline() = 0;
 
 		virtual uint64_t CreateBuffer(const char* name, size_t sizeAligned) = 0;
 		virtual void UploadBuffer(const char* name, void* data, size_t size, size_t offsetAligned) = 0;
 
-		virtual uint64_t CreateSRV(const char* name, size_t sizeAligned) = 0;
+		// stride 0 views the whole buffer as a single element
+		virtual uint64_t CreateSRV(const char* name, size_t sizeAligned, size_t stride = 0) = 0;
 		virtual void UploadSRV(const char* name, void* data, size_t size, size_t offsetAligned) = 0;
 
-		static Ref<Shader> Create(const char* filepath, const BufferLayout& layout);
+		static Ref<Shader> Create(const char* filepath, const BufferLayout& layout, ShaderPipeline pipeline = ShaderPipeline::Forward);
 	};
 }
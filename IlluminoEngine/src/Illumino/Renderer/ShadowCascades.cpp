@@ -0,0 +1,135 @@
+#include "ipch.h"
+#include "ShadowCascades.h"
+
+#include <chrono>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "FrustumCuller.h"
+#include "Illumino/Core/JobSystem.h"
+
+namespace IlluminoEngine
+{
+	static float GetMilliseconds(std::chrono::high_resolution_clock::time_point start)
+	{
+		return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	void ShadowCascades::Update(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& direction, const ShadowSettings& settings)
+	{
+		OPTICK_EVENT();
+
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		m_CascadeCount = glm::clamp(settings.CascadeCount, 1u, MaxCascades);
+
+		const glm::mat4 inverseProjection = glm::inverse(projection);
+		auto unproject = [&inverseProjection](float x, float y, float z)
+		{
+			const glm::vec4 point = inverseProjection * glm::vec4(x, y, z, 1.0f);
+			return glm::vec3(point) / point.w;
+		};
+
+		// Same near and far reconstruction as the light clusters
+		const glm::vec3 nearCenter = unproject(0.0f, 0.0f, 0.0f);
+		const glm::vec3 farCenter = unproject(0.0f, 0.0f, 1.0f);
+		const float forwardSign = farCenter.z < 0.0f ? -1.0f : 1.0f;
+		const float nearDepth = glm::max(nearCenter.z * forwardSign, 0.0001f);
+		float farDepth = farCenter.z * forwardSign;
+		if (!std::isfinite(farDepth) || farDepth <= nearDepth)
+			farDepth = nearDepth * 100000.0f;
+		farDepth = glm::clamp(settings.MaxDistance, nearDepth * 2.0f, farDepth);
+
+		// View space directions through the frustum corners, scaled to a depth of one
+		glm::vec3 directions[4];
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			const glm::vec3 point = unproject(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, 1.0f);
+			directions[i] = point / (point.z * forwardSign);
+		}
+
+		const glm::mat4 inverseView = glm::inverse(view);
+		const glm::vec3 lightDirection = glm::normalize(direction);
+		const glm::vec3 up = glm::abs(lightDirection.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+
+		float splitNear = nearDepth;
+		for (uint32_t cascade = 0; cascade < m_CascadeCount; ++cascade)
+		{
+			const float t = (float)(cascade + 1) / m_CascadeCount;
+			const float logSplit = nearDepth * glm::pow(farDepth / nearDepth, t);
+			const float uniformSplit = nearDepth + (farDepth - nearDepth) * t;
+			const float splitFar = glm::mix(uniformSplit, logSplit, settings.SplitLambda);
+
+			// The slice's corners only depend on the projection, so its sphere is the same for every camera orientation
+			glm::vec3 corners[8];
+			glm::vec3 center = glm::vec3(0.0f);
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				corners[i] = directions[i] * splitNear;
+				corners[i + 4] = directions[i] * splitFar;
+				center += corners[i] + corners[i + 4];
+			}
+			center /= 8.0f;
+
+			float radius = 0.0f;
+			for (const glm::vec3& corner : corners)
+				radius = glm::max(radius, glm::length(corner - center));
+			// Rounded up so float noise in the length doesn't change the texel size from frame to frame
+			radius = glm::ceil(radius * 16.0f) / 16.0f;
+
+			const glm::vec3 worldCenter = glm::vec3(inverseView * glm::vec4(center, 1.0f));
+			const glm::mat4 lightView = glm::lookAt(worldCenter - lightDirection * radius, worldCenter, up);
+			glm::mat4 lightProjection = glm::orthoRH_ZO(-radius, radius, -radius, radius, 0.0f, radius * 2.0f);
+
+			// Moves the projection so the world origin lands on a texel corner, the light's rotation is fixed
+			// so every other point then does too
+			const float halfResolution = Resolution * 0.5f;
+			const glm::vec4 origin = lightProjection * lightView * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f) * halfResolution;
+			const glm::vec2 offset = (glm::round(glm::vec2(origin)) - glm::vec2(origin)) / halfResolution;
+			lightProjection[3][0] += offset.x;
+			lightProjection[3][1] += offset.y;
+
+			ShadowCascade& data = m_Cascades[cascade];
+			data.ViewProjection = lightProjection * lightView;
+			data.SplitDepth = splitFar;
+			data.TexelSize = radius * 2.0f / Resolution;
+			data.CasterFrustum = Frustum(data.ViewProjection);
+			// Extruded toward the light, the shadow pass clamps casters in front of the near plane to depth 0
+			data.CasterFrustum.Planes[4] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+			splitNear = splitFar;
+		}
+
+		m_Timings.Setup = GetMilliseconds(start);
+	}
+
+	void ShadowCascades::CullCasters(const FrustumCuller& culler)
+	{
+		OPTICK_EVENT();
+
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		JobCounter counter;
+		JobSystem::Dispatch(m_CascadeCount, 1, [this, &culler](uint32_t start, uint32_t end)
+		{
+			for (uint32_t cascade = start; cascade < end; ++cascade)
+			{
+				ShadowCascade& data = m_Cascades[cascade];
+				eastl::vector<uint8_t>& visible = m_Visible[cascade];
+				eastl::vector<uint32_t>& casters = m_Casters[cascade];
+
+				data.CasterCount = culler.Cull(data.CasterFrustum, visible);
+
+				casters.clear();
+				casters.reserve(data.CasterCount);
+				for (uint32_t i = 0; i < (uint32_t)visible.size(); ++i)
+				{
+					if (visible[i])
+						casters.push_back(i);
+				}
+			}
+		}, counter);
+		JobSystem::Wait(counter);
+
+		m_Timings.CasterCulling = GetMilliseconds(start);
+	}
+}
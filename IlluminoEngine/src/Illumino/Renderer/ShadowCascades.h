@@ -0,0 +1,72 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <EASTL/vector.h>
+
+#include "Illumino/Math/BoundingVolume.h"
+
+namespace IlluminoEngine
+{
+	class FrustumCuller;
+
+	struct ShadowSettings
+	{
+		uint32_t CascadeCount = 4;
+		// Shadows end here even if the camera sees further
+		float MaxDistance = 150.0f;
+		// Practical split scheme, 0 splits the range uniformly and 1 logarithmically
+		float SplitLambda = 0.75f;
+	};
+
+	struct ShadowCascade
+	{
+		glm::mat4 ViewProjection = glm::mat4(1.0f);
+		// View depth where the cascade ends
+		float SplitDepth = 0.0f;
+		// World space size of one shadow map texel
+		float TexelSize = 0.0f;
+		// Light space box with the near plane removed, so casters between the light and the box are kept
+		Frustum CasterFrustum;
+		uint32_t CasterCount = 0;
+	};
+
+	// Milliseconds spent in each stage of the last frame
+	struct ShadowTimings
+	{
+		float Setup = 0.0f;
+		float CasterCulling = 0.0f;
+	};
+
+	// Cascaded shadow maps for one directional light. The view frustum up to MaxDistance is split into cascades and
+	// every cascade is covered by an orthographic light projection fitted to the bounding sphere of its slice. The sphere
+	// only depends on the projection, so the cascades don't change size when the camera rotates, and their origin
+	// is snapped to whole shadow map texels so moving the camera doesn't make the shadow edges swim.
+	// Casters are culled per cascade against the bounds already added to the camera's FrustumCuller.
+	class ShadowCascades
+	{
+	public:
+		static constexpr uint32_t MaxCascades = 4;
+		// Size of one cascade's tile, the tiles sit next to each other in one atlas
+		static constexpr uint32_t Resolution = 2048;
+
+		// direction is the world space direction the light travels in
+		void Update(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& direction, const ShadowSettings& settings);
+		// No shadow casting light this frame
+		void Clear() { m_CascadeCount = 0; }
+		// One job per cascade, the culler has to be culled for the camera first
+		void CullCasters(const FrustumCuller& culler);
+
+		uint32_t GetCascadeCount() const { return m_CascadeCount; }
+		const ShadowCascade& GetCascade(uint32_t cascade) const { return m_Cascades[cascade]; }
+		// Indices into the culler's objects, in the order they were added
+		const eastl::vector<uint32_t>& GetCasters(uint32_t cascade) const { return m_Casters[cascade]; }
+		const ShadowTimings& GetTimings() const { return m_Timings; }
+
+	private:
+		uint32_t m_CascadeCount = 0;
+		ShadowCascade m_Cascades[MaxCascades];
+		eastl::vector<uint32_t> m_Casters[MaxCascades];
+		eastl::vector<uint8_t> m_Visible[MaxCascades];
+		ShadowTimings m_Timings;
+	};
+}
@@ -0,0 +1,27 @@
+#include "ipch.h"
+#include "ShadowMap.h"
+
+#include "RendererAPI.h"
+#ifdef ILLUMINO_PLATFORM_WINDOWS
+#include "Platform/D3D12/Dx12ShadowMap.h"
+#endif
+#include "Platform/Null/NullShadowMap.h"
+
+namespace IlluminoEngine
+{
+	Ref<ShadowMap> ShadowMap::Create(uint32_t resolution, uint32_t cascadeCount)
+	{
+		switch (RendererAPI::GetAPI())
+		{
+			case RendererAPI::API::None:	ILLUMINO_ASSERT(false, "RendererAPI::None is currently not supported");
+											return nullptr;
+#ifdef ILLUMINO_PLATFORM_WINDOWS
+			case RendererAPI::API::DX12:	return CreateRef<Dx12ShadowMap>(resolution, cascadeCount);
+#endif
+			case RendererAPI::API::Null:	return CreateRef<NullShadowMap>(resolution, cascadeCount);
+		}
+
+		ILLUMINO_ASSERT(false, "Unknown API");
+		return nullptr;
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Illumino/Core/Core.h"
+
+namespace IlluminoEngine
+{
+	// Depth atlas with one square tile per shadow cascade, side by side along x
+	class ShadowMap
+	{
+	public:
+		virtual ~ShadowMap() = default;
+
+		// Makes the atlas the only depth target and clears it
+		virtual void BeginRender() = 0;
+		// Limits rendering to the cascade's tile
+		virtual void SetCascade(uint32_t cascade) = 0;
+		// Makes the atlas readable by shaders and puts back the render targets bound before BeginRender
+		virtual void EndRender() = 0;
+		virtual void Bind(uint32_t slot) = 0;
+
+		virtual uint32_t GetResolution() const = 0;
+		virtual uint32_t GetCascadeCount() const = 0;
+
+		static Ref<ShadowMap> Create(uint32_t resolution, uint32_t cascadeCount);
+	};
+}
@@ -2,7 +2,10 @@
 #include "Texture.h"
 
 #include "RendererAPI.h"
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 #include "Platform/D3D12/Dx12Texture2D.h"
+#endif
+#include "Platform/Null/NullTexture2D.h"
 
 namespace IlluminoEngine
 {
@@ -12,7 +15,10 @@ namespace IlluminoEngine
 		{
 			case RendererAPI::API::None:	ILLUMINO_ASSERT(false, "RendererAPI::None is currently not supported");
 											return nullptr;
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 			case RendererAPI::API::DX12:	return CreateRef<Dx12Texture2D>(filepath);
+#endif
+			case RendererAPI::API::Null:	return CreateRef<NullTexture2D>(filepath);
 		}
 
 		ILLUMINO_ASSERT(false, "Unknown API");
@@ -25,7 +31,10 @@ namespace IlluminoEngine
 		{
 			case RendererAPI::API::None:	ILLUMINO_ASSERT(false, "RendererAPI::None is currently not supported");
 				return nullptr;
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 			case RendererAPI::API::DX12:	return CreateRef<Dx12Texture2D>(width, height, data);
+#endif
+			case RendererAPI::API::Null:	return CreateRef<NullTexture2D>(width, height, data);
 		}
 
 		ILLUMINO_ASSERT(false, "Unknown API");
@@ -0,0 +1,103 @@
+#include "ipch.h"
+#include "UploadRing.h"
+
+namespace IlluminoEngine
+{
+	UploadRing::UploadRing(size_t capacity)
+	{
+		Reset(capacity);
+	}
+
+	void UploadRing::Reset(size_t capacity)
+	{
+		m_Capacity = capacity;
+		m_Head = 0;
+		m_Tail = 0;
+		m_Used = 0;
+		m_FrameSize = 0;
+		m_Frames.clear();
+	}
+
+	size_t UploadRing::Allocate(size_t size, size_t alignment)
+	{
+		ILLUMINO_ASSERT((alignment & (alignment - 1)) == 0, "Alignment must be a power of two!");
+
+		if (size > m_Capacity)
+			return InvalidOffset;
+
+		// Start over from the beginning when nothing is in use, keeps large allocations from wrapping
+		if (m_Used == 0)
+		{
+			m_Head = 0;
+			m_Tail = 0;
+		}
+
+		size_t offset = ALIGN(alignment, m_Head);
+		size_t allocated = offset + size - m_Head;
+		if (m_Used == 0 || m_Head > m_Tail)
+		{
+			// Free space is [head, capacity) followed by [0, tail), skip the end if it is too small
+			if (offset + size > m_Capacity)
+			{
+				if (size > m_Tail)
+					return InvalidOffset;
+
+				offset = 0;
+				allocated = m_Capacity - m_Head + size;
+			}
+		}
+		else if (offset + size > m_Tail)
+		{
+			// Free space is [head, tail), also covers a full ring where head == tail
+			return InvalidOffset;
+		}
+
+		m_Head = offset + size == m_Capacity ? 0 : offset + size;
+		m_Used += allocated;
+		m_FrameSize += allocated;
+
+		return offset;
+	}
+
+	void UploadRing::FinishFrame(uint64_t fenceValue)
+	{
+		if (m_FrameSize == 0)
+			return;
+
+		if (m_Frames.full())
+		{
+			ILLUMINO_WARN("UploadRing has too many frames in flight, merging the oldest ones");
+			m_Frames[1].Size += m_Frames[0].Size;
+			m_Frames.erase(m_Frames.begin());
+		}
+
+		m_Frames.push_back({ fenceValue, m_Head, m_FrameSize });
+		m_FrameSize = 0;
+	}
+
+	void UploadRing::Reclaim(uint64_t completedFenceValue)
+	{
+		uint32_t count = 0;
+		for (const FrameMarker& frame : m_Frames)
+		{
+			if (frame.FenceValue > completedFenceValue)
+				break;
+
+			m_Tail = frame.End;
+			m_Used -= frame.Size;
+			++count;
+		}
+
+		if (count > 0)
+			m_Frames.erase(m_Frames.begin(), m_Frames.begin() + count);
+	}
+
+	size_t UploadRing::GetGrowCapacity(size_t size, size_t alignment) const
+	{
+		const size_t required = m_Used + size + alignment;
+		size_t capacity = m_Capacity > 0 ? m_Capacity * 2 : 64 * 1024;
+		while (capacity < required)
+			capacity *= 2;
+		return capacity;
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <EASTL/fixed_vector.h>
+
+namespace IlluminoEngine
+{
+	// Offset allocator for a ring shaped upload buffer, it only hands out offsets so backends map it onto
+	// whatever memory they own. Allocations of a frame are closed with the fence value that signals the end
+	// of that frame and handed back once the fence has completed.
+	class UploadRing
+	{
+	public:
+		static constexpr size_t InvalidOffset = ~(size_t)0;
+
+		UploadRing(size_t capacity = 0);
+
+		// Drops every allocation, used after the backing buffer was replaced
+		void Reset(size_t capacity);
+
+		// Returns InvalidOffset if the free space cannot fit the allocation
+		size_t Allocate(size_t size, size_t alignment);
+		void FinishFrame(uint64_t fenceValue);
+		void Reclaim(uint64_t completedFenceValue);
+
+		// Power of two capacity that fits the current contents plus the failed allocation
+		size_t GetGrowCapacity(size_t size, size_t alignment) const;
+
+		size_t GetCapacity() const { return m_Capacity; }
+		size_t GetUsedBytes() const { return m_Used; }
+
+	private:
+		struct FrameMarker
+		{
+			uint64_t FenceValue;
+			size_t End;
+			size_t Size;
+		};
+
+		size_t m_Capacity = 0;
+		size_t m_Head = 0;
+		size_t m_Tail = 0;
+		size_t m_Used = 0;
+		// Bytes allocated since the last FinishFrame, including alignment padding and skipped space at the end
+		size_t m_FrameSize = 0;
+		eastl::fixed_vector<FrameMarker, 8> m_Frames;
+	};
+}
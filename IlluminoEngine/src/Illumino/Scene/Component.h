@@ -11,6 +11,8 @@
 
 namespace IlluminoEngine
 {
+	class Prefab;
+
 	struct IDComponent
 	{
 		UUID ID;
@@ -28,6 +30,36 @@ namespace IlluminoEngine
 		RelationshipComponent(const RelationshipComponent&) = default;
 	};
 
+	// Added to entities queued for destruction, they are no longer in the entity map
+	struct PendingDestroyComponent
+	{
+		PendingDestroyComponent() = default;
+		PendingDestroyComponent(const PendingDestroyComponent&) = default;
+	};
+
+	// Local state of the entity, only present once one of the flags was changed
+	struct StateComponent
+	{
+		bool Active = true;
+		bool Visible = true;
+
+		StateComponent() = default;
+		StateComponent(const StateComponent&) = default;
+	};
+
+	// Effective state cached from the entity and its ancestors, views exclude these to skip whole subtrees
+	struct InactiveComponent
+	{
+		InactiveComponent() = default;
+		InactiveComponent(const InactiveComponent&) = default;
+	};
+
+	struct HiddenComponent
+	{
+		HiddenComponent() = default;
+		HiddenComponent(const HiddenComponent&) = default;
+	};
+
 	struct TagComponent
 	{
 		eastl::string Tag = "";
@@ -45,7 +77,7 @@ namespace IlluminoEngine
 		TransformComponent() = default;
 		TransformComponent(const TransformComponent&) = default;
 
-		glm::mat4 GetTransform()
+		glm::mat4 GetTransform() const
 		{
 			return glm::translate(glm::mat4(1.0f), Translation)
 				 * glm::toMat4(glm::quat(Rotation))
@@ -57,6 +89,8 @@ namespace IlluminoEngine
 	{
 		Ref<Mesh> MeshGeometry;
 		uint32_t SubmeshIndex;
+		// Rasterized into the occlusion buffer, meant for large solid meshes like walls and floors
+		bool Occluder = false;
 
 		MeshComponent() = default;
 		MeshComponent(const MeshComponent&) = default;
@@ -76,8 +110,20 @@ namespace IlluminoEngine
 	{
 		float Intensity = 1.0f;
 		glm::vec3 Color = glm::vec3(1.0f);
+		// Only the first directional light with shadows enabled gets shadow cascades
+		bool CastShadows = true;
 
 		DirectionalLightComponent() = default;
 		DirectionalLightComponent(const DirectionalLightComponent&) = default;
 	};
+
+	struct PrefabInstanceComponent
+	{
+		Ref<Prefab> Source;
+		uint32_t NodeIndex = 0;
+		uint32_t Overrides = 0;
+
+		PrefabInstanceComponent() = default;
+		PrefabInstanceComponent(const PrefabInstanceComponent&) = default;
+	};
 }
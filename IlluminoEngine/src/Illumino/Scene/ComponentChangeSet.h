@@ -0,0 +1,94 @@
+#pragma once
+
+#include <mutex>
+#include <entt.hpp>
+#include <EASTL/vector.h>
+
+namespace IlluminoEngine
+{
+	// Tracks which entities had a component of type T constructed or updated since the last Clear.
+	// Updates are only seen through entt's signals, so writes must go through Entity::PatchComponent, replace or patch.
+	template<typename T>
+	class ComponentChangeSet
+	{
+	public:
+		void Connect(entt::registry& registry)
+		{
+			registry.on_construct<T>().template connect<&ComponentChangeSet::OnConstruct>(*this);
+			registry.on_update<T>().template connect<&ComponentChangeSet::OnUpdate>(*this);
+			registry.on_destroy<T>().template connect<&ComponentChangeSet::OnDestroy>(*this);
+		}
+
+		bool IsChanged(entt::entity entity) const
+		{
+			const size_t index = GetIndex(entity);
+			return index < m_Flags.size() && m_Flags[index];
+		}
+
+		const eastl::vector<entt::entity>& GetChanged() const { return m_Changed; }
+
+		// Components were added or removed, anything caching positions in a view must be rebuilt
+		bool HasStructureChanged() const { return m_StructureChanged; }
+		void MarkStructureChanged() { m_StructureChanged = true; }
+
+		void Clear()
+		{
+			for (entt::entity entity : m_Changed)
+			{
+				const size_t index = GetIndex(entity);
+				if (index < m_Flags.size())
+					m_Flags[index] = 0;
+			}
+
+			m_Changed.clear();
+			m_StructureChanged = false;
+		}
+
+	private:
+		static size_t GetIndex(entt::entity entity)
+		{
+			return entt::to_integral(entity) & entt::entt_traits<entt::entity>::entity_mask;
+		}
+
+		void Mark(entt::entity entity)
+		{
+			const size_t index = GetIndex(entity);
+			if (index >= m_Flags.size())
+				m_Flags.resize(eastl::max(index + 1, m_Flags.size() * 2), 0);
+
+			if (!m_Flags[index])
+			{
+				m_Flags[index] = 1;
+				m_Changed.push_back(entity);
+			}
+		}
+
+		// Structural changes only happen on the main thread
+		void OnConstruct(entt::registry& registry, entt::entity entity)
+		{
+			m_StructureChanged = true;
+			Mark(entity);
+		}
+
+		// Systems may patch components from worker threads
+		void OnUpdate(entt::registry& registry, entt::entity entity)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			Mark(entity);
+		}
+
+		void OnDestroy(entt::registry& registry, entt::entity entity)
+		{
+			m_StructureChanged = true;
+			const size_t index = GetIndex(entity);
+			if (index < m_Flags.size())
+				m_Flags[index] = 0;
+		}
+
+	private:
+		eastl::vector<uint8_t> m_Flags;
+		eastl::vector<entt::entity> m_Changed;
+		bool m_StructureChanged = false;
+		std::mutex m_Mutex;
+	};
+}
@@ -25,4 +25,29 @@ namespace IlluminoEngine
 		if (GetParent())
 			m_Scene->RemoveParent(*this);
 	}
+
+	void Entity::SetActive(bool active)
+	{
+		m_Scene->SetActive(*this, active);
+	}
+
+	void Entity::SetVisible(bool visible)
+	{
+		m_Scene->SetVisible(*this, visible);
+	}
+
+	bool Entity::IsActive()
+	{
+		return m_Scene->IsActive(*this);
+	}
+
+	bool Entity::IsVisible()
+	{
+		return m_Scene->IsVisible(*this);
+	}
+
+	void Entity::SetPrefabOverride(uint32_t overrides)
+	{
+		m_Scene->SetPrefabOverride(*this, overrides);
+	}
 }
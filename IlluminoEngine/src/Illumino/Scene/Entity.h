@@ -27,6 +27,7 @@ namespace IlluminoEngine
 			return m_Scene->m_Registry.has<T>(m_EntityHandle);
 		}
 
+		// Does not mark the component as changed, writers that need the change tracked use PatchComponent
 		template<typename T>
 		T& GetComponent()
 		{
@@ -34,6 +35,21 @@ namespace IlluminoEngine
 			return m_Scene->m_Registry.get<T>(m_EntityHandle);
 		}
 
+		template<typename T>
+		const T& GetComponent() const
+		{
+			ILLUMINO_ASSERT(m_Scene->m_Registry.has<T>(m_EntityHandle), "Entity doesn't have the component");
+			return m_Scene->m_Registry.get<T>(m_EntityHandle);
+		}
+
+		// Marks the component as updated so the scene's change sets pick it up, call it after writing to the component
+		template<typename T>
+		T& PatchComponent()
+		{
+			ILLUMINO_ASSERT(HasComponent<T>(), "Entity doesn't have the component");
+			return m_Scene->m_Registry.patch<T>(m_EntityHandle);
+		}
+
 		template<typename T>
 		void RemoveComponent()
 		{
@@ -52,6 +68,14 @@ namespace IlluminoEngine
 		void SetParent(Entity parent);
 		void RemoveParent();
 
+		void SetActive(bool active);
+		void SetVisible(bool visible);
+		bool IsActive();
+		bool IsVisible();
+
+		// Keeps edited components of a prefab instance when the prefab is propagated, editors call it after every edit
+		void SetPrefabOverride(uint32_t overrides);
+
 	private:
 		entt::entity m_EntityHandle = entt::null;
 		Scene* m_Scene = nullptr;
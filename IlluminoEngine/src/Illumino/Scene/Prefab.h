@@ -0,0 +1,98 @@
+#pragma once
+
+#include <type_traits>
+#include <EASTL/vector.h>
+
+#include "Component.h"
+
+namespace IlluminoEngine
+{
+	enum PrefabOverride : uint32_t
+	{
+		PrefabOverride_None				= 0,
+		PrefabOverride_Tag				= 1 << 0,
+		PrefabOverride_Transform		= 1 << 1,
+		PrefabOverride_Mesh				= 1 << 2,
+		PrefabOverride_PointLight		= 1 << 3,
+		PrefabOverride_DirectionalLight	= 1 << 4,
+	};
+
+	// Override bit of a component type, None for components a prefab doesn't propagate
+	template<typename T>
+	constexpr uint32_t GetPrefabOverride()
+	{
+		if constexpr (std::is_same_v<T, TagComponent>)
+			return PrefabOverride_Tag;
+		else if constexpr (std::is_same_v<T, TransformComponent>)
+			return PrefabOverride_Transform;
+		else if constexpr (std::is_same_v<T, MeshComponent>)
+			return PrefabOverride_Mesh;
+		else if constexpr (std::is_same_v<T, PointLightComponent>)
+			return PrefabOverride_PointLight;
+		else if constexpr (std::is_same_v<T, DirectionalLightComponent>)
+			return PrefabOverride_DirectionalLight;
+		else
+			return PrefabOverride_None;
+	}
+
+	// Optional component of a prefab node, NodeToIndex maps a node to its slot in Components
+	template<typename T>
+	struct PrefabComponentArray
+	{
+		static constexpr uint32_t k_InvalidIndex = UINT32_MAX;
+
+		eastl::vector<uint32_t> NodeToIndex;
+		eastl::vector<uint32_t> Nodes;
+		eastl::vector<T> Components;
+
+		void Clear()
+		{
+			NodeToIndex.clear();
+			Nodes.clear();
+			Components.clear();
+		}
+	};
+
+	// Entity subtree captured as per-type component arrays.
+	// Nodes are stored in breadth first order so a parent always comes before its children, node 0 is the root.
+	class Prefab
+	{
+	public:
+		static constexpr uint32_t k_InvalidIndex = UINT32_MAX;
+
+		Prefab() = default;
+		virtual ~Prefab() = default;
+
+		uint32_t GetNodeCount() const { return (uint32_t)m_Parents.size(); }
+
+		// Nanoseconds spent per entity by the last Scene::InstantiatePrefab call
+		float GetLastInstantiateTimePerEntity() const { return m_LastInstantiateTimePerEntity; }
+
+	private:
+		void Clear()
+		{
+			m_Parents.clear();
+			m_ChildCounts.clear();
+			m_Tags.clear();
+			m_Transforms.clear();
+			m_Meshes.Clear();
+			m_PointLights.Clear();
+			m_DirectionalLights.Clear();
+		}
+
+	private:
+		friend class Scene;
+		friend class WorldPartition;
+
+		eastl::vector<uint32_t> m_Parents;
+		eastl::vector<uint32_t> m_ChildCounts;
+		eastl::vector<TagComponent> m_Tags;
+		eastl::vector<TransformComponent> m_Transforms;
+
+		PrefabComponentArray<MeshComponent> m_Meshes;
+		PrefabComponentArray<PointLightComponent> m_PointLights;
+		PrefabComponentArray<DirectionalLightComponent> m_DirectionalLights;
+
+		float m_LastInstantiateTimePerEntity = 0.0f;
+	};
+}
@@ -1,13 +1,56 @@
 #include "ipch.h"
 #include "Scene.h"
 
+#include <chrono>
+
 #include "Illumino/Renderer/SceneRenderer.h"
 #include "Component.h"
+#include "Prefab.h"
+#include "SceneSnapshot.h"
 
 namespace IlluminoEngine
 {
+	// Transform can only be owned by one group, so the mesh group owns both pools
+	// and the light groups own their light pool and look transforms up.
+	static auto GetMeshGroup(entt::registry& registry)
+	{
+		return registry.group<TransformComponent, MeshComponent>(entt::exclude<PendingDestroyComponent, InactiveComponent, HiddenComponent>);
+	}
+
+	static auto GetPointLightGroup(entt::registry& registry)
+	{
+		return registry.group<PointLightComponent>(entt::get<TransformComponent>, entt::exclude<PendingDestroyComponent, InactiveComponent, HiddenComponent>);
+	}
+
+	static auto GetDirectionalLightGroup(entt::registry& registry)
+	{
+		return registry.group<DirectionalLightComponent>(entt::get<TransformComponent>, entt::exclude<PendingDestroyComponent, InactiveComponent, HiddenComponent>);
+	}
+
 	Scene::Scene()
 	{
+		InitRegistry();
+	}
+
+	void Scene::InitRegistry()
+	{
+		// Groups are created up front so the owned pools stay packed as components are added
+		GetMeshGroup(m_Registry);
+		GetPointLightGroup(m_Registry);
+		GetDirectionalLightGroup(m_Registry);
+
+		m_TransformChanges.Connect(m_Registry);
+		m_MeshChanges.Connect(m_Registry);
+		m_PointLightChanges.Connect(m_Registry);
+		m_DirectionalLightChanges.Connect(m_Registry);
+
+		m_Registry.on_destroy<MeshComponent>().connect<&Scene::OnMeshDestroyed>(*this);
+		m_SpatialIndex.Clear();
+		m_SpatialProxies.clear();
+		m_SpatialIndexDirty = true;
+		m_InstanceSlots.clear();
+		m_FreeInstanceSlots.clear();
+		m_InstanceSlotDirty.clear();
 	}
 
 	Entity Scene::CreateEntity(const char* name)
@@ -22,18 +65,185 @@ namespace IlluminoEngine
 		return entity;
 	}
 
+	eastl::vector<Entity> Scene::CreateEntities(uint32_t count, Entity parent, const char* name)
+	{
+		OPTICK_EVENT();
+
+		eastl::vector<entt::entity> handles(count);
+		eastl::vector<IDComponent> ids(count);
+
+		ReserveEntities(count);
+		m_Registry.create(handles.begin(), handles.end());
+
+		RelationshipComponent relationship;
+		if (parent)
+			relationship.Parent = parent.GetComponent<IDComponent>().ID;
+
+		TagComponent tag;
+		tag.Tag = name;
+
+		m_Registry.insert<IDComponent>(handles.begin(), handles.end(), ids.begin(), ids.end());
+		m_Registry.insert<RelationshipComponent>(handles.begin(), handles.end(), relationship);
+		m_Registry.insert<TagComponent>(handles.begin(), handles.end(), tag);
+		m_Registry.insert<TransformComponent>(handles.begin(), handles.end());
+
+		eastl::vector<Entity> entities;
+		entities.reserve(count);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			Entity entity(handles[i], this);
+			m_EntityMap.emplace(ids[i].ID, entity);
+			entities.push_back(entity);
+		}
+
+		if (parent)
+		{
+			auto& children = parent.GetComponent<RelationshipComponent>().Children;
+			children.reserve(children.size() + count);
+			for (uint32_t i = 0; i < count; ++i)
+				children.push_back(ids[i].ID);
+
+			if (m_Registry.has<InactiveComponent>(parent))
+				m_Registry.insert<InactiveComponent>(handles.begin(), handles.end());
+			if (m_Registry.has<HiddenComponent>(parent))
+				m_Registry.insert<HiddenComponent>(handles.begin(), handles.end());
+		}
+
+		return entities;
+	}
+
+	eastl::vector<Entity> Scene::CreateEntities(const eastl::vector<uint32_t>& parents, const eastl::vector<const char*>& names, Entity parent)
+	{
+		OPTICK_EVENT();
+
+		ILLUMINO_ASSERT(names.empty() || names.size() == parents.size(), "Names don't match the entities!");
+
+		const uint32_t count = (uint32_t)parents.size();
+		eastl::vector<entt::entity> handles(count);
+		eastl::vector<IDComponent> ids(count);
+		eastl::vector<RelationshipComponent> relationships(count);
+		eastl::vector<TagComponent> tags(count);
+
+		// Children are counted first so every child list is allocated once
+		eastl::vector<uint32_t> childCounts(count, 0);
+		uint32_t rootCount = 0;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			ILLUMINO_ASSERT(parents[i] == k_InvalidIndex || parents[i] < i, "Parents have to come before their children!");
+			if (parents[i] == k_InvalidIndex)
+				++rootCount;
+			else
+				++childCounts[parents[i]];
+		}
+
+		const UUID parentId = parent ? parent.GetComponent<IDComponent>().ID : UUID(0);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			relationships[i].Children.reserve(childCounts[i]);
+
+			const uint32_t parentIndex = parents[i];
+			if (parentIndex == k_InvalidIndex)
+			{
+				relationships[i].Parent = parentId;
+			}
+			else
+			{
+				relationships[i].Parent = ids[parentIndex].ID;
+				relationships[parentIndex].Children.push_back(ids[i].ID);
+			}
+
+			tags[i].Tag = names.empty() ? "Entity" : names[i];
+		}
+
+		ReserveEntities(count);
+		m_Registry.create(handles.begin(), handles.end());
+
+		m_Registry.insert<IDComponent>(handles.begin(), handles.end(), ids.begin(), ids.end());
+		m_Registry.insert<RelationshipComponent>(handles.begin(), handles.end(), std::make_move_iterator(relationships.begin()), std::make_move_iterator(relationships.end()));
+		m_Registry.insert<TagComponent>(handles.begin(), handles.end(), std::make_move_iterator(tags.begin()), std::make_move_iterator(tags.end()));
+		m_Registry.insert<TransformComponent>(handles.begin(), handles.end());
+
+		eastl::vector<Entity> entities;
+		entities.reserve(count);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			Entity entity(handles[i], this);
+			m_EntityMap.emplace(ids[i].ID, entity);
+			entities.push_back(entity);
+		}
+
+		if (parent)
+		{
+			auto& children = parent.GetComponent<RelationshipComponent>().Children;
+			children.reserve(children.size() + rootCount);
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				if (parents[i] == k_InvalidIndex)
+					children.push_back(ids[i].ID);
+			}
+
+			// New entities have no state of their own, the whole batch inherits the parent's
+			if (m_Registry.has<InactiveComponent>(parent))
+				m_Registry.insert<InactiveComponent>(handles.begin(), handles.end());
+			if (m_Registry.has<HiddenComponent>(parent))
+				m_Registry.insert<HiddenComponent>(handles.begin(), handles.end());
+		}
+
+		return entities;
+	}
+
 	void Scene::DeleteEntity(Entity entity)
 	{
-		UUID& parentId = entity.GetComponent<RelationshipComponent>().Parent;
-		if (parentId)
-			RemoveParent(entity);
+		OPTICK_EVENT();
+
+		DestroyEntity(entity);
+		FlushDestroyedEntities();
+	}
+
+	void Scene::DestroyEntity(Entity entity)
+	{
+		OPTICK_EVENT();
+
+		if (entity.HasComponent<PendingDestroyComponent>())
+			return;
+
+		// The subtree is going away, its effective state does not need to follow the detach
+		if (entity.GetComponent<RelationshipComponent>().Parent)
+			DetachFromParent(entity);
+
+		eastl::vector<Entity> stack;
+		stack.push_back(entity);
+		while (!stack.empty())
+		{
+			Entity current = stack.back();
+			stack.pop_back();
+
+			for (const UUID& child : current.GetComponent<RelationshipComponent>().Children)
+				stack.push_back(m_EntityMap.at(child));
+
+			m_Registry.emplace<PendingDestroyComponent>(current);
+			m_EntityMap.erase(current.GetComponent<IDComponent>().ID);
+			m_PendingDestroy.push_back(current);
+		}
+
+		// Pending entities drop out of the render views before they are destroyed
+		m_TransformChanges.MarkStructureChanged();
+	}
+
+	bool Scene::IsValid(Entity entity)
+	{
+		return m_Registry.valid(entity) && !m_Registry.has<PendingDestroyComponent>(entity);
+	}
+
+	void Scene::FlushDestroyedEntities()
+	{
+		OPTICK_EVENT();
 
-		auto children = entity.GetComponent<RelationshipComponent>().Children;
-		for (size_t i = 0, size = children.size(); i < size; ++i)
-			DeleteEntity(m_EntityMap.at(children[i]));
+		if (m_PendingDestroy.empty())
+			return;
 
-		m_EntityMap.erase(entity.GetComponent<IDComponent>().ID);
-		m_Registry.destroy(entity);
+		m_Registry.destroy(m_PendingDestroy.begin(), m_PendingDestroy.end());
+		m_PendingDestroy.clear();
 	}
 
 	Entity Scene::GetParent(Entity entity)
@@ -44,19 +254,31 @@ namespace IlluminoEngine
 
 	void Scene::SetParent(Entity entity, Entity parent)
 	{
-		UUID& parentId = entity.GetComponent<RelationshipComponent>().Parent;
-		if (parentId)
-			RemoveParent(entity);
+		Entity oldParent = GetParent(entity);
+		if (oldParent)
+			DetachFromParent(entity);
 
-		parentId = parent.GetComponent<IDComponent>().ID;
+		entity.GetComponent<RelationshipComponent>().Parent = parent.GetComponent<IDComponent>().ID;
 		parent.GetComponent<RelationshipComponent>().Children.push_back(entity.GetComponent<IDComponent>().ID);
+
+		if (!HasSameEffectiveState(oldParent, parent))
+			UpdateEffectiveState(entity);
 	}
 
 	void Scene::RemoveParent(Entity entity)
 	{
-		UUID& parentID = entity.GetComponent<RelationshipComponent>().Parent;
-		ILLUMINO_ASSERT(parentID, "Parent is not assigned!");
+		Entity parent = GetParent(entity);
+		ILLUMINO_ASSERT(parent, "Parent is not assigned!");
+
+		DetachFromParent(entity);
 
+		if (!HasSameEffectiveState(parent, Entity()))
+			UpdateEffectiveState(entity);
+	}
+
+	void Scene::DetachFromParent(Entity entity)
+	{
+		UUID& parentID = entity.GetComponent<RelationshipComponent>().Parent;
 		Entity parent = m_EntityMap.at(parentID);
 		UUID entityId = entity.GetComponent<IDComponent>().ID;
 		auto& children = parent.GetComponent<RelationshipComponent>().Children;
@@ -71,42 +293,840 @@ namespace IlluminoEngine
 		parentID = 0;
 	}
 
+	// A null entity stands for the scene root, which is always active and visible
+	bool Scene::HasSameEffectiveState(Entity a, Entity b)
+	{
+		const bool activeA = !a || IsActiveInHierarchy(a);
+		const bool activeB = !b || IsActiveInHierarchy(b);
+		const bool visibleA = !a || IsVisibleInHierarchy(a);
+		const bool visibleB = !b || IsVisibleInHierarchy(b);
+		return activeA == activeB && visibleA == visibleB;
+	}
+
+	void Scene::SetActive(Entity entity, bool active)
+	{
+		OPTICK_EVENT();
+
+		m_Registry.get_or_emplace<StateComponent>(entity).Active = active;
+		UpdateEffectiveState(entity);
+	}
+
+	void Scene::SetVisible(Entity entity, bool visible)
+	{
+		OPTICK_EVENT();
+
+		m_Registry.get_or_emplace<StateComponent>(entity).Visible = visible;
+		UpdateEffectiveState(entity);
+	}
+
+	bool Scene::IsActive(Entity entity)
+	{
+		const StateComponent* state = m_Registry.try_get<StateComponent>(entity);
+		return !state || state->Active;
+	}
+
+	bool Scene::IsVisible(Entity entity)
+	{
+		const StateComponent* state = m_Registry.try_get<StateComponent>(entity);
+		return !state || state->Visible;
+	}
+
+	bool Scene::IsActiveInHierarchy(Entity entity)
+	{
+		return !m_Registry.has<InactiveComponent>(entity);
+	}
+
+	bool Scene::IsVisibleInHierarchy(Entity entity)
+	{
+		return !m_Registry.has<HiddenComponent>(entity);
+	}
+
+	void Scene::UpdateEffectiveState(Entity root)
+	{
+		OPTICK_EVENT();
+
+		struct StackEntry
+		{
+			Entity Node;
+			bool ParentActive;
+			bool ParentVisible;
+		};
+
+		Entity parent = GetParent(root);
+		eastl::vector<StackEntry> stack;
+		stack.push_back({ root, !parent || IsActiveInHierarchy(parent), !parent || IsVisibleInHierarchy(parent) });
+
+		bool changed = false;
+		while (!stack.empty())
+		{
+			const StackEntry entry = stack.back();
+			stack.pop_back();
+
+			const entt::entity node = entry.Node;
+			if (m_Registry.has<PendingDestroyComponent>(node))
+				continue;
+
+			const StateComponent* state = m_Registry.try_get<StateComponent>(node);
+			const bool active = entry.ParentActive && (!state || state->Active);
+			const bool visible = entry.ParentVisible && (!state || state->Visible);
+
+			const bool wasActive = !m_Registry.has<InactiveComponent>(node);
+			const bool wasVisible = !m_Registry.has<HiddenComponent>(node);
+
+			// Descendants only depend on this node's effective state, so an unchanged node ends the walk
+			if (active == wasActive && visible == wasVisible)
+				continue;
+
+			if (active != wasActive)
+			{
+				if (active)
+					m_Registry.remove<InactiveComponent>(node);
+				else
+					m_Registry.emplace<InactiveComponent>(node);
+				changed = true;
+			}
+
+			if (visible != wasVisible)
+			{
+				if (visible)
+					m_Registry.remove<HiddenComponent>(node);
+				else
+					m_Registry.emplace<HiddenComponent>(node);
+				changed = true;
+			}
+
+			for (const UUID& child : m_Registry.get<RelationshipComponent>(node).Children)
+				stack.push_back({ m_EntityMap.at(child), active, visible });
+		}
+
+		// Entities entering or leaving the render groups move the others around
+		if (changed)
+			m_TransformChanges.MarkStructureChanged();
+	}
+
+	// Grows the pools geometrically, reserving the exact size for every batch would reallocate them each time
+	template<typename... Component>
+	static void ReserveComponents(entt::registry& registry, size_t count)
+	{
+		([&registry, count]()
+		{
+			const size_t required = registry.size<Component>() + count;
+			const size_t capacity = registry.capacity<Component>();
+			if (required > capacity)
+				registry.reserve<Component>(eastl::max(required, capacity * 2));
+		}(), ...);
+	}
+
+	template<typename T>
+	static void CapturePrefabComponent(entt::registry& registry, entt::entity entity, uint32_t node, PrefabComponentArray<T>& array)
+	{
+		if (const T* component = registry.try_get<T>(entity))
+		{
+			array.NodeToIndex.push_back((uint32_t)array.Components.size());
+			array.Nodes.push_back(node);
+			array.Components.push_back(*component);
+		}
+		else
+		{
+			array.NodeToIndex.push_back(PrefabComponentArray<T>::k_InvalidIndex);
+		}
+	}
+
+	template<typename T>
+	static void InstantiatePrefabComponent(entt::registry& registry, const eastl::vector<entt::entity>& handles, const PrefabComponentArray<T>& array)
+	{
+		if (array.Components.empty())
+			return;
+
+		eastl::vector<entt::entity> subset;
+		subset.reserve(array.Nodes.size());
+		for (uint32_t node : array.Nodes)
+			subset.push_back(handles[node]);
+
+		ReserveComponents<T>(registry, subset.size());
+		registry.insert<T>(subset.begin(), subset.end(), array.Components.begin(), array.Components.end());
+	}
+
+	template<typename T>
+	static void PropagatePrefabComponent(entt::registry& registry, entt::entity entity, uint32_t node, const PrefabComponentArray<T>& array)
+	{
+		const uint32_t index = array.NodeToIndex[node];
+		if (index != PrefabComponentArray<T>::k_InvalidIndex)
+			registry.emplace_or_replace<T>(entity, array.Components[index]);
+		else if (registry.has<T>(entity))
+			registry.remove<T>(entity);
+	}
+
+	Ref<Prefab> Scene::CreatePrefab(Entity root)
+	{
+		OPTICK_EVENT();
+
+		Ref<Prefab> prefab = CreateRef<Prefab>();
+		CapturePrefab(*prefab, root);
+		return prefab;
+	}
+
+	void Scene::UpdatePrefab(const Ref<Prefab>& prefab, Entity root)
+	{
+		OPTICK_EVENT();
+
+		const uint32_t oldNodeCount = prefab->GetNodeCount();
+		CapturePrefab(*prefab, root);
+		if (oldNodeCount != prefab->GetNodeCount())
+			ILLUMINO_WARN("Prefab hierarchy changed, existing instances will only be updated for matching nodes");
+
+		PropagatePrefab(prefab);
+	}
+
+	void Scene::PropagatePrefab(const Ref<Prefab>& prefab)
+	{
+		OPTICK_EVENT();
+
+		const uint32_t nodeCount = prefab->GetNodeCount();
+		auto view = m_Registry.view<PrefabInstanceComponent>();
+		for (auto entity : view)
+		{
+			const auto& instance = view.get<PrefabInstanceComponent>(entity);
+			if (instance.Source != prefab || instance.NodeIndex >= nodeCount)
+				continue;
+
+			const uint32_t node = instance.NodeIndex;
+			const uint32_t overrides = instance.Overrides;
+
+			if (!(overrides & PrefabOverride_Tag))
+				m_Registry.replace<TagComponent>(entity, prefab->m_Tags[node]);
+			if (!(overrides & PrefabOverride_Transform))
+				m_Registry.replace<TransformComponent>(entity, prefab->m_Transforms[node]);
+			if (!(overrides & PrefabOverride_Mesh))
+				PropagatePrefabComponent(m_Registry, entity, node, prefab->m_Meshes);
+			if (!(overrides & PrefabOverride_PointLight))
+				PropagatePrefabComponent(m_Registry, entity, node, prefab->m_PointLights);
+			if (!(overrides & PrefabOverride_DirectionalLight))
+				PropagatePrefabComponent(m_Registry, entity, node, prefab->m_DirectionalLights);
+		}
+	}
+
+	void Scene::SetPrefabOverride(Entity entity, uint32_t overrides)
+	{
+		if (PrefabInstanceComponent* instance = m_Registry.try_get<PrefabInstanceComponent>(entity))
+			instance->Overrides |= overrides;
+	}
+
+	Entity Scene::InstantiatePrefab(const Ref<Prefab>& prefab, Entity parent)
+	{
+		OPTICK_EVENT();
+
+		ILLUMINO_ASSERT(prefab && prefab->GetNodeCount() > 0, "Prefab is empty!");
+
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		const uint32_t count = prefab->GetNodeCount();
+		eastl::vector<entt::entity> handles(count);
+		eastl::vector<IDComponent> ids(count);
+		eastl::vector<RelationshipComponent> relationships(count);
+		eastl::vector<PrefabInstanceComponent> instances(count);
+
+		const UUID parentId = parent ? parent.GetComponent<IDComponent>().ID : UUID(0);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			relationships[i].Children.reserve(prefab->m_ChildCounts[i]);
+
+			const uint32_t parentNode = prefab->m_Parents[i];
+			if (parentNode == Prefab::k_InvalidIndex)
+			{
+				relationships[i].Parent = parentId;
+			}
+			else
+			{
+				relationships[i].Parent = ids[parentNode].ID;
+				relationships[parentNode].Children.push_back(ids[i].ID);
+			}
+
+			instances[i].Source = prefab;
+			instances[i].NodeIndex = i;
+		}
+
+		// Every instance is placed individually, so the root transform is never propagated
+		instances[0].Overrides = PrefabOverride_Transform;
+
+		ReserveEntities(count);
+		ReserveComponents<PrefabInstanceComponent>(m_Registry, count);
+		m_Registry.create(handles.begin(), handles.end());
+
+		m_Registry.insert<IDComponent>(handles.begin(), handles.end(), ids.begin(), ids.end());
+		m_Registry.insert<RelationshipComponent>(handles.begin(), handles.end(), std::make_move_iterator(relationships.begin()), std::make_move_iterator(relationships.end()));
+		m_Registry.insert<TagComponent>(handles.begin(), handles.end(), prefab->m_Tags.begin(), prefab->m_Tags.end());
+		m_Registry.insert<TransformComponent>(handles.begin(), handles.end(), prefab->m_Transforms.begin(), prefab->m_Transforms.end());
+		m_Registry.insert<PrefabInstanceComponent>(handles.begin(), handles.end(), std::make_move_iterator(instances.begin()), std::make_move_iterator(instances.end()));
+
+		InstantiatePrefabComponent(m_Registry, handles, prefab->m_Meshes);
+		InstantiatePrefabComponent(m_Registry, handles, prefab->m_PointLights);
+		InstantiatePrefabComponent(m_Registry, handles, prefab->m_DirectionalLights);
+
+		for (uint32_t i = 0; i < count; ++i)
+			m_EntityMap.emplace(ids[i].ID, Entity(handles[i], this));
+
+		if (parent)
+		{
+			parent.GetComponent<RelationshipComponent>().Children.push_back(ids[0].ID);
+			UpdateEffectiveState(Entity(handles[0], this));
+		}
+
+		const auto end = std::chrono::high_resolution_clock::now();
+		prefab->m_LastInstantiateTimePerEntity = std::chrono::duration<float, std::nano>(end - start).count() / count;
+
+		return Entity(handles[0], this);
+	}
+
+	void Scene::ReserveEntities(size_t count)
+	{
+		const size_t entityCount = m_Registry.size() + count;
+		if (entityCount > m_Registry.capacity())
+			m_Registry.reserve(eastl::max(entityCount, m_Registry.capacity() * 2));
+
+		ReserveComponents<IDComponent, RelationshipComponent, TagComponent, TransformComponent>(m_Registry, count);
+
+		const size_t mapCount = m_EntityMap.size() + count;
+		if (mapCount > m_EntityMap.bucket_count())
+			m_EntityMap.reserve(eastl::max(mapCount, m_EntityMap.size() * 2));
+	}
+
+	void Scene::CapturePrefab(Prefab& prefab, Entity root)
+	{
+		OPTICK_EVENT();
+
+		prefab.Clear();
+
+		eastl::vector<entt::entity> nodes;
+		nodes.push_back(root);
+		prefab.m_Parents.push_back(Prefab::k_InvalidIndex);
+
+		for (uint32_t node = 0; node < nodes.size(); ++node)
+		{
+			const entt::entity entity = nodes[node];
+			const auto& children = m_Registry.get<RelationshipComponent>(entity).Children;
+
+			prefab.m_ChildCounts.push_back((uint32_t)children.size());
+			prefab.m_Tags.push_back(m_Registry.get<TagComponent>(entity));
+			prefab.m_Transforms.push_back(m_Registry.get<TransformComponent>(entity));
+			CapturePrefabComponent(m_Registry, entity, node, prefab.m_Meshes);
+			CapturePrefabComponent(m_Registry, entity, node, prefab.m_PointLights);
+			CapturePrefabComponent(m_Registry, entity, node, prefab.m_DirectionalLights);
+
+			for (UUID child : children)
+			{
+				nodes.push_back(m_EntityMap.at(child));
+				prefab.m_Parents.push_back(node);
+			}
+		}
+	}
+
+	static_assert(std::is_trivially_copyable_v<TransformComponent>, "TransformComponent is expected to take the memcpy path");
+	static_assert(std::is_trivially_copyable_v<PointLightComponent>, "PointLightComponent is expected to take the memcpy path");
+	static_assert(std::is_trivially_copyable_v<DirectionalLightComponent>, "DirectionalLightComponent is expected to take the memcpy path");
+
+	// Pools are copied with one range insert, which is a single memmove for trivially copyable components
+	template<typename T>
+	static void ClonePool(const entt::registry& source, entt::registry& destination)
+	{
+		const size_t size = source.size<T>();
+		if (size == 0)
+			return;
+
+		const entt::entity* entities = source.data<T>();
+		if constexpr (std::is_empty_v<T>)
+		{
+			destination.insert<T>(entities, entities + size);
+		}
+		else
+		{
+			const T* components = source.raw<T>();
+			destination.insert<T>(entities, entities + size, components, components + size);
+		}
+	}
+
+	template<typename... T>
+	static void ClonePools(ComponentTypeList<T...>, const entt::registry& source, entt::registry& destination)
+	{
+		(ClonePool<T>(source, destination), ...);
+	}
+
+	Ref<Scene> Scene::Clone()
+	{
+		OPTICK_EVENT();
+
+		FlushDestroyedEntities();
+
+		Ref<Scene> scene = CreateRef<Scene>();
+		scene->m_Registry.assign(m_Registry.data(), m_Registry.data() + m_Registry.size());
+		ClonePools(SceneComponentTypes{}, m_Registry, scene->m_Registry);
+		scene->RebuildEntityMap();
+
+		return scene;
+	}
+
+	Ref<SceneSnapshot> Scene::CreateSnapshot()
+	{
+		OPTICK_EVENT();
+
+		FlushDestroyedEntities();
+
+		Ref<SceneSnapshot> snapshot = CreateRef<SceneSnapshot>();
+		snapshot->m_Entities.assign(m_Registry.data(), m_Registry.data() + m_Registry.size());
+		std::apply([this](auto&... pool) { (pool.Capture(m_Registry), ...); }, snapshot->m_Pools);
+
+		return snapshot;
+	}
+
+	void Scene::RestoreSnapshot(const SceneSnapshot& snapshot)
+	{
+		OPTICK_EVENT();
+
+		// A fresh registry drops every pool at once instead of destroying the entities one by one
+		m_Registry = entt::registry();
+		InitRegistry();
+		m_PendingDestroy.clear();
+
+		m_Registry.assign(snapshot.m_Entities.begin(), snapshot.m_Entities.end());
+		std::apply([this](const auto&... pool) { (pool.Restore(m_Registry), ...); }, snapshot.m_Pools);
+		RebuildEntityMap();
+	}
+
+	void Scene::RebuildEntityMap()
+	{
+		OPTICK_EVENT();
+
+		const size_t count = m_Registry.size<IDComponent>();
+		const entt::entity* entities = m_Registry.data<IDComponent>();
+		const IDComponent* ids = m_Registry.raw<IDComponent>();
+
+		m_EntityMap.clear();
+		m_EntityMap.reserve(count);
+		for (size_t i = 0; i < count; ++i)
+			m_EntityMap.emplace(ids[i].ID, Entity(entities[i], this));
+	}
+
+	template<typename T>
+	static size_t GetHeapBytes(const T& component)
+	{
+		return 0;
+	}
+
+	static size_t GetHeapBytes(const TagComponent& component)
+	{
+		// Short tags live inside the string itself
+		static const size_t ssoCapacity = eastl::string().capacity();
+		const size_t capacity = component.Tag.capacity();
+		return capacity > ssoCapacity ? capacity + 1 : 0;
+	}
+
+	static size_t GetHeapBytes(const RelationshipComponent& component)
+	{
+		return component.Children.capacity() * sizeof(UUID);
+	}
+
+	template<typename T>
+	static void AddComponentMemoryStats(const entt::registry& registry, const char* name, SceneMemoryStats& stats)
+	{
+		constexpr size_t entitiesPerPage = ENTT_PAGE_SIZE / sizeof(entt::entity);
+		constexpr size_t componentSize = std::is_empty_v<T> ? 0 : sizeof(T);
+
+		ComponentMemoryStats& component = stats.Components.push_back();
+		component.Name = name;
+		component.Count = registry.size<T>();
+
+		const size_t capacity = registry.capacity<T>();
+		component.DenseBytes = capacity * (sizeof(entt::entity) + componentSize);
+		component.SlackBytes = (capacity - component.Count) * (sizeof(entt::entity) + componentSize);
+
+		// Sparse pages are only allocated for the ranges of entity indices that are used
+		const entt::entity* entities = registry.data<T>();
+		eastl::vector<bool> pages;
+		size_t pageCount = 0;
+		for (size_t i = 0; i < component.Count; ++i)
+		{
+			const size_t page = (entt::to_integral(entities[i]) & entt::entt_traits<entt::entity>::entity_mask) / entitiesPerPage;
+			if (page >= pages.size())
+				pages.resize(page + 1, false);
+
+			if (!pages[page])
+			{
+				pages[page] = true;
+				++pageCount;
+			}
+		}
+		component.SparseBytes = pageCount * ENTT_PAGE_SIZE + pages.size() * sizeof(void*);
+
+		if constexpr (!std::is_trivially_copyable_v<T>)
+		{
+			const T* components = registry.raw<T>();
+			for (size_t i = 0; i < component.Count; ++i)
+				component.HeapBytes += GetHeapBytes(components[i]);
+		}
+
+		stats.TotalBytes += component.DenseBytes + component.SparseBytes + component.HeapBytes;
+	}
+
+	SceneMemoryStats Scene::GetMemoryStats() const
+	{
+		OPTICK_EVENT();
+
+		SceneMemoryStats stats;
+		AddComponentMemoryStats<IDComponent>(m_Registry, "ID", stats);
+		AddComponentMemoryStats<RelationshipComponent>(m_Registry, "Relationship", stats);
+		AddComponentMemoryStats<TagComponent>(m_Registry, "Tag", stats);
+		AddComponentMemoryStats<TransformComponent>(m_Registry, "Transform", stats);
+		AddComponentMemoryStats<MeshComponent>(m_Registry, "Mesh", stats);
+		AddComponentMemoryStats<PointLightComponent>(m_Registry, "PointLight", stats);
+		AddComponentMemoryStats<DirectionalLightComponent>(m_Registry, "DirectionalLight", stats);
+		AddComponentMemoryStats<PrefabInstanceComponent>(m_Registry, "PrefabInstance", stats);
+		AddComponentMemoryStats<StateComponent>(m_Registry, "State", stats);
+		AddComponentMemoryStats<InactiveComponent>(m_Registry, "Inactive", stats);
+		AddComponentMemoryStats<HiddenComponent>(m_Registry, "Hidden", stats);
+		AddComponentMemoryStats<PendingDestroyComponent>(m_Registry, "PendingDestroy", stats);
+
+		using EntityMapNode = eastl::hash_map<UUID, Entity>::node_type;
+		stats.EntityBytes = m_Registry.capacity() * sizeof(entt::entity);
+		stats.EntityMapBytes = m_EntityMap.size() * sizeof(EntityMapNode) + m_EntityMap.bucket_count() * sizeof(EntityMapNode*);
+		stats.TotalBytes += stats.EntityBytes + stats.EntityMapBytes;
+
+		return stats;
+	}
+
+	static size_t GetEntityIndex(entt::entity entity)
+	{
+		return entt::to_integral(entity) & entt::entt_traits<entt::entity>::entity_mask;
+	}
+
+	static AABB GetWorldBounds(const TransformComponent& transform, const MeshComponent& mesh)
+	{
+		return Math::TransformAABB(mesh.MeshGeometry->GetSubmesh(mesh.SubmeshIndex).Bounds, transform.GetTransform());
+	}
+
+	void Scene::UpdateSpatialIndex()
+	{
+		OPTICK_EVENT();
+
+		if (m_SpatialIndexDirty)
+		{
+			eastl::vector<AABB> bounds;
+			eastl::vector<uint32_t> userData;
+			eastl::vector<entt::entity> entities;
+
+			auto view = m_Registry.view<TransformComponent, MeshComponent>();
+			for (auto entity : view)
+			{
+				auto [transform, mesh] = view.get<TransformComponent, MeshComponent>(entity);
+				if (!mesh.MeshGeometry)
+					continue;
+
+				bounds.push_back(GetWorldBounds(transform, mesh));
+				userData.push_back(entt::to_integral(entity));
+				entities.push_back(entity);
+			}
+
+			eastl::vector<int32_t> proxies;
+			m_SpatialIndex.Build(bounds, userData, proxies);
+
+			m_SpatialProxies.assign(m_Registry.size(), DynamicBVH::NullNode);
+			for (size_t i = 0; i < entities.size(); ++i)
+				m_SpatialProxies[GetEntityIndex(entities[i])] = proxies[i];
+
+			m_SpatialReinserts = 0;
+			m_SpatialIndexDirty = false;
+			return;
+		}
+
+		for (entt::entity entity : m_MeshChanges.GetChanged())
+			UpdateSpatialProxy(entity);
+		for (entt::entity entity : m_TransformChanges.GetChanged())
+			UpdateSpatialProxy(entity);
+
+		// Incremental inserts degrade the tree, rebuild it with the SAH once a good share of it has moved
+		if (m_SpatialReinserts > 64 && m_SpatialReinserts > m_SpatialIndex.GetProxyCount() / 4)
+		{
+			m_SpatialIndex.Rebuild();
+			m_SpatialReinserts = 0;
+		}
+	}
+
+	void Scene::UpdateSpatialProxy(entt::entity entity)
+	{
+		if (!m_Registry.valid(entity))
+			return;
+
+		const MeshComponent* mesh = m_Registry.try_get<MeshComponent>(entity);
+		if (!mesh)
+			return;
+
+		const size_t index = GetEntityIndex(entity);
+		if (index >= m_SpatialProxies.size())
+			m_SpatialProxies.resize(eastl::max(index + 1, m_SpatialProxies.size() * 2), DynamicBVH::NullNode);
+
+		int32_t& proxy = m_SpatialProxies[index];
+		if (!mesh->MeshGeometry)
+		{
+			if (proxy != DynamicBVH::NullNode)
+			{
+				m_SpatialIndex.DestroyProxy(proxy);
+				proxy = DynamicBVH::NullNode;
+			}
+			return;
+		}
+
+		const AABB bounds = GetWorldBounds(m_Registry.get<TransformComponent>(entity), *mesh);
+		if (proxy == DynamicBVH::NullNode)
+		{
+			proxy = m_SpatialIndex.CreateProxy(bounds, entt::to_integral(entity));
+			++m_SpatialReinserts;
+		}
+		else if (m_SpatialIndex.MoveProxy(proxy, bounds))
+		{
+			++m_SpatialReinserts;
+		}
+	}
+
+	constexpr static uint32_t k_NullInstanceSlot = ~0u;
+
+	uint32_t Scene::GetInstanceSlot(entt::entity entity)
+	{
+		const size_t index = GetEntityIndex(entity);
+		if (index >= m_InstanceSlots.size())
+			m_InstanceSlots.resize(eastl::max(index + 1, m_InstanceSlots.size() * 2), k_NullInstanceSlot);
+
+		uint32_t& slot = m_InstanceSlots[index];
+		if (slot != k_NullInstanceSlot)
+			return slot;
+
+		if (!m_FreeInstanceSlots.empty())
+		{
+			slot = m_FreeInstanceSlots.back();
+			m_FreeInstanceSlots.pop_back();
+		}
+		else
+		{
+			slot = (uint32_t)m_InstanceSlotDirty.size();
+			m_InstanceSlotDirty.push_back(0);
+		}
+
+		// Whatever the renderer has in the slot belongs to its previous owner
+		m_InstanceSlotDirty[slot] = 1;
+		return slot;
+	}
+
+	void Scene::MarkInstanceSlotDirty(entt::entity entity)
+	{
+		const size_t index = GetEntityIndex(entity);
+		if (index < m_InstanceSlots.size() && m_InstanceSlots[index] != k_NullInstanceSlot && m_Registry.valid(entity))
+			m_InstanceSlotDirty[m_InstanceSlots[index]] = 1;
+	}
+
+	void Scene::OnMeshDestroyed(entt::registry& registry, entt::entity entity)
+	{
+		const size_t index = GetEntityIndex(entity);
+		if (index < m_SpatialProxies.size() && m_SpatialProxies[index] != DynamicBVH::NullNode)
+		{
+			m_SpatialIndex.DestroyProxy(m_SpatialProxies[index]);
+			m_SpatialProxies[index] = DynamicBVH::NullNode;
+		}
+
+		if (index < m_InstanceSlots.size() && m_InstanceSlots[index] != k_NullInstanceSlot)
+		{
+			m_FreeInstanceSlots.push_back(m_InstanceSlots[index]);
+			m_InstanceSlots[index] = k_NullInstanceSlot;
+		}
+	}
+
+	void Scene::QueryFrustum(const Frustum& frustum, eastl::vector<Entity>& outEntities)
+	{
+		OPTICK_EVENT();
+
+		UpdateSpatialIndex();
+		auto group = GetMeshGroup(m_Registry);
+		m_SpatialIndex.QueryFrustum(frustum, [&](uint32_t userData)
+		{
+			const entt::entity entity = entt::entity(userData);
+			if (group.contains(entity))
+				outEntities.emplace_back(entity, this);
+		});
+	}
+
+	void Scene::QuerySphere(const BoundingSphere& sphere, eastl::vector<Entity>& outEntities)
+	{
+		OPTICK_EVENT();
+
+		UpdateSpatialIndex();
+		auto group = GetMeshGroup(m_Registry);
+		m_SpatialIndex.QuerySphere(sphere, [&](uint32_t userData)
+		{
+			const entt::entity entity = entt::entity(userData);
+			if (group.contains(entity))
+				outEntities.emplace_back(entity, this);
+		});
+	}
+
+	void Scene::QueryBox(const AABB& bounds, eastl::vector<Entity>& outEntities)
+	{
+		OPTICK_EVENT();
+
+		UpdateSpatialIndex();
+		auto group = GetMeshGroup(m_Registry);
+		m_SpatialIndex.QueryAABB(bounds, [&](uint32_t userData)
+		{
+			const entt::entity entity = entt::entity(userData);
+			if (group.contains(entity))
+				outEntities.emplace_back(entity, this);
+		});
+	}
+
+	Entity Scene::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float* outDistance)
+	{
+		OPTICK_EVENT();
+
+		UpdateSpatialIndex();
+		auto group = GetMeshGroup(m_Registry);
+		const glm::vec3 inverseDirection = 1.0f / direction;
+
+		entt::entity closest = entt::null;
+		float closestDistance = maxDistance;
+		m_SpatialIndex.Raycast(origin, direction, maxDistance, [&](uint32_t userData, float)
+		{
+			const entt::entity entity = entt::entity(userData);
+			if (!group.contains(entity))
+				return closestDistance;
+
+			// The tree only has the fattened bounds, test the tight ones
+			auto [transform, mesh] = group.get<TransformComponent, MeshComponent>(entity);
+			const AABB bounds = GetWorldBounds(transform, mesh);
+			const glm::vec3 t0 = (bounds.Min - origin) * inverseDirection;
+			const glm::vec3 t1 = (bounds.Max - origin) * inverseDirection;
+			const glm::vec3 tMin = glm::min(t0, t1);
+			const glm::vec3 tMax = glm::max(t0, t1);
+			const float enter = glm::max(glm::max(tMin.x, tMin.y), glm::max(tMin.z, 0.0f));
+			const float exit = glm::min(glm::min(tMax.x, tMax.y), glm::min(tMax.z, closestDistance));
+			if (enter <= exit && enter < closestDistance)
+			{
+				closest = entity;
+				closestDistance = enter;
+			}
+
+			return closestDistance;
+		});
+
+		if (outDistance && closest != entt::null)
+			*outDistance = closestDistance;
+
+		return closest == entt::null ? Entity() : Entity(closest, this);
+	}
+
 	void Scene::OnUpdateEditor(Timestep ts)
 	{
-		
+		OPTICK_EVENT();
+
+		FlushDestroyedEntities();
+		m_SystemScheduler.Run(m_Registry, ts);
 	}
 
 	void Scene::OnRenderEditor(const Camera& camera)
 	{
 		OPTICK_EVENT("SubmitMeshes");
 
-		eastl::vector<Entity> directionalLights;
-		eastl::vector<Entity> pointLights;
+		const bool structureChanged = m_TransformChanges.HasStructureChanged()
+			|| m_MeshChanges.HasStructureChanged()
+			|| m_PointLightChanges.HasStructureChanged()
+			|| m_DirectionalLightChanges.HasStructureChanged();
+
+		bool lightsChanged = structureChanged || !m_PointLightChanges.GetChanged().empty() || !m_DirectionalLightChanges.GetChanged().empty();
+
+		FrameVector<Entity> directionalLights;
+		FrameVector<Entity> pointLights;
 		
 		{
-			auto& view = m_Registry.view<TransformComponent, PointLightComponent>();
-			pointLights.reserve(view.size());
-			for (auto entity : view)
+			auto group = GetPointLightGroup(m_Registry);
+			pointLights.reserve(group.size());
+			for (auto entity : group)
+			{
 				pointLights.emplace_back(entity, this);
+				lightsChanged |= m_TransformChanges.IsChanged(entity);
+			}
 		}
 		{
-			auto& view = m_Registry.view<TransformComponent, DirectionalLightComponent>();
-			for (auto entity : view)
+			auto group = GetDirectionalLightGroup(m_Registry);
+			directionalLights.reserve(group.size());
+			for (auto entity : group)
+			{
 				directionalLights.emplace_back(entity, this);
+				lightsChanged |= m_TransformChanges.IsChanged(entity);
+			}
 		}
 
-		SceneRenderer::BeginScene(camera, pointLights, directionalLights);
+		SceneRenderer::BeginScene(camera, pointLights, directionalLights, lightsChanged);
 		{
 			OPTICK_EVENT("SubmitMeshes");
 
-			auto& view = m_Registry.view<TransformComponent, MeshComponent>();
-			for (auto entity : view)
+			UpdateSpatialIndex();
+
+			// Edits to culled entities are remembered until they are submitted again
+			for (entt::entity entity : m_TransformChanges.GetChanged())
+				MarkInstanceSlotDirty(entity);
+			for (entt::entity entity : m_MeshChanges.GetChanged())
+				MarkInstanceSlotDirty(entity);
+
+			FrameVector<entt::entity> visibleMeshes;
+			visibleMeshes.reserve(m_InstanceSlotDirty.size() - m_FreeInstanceSlots.size());
+			auto group = GetMeshGroup(m_Registry);
+			m_SpatialIndex.QueryFrustum(Frustum(camera.GetProjection() * camera.GetView()), [&](uint32_t userData)
+			{
+				const entt::entity entity = entt::entity(userData);
+				if (group.contains(entity))
+					visibleMeshes.push_back(entity);
+			});
+
+			// Casters outside the view still throw shadows into it, every cascade's light volume is queried as well
+			const size_t mainViewCount = visibleMeshes.size();
+			const ShadowCascades& cascades = SceneRenderer::GetShadowCascades();
+			if (cascades.GetCascadeCount() > 0)
+			{
+				FrameVector<uint8_t> submitted;
+				submitted.resize(m_Registry.size(), 0);
+				for (entt::entity entity : visibleMeshes)
+					submitted[GetEntityIndex(entity)] = 1;
+
+				for (uint32_t cascade = 0; cascade < cascades.GetCascadeCount(); ++cascade)
+				{
+					m_SpatialIndex.QueryFrustum(cascades.GetCascade(cascade).CasterFrustum, [&](uint32_t userData)
+					{
+						const entt::entity entity = entt::entity(userData);
+						uint8_t& seen = submitted[GetEntityIndex(entity)];
+						if (!seen && group.contains(entity))
+						{
+							seen = 1;
+							visibleMeshes.push_back(entity);
+						}
+					});
+				}
+			}
+
+			for (size_t i = 0; i < visibleMeshes.size(); ++i)
 			{
-				auto [trans, mesh] = view.get<TransformComponent, MeshComponent>(entity);
-				if (mesh.MeshGeometry)
-					SceneRenderer::SubmitMesh(mesh.MeshGeometry->GetSubmesh(mesh.SubmeshIndex), trans.GetTransform());
+				const entt::entity entity = visibleMeshes[i];
+				auto [trans, mesh] = group.get<TransformComponent, MeshComponent>(entity);
+
+				// Meshes only keep their triangles on the CPU once they are used as occluders
+				if (mesh.Occluder && !mesh.MeshGeometry->HasOccluderGeometry())
+					mesh.MeshGeometry->LoadOccluderGeometry();
+
+				// The renderer keeps instance data per slot, only slots that changed since their last submission are uploaded
+				const uint32_t slot = GetInstanceSlot(entity);
+				SceneRenderer::SubmitMesh(mesh.MeshGeometry->GetSubmesh(mesh.SubmeshIndex), trans.GetTransform(), slot, m_InstanceSlotDirty[slot], mesh.Occluder, i < mainViewCount);
+				m_InstanceSlotDirty[slot] = 0;
 			}
 		}
 		SceneRenderer::EndScene();
+
+		m_TransformChanges.Clear();
+		m_MeshChanges.Clear();
+		m_PointLightChanges.Clear();
+		m_DirectionalLightChanges.Clear();
 	}
 }
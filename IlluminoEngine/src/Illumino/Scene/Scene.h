@@ -1,36 +1,141 @@
 #pragma once
 
+#include <limits>
 #include <entt.hpp>
 #include <EASTL/hash_map.h>
 
 #include "Illumino/Core/UUID.h"
 #include "Illumino/Core/Timestep.h"
 #include "Illumino/Renderer/Camera.h"
+#include "Illumino/Math/DynamicBVH.h"
 #include "Entity.h"
+#include "SystemScheduler.h"
+#include "ComponentChangeSet.h"
 
 namespace IlluminoEngine
 {
+	class Prefab;
+	class SceneSnapshot;
+	struct TransformComponent;
+	struct MeshComponent;
+	struct PointLightComponent;
+	struct DirectionalLightComponent;
+
+	struct ComponentMemoryStats
+	{
+		const char* Name = "";
+		size_t Count = 0;
+		size_t DenseBytes = 0;		// packed entities and components, including unused capacity
+		size_t SparseBytes = 0;		// sparse pages mapping entities to packed indices
+		size_t SlackBytes = 0;		// unused capacity of the dense arrays
+		size_t HeapBytes = 0;		// owned by the components themselves, like strings and child lists
+	};
+
+	struct SceneMemoryStats
+	{
+		eastl::vector<ComponentMemoryStats> Components;
+		size_t EntityBytes = 0;		// registry entity list
+		size_t EntityMapBytes = 0;	// UUID map nodes and buckets
+		size_t TotalBytes = 0;
+	};
+
 	class Scene
 	{
 	public:
+		static constexpr uint32_t k_InvalidIndex = UINT32_MAX;
+
 		Scene();
 		virtual ~Scene() = default;
 
 		Entity CreateEntity(const char* name = "Entity");
+		eastl::vector<Entity> CreateEntities(uint32_t count, Entity parent = {}, const char* name = "Entity");
+		// Creates a whole hierarchy at once. parents[i] indexes the entity's parent in the batch and has to be smaller
+		// than i, k_InvalidIndex attaches it to parent instead. names is either empty or has one name per entity
+		eastl::vector<Entity> CreateEntities(const eastl::vector<uint32_t>& parents, const eastl::vector<const char*>& names, Entity parent = {});
 		void DeleteEntity(Entity entity);
 
+		// Detaches the entity and queues it with its whole subtree, destroyed in bulk by FlushDestroyedEntities
+		void DestroyEntity(Entity entity);
+		void FlushDestroyedEntities();
+		// False once the entity was destroyed or queued for destruction
+		bool IsValid(Entity entity);
+
 		Entity GetParent(Entity entity);
 		void SetParent(Entity entity, Entity parent);
 		void RemoveParent(Entity entity);
 
+		// Active and Visible are inherited, an entity is only active or visible in the hierarchy if all its ancestors are
+		void SetActive(Entity entity, bool active);
+		void SetVisible(Entity entity, bool visible);
+		bool IsActive(Entity entity);
+		bool IsVisible(Entity entity);
+		bool IsActiveInHierarchy(Entity entity);
+		bool IsVisibleInHierarchy(Entity entity);
+
+		Ref<Prefab> CreatePrefab(Entity root);
+		void UpdatePrefab(const Ref<Prefab>& prefab, Entity root);
+		void PropagatePrefab(const Ref<Prefab>& prefab);
+		// Marks components of a prefab instance as edited so propagation keeps them, see PrefabOverride.
+		// Does nothing for entities that are not prefab instances
+		void SetPrefabOverride(Entity entity, uint32_t overrides);
+		Entity InstantiatePrefab(const Ref<Prefab>& prefab, Entity parent = {});
+
+		// Copies every entity and component with the same handles and UUIDs, registered systems are not copied
+		Ref<Scene> Clone();
+		Ref<SceneSnapshot> CreateSnapshot();
+		void RestoreSnapshot(const SceneSnapshot& snapshot);
+
 		void OnUpdateEditor(Timestep ts);
 		void OnRenderEditor(const Camera& camera);
 
+		// Spatial queries over the active and visible mesh entities
+		void QueryFrustum(const Frustum& frustum, eastl::vector<Entity>& outEntities);
+		void QuerySphere(const BoundingSphere& sphere, eastl::vector<Entity>& outEntities);
+		void QueryBox(const AABB& bounds, eastl::vector<Entity>& outEntities);
+		// Returns the closest mesh entity whose world bounds the ray hits
+		Entity Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance = std::numeric_limits<float>::max(), float* outDistance = nullptr);
+		const DynamicBVH& GetSpatialIndex() { UpdateSpatialIndex(); return m_SpatialIndex; }
+
 		const eastl::hash_map<UUID, Entity>& GetEntityMap() const { return m_EntityMap; }
+		SceneMemoryStats GetMemoryStats() const;
+		SystemScheduler& GetSystemScheduler() { return m_SystemScheduler; }
+
+	private:
+		void InitRegistry();
+		void ReserveEntities(size_t count);
+		void CapturePrefab(Prefab& prefab, Entity root);
+		void DetachFromParent(Entity entity);
+		bool HasSameEffectiveState(Entity a, Entity b);
+		void UpdateEffectiveState(Entity root);
+		void RebuildEntityMap();
+		void UpdateSpatialIndex();
+		void UpdateSpatialProxy(entt::entity entity);
+		uint32_t GetInstanceSlot(entt::entity entity);
+		void MarkInstanceSlotDirty(entt::entity entity);
+		void OnMeshDestroyed(entt::registry& registry, entt::entity entity);
 
 	private:
 		friend class Entity;
 		entt::registry m_Registry;
 		eastl::hash_map<UUID, Entity> m_EntityMap;
+		eastl::vector<entt::entity> m_PendingDestroy;
+		SystemScheduler m_SystemScheduler;
+
+		ComponentChangeSet<TransformComponent> m_TransformChanges;
+		ComponentChangeSet<MeshComponent> m_MeshChanges;
+		ComponentChangeSet<PointLightComponent> m_PointLightChanges;
+		ComponentChangeSet<DirectionalLightComponent> m_DirectionalLightChanges;
+
+		// Proxies are indexed by entity index, the tree is built in one go when it is dirty
+		DynamicBVH m_SpatialIndex;
+		eastl::vector<int32_t> m_SpatialProxies;
+		uint32_t m_SpatialReinserts = 0;
+		bool m_SpatialIndexDirty = true;
+
+		// Renderer instance slot of every mesh entity indexed by entity index, an entity keeps its slot until its mesh
+		// component is destroyed. Dirty slots changed since they were last submitted, culled entities can change too
+		eastl::vector<uint32_t> m_InstanceSlots;
+		eastl::vector<uint32_t> m_FreeInstanceSlots;
+		eastl::vector<uint8_t> m_InstanceSlotDirty;
 	};
 }
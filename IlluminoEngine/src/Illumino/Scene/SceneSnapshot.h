@@ -0,0 +1,100 @@
+#pragma once
+
+#include <tuple>
+#include <type_traits>
+#include <entt.hpp>
+#include <EASTL/vector.h>
+
+#include "Component.h"
+
+namespace IlluminoEngine
+{
+	template<typename... T>
+	struct ComponentTypeList {};
+
+	// Every component type copied by Scene::Clone and stored in snapshots
+	using SceneComponentTypes = ComponentTypeList<IDComponent, RelationshipComponent, TagComponent, TransformComponent,
+		MeshComponent, PointLightComponent, DirectionalLightComponent, PrefabInstanceComponent,
+		StateComponent, InactiveComponent, HiddenComponent>;
+
+	// A copy of one component pool, trivially copyable components are stored as raw bytes and copied with memcpy
+	template<typename T>
+	struct ComponentSnapshot
+	{
+		static constexpr bool k_Trivial = std::is_trivially_copyable_v<T>;
+		using Storage = std::conditional_t<k_Trivial, eastl::vector<uint8_t>, eastl::vector<T>>;
+
+		eastl::vector<entt::entity> Entities;
+		Storage Components;
+
+		void Capture(const entt::registry& registry)
+		{
+			const size_t size = registry.size<T>();
+			Entities.resize(size);
+			memcpy(Entities.data(), registry.data<T>(), size * sizeof(entt::entity));
+
+			if constexpr (std::is_empty_v<T>)
+				return;
+			else if constexpr (k_Trivial)
+			{
+				Components.resize(size * sizeof(T));
+				memcpy(Components.data(), registry.raw<T>(), size * sizeof(T));
+			}
+			else
+			{
+				const T* components = registry.raw<T>();
+				Components.assign(components, components + size);
+			}
+		}
+
+		void Restore(entt::registry& registry) const
+		{
+			if (Entities.empty())
+				return;
+
+			if constexpr (std::is_empty_v<T>)
+				registry.insert<T>(Entities.begin(), Entities.end());
+			else if constexpr (k_Trivial)
+			{
+				const T* components = reinterpret_cast<const T*>(Components.data());
+				registry.insert<T>(Entities.begin(), Entities.end(), components, components + Entities.size());
+			}
+			else
+				registry.insert<T>(Entities.begin(), Entities.end(), Components.begin(), Components.end());
+		}
+
+		size_t GetMemoryUsage() const
+		{
+			return Entities.capacity() * sizeof(entt::entity) + Components.capacity() * sizeof(typename Storage::value_type);
+		}
+	};
+
+	template<typename List>
+	struct SnapshotPools;
+
+	template<typename... T>
+	struct SnapshotPools<ComponentTypeList<T...>>
+	{
+		using Type = std::tuple<ComponentSnapshot<T>...>;
+	};
+
+	class SceneSnapshot
+	{
+	public:
+		size_t GetEntityCount() const { return std::get<0>(m_Pools).Entities.size(); }
+
+		size_t GetMemoryUsage() const
+		{
+			size_t usage = m_Entities.capacity() * sizeof(entt::entity);
+			std::apply([&usage](const auto&... pool) { ((usage += pool.GetMemoryUsage()), ...); }, m_Pools);
+			return usage;
+		}
+
+	private:
+		friend class Scene;
+
+		// The registry's entity list including released identifiers, so restored handles stay the same
+		eastl::vector<entt::entity> m_Entities;
+		SnapshotPools<SceneComponentTypes>::Type m_Pools;
+	};
+}
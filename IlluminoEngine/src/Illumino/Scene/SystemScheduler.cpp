@@ -0,0 +1,114 @@
+#include "ipch.h"
+#include "SystemScheduler.h"
+
+#include <chrono>
+
+namespace IlluminoEngine
+{
+	static bool Intersects(const eastl::vector<entt::id_type>& a, const eastl::vector<entt::id_type>& b)
+	{
+		for (entt::id_type id : a)
+		{
+			if (eastl::find(b.begin(), b.end(), id) != b.end())
+				return true;
+		}
+		return false;
+	}
+
+	bool SystemAccess::ConflictsWith(const SystemAccess& other) const
+	{
+		return Intersects(m_Writes, other.m_Writes)
+			|| Intersects(m_Writes, other.m_Reads)
+			|| Intersects(m_Reads, other.m_Writes);
+	}
+
+	void SystemScheduler::AddSystem(const char* name, const SystemAccess& access, SystemFn system)
+	{
+		OPTICK_EVENT();
+
+		SystemNode& node = m_Systems.push_back();
+		node.Access = access;
+		node.Fn = eastl::move(system);
+
+		SystemTiming& timing = m_Timings.push_back();
+		timing.Name = name;
+
+		m_GraphDirty = true;
+	}
+
+	void SystemScheduler::BuildGraph()
+	{
+		OPTICK_EVENT();
+
+		// Conflicting systems keep their registration order, everything else is free to overlap
+		const uint32_t count = (uint32_t)m_Systems.size();
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			m_Systems[i].Dependents.clear();
+			m_Systems[i].DependencyCount = 0;
+			m_Timings[i].Level = 0;
+		}
+
+		for (uint32_t j = 0; j < count; ++j)
+		{
+			for (uint32_t i = 0; i < j; ++i)
+			{
+				if (!m_Systems[i].Access.ConflictsWith(m_Systems[j].Access))
+					continue;
+
+				m_Systems[i].Dependents.push_back(j);
+				++m_Systems[j].DependencyCount;
+				m_Timings[j].Level = eastl::max(m_Timings[j].Level, m_Timings[i].Level + 1);
+			}
+		}
+
+		m_RemainingDependencies = CreateScope<std::atomic<uint32_t>[]>(count);
+		m_GraphDirty = false;
+	}
+
+	void SystemScheduler::Run(entt::registry& registry, Timestep ts)
+	{
+		OPTICK_EVENT();
+
+		if (m_Systems.empty())
+			return;
+
+		if (m_GraphDirty)
+			BuildGraph();
+
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		const uint32_t count = (uint32_t)m_Systems.size();
+		for (uint32_t i = 0; i < count; ++i)
+			m_RemainingDependencies[i].store(m_Systems[i].DependencyCount, std::memory_order_relaxed);
+
+		JobCounter counter;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (m_Systems[i].DependencyCount == 0)
+				Schedule(i, registry, ts, counter);
+		}
+		JobSystem::Wait(counter);
+
+		m_LastRunTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	void SystemScheduler::Schedule(uint32_t index, entt::registry& registry, Timestep ts, JobCounter& counter)
+	{
+		JobSystem::Execute([this, index, &registry, ts, &counter]()
+		{
+			OPTICK_EVENT("System");
+			OPTICK_TAG("Name", m_Timings[index].Name.c_str());
+
+			const auto start = std::chrono::high_resolution_clock::now();
+			m_Systems[index].Fn(registry, ts);
+			m_Timings[index].Time = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+			for (uint32_t dependent : m_Systems[index].Dependents)
+			{
+				if (m_RemainingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+					Schedule(dependent, registry, ts, counter);
+			}
+		}, counter);
+	}
+}
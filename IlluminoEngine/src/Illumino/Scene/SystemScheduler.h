@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <entt.hpp>
+#include <EASTL/vector.h>
+#include <EASTL/string.h>
+
+#include "Illumino/Core/Core.h"
+#include "Illumino/Core/Timestep.h"
+#include "Illumino/Core/JobSystem.h"
+#include "Component.h"
+
+namespace IlluminoEngine
+{
+	// Components a system reads and writes, systems conflict when one writes what the other touches
+	class SystemAccess
+	{
+	public:
+		template<typename... Component>
+		SystemAccess& Read()
+		{
+			(m_Reads.push_back(entt::type_info<Component>::id()), ...);
+			return *this;
+		}
+
+		template<typename... Component>
+		SystemAccess& Write()
+		{
+			(m_Writes.push_back(entt::type_info<Component>::id()), ...);
+			return *this;
+		}
+
+		bool ConflictsWith(const SystemAccess& other) const;
+
+	private:
+		eastl::vector<entt::id_type> m_Reads;
+		eastl::vector<entt::id_type> m_Writes;
+	};
+
+	struct SystemTiming
+	{
+		eastl::string Name;
+		float Time = 0.0f;			// milliseconds
+		uint32_t Level = 0;			// longest dependency chain before the system
+	};
+
+	// Runs registered systems every frame, systems without conflicting access run in parallel on the JobSystem.
+	// Systems must not create or destroy entities or add and remove components while running.
+	class SystemScheduler
+	{
+	public:
+		using SystemFn = std::function<void(entt::registry& registry, Timestep ts)>;
+
+		static constexpr uint32_t k_DefaultChunkSize = 1024;
+
+		void AddSystem(const char* name, const SystemAccess& access, SystemFn system);
+		void Run(entt::registry& registry, Timestep ts);
+
+		const eastl::vector<SystemTiming>& GetTimings() const { return m_Timings; }
+		float GetLastRunTime() const { return m_LastRunTime; }
+
+		// Runs fn(entity, components...) over the view, split into chunks executed in parallel.
+		// Inactive subtrees and entities pending destruction are skipped.
+		template<typename... Component, typename Fn>
+		static void ParallelEach(entt::registry& registry, Fn fn, uint32_t chunkSize = k_DefaultChunkSize)
+		{
+			OPTICK_EVENT();
+
+			auto view = registry.view<Component...>(entt::exclude<InactiveComponent, PendingDestroyComponent>);
+
+			// Chunks index straight into the packed entities of the smallest pool, like the view itself iterates,
+			// and skip the entities the view filters out
+			const entt::entity* entities = nullptr;
+			size_t size = SIZE_MAX;
+			((registry.size<Component>() < size ? (void)(size = registry.size<Component>(), entities = registry.data<Component>()) : (void)0), ...);
+
+			const uint32_t count = (uint32_t)size;
+			if (count <= chunkSize || JobSystem::GetWorkerCount() == 0)
+			{
+				for (entt::entity entity : view)
+					fn(entity, view.template get<Component>(entity)...);
+				return;
+			}
+
+			JobCounter counter;
+			JobSystem::Dispatch(count, chunkSize, [&](uint32_t start, uint32_t end)
+			{
+				OPTICK_EVENT("ParallelEach Chunk");
+
+				for (uint32_t i = start; i < end; ++i)
+				{
+					if (view.contains(entities[i]))
+						fn(entities[i], view.template get<Component>(entities[i])...);
+				}
+			}, counter);
+			JobSystem::Wait(counter);
+		}
+
+	private:
+		struct SystemNode
+		{
+			SystemAccess Access;
+			SystemFn Fn;
+			eastl::vector<uint32_t> Dependents;
+			uint32_t DependencyCount = 0;
+		};
+
+		void BuildGraph();
+		void Schedule(uint32_t index, entt::registry& registry, Timestep ts, JobCounter& counter);
+
+	private:
+		eastl::vector<SystemNode> m_Systems;
+		eastl::vector<SystemTiming> m_Timings;
+		Scope<std::atomic<uint32_t>[]> m_RemainingDependencies;
+		bool m_GraphDirty = false;
+		float m_LastRunTime = 0.0f;
+	};
+}
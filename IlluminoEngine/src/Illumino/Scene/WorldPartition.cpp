@@ -0,0 +1,267 @@
+#include "ipch.h"
+#include "WorldPartition.h"
+
+#include <chrono>
+#include <filesystem>
+
+#include "Scene.h"
+#include "Prefab.h"
+#include "Component.h"
+
+namespace IlluminoEngine
+{
+	WorldPartition::WorldPartition(Scene* scene, const WorldPartitionSpec& spec)
+		: m_Scene(scene), m_Spec(spec)
+	{
+		ILLUMINO_ASSERT(m_Spec.UnloadRadius >= m_Spec.LoadRadius, "Unload radius must not be smaller than the load radius!");
+	}
+
+	WorldPartition::~WorldPartition()
+	{
+		OPTICK_EVENT();
+
+		for (auto& [key, cell] : m_Cells)
+		{
+			if (cell.LoadJob.valid())
+				cell.LoadJob.wait();
+		}
+	}
+
+	void WorldPartition::Build()
+	{
+		OPTICK_EVENT();
+
+		eastl::vector<Entity> roots;
+		for (auto [id, entity] : m_Scene->GetEntityMap())
+		{
+			if (!entity.GetParent())
+				roots.push_back(entity);
+		}
+
+		for (Entity root : roots)
+		{
+			const glm::vec3& translation = root.GetComponent<TransformComponent>().Translation;
+			const uint64_t key = GetCellKey(translation);
+
+			Cell& cell = m_Cells[key];
+			cell.Center = (glm::floor(glm::vec2(translation.x, translation.z) / m_Spec.CellSize) + 0.5f) * m_Spec.CellSize;
+
+			CellPrefab cellPrefab;
+			cellPrefab.Data = m_Scene->CreatePrefab(root);
+
+			// Keep only the mesh paths in the cell, the meshes are streamed back in when the cell loads
+			for (auto& meshComponent : cellPrefab.Data->m_Meshes.Components)
+			{
+				uint32_t pathIndex = k_InvalidIndex;
+				if (const Ref<Mesh>& mesh = meshComponent.MeshGeometry)
+				{
+					const char* filepath = mesh->GetFilepath();
+					const bool pinned = filepath[0] == '\0' || !std::filesystem::exists(filepath);
+
+					// File meshes are shared by path, pinned ones by the mesh itself
+					pathIndex = 0;
+					while (pathIndex < cell.MeshPaths.size() && (pinned
+						? cell.PinnedMeshes[pathIndex] != mesh
+						: cell.PinnedMeshes[pathIndex] || cell.MeshPaths[pathIndex] != filepath))
+						++pathIndex;
+
+					if (pathIndex == cell.MeshPaths.size())
+					{
+						if (pinned)
+							ILLUMINO_WARN("Mesh {0} has no file to stream from, it stays loaded", mesh->GetName());
+
+						cell.MeshPaths.push_back(filepath);
+						cell.MeshOccluders.push_back(0);
+						cell.PinnedMeshes.push_back(pinned ? mesh : nullptr);
+						cell.Meshes.push_back(mesh);
+					}
+					cell.MeshOccluders[pathIndex] |= meshComponent.Occluder;
+
+					if (!pinned)
+						m_MeshCache[filepath] = mesh;
+				}
+
+				cellPrefab.MeshPathIndices.push_back(pathIndex);
+				meshComponent.MeshGeometry = nullptr;
+			}
+
+			cell.Prefabs.push_back(eastl::move(cellPrefab));
+			m_Scene->DeleteEntity(root);
+		}
+
+		m_Stats.CellCount = (uint32_t)m_Cells.size();
+	}
+
+	void WorldPartition::Update(const glm::vec3& cameraPosition)
+	{
+		OPTICK_EVENT();
+
+		const glm::vec2 camera = glm::vec2(cameraPosition.x, cameraPosition.z);
+		const glm::vec2 halfExtent = glm::vec2(m_Spec.CellSize * 0.5f);
+
+		m_Stats.ResidentCells = 0;
+		m_Stats.LoadingCells = 0;
+		m_Stats.PendingIntegrations = 0;
+
+		for (auto& [key, cell] : m_Cells)
+		{
+			// Distance from the camera to the closest point of the cell
+			const float distance = glm::length(glm::max(glm::abs(camera - cell.Center) - halfExtent, glm::vec2(0.0f)));
+
+			if (distance < m_Spec.LoadRadius)
+				cell.WantsResident = true;
+			else if (distance > m_Spec.UnloadRadius)
+				cell.WantsResident = false;
+
+			if (cell.WantsResident && cell.State == CellState::Unloaded)
+				BeginLoad(cell);
+			else if (!cell.WantsResident && cell.State == CellState::Resident)
+				Unload(cell);
+
+			m_Stats.ResidentCells += cell.State == CellState::Resident;
+			m_Stats.LoadingCells += cell.State == CellState::Loading;
+		}
+
+		const auto start = std::chrono::high_resolution_clock::now();
+		float elapsed = 0.0f;
+		uint32_t integrations = 0;
+		for (auto& [key, cell] : m_Cells)
+		{
+			if (cell.State != CellState::Loading || cell.LoadJob.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+				continue;
+
+			// The camera moved away while the cell was loading
+			if (!cell.WantsResident)
+			{
+				cell.LoadJob.get();
+				cell.Meshes.clear();
+				cell.State = CellState::Unloaded;
+				--m_Stats.LoadingCells;
+				continue;
+			}
+
+			if (integrations >= m_Spec.MaxIntegrationsPerFrame || elapsed >= m_Spec.IntegrationBudget)
+			{
+				++m_Stats.PendingIntegrations;
+				continue;
+			}
+
+			Integrate(cell);
+			++integrations;
+			--m_Stats.LoadingCells;
+			++m_Stats.ResidentCells;
+
+			elapsed = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		}
+
+		m_Stats.LastIntegrationTime = elapsed;
+		m_Stats.MaxIntegrationTime = eastl::max(m_Stats.MaxIntegrationTime, elapsed);
+		if (elapsed > m_Spec.IntegrationBudget)
+			++m_Stats.Hitches;
+	}
+
+	uint64_t WorldPartition::GetCellKey(const glm::vec3& position) const
+	{
+		const int32_t x = (int32_t)glm::floor(position.x / m_Spec.CellSize);
+		const int32_t z = (int32_t)glm::floor(position.z / m_Spec.CellSize);
+		return ((uint64_t)(uint32_t)x << 32) | (uint64_t)(uint32_t)z;
+	}
+
+	void WorldPartition::BeginLoad(Cell& cell)
+	{
+		OPTICK_EVENT();
+
+		// Meshes still alive in the scene are shared, only the missing ones are imported on the worker
+		cell.Meshes.resize(cell.MeshPaths.size());
+		eastl::vector<eastl::string> paths(cell.MeshPaths.size());
+		for (size_t i = 0; i < cell.Meshes.size(); ++i)
+		{
+			if (cell.PinnedMeshes[i])
+				cell.Meshes[i] = cell.PinnedMeshes[i];
+
+			auto it = m_MeshCache.find(cell.MeshPaths[i]);
+			if (!cell.Meshes[i] && it != m_MeshCache.end())
+				cell.Meshes[i] = it->second.lock();
+
+			if (!cell.Meshes[i])
+				paths[i] = cell.MeshPaths[i];
+		}
+
+		// The worker must not touch the renderer, the D3D12 backend records texture uploads into the shared frame command list
+		cell.LoadJob = std::async(std::launch::async, [paths = eastl::move(paths)]()
+		{
+			OPTICK_THREAD("WorldPartition Streaming");
+
+			eastl::vector<MeshSource> sources(paths.size());
+			for (size_t i = 0; i < paths.size(); ++i)
+			{
+				if (!paths[i].empty())
+					sources[i].Import(paths[i].c_str());
+			}
+
+			return sources;
+		});
+
+		cell.State = CellState::Loading;
+		++m_Stats.LoadsIssued;
+	}
+
+	void WorldPartition::Integrate(Cell& cell)
+	{
+		OPTICK_EVENT();
+
+		const eastl::vector<MeshSource> sources = cell.LoadJob.get();
+		eastl::vector<Ref<Mesh>>& meshes = cell.Meshes;
+		for (size_t i = 0; i < meshes.size(); ++i)
+		{
+			if (meshes[i])
+				continue;
+
+			// Another cell may have created the mesh while this one was loading
+			auto it = m_MeshCache.find(cell.MeshPaths[i]);
+			if (it != m_MeshCache.end())
+				meshes[i] = it->second.lock();
+
+			if (!meshes[i])
+			{
+				meshes[i] = CreateRef<Mesh>(sources[i], cell.MeshOccluders[i] != 0);
+				m_MeshCache[cell.MeshPaths[i]] = meshes[i];
+			}
+		}
+
+		for (auto& cellPrefab : cell.Prefabs)
+		{
+			auto& meshComponents = cellPrefab.Data->m_Meshes.Components;
+			for (size_t i = 0; i < meshComponents.size(); ++i)
+			{
+				const uint32_t pathIndex = cellPrefab.MeshPathIndices[i];
+				meshComponents[i].MeshGeometry = pathIndex != k_InvalidIndex ? meshes[pathIndex] : nullptr;
+			}
+
+			cell.Roots.push_back(m_Scene->InstantiatePrefab(cellPrefab.Data));
+
+			// The instances own the meshes now, the cell data must not keep them alive once unloaded
+			for (auto& meshComponent : meshComponents)
+				meshComponent.MeshGeometry = nullptr;
+		}
+
+		meshes.clear();
+		cell.State = CellState::Resident;
+	}
+
+	void WorldPartition::Unload(Cell& cell)
+	{
+		OPTICK_EVENT();
+
+		// Roots the user deleted in the meantime are already gone
+		for (Entity root : cell.Roots)
+		{
+			if (m_Scene->IsValid(root))
+				m_Scene->DestroyEntity(root);
+		}
+
+		cell.Roots.clear();
+		cell.State = CellState::Unloaded;
+		++m_Stats.Unloads;
+	}
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <future>
+#include <EASTL/vector.h>
+#include <EASTL/string.h>
+#include <EASTL/hash_map.h>
+#include <glm/glm.hpp>
+
+#include "Illumino/Core/Core.h"
+#include "Illumino/Renderer/Mesh.h"
+#include "Entity.h"
+
+namespace IlluminoEngine
+{
+	class Scene;
+	class Prefab;
+
+	struct WorldPartitionSpec
+	{
+		float CellSize = 64.0f;
+
+		// Cells load inside LoadRadius and unload outside UnloadRadius, the gap between them is the hysteresis band
+		float LoadRadius = 128.0f;
+		float UnloadRadius = 160.0f;
+
+		// Loaded cells are integrated into the scene on the main thread within this budget
+		uint32_t MaxIntegrationsPerFrame = 2;
+		float IntegrationBudget = 2.0f;		// milliseconds
+	};
+
+	struct WorldPartitionStats
+	{
+		uint32_t CellCount = 0;
+		uint32_t ResidentCells = 0;
+		uint32_t LoadingCells = 0;
+		uint32_t PendingIntegrations = 0;
+
+		uint32_t LoadsIssued = 0;
+		uint32_t Unloads = 0;
+		uint32_t Hitches = 0;				// frames where integration exceeded the budget
+
+		float LastIntegrationTime = 0.0f;	// milliseconds
+		float MaxIntegrationTime = 0.0f;	// milliseconds
+	};
+
+	// Groups the root entities of a scene into square cells on the XZ plane.
+	// Every cell keeps its own captured copy of its entities and the paths of the meshes they use,
+	// so cells are streamed in and out of the scene independently, meshes and textures included.
+	// Files are read and decoded on a worker, GPU resources are only created on the main thread.
+	class WorldPartition
+	{
+	public:
+		WorldPartition(Scene* scene, const WorldPartitionSpec& spec = {});
+		virtual ~WorldPartition();
+
+		// Moves every root entity of the scene into the cell containing its translation, all cells start unloaded
+		void Build();
+		void Update(const glm::vec3& cameraPosition);
+
+		const WorldPartitionSpec& GetSpecification() const { return m_Spec; }
+		const WorldPartitionStats& GetStats() const { return m_Stats; }
+
+	private:
+		enum class CellState
+		{
+			Unloaded = 0, Loading, Resident
+		};
+
+		struct CellPrefab
+		{
+			Ref<Prefab> Data;
+			eastl::vector<uint32_t> MeshPathIndices;	// one per mesh component in Data
+		};
+
+		struct Cell
+		{
+			glm::vec2 Center = glm::vec2(0.0f);
+			eastl::vector<CellPrefab> Prefabs;
+			eastl::vector<eastl::string> MeshPaths;
+			// One per mesh path, set when a component uses the mesh as an occluder so its triangles are kept on the CPU
+			eastl::vector<uint8_t> MeshOccluders;
+			// One per mesh path, set for meshes without a file on disk. They can't be read back, so the cell keeps them loaded
+			eastl::vector<Ref<Mesh>> PinnedMeshes;
+			eastl::vector<Entity> Roots;
+
+			CellState State = CellState::Unloaded;
+			bool WantsResident = false;
+			// One per mesh path. Meshes that were still alive when the load began are shared, the job imports
+			// the others and Integrate creates their GPU resources on the main thread. Build fills it with the meshes
+			// the scene already had, so the first load doesn't import them again
+			eastl::vector<Ref<Mesh>> Meshes;
+			std::future<eastl::vector<MeshSource>> LoadJob;
+		};
+
+		uint64_t GetCellKey(const glm::vec3& position) const;
+		void BeginLoad(Cell& cell);
+		void Integrate(Cell& cell);
+		void Unload(Cell& cell);
+
+	private:
+		static constexpr uint32_t k_InvalidIndex = UINT32_MAX;
+
+		Scene* m_Scene;
+		WorldPartitionSpec m_Spec;
+		WorldPartitionStats m_Stats;
+
+		eastl::hash_map<uint64_t, Cell> m_Cells;
+		eastl::hash_map<eastl::string, std::weak_ptr<Mesh>> m_MeshCache;
+	};
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Illumino/Core/Core.h"
+
+#include <EASTL/vector.h>
+#include <optick.h>
+
+namespace IlluminoEngine
+{
+	class SortUtils
+	{
+	public:
+		// LSD radix sort on 64 bit keys, one byte per pass. Values are moved along with their keys,
+		// the sort is stable and passes where every key has the same byte are skipped.
+		// The temp vectors are scratch space so callers can keep them around between frames.
+		inline static void RadixSort(eastl::vector<uint64_t>& keys, eastl::vector<uint32_t>& values,
+			eastl::vector<uint64_t>& tempKeys, eastl::vector<uint32_t>& tempValues)
+		{
+			OPTICK_EVENT();
+
+			const size_t count = keys.size();
+			if (count < 2)
+				return;
+
+			uint32_t histograms[8][256] = {};
+			for (const uint64_t key : keys)
+			{
+				for (uint32_t pass = 0; pass < 8; ++pass)
+					++histograms[pass][(key >> (pass * 8)) & 0xFF];
+			}
+
+			tempKeys.resize(count);
+			tempValues.resize(count);
+
+			uint64_t* srcKeys = keys.data();
+			uint32_t* srcValues = values.data();
+			uint64_t* dstKeys = tempKeys.data();
+			uint32_t* dstValues = tempValues.data();
+
+			for (uint32_t pass = 0; pass < 8; ++pass)
+			{
+				uint32_t* histogram = histograms[pass];
+				const uint32_t shift = pass * 8;
+				if (histogram[(srcKeys[0] >> shift) & 0xFF] == count)
+					continue;
+
+				uint32_t offset = 0;
+				for (uint32_t bucket = 0; bucket < 256; ++bucket)
+				{
+					const uint32_t bucketCount = histogram[bucket];
+					histogram[bucket] = offset;
+					offset += bucketCount;
+				}
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					const uint32_t destination = histogram[(srcKeys[i] >> shift) & 0xFF]++;
+					dstKeys[destination] = srcKeys[i];
+					dstValues[destination] = srcValues[i];
+				}
+
+				eastl::swap(srcKeys, dstKeys);
+				eastl::swap(srcValues, dstValues);
+			}
+
+			// An odd number of passes leaves the result in the temp vectors
+			if (srcKeys != keys.data())
+			{
+				keys.swap(tempKeys);
+				values.swap(tempValues);
+			}
+		}
+	};
+}
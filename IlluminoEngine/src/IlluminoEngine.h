@@ -11,6 +11,8 @@
 #include "Illumino/Core/Assert.h"
 #include "Illumino/Core/Timestep.h"
 #include "Illumino/Core/UUID.h"
+#include "Illumino/Core/JobSystem.h"
+#include "Illumino/Core/FrameAllocator.h"
 
 //-----ImGui---------------------------------------
 #include "Illumino/ImGui/ImGuiLayer.h"
@@ -29,6 +31,10 @@
 #include "Illumino/Scene/Scene.h"
 #include "Illumino/Scene/Entity.h"
 #include "Illumino/Scene/Component.h"
+#include "Illumino/Scene/Prefab.h"
+#include "Illumino/Scene/WorldPartition.h"
+#include "Illumino/Scene/SystemScheduler.h"
+#include "Illumino/Scene/SceneSnapshot.h"
 
 #include "Illumino/Utils/StringUtils.h"
 
@@ -78,6 +78,7 @@ namespace IlluminoEngine
 		factory->Release();
 
 		CreateAllocatorsAndCommandLists();
+		CreateUploadBuffer(4 * 1024 * 1024);
 
 		WaitForFence(m_Fences[m_CurrentBackBuffer], m_FenceValues[m_CurrentBackBuffer], m_FenceEvents[m_CurrentBackBuffer]);
 		PrepareRender();
@@ -114,6 +115,7 @@ namespace IlluminoEngine
 
 			const uint64_t fenceValue = m_CurrentFenceValue;
 			m_CommandQueue->Signal(m_Fences[m_CurrentBackBuffer], fenceValue);
+			m_UploadRing.FinishFrame(fenceValue);
 			m_FenceValues[m_CurrentBackBuffer] = fenceValue;
 			++m_CurrentFenceValue;
 			m_CurrentBackBuffer = m_RenderSurface->GetBackBufferIndex();// (m_CurrentBackBuffer + 1) % g_QueueSlotCount;
@@ -173,6 +175,16 @@ namespace IlluminoEngine
 #endif // ENABLE_DX12_DEBUG_MESSAGES
 #endif // ILLUMINO_DEBUG
 
+		for (auto& retired : m_RetiredUploadBuffers)
+		{
+			for (ID3D12Resource* buffer : retired)
+				buffer->Release();
+			retired.clear();
+		}
+		m_UploadBuffer->Release();
+		m_UploadBuffer = nullptr;
+		m_UploadBufferData = nullptr;
+
 		for (size_t i = 0; i < g_QueueSlotCount; ++i)
 		{
 			m_CommandLists[i]->Release();
@@ -394,22 +406,26 @@ namespace IlluminoEngine
 			ProcessDeferredReleases(m_CurrentBackBuffer);
 		}
 
+		// The queue executes in order, the newest completed fence covers every earlier frame
+		uint64_t completedFenceValue = 0;
+		for (ID3D12Fence* fence : m_Fences)
+			completedFenceValue = std::max<uint64_t>(completedFenceValue, fence->GetCompletedValue());
+		m_UploadRing.Reclaim(completedFenceValue);
+
+		for (ID3D12Resource* buffer : m_RetiredUploadBuffers[m_CurrentBackBuffer])
+			buffer->Release();
+		m_RetiredUploadBuffers[m_CurrentBackBuffer].clear();
+
 		m_CommandAllocators[m_CurrentBackBuffer]->Reset();
 
 		auto commandList = m_CommandLists[m_CurrentBackBuffer];
 		commandList->Reset(m_CommandAllocators[m_CurrentBackBuffer], nullptr);
 
 		D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = m_RenderSurface->GetRTV();
-
-		commandList->OMSetRenderTargets(1, &rtvHandle, false, nullptr);
+		SetRenderTargets(&rtvHandle, nullptr, m_RenderSurface->GetWidth(), m_RenderSurface->GetHeight());
 
 		ID3D12DescriptorHeap* descHeap = const_cast<ID3D12DescriptorHeap*>(m_SRVDescriptorHeap.GetHeap());
         commandList->SetDescriptorHeaps(1, &descHeap);
-		
-		auto& viewport = m_RenderSurface->GetViewport();
-		auto& scissorRect = m_RenderSurface->GetScissorRect();
-		commandList->RSSetViewports(1, &viewport);
-		commandList->RSSetScissorRects(1, &scissorRect);
 
 		// Transition back buffer
 		D3D12_RESOURCE_BARRIER barrier;
@@ -461,6 +477,33 @@ namespace IlluminoEngine
 		commandList->SetGraphicsRootSignature(rootSignature);
 	}
 
+	void Dx12GraphicsContext::SetRenderTargets(const D3D12_CPU_DESCRIPTOR_HANDLE* rtv, const D3D12_CPU_DESCRIPTOR_HANDLE* dsv, uint32_t width, uint32_t height)
+	{
+		OPTICK_EVENT();
+
+		m_HasBoundRTV = rtv != nullptr;
+		m_HasBoundDSV = dsv != nullptr;
+		m_BoundRTV = rtv ? *rtv : D3D12_CPU_DESCRIPTOR_HANDLE{};
+		m_BoundDSV = dsv ? *dsv : D3D12_CPU_DESCRIPTOR_HANDLE{};
+		m_BoundWidth = width;
+		m_BoundHeight = height;
+
+		RestoreRenderTargets();
+	}
+
+	void Dx12GraphicsContext::RestoreRenderTargets()
+	{
+		OPTICK_EVENT();
+
+		auto commandList = m_CommandLists[m_CurrentBackBuffer];
+		commandList->OMSetRenderTargets(m_HasBoundRTV ? 1 : 0, m_HasBoundRTV ? &m_BoundRTV : nullptr, false, m_HasBoundDSV ? &m_BoundDSV : nullptr);
+
+		D3D12_VIEWPORT viewport = { 0.0f, 0.0f, (float)m_BoundWidth, (float)m_BoundHeight, 0.0f, 1.0f };
+		D3D12_RECT scissorRect = { 0, 0, (LONG)m_BoundWidth, (LONG)m_BoundHeight };
+		commandList->RSSetViewports(1, &viewport);
+		commandList->RSSetScissorRects(1, &scissorRect);
+	}
+
 	void Dx12GraphicsContext::BindMeshBuffer(MeshBuffer& mesh)
 	{
 		OPTICK_EVENT();
@@ -497,4 +540,37 @@ namespace IlluminoEngine
 		ILLUMINO_ASSERT(SUCCEEDED(hr), "Could not create constant buffer");
 		return ret;
 	}
+
+	uint64_t Dx12GraphicsContext::AllocateUpload(size_t size, size_t alignment, uint8_t** outData)
+	{
+		OPTICK_EVENT();
+
+		size_t offset = m_UploadRing.Allocate(size, alignment);
+		if (offset == UploadRing::InvalidOffset)
+		{
+			// Frames in flight still read the old buffer, it is released once the current frame has finished
+			const size_t capacity = m_UploadRing.GetGrowCapacity(size, alignment);
+			ILLUMINO_WARN("Upload ring is full, growing it to {0} KB", capacity / 1024);
+
+			m_RetiredUploadBuffers[m_CurrentBackBuffer].push_back(m_UploadBuffer);
+			CreateUploadBuffer(capacity);
+
+			offset = m_UploadRing.Allocate(size, alignment);
+			ILLUMINO_ASSERT(offset != UploadRing::InvalidOffset, "Upload ring allocation failed after growing!");
+		}
+
+		*outData = m_UploadBufferData + offset;
+		return m_UploadBuffer->GetGPUVirtualAddress() + offset;
+	}
+
+	void Dx12GraphicsContext::CreateUploadBuffer(size_t size)
+	{
+		OPTICK_EVENT();
+
+		// Upload heap memory can stay mapped for the lifetime of the resource
+		m_UploadBuffer = CreateConstantBuffer(size);
+		m_UploadBuffer->SetName(L"Upload Ring");
+		m_UploadBuffer->Map(0, nullptr, reinterpret_cast<void**>(&m_UploadBufferData));
+		m_UploadRing.Reset(size);
+	}
 }
@@ -5,6 +5,7 @@
 
 #include "Illumino/Renderer/GraphicsContext.h"
 #include "Illumino/Renderer/Shader.h"
+#include "Illumino/Renderer/UploadRing.h"
 #include "Dx12Resources.h"
 #include "Dx12RenderSurface.h"
 
@@ -49,9 +50,18 @@ namespace IlluminoEngine
 		void CreatePipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& psoDesc, ID3D12PipelineState** pipelineState);
 		ID3D12Resource* CreateConstantBuffer(size_t sizeAligned);
 
+		// Sub-allocates from the persistently mapped upload ring, valid until the GPU has finished the current frame
+		uint64_t AllocateUpload(size_t size, size_t alignment, uint8_t** outData);
+		void CreateUploadBuffer(size_t size);
+
 		void BindShader(ID3D12PipelineState* pso, ID3D12RootSignature* rootSignature);
 		void BindMeshBuffer(MeshBuffer& mesh);
 
+		// Binds the targets and a viewport covering them. They are remembered, so passes that bind their own
+		// targets in between, like the shadow map, can put them back with RestoreRenderTargets
+		void SetRenderTargets(const D3D12_CPU_DESCRIPTOR_HANDLE* rtv, const D3D12_CPU_DESCRIPTOR_HANDLE* dsv, uint32_t width, uint32_t height);
+		void RestoreRenderTargets();
+
 		void SetDeferredReleasesFlag() { m_DeferredReleasesFlag[m_CurrentBackBuffer] = 1; }
 		void DeferredRelease(IUnknown** resource);
 		void ProcessDeferredReleases(const uint32_t frameIndex);
@@ -78,6 +88,19 @@ namespace IlluminoEngine
 		std::vector<IUnknown**> m_DeferredReleases[g_QueueSlotCount];
 		uint32_t m_DeferredReleasesFlag[g_QueueSlotCount];
 
+		ID3D12Resource* m_UploadBuffer = nullptr;
+		uint8_t* m_UploadBufferData = nullptr;
+		UploadRing m_UploadRing;
+		// Replaced upload buffers, released once the frame that retired them has finished
+		eastl::vector<ID3D12Resource*> m_RetiredUploadBuffers[g_QueueSlotCount];
+
+		D3D12_CPU_DESCRIPTOR_HANDLE m_BoundRTV = {};
+		D3D12_CPU_DESCRIPTOR_HANDLE m_BoundDSV = {};
+		bool m_HasBoundRTV = false;
+		bool m_HasBoundDSV = false;
+		uint32_t m_BoundWidth = 0;
+		uint32_t m_BoundHeight = 0;
+
 		DescriptorHeap m_RTVDescriptorHeap{ D3D12_DESCRIPTOR_HEAP_TYPE_RTV };
 		DescriptorHeap m_DSVDescriptorHeap{ D3D12_DESCRIPTOR_HEAP_TYPE_DSV };
 		DescriptorHeap m_SRVDescriptorHeap{ D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV };
@@ -89,6 +112,7 @@ namespace IlluminoEngine
 		friend class Dx12Shader;
 		friend class Dx12Texture2D;
 		friend class Dx12RenderTexture;
+		friend class Dx12ShadowMap;
 		friend class DescriptorHeap;
 		static Dx12GraphicsContext* s_Context;
 	};
@@ -151,17 +151,12 @@ namespace IlluminoEngine
 		auto& data = m_RenderTargets[Dx12GraphicsContext::s_Context->m_CurrentBackBuffer];
 
 		auto commandList = Dx12GraphicsContext::s_Context->GetCommandList();
-		commandList->OMSetRenderTargets(1, &data.RTVHandle.CPU, true, &data.DSVHandle.CPU);
+		Dx12GraphicsContext::s_Context->SetRenderTargets(&data.RTVHandle.CPU, &data.DSVHandle.CPU, m_Specification.Width, m_Specification.Height);
 		commandList->ClearRenderTargetView(data.RTVHandle.CPU, glm::value_ptr(m_ClearColor), 0, nullptr);
 
 		D3D12_CLEAR_VALUE depthClearValue = { DXGI_FORMAT_D32_FLOAT, {} };
 		memset(depthClearValue.Color, 1.0f, sizeof(depthClearValue.Color));
 		commandList->ClearDepthStencilView(data.DSVHandle.CPU, D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, m_ClearDepth.r, m_ClearDepth.g, 0, nullptr);
-
-		D3D12_VIEWPORT viewport = { 0.0f, 0.0f, (float)m_Specification.Width, (float)m_Specification.Height, 0.0f, 1.0f };
-		D3D12_RECT scissorRect = { 0, 0, m_Specification.Width, m_Specification.Height };
-		commandList->RSSetViewports(1, &viewport);
-		commandList->RSSetScissorRects(1, &scissorRect);
 		
 		TransitionTo(data.ColorState, D3D12_RESOURCE_STATE_RENDER_TARGET, data.ColorResource, commandList);
 		TransitionTo(data.DepthState, D3D12_RESOURCE_STATE_DEPTH_WRITE, data.DepthResource, commandList);
@@ -179,12 +174,7 @@ namespace IlluminoEngine
 		auto width = Dx12GraphicsContext::s_Context->m_RenderSurface->GetWidth();
 		auto height = Dx12GraphicsContext::s_Context->m_RenderSurface->GetHeight();
 
-		commandList->OMSetRenderTargets(1, &rtv, true, nullptr);
-
-		D3D12_VIEWPORT viewport = { 0.0f, 0.0f, (float)width, (float)height, 0.0f, 1.0f };
-		D3D12_RECT scissorRect = { 0, 0, width, height };
-		commandList->RSSetViewports(1, &viewport);
-		commandList->RSSetScissorRects(1, &scissorRect);
+		Dx12GraphicsContext::s_Context->SetRenderTargets(&rtv, nullptr, width, height);
 		
 		TransitionTo(data.ColorState, D3D12_RESOURCE_STATE_RENDER_TARGET, data.ColorResource, commandList);
 		TransitionTo(data.DepthState, D3D12_RESOURCE_STATE_DEPTH_WRITE, data.DepthResource, commandList);
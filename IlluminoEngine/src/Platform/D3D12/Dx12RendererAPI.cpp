@@ -3,6 +3,9 @@
 
 #include <glm/gtc/type_ptr.hpp>
 
+#include "Illumino/Renderer/Shader.h"
+#include "Illumino/Renderer/Texture.h"
+#include "Illumino/Renderer/ShadowMap.h"
 #include "Dx12GraphicsContext.h"
 
 namespace IlluminoEngine
@@ -44,4 +47,128 @@ namespace IlluminoEngine
 
 		commandList->DrawIndexedInstanced(meshBuffer->GetIndexCount(), 1, 0, 0, 0);
 	}
+
+	void Dx12RendererAPI::DrawIndexedInstanced(const Ref<MeshBuffer>& meshBuffer, uint32_t instanceCount, uint32_t startInstance)
+	{
+		meshBuffer->Bind();
+
+		ID3D12GraphicsCommandList* commandList = Dx12GraphicsContext::s_Context->GetCommandList();
+
+		OPTICK_GPU_CONTEXT(commandList);
+		OPTICK_GPU_EVENT("DrawIndexedInstanced");
+
+		commandList->DrawIndexedInstanced(meshBuffer->GetIndexCount(), instanceCount, 0, 0, startInstance);
+	}
+
+	uint32_t Dx12RendererAPI::GetFrameIndex()
+	{
+		return Dx12GraphicsContext::s_Context->GetCurrentBackBufferIndex();
+	}
+
+	uint64_t Dx12RendererAPI::UploadTransient(const void* data, size_t size, size_t alignment)
+	{
+		OPTICK_EVENT();
+
+		uint8_t* dst;
+		const uint64_t gpuAddress = Dx12GraphicsContext::s_Context->AllocateUpload(size, alignment, &dst);
+		memcpy(dst, data, size);
+		return gpuAddress;
+	}
+
+	void Dx12RendererAPI::Submit(const CommandBuffer& commandBuffer)
+	{
+		OPTICK_EVENT();
+
+		ID3D12GraphicsCommandList* commandList = Dx12GraphicsContext::s_Context->GetCommandList();
+
+		OPTICK_GPU_CONTEXT(commandList);
+		OPTICK_GPU_EVENT("Submit");
+
+		commandBuffer.ForEach([commandList](const CommandHeader& header)
+		{
+			switch (header.Type)
+			{
+				case CommandType::ClearColor:
+				{
+					const auto& command = (const ClearColorCommand&)header;
+					commandList->ClearRenderTargetView(Dx12GraphicsContext::s_Context->GetRenderTargetHandle(), glm::value_ptr(command.Color), 0, nullptr);
+					break;
+				}
+				case CommandType::BindPipeline:
+				{
+					((const BindPipelineCommand&)header).PipelineShader->BindPipeline();
+					break;
+				}
+				case CommandType::BindConstantBuffer:
+				{
+					const auto& command = (const BindConstantBufferCommand&)header;
+					commandList->SetGraphicsRootConstantBufferView(command.Slot, command.Handle);
+					break;
+				}
+				case CommandType::BindStructuredBuffer:
+				{
+					const auto& command = (const BindStructuredBufferCommand&)header;
+					commandList->SetGraphicsRootDescriptorTable(command.Slot, { command.Handle });
+					break;
+				}
+				case CommandType::BindShaderResource:
+				{
+					const auto& command = (const BindShaderResourceCommand&)header;
+					commandList->SetGraphicsRootShaderResourceView(command.Slot, command.Handle);
+					break;
+				}
+				case CommandType::BindTexture:
+				{
+					const auto& command = (const BindTextureCommand&)header;
+					commandList->SetGraphicsRootDescriptorTable(command.Slot, { command.Texture->GetRendererID() });
+					break;
+				}
+				case CommandType::SetConstant:
+				{
+					const auto& command = (const SetConstantCommand&)header;
+					commandList->SetGraphicsRoot32BitConstant(command.Slot, command.Value, 0);
+					break;
+				}
+				case CommandType::DrawIndexed:
+				{
+					MeshBuffer* mesh = ((const DrawIndexedCommand&)header).Mesh;
+					mesh->Bind();
+					commandList->DrawIndexedInstanced(mesh->GetIndexCount(), 1, 0, 0, 0);
+					break;
+				}
+				case CommandType::DrawIndexedInstanced:
+				{
+					const auto& command = (const DrawIndexedInstancedCommand&)header;
+					command.Mesh->Bind();
+					commandList->DrawIndexedInstanced(command.Mesh->GetIndexCount(), command.InstanceCount, 0, 0, command.StartInstance);
+					break;
+				}
+				case CommandType::BeginShadowMap:
+				{
+					((const BeginShadowMapCommand&)header).Map->BeginRender();
+					break;
+				}
+				case CommandType::SetShadowCascade:
+				{
+					const auto& command = (const SetShadowCascadeCommand&)header;
+					command.Map->SetCascade(command.Cascade);
+					break;
+				}
+				case CommandType::EndShadowMap:
+				{
+					((const EndShadowMapCommand&)header).Map->EndRender();
+					break;
+				}
+				case CommandType::BindShadowMap:
+				{
+					const auto& command = (const BindShadowMapCommand&)header;
+					command.Map->Bind(command.Slot);
+					break;
+				}
+				default:
+					ILLUMINO_ASSERT(false, "Unknown command type");
+					break;
+			}
+		});
+	}
 }
@@ -15,5 +15,9 @@ namespace IlluminoEngine
 		virtual void SetViewportSize(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
 		virtual void ClearColor(const glm::vec4& color) override;
 		virtual void DrawIndexed(const Ref<MeshBuffer>& meshBuffer) override;
+		virtual void DrawIndexedInstanced(const Ref<MeshBuffer>& meshBuffer, uint32_t instanceCount, uint32_t startInstance) override;
+		virtual uint32_t GetFrameIndex() override;
+		virtual uint64_t UploadTransient(const void* data, size_t size, size_t alignment) override;
+		virtual void Submit(const CommandBuffer& commandBuffer) override;
 	};
 }
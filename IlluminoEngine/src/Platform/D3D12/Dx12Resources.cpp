@@ -60,6 +60,7 @@ namespace IlluminoEngine
 	{
 		ILLUMINO_ASSERT(frameIndex < g_QueueSlotCount);
 
+		std::lock_guard<std::mutex> lock(m_Mutex);
 		std::vector<uint32_t>& indices = m_DeferredFreeIndices[frameIndex];
 		if (!indices.empty())
 		{
@@ -87,6 +88,8 @@ namespace IlluminoEngine
 	{
 		OPTICK_EVENT();
 
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
 		ILLUMINO_ASSERT(m_Heap);
 		ILLUMINO_ASSERT(m_Size < m_Capacity);
 
@@ -114,6 +117,8 @@ namespace IlluminoEngine
 		if (!handle.IsValid())
 			return;
 
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
 		ILLUMINO_ASSERT(m_Heap && m_Size);
 		ILLUMINO_ASSERT(handle.m_Container == this);
 		ILLUMINO_ASSERT(handle.CPU.ptr >= m_CPUStart.ptr);
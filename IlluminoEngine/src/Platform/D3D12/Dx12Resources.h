@@ -1,6 +1,7 @@
 #pragma once
 
 #include <d3d12.h>
+#include <mutex>
 
 #include "Illumino/Core/Core.h"
 #include "Illumino/Renderer/GraphicsContext.h"
@@ -67,5 +68,8 @@ namespace IlluminoEngine
 		uint32_t m_Size = 0;
 		uint32_t m_DescriptorSize = 0;
 		const D3D12_DESCRIPTOR_HEAP_TYPE m_Type;
+
+		// Resources can be created from streaming threads
+		std::mutex m_Mutex;
 	};
 }
@@ -11,8 +11,8 @@
 
 namespace IlluminoEngine
 {
-	Dx12Shader::Dx12Shader(const char* filepath, const BufferLayout& layout)
-		: m_Filepath(filepath)
+	Dx12Shader::Dx12Shader(const char* filepath, const BufferLayout& layout, ShaderPipeline pipeline)
+		: m_Filepath(filepath), m_Pipeline(pipeline)
 	{
 		OPTICK_EVENT();
 
@@ -70,6 +70,15 @@ namespace IlluminoEngine
 		Dx12GraphicsContext::s_Context->GetCommandList()->SetGraphicsRootDescriptorTable(slot, { handle });
 	}
 
+	void Dx12Shader::BindShaderResource(uint32_t slot, uint64_t address)
+	{
+		OPTICK_EVENT();
+
+		ILLUMINO_ASSERT(Dx12GraphicsContext::s_Context);
+
+		Dx12GraphicsContext::s_Context->GetCommandList()->SetGraphicsRootShaderResourceView(slot, address);
+	}
+
 	void Dx12Shader::BindGlobal(uint32_t slot, uint64_t handle)
 	{
 		OPTICK_EVENT();
@@ -79,6 +88,15 @@ namespace IlluminoEngine
 		Dx12GraphicsContext::s_Context->GetCommandList()->SetGraphicsRootUnorderedAccessView(slot, handle);
 	}
 
+	void Dx12Shader::BindConstant(uint32_t slot, uint32_t value)
+	{
+		OPTICK_EVENT();
+
+		ILLUMINO_ASSERT(Dx12GraphicsContext::s_Context);
+
+		Dx12GraphicsContext::s_Context->GetCommandList()->SetGraphicsRoot32BitConstant(slot, value, 0);
+	}
+
 	void Dx12Shader::BindPipeline()
 	{
 		OPTICK_EVENT();
@@ -95,39 +113,41 @@ namespace IlluminoEngine
 		uint32_t backBuffer = Dx12GraphicsContext::s_Context->GetCurrentBackBufferIndex();
 		auto& constantBufferMap = m_ConstantBuffers[backBuffer];
 
-		if (constantBufferMap.find_as(name) != constantBufferMap.end())
+		// Buffers only grow, the frame that last used this one has already finished
+		auto it = constantBufferMap.find_as(name);
+		if (it != constantBufferMap.end())
 		{
-			auto& cb = constantBufferMap.at(name);
-			if (cb.Size == sizeAligned)
-				return cb.Resource->GetGPUVirtualAddress();
-			else
-				cb.Resource->Release();
+			if (it->second.Size >= sizeAligned)
+				return it->second.Resource->GetGPUVirtualAddress();
+
+			it->second.Resource->Release();
 		}
 
-		ID3D12Resource* buffer = Dx12GraphicsContext::s_Context->CreateConstantBuffer(sizeAligned);
-		constantBufferMap[name] = { sizeAligned, buffer };
+		BufferData buffer;
+		buffer.Size = sizeAligned;
+		buffer.Resource = Dx12GraphicsContext::s_Context->CreateConstantBuffer(sizeAligned);
+		buffer.Resource->Map(0, nullptr, reinterpret_cast<void**>(&buffer.Data));
+		constantBufferMap[name] = buffer;
 
-		return buffer->GetGPUVirtualAddress();
+		return buffer.Resource->GetGPUVirtualAddress();
 	}
 
-	uint64_t Dx12Shader::CreateSRV(const char* name, size_t size)
+	uint64_t Dx12Shader::CreateSRV(const char* name, size_t size, size_t stride)
 	{
 		ILLUMINO_ASSERT(Dx12GraphicsContext::s_Context);
 
 		uint32_t backBuffer = Dx12GraphicsContext::s_Context->GetCurrentBackBufferIndex();
 		auto& srvBufferMap = m_SRVBuffers[backBuffer];
-		if (srvBufferMap.find_as(name) != srvBufferMap.end())
+		// Strided buffers only grow. Without a stride the element is the whole buffer, so the size has to match
+		auto it = srvBufferMap.find_as(name);
+		if (it != srvBufferMap.end())
 		{
-			auto& s = srvBufferMap.at(name);
-			if (s.Size == size)
-			{
+			BufferData& s = it->second;
+			if (s.Size == size || (stride != 0 && s.Stride == stride && s.Size >= size))
 				return s.Handle.GPU.ptr;
-			}
-			else
-			{
-				s.Resource->Release();
-				Dx12GraphicsContext::s_Context->GetSRVDescriptorHeap().Free(s.Handle);
-			}
+
+			s.Resource->Release();
+			Dx12GraphicsContext::s_Context->GetSRVDescriptorHeap().Free(s.Handle);
 		}
 
 		D3D12_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc = {};
@@ -135,8 +155,8 @@ namespace IlluminoEngine
 		shaderResourceViewDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
 		shaderResourceViewDesc.Format = DXGI_FORMAT_UNKNOWN;
 		shaderResourceViewDesc.Buffer.FirstElement = 0;
-		shaderResourceViewDesc.Buffer.NumElements = 1;
-		shaderResourceViewDesc.Buffer.StructureByteStride = size;
+		shaderResourceViewDesc.Buffer.NumElements = stride ? size / stride : 1;
+		shaderResourceViewDesc.Buffer.StructureByteStride = stride ? stride : size;
 		shaderResourceViewDesc.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_NONE;
 
 		D3D12_HEAP_PROPERTIES heapDesc = {};
@@ -162,8 +182,10 @@ namespace IlluminoEngine
 
 		DescriptorHandle handle = Dx12GraphicsContext::s_Context->GetSRVDescriptorHeap().Allocate();
 		Dx12GraphicsContext::s_Context->GetDevice()->CreateShaderResourceView(ret, &shaderResourceViewDesc, handle.CPU);
-		
-		srvBufferMap[name] = { size, ret, handle };
+
+		uint8_t* data;
+		ret->Map(0, nullptr, reinterpret_cast<void**>(&data));
+		srvBufferMap[name] = { size, stride, ret, handle, data };
 
 		return handle.GPU.ptr;
 	}
@@ -172,39 +194,26 @@ namespace IlluminoEngine
 	{
 		OPTICK_EVENT();
 
-		ID3D12Resource* constantBuffer = GetConstantBuffer((String&&)name);
-		void** p;
-		constantBuffer->Map(0, nullptr, reinterpret_cast<void**>(&p));
-		memcpy(p + offsetAligned, data, size);
-		constantBuffer->Unmap(0, nullptr);
-	}
-
-	void Dx12Shader::UploadSRV(const char* name, void* data, size_t size, size_t offsetAligned)
-	{
-		OPTICK_EVENT();
+		ILLUMINO_ASSERT(Dx12GraphicsContext::s_Context);
 
 		uint32_t backBuffer = Dx12GraphicsContext::s_Context->GetCurrentBackBufferIndex();
-		ID3D12Resource* srvBuffer = m_SRVBuffers[backBuffer].at(name).Resource;
-		void** p;
-		srvBuffer->Map(0, nullptr, reinterpret_cast<void**>(&p));
-		memcpy(p + offsetAligned, data, size);
-		srvBuffer->Unmap(0, nullptr);
+		auto& constantBufferMap = m_ConstantBuffers[backBuffer];
+		auto it = constantBufferMap.find_as(name);
+		ILLUMINO_ASSERT(it != constantBufferMap.end(), "Constant buffer not found!");
+
+		memcpy(it->second.Data + offsetAligned, data, size);
 	}
 
-	ID3D12Resource* Dx12Shader::GetConstantBuffer(const char* name)
+	void Dx12Shader::UploadSRV(const char* name, void* data, size_t size, size_t offsetAligned)
 	{
 		OPTICK_EVENT();
 
-		ILLUMINO_ASSERT(Dx12GraphicsContext::s_Context);
-
 		uint32_t backBuffer = Dx12GraphicsContext::s_Context->GetCurrentBackBufferIndex();
-		auto& constantBufferMap = m_ConstantBuffers[backBuffer];
-
-		if (constantBufferMap.find_as(name) != constantBufferMap.end())
-			return constantBufferMap.at(name).Resource;
+		auto& srvBufferMap = m_SRVBuffers[backBuffer];
+		auto it = srvBufferMap.find_as(name);
+		ILLUMINO_ASSERT(it != srvBufferMap.end(), "SRV buffer not found!");
 
-		ILLUMINO_ASSERT("Constant buffer not found!");
-		return nullptr;
+		memcpy(it->second.Data + offsetAligned, data, size);
 	}
 
 	void Dx12Shader::SetBufferLayout(const BufferLayout& layout)
@@ -221,33 +230,59 @@ namespace IlluminoEngine
 		if (errorBlob)
 			errorBlob->Release();
 
-		ID3DBlob* pixelShader;
-		hr = D3DCompile(source.c_str(), source.size(), "", nullptr, nullptr, "PS_main", "ps_5_0", 0, 0, &pixelShader, &errorBlob);
-		ILLUMINO_ASSERT(SUCCEEDED(hr), (char*) errorBlob->GetBufferPointer());
-		if (errorBlob)
-			errorBlob->Release();
+		// Every forward variant compiles the same pixel shader, the defines pick its alpha handling
+		const D3D_SHADER_MACRO alphaTestDefines[] = { { "ALPHA_TEST", "1" }, { nullptr, nullptr } };
+		const D3D_SHADER_MACRO alphaBlendDefines[] = { { "ALPHA_BLEND", "1" }, { nullptr, nullptr } };
+		const D3D_SHADER_MACRO* pixelDefines = nullptr;
+		if (m_Pipeline == ShaderPipeline::ForwardMasked)
+			pixelDefines = alphaTestDefines;
+		else if (m_Pipeline == ShaderPipeline::ForwardTransparent)
+			pixelDefines = alphaBlendDefines;
+
+		ID3DBlob* pixelShader = nullptr;
+		if (m_Pipeline != ShaderPipeline::ShadowDepth)
+		{
+			hr = D3DCompile(source.c_str(), source.size(), "", pixelDefines, nullptr, "PS_main", "ps_5_0", 0, 0, &pixelShader, &errorBlob);
+			ILLUMINO_ASSERT(SUCCEEDED(hr), (char*) errorBlob->GetBufferPointer());
+			if (errorBlob)
+				errorBlob->Release();
+		}
 
 		// Create root signature
-		CD3DX12_ROOT_PARAMETER parameters[7];
+		CD3DX12_ROOT_PARAMETER parameters[14];
 		CD3DX12_DESCRIPTOR_RANGE range1 { D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0 };
 		CD3DX12_DESCRIPTOR_RANGE range2 { D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 1 };
 		CD3DX12_DESCRIPTOR_RANGE range3 { D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 2 };
 		CD3DX12_DESCRIPTOR_RANGE range4 { D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 3 };
+		CD3DX12_DESCRIPTOR_RANGE range5 { D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 4 };
+		CD3DX12_DESCRIPTOR_RANGE range6 { D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 8 };
+		CD3DX12_DESCRIPTOR_RANGE range7 { D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 9 };
 
 		parameters[0].InitAsDescriptorTable(1, &range1);
 		parameters[1].InitAsDescriptorTable(1, &range2);
 		parameters[2].InitAsDescriptorTable(1, &range3);
 		parameters[3].InitAsDescriptorTable(1, &range4);
 		parameters[4].InitAsConstantBufferView(0, 0);
-		parameters[5].InitAsConstantBufferView(1, 0);
-		parameters[6].InitAsConstantBufferView(2, 0);
-
-		CD3DX12_STATIC_SAMPLER_DESC samplers[1];
+		parameters[5].InitAsDescriptorTable(1, &range5);
+		parameters[6].InitAsShaderResourceView(5);
+		parameters[7].InitAsConstants(1, 1, 0);
+		parameters[8].InitAsConstantBufferView(2, 0);
+		parameters[9].InitAsShaderResourceView(6);
+		parameters[10].InitAsShaderResourceView(7);
+		parameters[11].InitAsConstantBufferView(3, 0);
+		parameters[12].InitAsDescriptorTable(1, &range6);
+		parameters[13].InitAsDescriptorTable(1, &range7);
+
+		CD3DX12_STATIC_SAMPLER_DESC samplers[2];
 		samplers[0].Init(0, D3D12_FILTER_MIN_MAG_LINEAR_MIP_POINT);
+		// Shadow map compare, bilinear so 2x2 texels are filtered per tap. Outside the atlas counts as lit
+		samplers[1].Init(1, D3D12_FILTER_COMPARISON_MIN_MAG_LINEAR_MIP_POINT,
+			D3D12_TEXTURE_ADDRESS_MODE_BORDER, D3D12_TEXTURE_ADDRESS_MODE_BORDER, D3D12_TEXTURE_ADDRESS_MODE_BORDER,
+			0.0f, 1, D3D12_COMPARISON_FUNC_LESS_EQUAL, D3D12_STATIC_BORDER_COLOR_OPAQUE_WHITE);
 
 		CD3DX12_ROOT_SIGNATURE_DESC descRootSignature;
 		
-		descRootSignature.Init(7, parameters, 1, samplers, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+		descRootSignature.Init(14, parameters, 2, samplers, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
 		ID3DBlob* rootBlob;
 		hr = D3D12SerializeRootSignature(&descRootSignature, D3D_ROOT_SIGNATURE_VERSION_1, &rootBlob, &errorBlob);
@@ -323,8 +358,11 @@ namespace IlluminoEngine
 		D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
 		psoDesc.VS.BytecodeLength = vertexShader->GetBufferSize();
 		psoDesc.VS.pShaderBytecode = vertexShader->GetBufferPointer();
-		psoDesc.PS.BytecodeLength = pixelShader->GetBufferSize();
-		psoDesc.PS.pShaderBytecode = pixelShader->GetBufferPointer();
+		if (pixelShader)
+		{
+			psoDesc.PS.BytecodeLength = pixelShader->GetBufferSize();
+			psoDesc.PS.pShaderBytecode = pixelShader->GetBufferPointer();
+		}
 		psoDesc.pRootSignature = m_RootSignature;
 		psoDesc.NumRenderTargets = 1;
 		psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
@@ -334,8 +372,9 @@ namespace IlluminoEngine
 		psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
 		psoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
 
+		// Only transparent draws pay for blending, everything else overwrites the target
 		auto& renderTarget = psoDesc.BlendState.RenderTarget[0];
-		renderTarget.BlendEnable = true;
+		renderTarget.BlendEnable = m_Pipeline == ShaderPipeline::ForwardTransparent;
 		renderTarget.SrcBlend = D3D12_BLEND_SRC_ALPHA;
 		renderTarget.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
 		renderTarget.BlendOp = D3D12_BLEND_OP_ADD;
@@ -353,10 +392,28 @@ namespace IlluminoEngine
 		psoDesc.SampleMask = 0xFFFFFFFF;
 		psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
 
+		if (m_Pipeline == ShaderPipeline::ForwardTransparent)
+		{
+			// Transparent surfaces are sorted back to front and must not hide the ones behind them
+			psoDesc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+		}
+		else if (m_Pipeline == ShaderPipeline::ShadowDepth)
+		{
+			psoDesc.NumRenderTargets = 0;
+			psoDesc.RTVFormats[0] = DXGI_FORMAT_UNKNOWN;
+			// Both faces are drawn so open meshes still cast, the bias keeps lit surfaces from shadowing themselves
+			psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+			psoDesc.RasterizerState.DepthBias = 1000;
+			psoDesc.RasterizerState.SlopeScaledDepthBias = 2.0f;
+			psoDesc.RasterizerState.DepthBiasClamp = 0.01f;
+			psoDesc.RasterizerState.DepthClipEnable = false;
+		}
+
 		Dx12GraphicsContext::s_Context->CreatePipelineState(psoDesc, &m_PipelineState);
 
 		rootBlob->Release();
-		pixelShader->Release();
+		if (pixelShader)
+			pixelShader->Release();
 		vertexShader->Release();
 	}
 
@@ -13,34 +13,39 @@ namespace IlluminoEngine
 	class Dx12Shader : public Shader
 	{
 	public:
-		Dx12Shader(const char* filepath, const BufferLayout& layout);
+		Dx12Shader(const char* filepath, const BufferLayout& layout, ShaderPipeline pipeline);
 		virtual ~Dx12Shader() override;
 
 		virtual void BindConstantBuffer(uint32_t slot, uint64_t handle) override;
 		virtual void BindStructuredBuffer(uint32_t slot, uint64_t handle) override;
+		virtual void BindShaderResource(uint32_t slot, uint64_t address) override;
 		virtual void BindGlobal(uint32_t slot, uint64_t handle) override;
+		virtual void BindConstant(uint32_t slot, uint32_t value) override;
 		virtual void BindPipeline() override;
 
 		virtual uint64_t CreateBuffer(const char* name, size_t sizeAligned) override;
 		virtual void UploadBuffer(const char* name, void* data, size_t size, size_t offsetAligned) override;
 
-		virtual uint64_t CreateSRV(const char* name, size_t sizeAligned) override;
+		virtual uint64_t CreateSRV(const char* name, size_t sizeAligned, size_t stride = 0) override;
 		virtual void UploadSRV(const char* name, void* data, size_t size, size_t offsetAligned) override;
 
 	private:
 		void SetBufferLayout(const BufferLayout& layout);
 		std::string ReadFile(const char* filepath);
-		ID3D12Resource* GetConstantBuffer(const char* name);
 
 	private:
 		struct BufferData
 		{
 			size_t Size = 0;
+			size_t Stride = 0;
 			ID3D12Resource* Resource = nullptr;
 			DescriptorHandle Handle = {};
+			// Upload heap buffers stay mapped until they are released
+			uint8_t* Data = nullptr;
 		};
 
 		String m_Filepath;
+		ShaderPipeline m_Pipeline;
 		ID3D12RootSignature* m_RootSignature;
 		ID3D12PipelineState* m_PipelineState;
 		eastl::unordered_map<eastl::string, BufferData> m_ConstantBuffers[g_QueueSlotCount];
@@ -0,0 +1,107 @@
+#include "ipch.h"
+#include "Dx12ShadowMap.h"
+
+#include "d3dx12.h"
+#include "Dx12GraphicsContext.h"
+
+namespace IlluminoEngine
+{
+	Dx12ShadowMap::Dx12ShadowMap(uint32_t resolution, uint32_t cascadeCount)
+		: m_Resolution(resolution), m_CascadeCount(cascadeCount), m_State(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE)
+	{
+		OPTICK_EVENT();
+
+		ID3D12Device* device = Dx12GraphicsContext::s_Context->GetDevice();
+
+		// Typeless so the same memory can be written as depth and sampled as a float texture
+		auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+		D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Tex2D(
+			DXGI_FORMAT_R32_TYPELESS,
+			(UINT64)resolution * cascadeCount, (UINT)resolution,
+			1, 1, 1, 0,
+			D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL);
+
+		D3D12_CLEAR_VALUE clearValue = {};
+		clearValue.Format = DXGI_FORMAT_D32_FLOAT;
+		clearValue.DepthStencil.Depth = 1.0f;
+
+		device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &desc, m_State, &clearValue, IID_PPV_ARGS(&m_Resource));
+		m_Resource->SetName(L"ShadowMap");
+
+		m_DSVHandle = Dx12GraphicsContext::s_Context->GetDSVDescriptorHeap().Allocate();
+		D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
+		dsvDesc.Format = DXGI_FORMAT_D32_FLOAT;
+		dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
+		dsvDesc.Texture2D.MipSlice = 0;
+		dsvDesc.Flags = D3D12_DSV_FLAG_NONE;
+		device->CreateDepthStencilView(m_Resource, &dsvDesc, m_DSVHandle.CPU);
+
+		m_SRVHandle = Dx12GraphicsContext::s_Context->GetSRVDescriptorHeap().Allocate();
+		D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+		srvDesc.Format = DXGI_FORMAT_R32_FLOAT;
+		srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+		srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+		srvDesc.Texture2D.MipLevels = 1;
+		device->CreateShaderResourceView(m_Resource, &srvDesc, m_SRVHandle.CPU);
+	}
+
+	Dx12ShadowMap::~Dx12ShadowMap()
+	{
+		Dx12GraphicsContext::s_Context->WaitForAllFrames();
+
+		m_Resource->Release();
+		Dx12GraphicsContext::s_Context->GetDSVDescriptorHeap().Free(m_DSVHandle);
+		Dx12GraphicsContext::s_Context->GetSRVDescriptorHeap().Free(m_SRVHandle);
+	}
+
+	void Dx12ShadowMap::BeginRender()
+	{
+		OPTICK_EVENT();
+
+		TransitionTo(D3D12_RESOURCE_STATE_DEPTH_WRITE);
+
+		auto commandList = Dx12GraphicsContext::s_Context->GetCommandList();
+		commandList->OMSetRenderTargets(0, nullptr, false, &m_DSVHandle.CPU);
+		commandList->ClearDepthStencilView(m_DSVHandle.CPU, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+	}
+
+	void Dx12ShadowMap::SetCascade(uint32_t cascade)
+	{
+		OPTICK_EVENT();
+
+		ILLUMINO_ASSERT(cascade < m_CascadeCount, "Cascade out of range!");
+
+		const float x = (float)(cascade * m_Resolution);
+		D3D12_VIEWPORT viewport = { x, 0.0f, (float)m_Resolution, (float)m_Resolution, 0.0f, 1.0f };
+		D3D12_RECT scissorRect = { (LONG)x, 0, (LONG)(x + m_Resolution), (LONG)m_Resolution };
+
+		auto commandList = Dx12GraphicsContext::s_Context->GetCommandList();
+		commandList->RSSetViewports(1, &viewport);
+		commandList->RSSetScissorRects(1, &scissorRect);
+	}
+
+	void Dx12ShadowMap::EndRender()
+	{
+		OPTICK_EVENT();
+
+		TransitionTo(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+		Dx12GraphicsContext::s_Context->RestoreRenderTargets();
+	}
+
+	void Dx12ShadowMap::Bind(uint32_t slot)
+	{
+		OPTICK_EVENT();
+
+		Dx12GraphicsContext::s_Context->GetCommandList()->SetGraphicsRootDescriptorTable(slot, m_SRVHandle.GPU);
+	}
+
+	void Dx12ShadowMap::TransitionTo(D3D12_RESOURCE_STATES state)
+	{
+		if (m_State == state)
+			return;
+
+		D3D12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(m_Resource, m_State, state);
+		Dx12GraphicsContext::s_Context->GetCommandList()->ResourceBarrier(1, &barrier);
+		m_State = state;
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Illumino/Renderer/ShadowMap.h"
+#include "Dx12Resources.h"
+
+namespace IlluminoEngine
+{
+	// One atlas for all frames, the frames run on one queue so a frame's shadow pass can't overlap the
+	// previous frame reading it
+	class Dx12ShadowMap : public ShadowMap
+	{
+	public:
+		Dx12ShadowMap(uint32_t resolution, uint32_t cascadeCount);
+		virtual ~Dx12ShadowMap() override;
+
+		virtual void BeginRender() override;
+		virtual void SetCascade(uint32_t cascade) override;
+		virtual void EndRender() override;
+		virtual void Bind(uint32_t slot) override;
+
+		virtual uint32_t GetResolution() const override { return m_Resolution; }
+		virtual uint32_t GetCascadeCount() const override { return m_CascadeCount; }
+
+	private:
+		void TransitionTo(D3D12_RESOURCE_STATES state);
+
+	private:
+		uint32_t m_Resolution;
+		uint32_t m_CascadeCount;
+
+		ID3D12Resource* m_Resource = nullptr;
+		D3D12_RESOURCE_STATES m_State;
+		DescriptorHandle m_SRVHandle;
+		DescriptorHandle m_DSVHandle;
+	};
+}
@@ -0,0 +1,26 @@
+#include "ipch.h"
+#include "NullBuffer.h"
+
+#include "NullGraphicsContext.h"
+
+namespace IlluminoEngine
+{
+	NullMeshBuffer::NullMeshBuffer(float* vertexData, uint32_t* indexData, size_t verticesSize, size_t indicesSize, size_t strideSize)
+		: m_VertexCount((uint32_t)(verticesSize / strideSize)), m_IndexCount((uint32_t)(indicesSize / sizeof(uint32_t))), m_Size(verticesSize + indicesSize)
+	{
+		OPTICK_EVENT();
+
+		NullGraphicsContext::ValidateCreationThread();
+
+		NullResourceStats& stats = NullGraphicsContext::GetResourceStats();
+		++stats.MeshBuffers;
+		stats.MeshBytes += m_Size;
+	}
+
+	NullMeshBuffer::~NullMeshBuffer()
+	{
+		NullResourceStats& stats = NullGraphicsContext::GetResourceStats();
+		--stats.MeshBuffers;
+		stats.MeshBytes -= m_Size;
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Illumino/Renderer/Buffer.h"
+
+namespace IlluminoEngine
+{
+	// Keeps no copy of the geometry, only its counts and size
+	class NullMeshBuffer : public MeshBuffer
+	{
+	public:
+		NullMeshBuffer(float* vertexData, uint32_t* indexData, size_t verticesSize, size_t indicesSize, size_t strideSize);
+		virtual ~NullMeshBuffer() override;
+
+		virtual void* GetVertexBufferView() override { return nullptr; }
+		virtual void* GetIndexBufferView() override { return nullptr; }
+		virtual void Bind() override {}
+
+		virtual uint32_t GetVertexCount() override { return m_VertexCount; }
+		virtual uint32_t GetIndexCount() override { return m_IndexCount; }
+
+	private:
+		uint32_t m_VertexCount;
+		uint32_t m_IndexCount;
+		size_t m_Size;
+	};
+}
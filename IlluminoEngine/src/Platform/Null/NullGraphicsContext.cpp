@@ -0,0 +1,105 @@
+#include "ipch.h"
+#include "NullGraphicsContext.h"
+
+#include "Window.h"
+
+namespace IlluminoEngine
+{
+	NullGraphicsContext* NullGraphicsContext::s_Context;
+	NullFrameStats NullGraphicsContext::s_CurrentFrameStats;
+	NullFrameStats NullGraphicsContext::s_LastFrameStats;
+	NullResourceStats NullGraphicsContext::s_ResourceStats;
+
+	NullGraphicsContext::NullGraphicsContext(const Window& window)
+		: m_Window(window), m_Vsync(true), m_OwnerThread(std::this_thread::get_id())
+	{
+		OPTICK_EVENT();
+
+		ILLUMINO_ASSERT(!s_Context, "Null Graphics Context already exists!");
+		s_Context = this;
+	}
+
+	NullGraphicsContext::~NullGraphicsContext()
+	{
+		s_Context = nullptr;
+	}
+
+	void NullGraphicsContext::Init()
+	{
+		OPTICK_EVENT();
+
+		CreateUploadBuffer(4 * 1024 * 1024);
+		ILLUMINO_INFO("Null graphics context initialized, nothing will be rendered");
+	}
+
+	void NullGraphicsContext::SwapBuffers()
+	{
+		OPTICK_EVENT();
+
+		// Frame N is treated as finished on the GPU once frame N + g_QueueSlotCount - 1 has been submitted,
+		// the same point where the D3D12 backend waits before it reuses the frame's resources
+		const uint64_t fenceValue = ++m_FrameCount;
+		m_UploadRing.FinishFrame(fenceValue);
+		m_FrameIndex = (m_FrameIndex + 1) % g_QueueSlotCount;
+
+		if (fenceValue >= g_QueueSlotCount)
+			m_UploadRing.Reclaim(fenceValue - g_QueueSlotCount + 1);
+		m_RetiredUploadBuffers[m_FrameIndex].clear();
+
+		s_LastFrameStats = s_CurrentFrameStats;
+		s_CurrentFrameStats = {};
+	}
+
+	void NullGraphicsContext::ValidateCreationThread()
+	{
+		if (s_Context && std::this_thread::get_id() != s_Context->m_OwnerThread)
+		{
+			ILLUMINO_ERROR("GPU resource created off the main thread");
+			++s_ResourceStats.OffThreadCreations;
+		}
+	}
+
+	void NullGraphicsContext::Shutdown()
+	{
+		OPTICK_EVENT();
+
+		for (auto& retired : m_RetiredUploadBuffers)
+			retired.clear();
+
+		m_UploadBuffer.set_capacity(0);
+		m_UploadRing.Reset(0);
+	}
+
+	uint64_t NullGraphicsContext::AllocateUpload(size_t size, size_t alignment, uint8_t** outData)
+	{
+		OPTICK_EVENT();
+
+		size_t offset = m_UploadRing.Allocate(size, alignment);
+		if (offset == UploadRing::InvalidOffset)
+		{
+			// Earlier uploads of the frame still point into the old buffer, keep it until the frame comes around again
+			const size_t capacity = m_UploadRing.GetGrowCapacity(size, alignment);
+			ILLUMINO_WARN("Upload ring is full, growing it to {0} KB", capacity / 1024);
+
+			m_RetiredUploadBuffers[m_FrameIndex].push_back(eastl::move(m_UploadBuffer));
+			CreateUploadBuffer(capacity);
+
+			offset = m_UploadRing.Allocate(size, alignment);
+			ILLUMINO_ASSERT(offset != UploadRing::InvalidOffset, "Upload ring allocation failed after growing!");
+		}
+
+		s_CurrentFrameStats.TransientUploadBytes += size;
+
+		*outData = m_UploadBuffer.data() + offset;
+		return (uint64_t)(uintptr_t)*outData;
+	}
+
+	void NullGraphicsContext::CreateUploadBuffer(size_t size)
+	{
+		OPTICK_EVENT();
+
+		m_UploadBuffer = eastl::vector<uint8_t>();
+		m_UploadBuffer.resize(size);
+		m_UploadRing.Reset(size);
+	}
+}
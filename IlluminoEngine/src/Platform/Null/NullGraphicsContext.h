@@ -0,0 +1,100 @@
+#pragma once
+
+#include <thread>
+#include <EASTL/vector.h>
+
+#include "Illumino/Renderer/GraphicsContext.h"
+#include "Illumino/Renderer/UploadRing.h"
+
+namespace IlluminoEngine
+{
+	class Window;
+
+	// Calls the null backend received during one frame
+	struct NullFrameStats
+	{
+		uint32_t Submits = 0;
+		uint32_t Commands = 0;
+		uint32_t Clears = 0;
+		uint32_t PipelineBinds = 0;
+		uint32_t BufferBinds = 0;
+		uint32_t TextureBinds = 0;
+		uint32_t Constants = 0;
+		uint32_t DrawCalls = 0;
+		uint64_t Instances = 0;
+		uint64_t Indices = 0;
+		uint32_t RenderTextureBinds = 0;
+		uint32_t ShadowCascades = 0;
+		uint64_t TransientUploadBytes = 0;
+		uint64_t BufferUploadBytes = 0;
+	};
+
+	// Resources that are currently alive and the memory a GPU backend would have allocated for them
+	struct NullResourceStats
+	{
+		uint32_t MeshBuffers = 0;
+		uint32_t Textures = 0;
+		uint32_t Shaders = 0;
+		uint32_t ShaderBuffers = 0;
+		uint32_t RenderTextures = 0;
+		uint64_t MeshBytes = 0;
+		uint64_t TextureBytes = 0;
+		uint64_t ShaderBufferBytes = 0;
+		uint64_t RenderTextureBytes = 0;
+		// Textures and mesh buffers created off the thread that owns the context, always a bug
+		uint32_t OffThreadCreations = 0;
+	};
+
+	// Headless graphics context, there is no device or swap chain. Frames only advance the frame index and
+	// release upload memory, resources live in system memory and every call is counted so the CPU side of the
+	// renderer can run and be measured without a GPU. Transient upload addresses are plain host pointers.
+	class NullGraphicsContext : public GraphicsContext
+	{
+	public:
+		NullGraphicsContext(const Window& window);
+		virtual ~NullGraphicsContext() override;
+
+		virtual void Init() override;
+		virtual void SwapBuffers() override;
+		virtual void Shutdown() override;
+		virtual void SetVsync(bool state) override { m_Vsync = state; }
+
+		virtual bool IsVsync() override { return m_Vsync; }
+
+		uint32_t GetFrameIndex() const { return m_FrameIndex; }
+		uint64_t GetFrameCount() const { return m_FrameCount; }
+
+		// Counters of the frame being recorded and of the last one SwapBuffers finished
+		static NullFrameStats& GetCurrentFrameStats() { return s_CurrentFrameStats; }
+		static const NullFrameStats& GetLastFrameStats() { return s_LastFrameStats; }
+		// Resources are created and destroyed on the main thread like with the other backends
+		static NullResourceStats& GetResourceStats() { return s_ResourceStats; }
+		// Called by every texture and mesh buffer, the D3D12 backend records their uploads into the frame's
+		// command list, so creating them on another thread would race with the main thread
+		static void ValidateCreationThread();
+
+	private:
+		uint64_t AllocateUpload(size_t size, size_t alignment, uint8_t** outData);
+		void CreateUploadBuffer(size_t size);
+
+	private:
+		const Window& m_Window;
+		bool m_Vsync;
+		std::thread::id m_OwnerThread;
+
+		uint32_t m_FrameIndex = 0;
+		uint64_t m_FrameCount = 0;
+
+		eastl::vector<uint8_t> m_UploadBuffer;
+		UploadRing m_UploadRing;
+		// Replaced upload buffers, released once the frame that retired them comes around again
+		eastl::vector<eastl::vector<uint8_t>> m_RetiredUploadBuffers[g_QueueSlotCount];
+
+		static NullFrameStats s_CurrentFrameStats;
+		static NullFrameStats s_LastFrameStats;
+		static NullResourceStats s_ResourceStats;
+
+		friend class NullRendererAPI;
+		static NullGraphicsContext* s_Context;
+	};
+}
@@ -0,0 +1,40 @@
+#include "ipch.h"
+#include "NullRenderTexture.h"
+
+#include "NullGraphicsContext.h"
+
+namespace IlluminoEngine
+{
+	NullRenderTexture::NullRenderTexture(RenderTextureSpec spec)
+		: m_Specification(spec)
+	{
+		OPTICK_EVENT();
+
+		NullResourceStats& stats = NullGraphicsContext::GetResourceStats();
+		++stats.RenderTextures;
+		stats.RenderTextureBytes += GetSize();
+	}
+
+	NullRenderTexture::~NullRenderTexture()
+	{
+		NullResourceStats& stats = NullGraphicsContext::GetResourceStats();
+		--stats.RenderTextures;
+		stats.RenderTextureBytes -= GetSize();
+	}
+
+	void NullRenderTexture::Resize(size_t width, size_t height)
+	{
+		NullResourceStats& stats = NullGraphicsContext::GetResourceStats();
+		stats.RenderTextureBytes -= GetSize();
+		m_Specification.Width = (uint32_t)width;
+		m_Specification.Height = (uint32_t)height;
+		stats.RenderTextureBytes += GetSize();
+	}
+
+	void NullRenderTexture::Bind()
+	{
+		NullFrameStats& stats = NullGraphicsContext::GetCurrentFrameStats();
+		++stats.RenderTextureBinds;
+		++stats.Clears;
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Illumino/Renderer/RenderTexture.h"
+#include "Illumino/Renderer/GraphicsContext.h"
+
+namespace IlluminoEngine
+{
+	class NullRenderTexture : public RenderTexture
+	{
+	public:
+		NullRenderTexture(RenderTextureSpec spec);
+		virtual ~NullRenderTexture() override;
+
+		virtual void Resize(size_t width, size_t height) override;
+		virtual void Bind() override;
+		virtual void Unbind() override {}
+		virtual void SetClearColor(glm::vec4 color) override { m_ClearColor = color; }
+
+		virtual const RenderTextureSpec& GetSpecification() const override { return m_Specification; }
+		virtual uint64_t GetRendererID() override { return (uint64_t)(uintptr_t)this; }
+
+	private:
+		// Color and depth of every frame in flight, like the D3D12 render texture keeps them
+		uint64_t GetSize() const { return (uint64_t)m_Specification.Width * m_Specification.Height * 8 * g_QueueSlotCount; }
+
+	private:
+		glm::vec4 m_ClearColor = glm::vec4(0.1f, 0.1f, 0.1f, 1.0f);
+		RenderTextureSpec m_Specification;
+	};
+}
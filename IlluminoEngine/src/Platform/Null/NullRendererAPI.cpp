@@ -0,0 +1,135 @@
+#include "ipch.h"
+#include "NullRendererAPI.h"
+
+#include "Illumino/Renderer/Shader.h"
+#include "Illumino/Renderer/Texture.h"
+#include "Illumino/Renderer/ShadowMap.h"
+#include "NullGraphicsContext.h"
+
+namespace IlluminoEngine
+{
+	void NullRendererAPI::Init()
+	{
+		OPTICK_EVENT();
+
+	}
+
+	void NullRendererAPI::SetViewportSize(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+	{
+		OPTICK_EVENT();
+
+	}
+
+	void NullRendererAPI::ClearColor(const glm::vec4& color)
+	{
+		++NullGraphicsContext::GetCurrentFrameStats().Clears;
+	}
+
+	void NullRendererAPI::DrawIndexed(const Ref<MeshBuffer>& meshBuffer)
+	{
+		DrawIndexedInstanced(meshBuffer, 1, 0);
+	}
+
+	void NullRendererAPI::DrawIndexedInstanced(const Ref<MeshBuffer>& meshBuffer, uint32_t instanceCount, uint32_t startInstance)
+	{
+		meshBuffer->Bind();
+
+		NullFrameStats& stats = NullGraphicsContext::GetCurrentFrameStats();
+		++stats.DrawCalls;
+		stats.Instances += instanceCount;
+		stats.Indices += (uint64_t)meshBuffer->GetIndexCount() * instanceCount;
+	}
+
+	uint32_t NullRendererAPI::GetFrameIndex()
+	{
+		return NullGraphicsContext::s_Context ? NullGraphicsContext::s_Context->GetFrameIndex() : 0;
+	}
+
+	uint64_t NullRendererAPI::UploadTransient(const void* data, size_t size, size_t alignment)
+	{
+		OPTICK_EVENT();
+
+		ILLUMINO_ASSERT(NullGraphicsContext::s_Context);
+
+		uint8_t* dst;
+		const uint64_t address = NullGraphicsContext::s_Context->AllocateUpload(size, alignment, &dst);
+		memcpy(dst, data, size);
+		return address;
+	}
+
+	void NullRendererAPI::Submit(const CommandBuffer& commandBuffer)
+	{
+		OPTICK_EVENT();
+
+		NullFrameStats& stats = NullGraphicsContext::GetCurrentFrameStats();
+		++stats.Submits;
+		stats.Commands += commandBuffer.GetCommandCount();
+
+		// Walks the packets like a real backend would so their pointers are actually dereferenced
+		commandBuffer.ForEach([&stats](const CommandHeader& header)
+		{
+			switch (header.Type)
+			{
+				case CommandType::ClearColor:
+					++stats.Clears;
+					break;
+				case CommandType::BindPipeline:
+					((const BindPipelineCommand&)header).PipelineShader->BindPipeline();
+					break;
+				case CommandType::BindConstantBuffer:
+				case CommandType::BindStructuredBuffer:
+				case CommandType::BindShaderResource:
+					++stats.BufferBinds;
+					break;
+				case CommandType::BindTexture:
+				{
+					const auto& command = (const BindTextureCommand&)header;
+					command.Texture->Bind(command.Slot);
+					break;
+				}
+				case CommandType::SetConstant:
+					++stats.Constants;
+					break;
+				case CommandType::DrawIndexed:
+				{
+					MeshBuffer* mesh = ((const DrawIndexedCommand&)header).Mesh;
+					mesh->Bind();
+					++stats.DrawCalls;
+					++stats.Instances;
+					stats.Indices += mesh->GetIndexCount();
+					break;
+				}
+				case CommandType::DrawIndexedInstanced:
+				{
+					const auto& command = (const DrawIndexedInstancedCommand&)header;
+					command.Mesh->Bind();
+					++stats.DrawCalls;
+					stats.Instances += command.InstanceCount;
+					stats.Indices += (uint64_t)command.Mesh->GetIndexCount() * command.InstanceCount;
+					break;
+				}
+				case CommandType::BeginShadowMap:
+					((const BeginShadowMapCommand&)header).Map->BeginRender();
+					break;
+				case CommandType::SetShadowCascade:
+				{
+					const auto& command = (const SetShadowCascadeCommand&)header;
+					command.Map->SetCascade(command.Cascade);
+					break;
+				}
+				case CommandType::EndShadowMap:
+					((const EndShadowMapCommand&)header).Map->EndRender();
+					break;
+				case CommandType::BindShadowMap:
+				{
+					const auto& command = (const BindShadowMapCommand&)header;
+					command.Map->Bind(command.Slot);
+					break;
+				}
+				default:
+					ILLUMINO_ASSERT(false, "Unknown command type");
+					break;
+			}
+		});
+	}
+}
@@ -0,0 +1,129 @@
+#include "ipch.h"
+#include "NullShader.h"
+
+#include "Illumino/Renderer/RenderCommand.h"
+#include "NullGraphicsContext.h"
+
+namespace IlluminoEngine
+{
+	NullShader::NullShader(const char* filepath, const BufferLayout& layout, ShaderPipeline pipeline)
+		: m_Filepath(filepath)
+	{
+		OPTICK_EVENT();
+
+		++NullGraphicsContext::GetResourceStats().Shaders;
+	}
+
+	NullShader::~NullShader()
+	{
+		OPTICK_EVENT();
+
+		NullResourceStats& stats = NullGraphicsContext::GetResourceStats();
+		--stats.Shaders;
+
+		for (BufferMap* maps : { m_ConstantBuffers, m_SRVBuffers })
+		{
+			for (uint32_t i = 0; i < g_QueueSlotCount; ++i)
+			{
+				for (auto& [name, buffer] : maps[i])
+				{
+					--stats.ShaderBuffers;
+					stats.ShaderBufferBytes -= buffer.Data.size();
+				}
+			}
+		}
+	}
+
+	void NullShader::BindConstantBuffer(uint32_t slot, uint64_t handle)
+	{
+		++NullGraphicsContext::GetCurrentFrameStats().BufferBinds;
+	}
+
+	void NullShader::BindStructuredBuffer(uint32_t slot, uint64_t handle)
+	{
+		++NullGraphicsContext::GetCurrentFrameStats().BufferBinds;
+	}
+
+	void NullShader::BindShaderResource(uint32_t slot, uint64_t address)
+	{
+		++NullGraphicsContext::GetCurrentFrameStats().BufferBinds;
+	}
+
+	void NullShader::BindGlobal(uint32_t slot, uint64_t handle)
+	{
+		++NullGraphicsContext::GetCurrentFrameStats().BufferBinds;
+	}
+
+	void NullShader::BindConstant(uint32_t slot, uint32_t value)
+	{
+		++NullGraphicsContext::GetCurrentFrameStats().Constants;
+	}
+
+	void NullShader::BindPipeline()
+	{
+		++NullGraphicsContext::GetCurrentFrameStats().PipelineBinds;
+	}
+
+	uint64_t NullShader::CreateBuffer(const char* name, size_t sizeAligned)
+	{
+		return CreateBuffer(m_ConstantBuffers[RenderCommand::GetFrameIndex()], name, sizeAligned, 0, false);
+	}
+
+	void NullShader::UploadBuffer(const char* name, void* data, size_t size, size_t offsetAligned)
+	{
+		OPTICK_EVENT();
+
+		Upload(m_ConstantBuffers[RenderCommand::GetFrameIndex()], name, data, size, offsetAligned);
+	}
+
+	uint64_t NullShader::CreateSRV(const char* name, size_t sizeAligned, size_t stride)
+	{
+		// Same reuse rules as the D3D12 shader: strided buffers only grow, unstrided ones have to match
+		return CreateBuffer(m_SRVBuffers[RenderCommand::GetFrameIndex()], name, sizeAligned, stride, stride == 0);
+	}
+
+	void NullShader::UploadSRV(const char* name, void* data, size_t size, size_t offsetAligned)
+	{
+		OPTICK_EVENT();
+
+		Upload(m_SRVBuffers[RenderCommand::GetFrameIndex()], name, data, size, offsetAligned);
+	}
+
+	uint64_t NullShader::CreateBuffer(BufferMap& buffers, const char* name, size_t size, size_t stride, bool exactSize)
+	{
+		NullResourceStats& stats = NullGraphicsContext::GetResourceStats();
+
+		auto it = buffers.find_as(name);
+		if (it != buffers.end())
+		{
+			BufferData& buffer = it->second;
+			if (buffer.Data.size() == size || (!exactSize && buffer.Stride == stride && buffer.Data.size() >= size))
+				return (uint64_t)(uintptr_t)buffer.Data.data();
+
+			stats.ShaderBufferBytes -= buffer.Data.size();
+			buffer.Data = eastl::vector<uint8_t>();
+		}
+		else
+		{
+			it = buffers.insert(eastl::string(name)).first;
+			++stats.ShaderBuffers;
+		}
+
+		BufferData& buffer = it->second;
+		buffer.Stride = stride;
+		buffer.Data.resize(size);
+		stats.ShaderBufferBytes += size;
+
+		return (uint64_t)(uintptr_t)buffer.Data.data();
+	}
+
+	void NullShader::Upload(BufferMap& buffers, const char* name, void* data, size_t size, size_t offsetAligned)
+	{
+		auto it = buffers.find_as(name);
+		ILLUMINO_ASSERT(it != buffers.end(), "Buffer not found!");
+		ILLUMINO_ASSERT(offsetAligned + size <= it->second.Data.size(), "Upload outside of the buffer!");
+
+		memcpy(it->second.Data.data() + offsetAligned, data, size);
+		NullGraphicsContext::GetCurrentFrameStats().BufferUploadBytes += size;
+	}
+}
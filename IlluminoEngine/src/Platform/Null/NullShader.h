@@ -0,0 +1,49 @@
+#pragma once
+
+#include <EASTL/unordered_map.h>
+#include <EASTL/string.h>
+
+#include "Illumino/Renderer/Shader.h"
+#include "Illumino/Renderer/GraphicsContext.h"
+
+namespace IlluminoEngine
+{
+	// Nothing is compiled, buffers live in system memory so uploads still copy their data.
+	// Buffer handles are the host addresses of the buffers.
+	class NullShader : public Shader
+	{
+	public:
+		NullShader(const char* filepath, const BufferLayout& layout, ShaderPipeline pipeline);
+		virtual ~NullShader() override;
+
+		virtual void BindConstantBuffer(uint32_t slot, uint64_t handle) override;
+		virtual void BindStructuredBuffer(uint32_t slot, uint64_t handle) override;
+		virtual void BindShaderResource(uint32_t slot, uint64_t address) override;
+		virtual void BindGlobal(uint32_t slot, uint64_t handle) override;
+		virtual void BindConstant(uint32_t slot, uint32_t value) override;
+		virtual void BindPipeline() override;
+
+		virtual uint64_t CreateBuffer(const char* name, size_t sizeAligned) override;
+		virtual void UploadBuffer(const char* name, void* data, size_t size, size_t offsetAligned) override;
+
+		virtual uint64_t CreateSRV(const char* name, size_t sizeAligned, size_t stride = 0) override;
+		virtual void UploadSRV(const char* name, void* data, size_t size, size_t offsetAligned) override;
+
+	private:
+		struct BufferData
+		{
+			size_t Stride = 0;
+			eastl::vector<uint8_t> Data;
+		};
+
+		using BufferMap = eastl::unordered_map<eastl::string, BufferData>;
+
+		uint64_t CreateBuffer(BufferMap& buffers, const char* name, size_t size, size_t stride, bool exactSize);
+		void Upload(BufferMap& buffers, const char* name, void* data, size_t size, size_t offsetAligned);
+
+	private:
+		String m_Filepath;
+		BufferMap m_ConstantBuffers[g_QueueSlotCount];
+		BufferMap m_SRVBuffers[g_QueueSlotCount];
+	};
+}
@@ -0,0 +1,42 @@
+#include "ipch.h"
+#include "NullShadowMap.h"
+
+#include "NullGraphicsContext.h"
+
+namespace IlluminoEngine
+{
+	NullShadowMap::NullShadowMap(uint32_t resolution, uint32_t cascadeCount)
+		: m_Resolution(resolution), m_CascadeCount(cascadeCount)
+	{
+		OPTICK_EVENT();
+
+		NullResourceStats& stats = NullGraphicsContext::GetResourceStats();
+		++stats.RenderTextures;
+		stats.RenderTextureBytes += GetSize();
+	}
+
+	NullShadowMap::~NullShadowMap()
+	{
+		NullResourceStats& stats = NullGraphicsContext::GetResourceStats();
+		--stats.RenderTextures;
+		stats.RenderTextureBytes -= GetSize();
+	}
+
+	void NullShadowMap::BeginRender()
+	{
+		NullFrameStats& stats = NullGraphicsContext::GetCurrentFrameStats();
+		++stats.RenderTextureBinds;
+		++stats.Clears;
+	}
+
+	void NullShadowMap::SetCascade(uint32_t cascade)
+	{
+		ILLUMINO_ASSERT(cascade < m_CascadeCount, "Cascade out of range!");
+		++NullGraphicsContext::GetCurrentFrameStats().ShadowCascades;
+	}
+
+	void NullShadowMap::Bind(uint32_t slot)
+	{
+		++NullGraphicsContext::GetCurrentFrameStats().TextureBinds;
+	}
+}
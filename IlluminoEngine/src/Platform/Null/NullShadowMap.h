@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Illumino/Renderer/ShadowMap.h"
+
+namespace IlluminoEngine
+{
+	class NullShadowMap : public ShadowMap
+	{
+	public:
+		NullShadowMap(uint32_t resolution, uint32_t cascadeCount);
+		virtual ~NullShadowMap() override;
+
+		virtual void BeginRender() override;
+		virtual void SetCascade(uint32_t cascade) override;
+		virtual void EndRender() override {}
+		virtual void Bind(uint32_t slot) override;
+
+		virtual uint32_t GetResolution() const override { return m_Resolution; }
+		virtual uint32_t GetCascadeCount() const override { return m_CascadeCount; }
+
+	private:
+		// 32 bit depth, one atlas shared by all frames like the D3D12 shadow map
+		uint64_t GetSize() const { return (uint64_t)m_Resolution * m_Resolution * m_CascadeCount * 4; }
+
+	private:
+		uint32_t m_Resolution;
+		uint32_t m_CascadeCount;
+	};
+}
@@ -0,0 +1,59 @@
+#include "ipch.h"
+#include "NullTexture2D.h"
+
+#include <stb_image.h>
+
+#include "NullGraphicsContext.h"
+
+namespace IlluminoEngine
+{
+	NullTexture2D::NullTexture2D(const char* filepath)
+	{
+		OPTICK_EVENT();
+
+		int width, height, channels;
+
+		stbi_uc* data = nullptr;
+		{
+			OPTICK_EVENT("stbi_load Texture");
+
+			data = stbi_load(filepath, &width, &height, &channels, 4);
+		}
+		ILLUMINO_ASSERT(data, "Failed to load image!");
+
+		LoadTexture(width, height);
+
+		stbi_image_free(data);
+	}
+
+	NullTexture2D::NullTexture2D(uint32_t width, uint32_t height, void* data)
+	{
+		OPTICK_EVENT();
+
+		LoadTexture(width, height);
+	}
+
+	NullTexture2D::~NullTexture2D()
+	{
+		NullResourceStats& stats = NullGraphicsContext::GetResourceStats();
+		--stats.Textures;
+		stats.TextureBytes -= (uint64_t)m_Width * m_Height * 4;
+	}
+
+	void NullTexture2D::Bind(uint32_t slot)
+	{
+		++NullGraphicsContext::GetCurrentFrameStats().TextureBinds;
+	}
+
+	void NullTexture2D::LoadTexture(uint32_t width, uint32_t height)
+	{
+		NullGraphicsContext::ValidateCreationThread();
+
+		m_Width = width;
+		m_Height = height;
+
+		NullResourceStats& stats = NullGraphicsContext::GetResourceStats();
+		++stats.Textures;
+		stats.TextureBytes += (uint64_t)m_Width * m_Height * 4;
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Illumino/Renderer/Texture.h"
+
+namespace IlluminoEngine
+{
+	// Images are still decoded so importing assets costs the same CPU time as with a GPU backend
+	class NullTexture2D : public Texture2D
+	{
+	public:
+		NullTexture2D(const char* filepath);
+		NullTexture2D(uint32_t width, uint32_t height, void* data);
+		virtual ~NullTexture2D() override;
+
+		virtual void Bind(uint32_t slot) override;
+		virtual uint64_t GetRendererID() override { return (uint64_t)(uintptr_t)this; }
+
+	private:
+		void LoadTexture(uint32_t width, uint32_t height);
+
+	private:
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+	};
+}
@@ -3,10 +3,13 @@
 
 #include <imgui.h>
 
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
+#endif
 
 namespace IlluminoEngine
 {
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 	LRESULT Window::HandleInput(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 	{
 		OPTICK_EVENT();
@@ -39,12 +42,18 @@ namespace IlluminoEngine
 
 		return DefWindowProcA(hWnd, uMsg, wParam, lParam);
 	}
+#endif
 
 	Window::Window(const char* name, uint32_t width, uint32_t height)
-		: m_Name(name), m_Width(width), m_Height(height), m_Closed(false), m_HInstance(GetModuleHandle(nullptr))
+#ifdef ILLUMINO_PLATFORM_WINDOWS
+		: m_Name(name), m_Width(width), m_Height(height), m_Minimized(false), m_Closed(false), m_HInstance(GetModuleHandle(nullptr))
+#else
+		: m_Name(name), m_Width(width), m_Height(height), m_Minimized(false), m_Closed(false)
+#endif
 	{
 		OPTICK_EVENT();
 
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 		WNDCLASSA wc = {};
 		wc.style = 0;
 		wc.lpfnWndProc = &(IlluminoEngine::Window::HandleInput);
@@ -76,6 +85,9 @@ namespace IlluminoEngine
 
 		ShowWindow(m_Hwnd, SW_SHOWDEFAULT);
 		UpdateWindow(m_Hwnd);
+#else
+		ILLUMINO_INFO("Creating headless window {0} ({1}x{2})", m_Name, m_Width, m_Height);
+#endif
 
 		m_Context = GraphicsContext::Create(*this);
 	}
@@ -85,8 +97,10 @@ namespace IlluminoEngine
 		OPTICK_EVENT();
 
 		m_Context->Shutdown();
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 		UnregisterClassA(m_Name.c_str(), m_HInstance);
 		PostQuitMessage(0);
+#endif
 	}
 
 	void Window::Init()
@@ -106,11 +120,13 @@ namespace IlluminoEngine
 	{
 		OPTICK_EVENT();
 
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 		MSG msg = {};
 		while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
 		{
 			TranslateMessage(&msg);
 			DispatchMessage(&msg);
 		}
+#endif
 	}
 }
@@ -1,6 +1,8 @@
 #pragma once
 
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 #include <Windows.h>
+#endif
 
 #include "Illumino/Renderer/GraphicsContext.h"
 
@@ -16,19 +18,25 @@ namespace IlluminoEngine
 
 		void Init();
 		void Update();
+		// Lets ShouldClose return true, headless builds have no OS window that could be closed
+		void Close() { m_Closed = true; }
 
 		bool Minimized() const { return m_Minimized; }
 		bool ShouldClose() const { return m_Closed; }
 		uint32_t GetWidth() const { return m_Width; }
 		uint32_t GetHeight() const { return m_Height; }
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 		HWND GetHwnd() const { return m_Hwnd; }
+#endif
 
 		const Scope<GraphicsContext>& GetGraphicsContext() { return m_Context; }
 
 	private:
 		void ProcessInput();
 
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 		static LRESULT HandleInput(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
+#endif
 
 	private:
 		std::string m_Name;
@@ -36,8 +44,10 @@ namespace IlluminoEngine
 		uint32_t m_Height;
 		bool m_Minimized;
 		bool m_Closed;
+#ifdef ILLUMINO_PLATFORM_WINDOWS
 		HINSTANCE m_HInstance;
 		HWND m_Hwnd;
+#endif
 		Scope<GraphicsContext> m_Context;
 	};
 }
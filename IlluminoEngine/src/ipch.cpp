@@ -1,11 +1,15 @@
 #include "ipch.h"
 
+#include "Illumino/Core/FrameAllocator.h"
+
 void* operator new[](size_t size, const char* pName, int flags, unsigned     debugFlags, const char* file, int line)
 {
+	IlluminoEngine::FrameAllocator::CountHeapAllocation();
 	return malloc(size);
 }
 
 void* operator new[](size_t size, size_t alignment, size_t alignmentOffset, const char* pName, int flags, unsigned debugFlags, const char* file, int line)
 {
+	IlluminoEngine::FrameAllocator::CountHeapAllocation();
 	return malloc(size);
 }
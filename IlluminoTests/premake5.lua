@@ -0,0 +1,60 @@
+project "IlluminoTests"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "on"
+
+	targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("%{wks.location}/bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files
+	{
+		"src/**.h",
+		"src/**.cpp"
+	}
+
+	includedirs
+	{
+		"src",
+		"%{wks.location}/IlluminoEngine/vendor/spdlog/include",
+		"%{wks.location}/IlluminoEngine/src",
+		"%{wks.location}/IlluminoEngine/vendor",
+		"%{IncludeDir.optick}",
+		"%{IncludeDir.glm}",
+		"%{IncludeDir.assimp}",
+		"%{IncludeDir.assimp_config}",
+		"%{IncludeDir.assimp_config_assimp}",
+		"%{IncludeDir.EASTL}",
+		"%{IncludeDir.EABase}",
+		"%{IncludeDir.entt}",
+		"%{IncludeDir.half}",
+	}
+
+	links
+	{
+		"IlluminoEngine"
+	}
+
+	-- Tests always run on the null renderer backend, see TestMain.cpp
+	filter "system:windows"
+		systemversion "latest"
+		defines "ILLUMINO_PLATFORM_WINDOWS"
+
+	filter "system:linux"
+		defines { "ILLUMINO_PLATFORM_LINUX", "ILLUMINO_HEADLESS" }
+		links { "optick", "assimp", "EASTL", "pthread" }
+
+	filter "configurations:Debug"
+		defines "ILLUMINO_DEBUG"
+		runtime "Debug"
+		symbols "on"
+
+	filter "configurations:Release"
+		defines "ILLUMINO_RELEASE"
+		runtime "Release"
+		optimize "on"
+
+	filter "configurations:Dist"
+		defines "ILLUMINO_DIST"
+		runtime "Release"
+		optimize "on"
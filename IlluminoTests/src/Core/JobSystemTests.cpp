@@ -0,0 +1,57 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+#include "HeadlessEngine.h"
+
+namespace IlluminoEngine
+{
+	// Queued jobs live in the preallocated ring, dispatching must not hit the heap even when the ring overflows
+	ILLUMINO_TEST(JobSystemDispatchDoesNotAllocate)
+	{
+		HeadlessEngine engine(3);
+
+		constexpr uint32_t count = JobSystem::k_QueueCapacity * 4;
+		uint32_t* values = new uint32_t[count]();
+		std::atomic<uint32_t> groups = 0;
+
+		const uint64_t allocationsBefore = FrameAllocator::GetHeapAllocationCount();
+
+		JobCounter counter;
+		JobSystem::Dispatch(count, 2, [values, &groups](uint32_t start, uint32_t end)
+		{
+			for (uint32_t i = start; i < end; ++i)
+				values[i] += i;
+			groups.fetch_add(1, std::memory_order_relaxed);
+		}, counter);
+		JobSystem::Execute([&groups]() { groups.fetch_add(1, std::memory_order_relaxed); }, counter);
+		JobSystem::Wait(counter);
+
+		ILLUMINO_CHECK(FrameAllocator::GetHeapAllocationCount() == allocationsBefore);
+		ILLUMINO_CHECK(groups.load() == count / 2 + 1);
+
+		bool valid = true;
+		for (uint32_t i = 0; i < count; ++i)
+			valid &= values[i] == i;
+		ILLUMINO_CHECK(valid);
+
+		delete[] values;
+	}
+
+	ILLUMINO_BENCHMARK(JobSystemDispatchOverhead)
+	{
+		HeadlessEngine engine;
+
+		constexpr uint32_t count = 1024;
+		std::atomic<uint32_t> sink = 0;
+		const uint64_t allocationsBefore = FrameAllocator::GetHeapAllocationCount();
+		const double time = MeasureMs(1000, [&sink]()
+		{
+			JobCounter counter;
+			JobSystem::Dispatch(count, 1, [&sink](uint32_t start, uint32_t end) { sink.fetch_add(end - start, std::memory_order_relaxed); }, counter);
+			JobSystem::Wait(counter);
+		});
+
+		ILLUMINO_INFO("Dispatch of {0} single item jobs: {1:.4f} ms, {2} heap allocations over 1000 dispatches",
+			count, time, FrameAllocator::GetHeapAllocationCount() - allocationsBefore);
+		ILLUMINO_CHECK(sink.load() == count * 1000);
+	}
+}
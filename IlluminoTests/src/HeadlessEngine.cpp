@@ -0,0 +1,51 @@
+#include <IlluminoEngine.h>
+#include "HeadlessEngine.h"
+
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+
+#include "Window.h"
+
+namespace IlluminoEngine
+{
+	HeadlessEngine::HeadlessEngine(uint32_t threadCount, size_t frameBlockSize)
+	{
+		JobSystem::Init(threadCount);
+		FrameAllocator::Init(frameBlockSize);
+
+		m_Window = CreateScope<Window>("IlluminoTests", 1280, 720);
+		m_Window->Init();
+		RenderCommand::Init();
+		SceneRenderer::Init();
+	}
+
+	HeadlessEngine::~HeadlessEngine()
+	{
+		m_Window->Update();
+
+		SceneRenderer::Shutdown();
+		FrameAllocator::Shutdown();
+		JobSystem::Shutdown();
+	}
+
+	void HeadlessEngine::BeginFrame()
+	{
+		FrameAllocator::NextFrame();
+	}
+
+	void HeadlessEngine::EndFrame()
+	{
+		m_Window->Update();
+	}
+
+	TestCamera::TestCamera(float fov, float aspect, float nearPlane, float farPlane)
+		: m_Projection(glm::perspective(fov, aspect, nearPlane, farPlane))
+	{
+	}
+
+	void TestCamera::LookAt(const glm::vec3& position, const glm::vec3& target)
+	{
+		m_View = glm::lookAt(position, target, glm::vec3(0.0f, 1.0f, 0.0f));
+		m_Transform = glm::inverse(m_View);
+	}
+}
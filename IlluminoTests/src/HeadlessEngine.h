@@ -0,0 +1,44 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Illumino/Core/Core.h"
+#include "Illumino/Renderer/Camera.h"
+
+namespace IlluminoEngine
+{
+	class Window;
+
+	// Brings up the job system, frame allocator, a window and the renderer on the null backend
+	// for the lifetime of a test
+	class HeadlessEngine
+	{
+	public:
+		// threadCount is passed to JobSystem::Init, 0 uses every hardware thread
+		HeadlessEngine(uint32_t threadCount = 0, size_t frameBlockSize = 64 * 1024 * 1024);
+		~HeadlessEngine();
+
+		void BeginFrame();
+		void EndFrame();
+
+	private:
+		Scope<Window> m_Window;
+	};
+
+	class TestCamera : public Camera
+	{
+	public:
+		TestCamera(float fov = 1.0f, float aspect = 16.0f / 9.0f, float nearPlane = 0.1f, float farPlane = 1000.0f);
+
+		void LookAt(const glm::vec3& position, const glm::vec3& target);
+
+		virtual const glm::mat4& GetTransform() const override { return m_Transform; }
+		virtual const glm::mat4& GetView() const override { return m_View; }
+		virtual const glm::mat4& GetProjection() const override { return m_Projection; }
+
+	private:
+		glm::mat4 m_Transform = glm::mat4(1.0f);
+		glm::mat4 m_View = glm::mat4(1.0f);
+		glm::mat4 m_Projection = glm::mat4(1.0f);
+	};
+}
@@ -0,0 +1,82 @@
+#include <IlluminoEngine.h>
+
+#include <cstdlib>
+#include <new>
+
+// Global replacements so allocations from std containers, std::function and make_shared are counted too. They only
+// live in the test executable, the engine itself counts its EASTL and frame allocator fallbacks.
+
+static void* CountedAlloc(size_t size)
+{
+	IlluminoEngine::FrameAllocator::CountHeapAllocation();
+	return malloc(size ? size : 1);
+}
+
+static void* CountedAlignedAlloc(size_t size, size_t alignment)
+{
+	IlluminoEngine::FrameAllocator::CountHeapAllocation();
+	size = size ? size : 1;
+#ifdef ILLUMINO_PLATFORM_WINDOWS
+	return _aligned_malloc(size, alignment);
+#else
+	alignment = std::max(alignment, sizeof(void*));
+	return aligned_alloc(alignment, ALIGN(alignment, size));
+#endif
+}
+
+static void AlignedFree(void* ptr)
+{
+#ifdef ILLUMINO_PLATFORM_WINDOWS
+	_aligned_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+
+void* operator new(size_t size)
+{
+	if (void* ptr = CountedAlloc(size))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+	if (void* ptr = CountedAlloc(size))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	if (void* ptr = CountedAlignedAlloc(size, (size_t)alignment))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	if (void* ptr = CountedAlignedAlloc(size, (size_t)alignment))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAlignedAlloc(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAlignedAlloc(size, (size_t)alignment); }
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete[](void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { free(ptr); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept { AlignedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { AlignedFree(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { AlignedFree(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { AlignedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(ptr); }
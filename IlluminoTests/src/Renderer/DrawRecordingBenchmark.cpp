@@ -0,0 +1,75 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+#include "HeadlessEngine.h"
+
+#include "Platform/Null/NullGraphicsContext.h"
+
+namespace IlluminoEngine
+{
+	// Draw recording on the calling thread against one command buffer per job system thread. 50k draws spread over
+	// 2000 materials, so most of the frame's packets are binds and draws and the chunks have real work to split.
+	ILLUMINO_BENCHMARK(DrawRecordingChunks)
+	{
+		HeadlessEngine engine;
+		TestCamera camera;
+
+		constexpr uint32_t materialCount = 2000;
+		constexpr uint32_t drawCount = 50000;
+		constexpr uint32_t frameCount = 10;
+		constexpr uint32_t warmupFrames = 2;
+
+		float vertices[8 * 8] = {};
+		uint32_t indices[36] = {};
+		uint32_t white = 0xffffffff;
+		Ref<MeshBuffer> geometry = MeshBuffer::Create(vertices, indices, sizeof(vertices), sizeof(indices), 8 * sizeof(float));
+		eastl::vector<Submesh> submeshes(materialCount);
+		for (Submesh& submesh : submeshes)
+		{
+			submesh.Geometry = geometry;
+			submesh.Albedo = Texture2D::Create(1, 1, &white);
+			submesh.Bounds = { glm::vec3(-0.1f), glm::vec3(0.1f) };
+			submesh.Sphere = { glm::vec3(0.0f), 0.18f };
+		}
+
+		FrameVector<Entity> noLights;
+		auto run = [&](uint32_t maxChunks, uint32_t& chunks, uint32_t& drawCalls)
+		{
+			SceneRenderer::SetMaxRecordingChunks(maxChunks);
+
+			float recording = 0.0f;
+			for (uint32_t frame = 0; frame < frameCount; ++frame)
+			{
+				engine.BeginFrame();
+				SceneRenderer::BeginScene(camera, noLights, noLights, frame == 0);
+				for (uint32_t i = 0; i < drawCount; ++i)
+				{
+					glm::mat4 transform(1.0f);
+					transform[3] = glm::vec4((float)(i % 250) * 0.1f - 12.5f, (float)(i / 250) * 0.1f - 10.0f, -30.0f, 1.0f);
+					SceneRenderer::SubmitMesh(submeshes[(i * 7) % materialCount], transform, i, frame == 0);
+				}
+				SceneRenderer::EndScene();
+				engine.EndFrame();
+
+				if (frame >= warmupFrames)
+					recording += SceneRenderer::GetStats().DrawRecording;
+			}
+
+			chunks = SceneRenderer::GetStats().RecordingChunks;
+			drawCalls = NullGraphicsContext::GetLastFrameStats().DrawCalls;
+			return recording / (frameCount - warmupFrames);
+		};
+
+		uint32_t serialChunks = 0, serialDraws = 0;
+		uint32_t parallelChunks = 0, parallelDraws = 0;
+		const float serialTime = run(1, serialChunks, serialDraws);
+		const float parallelTime = run(0, parallelChunks, parallelDraws);
+		SceneRenderer::SetMaxRecordingChunks(0);
+
+		// Splitting the recording must not change what is drawn
+		ILLUMINO_CHECK(serialChunks == 1);
+		ILLUMINO_CHECK(parallelChunks >= 1 && parallelChunks <= JobSystem::GetWorkerCount() + 1);
+		ILLUMINO_CHECK(serialDraws == parallelDraws);
+		ILLUMINO_INFO("{0} draws, {1} materials: 1 chunk {2:.3f} ms, {3} chunks {4:.3f} ms, {5} draw calls", drawCount, materialCount,
+			serialTime, parallelChunks, parallelTime, parallelDraws);
+	}
+}
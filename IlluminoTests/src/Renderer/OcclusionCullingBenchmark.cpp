@@ -0,0 +1,108 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+#include "TestAssets.h"
+#include "HeadlessEngine.h"
+
+#include <random>
+
+namespace IlluminoEngine
+{
+	// City block scene: a 32x32 grid of box buildings of random height with 20k small props scattered in the
+	// streets between them, seen from street level down one of the streets. Buildings are the occluders, props
+	// the occludees.
+	ILLUMINO_BENCHMARK(OcclusionCullingCityBlock)
+	{
+		HeadlessEngine engine;
+
+		constexpr uint32_t blocksPerSide = 32;
+		constexpr float blockSize = 20.0f;
+		constexpr float streetWidth = 8.0f;
+		constexpr uint32_t propCount = 20000;
+
+		const MeshSource building = CreateBoxSource(glm::vec3(0.5f));
+		eastl::vector<glm::vec3> positions;
+		for (const MeshVertex& vertex : building.Submeshes[0].Vertices)
+			positions.push_back(vertex.Position);
+		const eastl::vector<uint32_t>& indices = building.Submeshes[0].Indices;
+
+		std::mt19937 random(11);
+		std::uniform_real_distribution<float> height(10.0f, 60.0f);
+		eastl::vector<glm::mat4> buildings;
+		const float cityExtent = blocksPerSide * blockSize;
+		for (uint32_t z = 0; z < blocksPerSide; ++z)
+		{
+			for (uint32_t x = 0; x < blocksPerSide; ++x)
+			{
+				const float h = height(random);
+				const glm::vec3 center = glm::vec3((x + 0.5f) * blockSize - cityExtent * 0.5f, h * 0.5f, (z + 0.5f) * blockSize - cityExtent * 0.5f);
+				glm::mat4 transform(1.0f);
+				transform[0][0] = blockSize - streetWidth;
+				transform[1][1] = h;
+				transform[2][2] = blockSize - streetWidth;
+				transform[3] = glm::vec4(center, 1.0f);
+				buildings.push_back(transform);
+			}
+		}
+
+		// Props sit on the street grid lines, half of them along X streets and half along Z streets
+		const AABB propBounds = { glm::vec3(-0.5f), glm::vec3(0.5f) };
+		std::uniform_real_distribution<float> along(-cityExtent * 0.5f, cityExtent * 0.5f);
+		std::uniform_int_distribution<uint32_t> street(0, blocksPerSide);
+		eastl::vector<glm::mat4> props;
+		for (uint32_t i = 0; i < propCount; ++i)
+		{
+			const float line = street(random) * blockSize - cityExtent * 0.5f;
+			const glm::vec3 position = i % 2 ? glm::vec3(along(random), 0.5f, line) : glm::vec3(line, 0.5f, along(random));
+			props.push_back(glm::translate(glm::mat4(1.0f), position));
+		}
+
+		TestCamera camera(1.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+		const glm::vec3 eye = glm::vec3(-cityExtent * 0.5f + 3.0f * blockSize, 1.7f, -cityExtent * 0.5f + 2.0f);
+		camera.LookAt(eye, eye + glm::vec3(0.3f, 0.0f, 1.0f));
+
+		// Like in the renderer, only props that passed frustum culling are tested against the occluders
+		const Frustum frustum(camera.GetProjection() * camera.GetView());
+		eastl::vector<glm::mat4> candidates;
+		for (const glm::mat4& transform : props)
+		{
+			const glm::vec3 center = glm::vec3(transform[3]);
+			bool inside = true;
+			for (const glm::vec4& plane : frustum.Planes)
+				inside &= glm::dot(glm::vec3(plane), center) + plane.w + glm::dot(glm::abs(glm::vec3(plane)), propBounds.GetExtents()) >= 0.0f;
+			if (inside)
+				candidates.push_back(transform);
+		}
+
+		OcclusionCuller culler;
+		OcclusionTimings timings;
+		const uint32_t iterations = 20;
+		const double renderTime = MeasureMs(iterations, [&]()
+		{
+			culler.Begin(camera.GetView(), camera.GetProjection(), buildings.size());
+			for (const glm::mat4& transform : buildings)
+				culler.AddOccluder(positions.data(), indices.data(), (uint32_t)indices.size(), transform);
+			culler.Render();
+
+			timings.Binning += culler.GetTimings().Binning / iterations;
+			timings.Rasterization += culler.GetTimings().Rasterization / iterations;
+		});
+
+		uint32_t visibleCount = 0;
+		const double testTime = MeasureMs(iterations, [&]()
+		{
+			visibleCount = 0;
+			for (const glm::mat4& transform : candidates)
+				visibleCount += culler.IsVisible(propBounds, transform);
+		});
+
+		// A prop right in front of the camera is never hidden, one inside a building down the street always is
+		const glm::vec3 insideBuilding = glm::vec3(4.5f * blockSize - cityExtent * 0.5f, 0.5f, 5.5f * blockSize - cityExtent * 0.5f);
+		ILLUMINO_CHECK(culler.IsVisible(propBounds, glm::translate(glm::mat4(1.0f), eye + glm::vec3(0.0f, 0.0f, 5.0f))));
+		ILLUMINO_CHECK(!culler.IsVisible(propBounds, glm::translate(glm::mat4(1.0f), insideBuilding)));
+		ILLUMINO_CHECK(visibleCount < candidates.size() / 2);
+
+		ILLUMINO_INFO("{0} buildings, {1} of {2} triangles rasterized: render {3:.3f} ms (binning {4:.3f} ms, raster {5:.3f} ms)",
+			buildings.size(), culler.GetRasterizedTriangleCount(), culler.GetTriangleCount(), renderTime, timings.Binning, timings.Rasterization);
+		ILLUMINO_INFO("{0} props, {1} in the frustum: {2} occluded, occludee tests {3:.3f} ms", propCount, candidates.size(), candidates.size() - visibleCount, testTime);
+	}
+}
@@ -0,0 +1,213 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+
+#include "Illumino/Renderer/RenderGraph.h"
+
+namespace IlluminoEngine
+{
+	static uint32_t CountBarriers(const RenderGraphBarrier* barriers, uint32_t count, RenderGraphBarrier::Type type)
+	{
+		uint32_t found = 0;
+		for (uint32_t i = 0; i < count; ++i)
+			found += barriers[i].BarrierType == type;
+		return found;
+	}
+
+	static bool HasTransition(const RenderGraphBarrier* barriers, uint32_t count, RenderGraphHandle resource, RenderGraphState before, RenderGraphState after)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const RenderGraphBarrier& barrier = barriers[i];
+			if (barrier.BarrierType == RenderGraphBarrier::Type::Transition && barrier.Resource == resource && barrier.Before == before && barrier.After == after)
+				return true;
+		}
+		return false;
+	}
+
+	static bool LivesTogether(const RenderGraph& graph, RenderGraphHandle a, RenderGraphHandle b)
+	{
+		return graph.GetFirstUse(a) <= graph.GetLastUse(b) && graph.GetFirstUse(b) <= graph.GetLastUse(a);
+	}
+
+	static bool SharesMemory(const RenderGraph& graph, RenderGraphHandle a, RenderGraphHandle b)
+	{
+		return graph.GetHeapOffset(a) < graph.GetHeapOffset(b) + graph.GetSize(b) && graph.GetHeapOffset(b) < graph.GetHeapOffset(a) + graph.GetSize(a);
+	}
+
+	// A pass whose transient output nothing reads is dropped along with its resources, it never runs
+	ILLUMINO_TEST(RenderGraphCullsUnreadPasses)
+	{
+		RenderGraph graph;
+		const RenderGraphTextureDesc desc = { 1920, 1080, RenderGraphFormat::RGBA8 };
+		const RenderGraphHandle backbuffer = graph.ImportTexture("Backbuffer", RenderGraphState::Present, RenderGraphState::Present);
+		const RenderGraphHandle depth = graph.CreateTexture("Depth", { 1920, 1080, RenderGraphFormat::D32 });
+		const RenderGraphHandle debug = graph.CreateTexture("Debug", desc);
+
+		bool debugRan = false;
+		uint32_t executed = 0;
+		const uint32_t depthPass = graph.AddPass("Depth", [&](RenderGraphBuilder& builder) { builder.Write(depth, RenderGraphState::DepthWrite); }, [&]() { ++executed; });
+		const uint32_t debugPass = graph.AddPass("Debug", [&](RenderGraphBuilder& builder)
+		{
+			builder.Read(depth, RenderGraphState::DepthRead);
+			builder.Write(debug);
+		}, [&]() { debugRan = true; });
+		const uint32_t lightingPass = graph.AddPass("Lighting", [&](RenderGraphBuilder& builder)
+		{
+			builder.Read(depth, RenderGraphState::DepthRead);
+			builder.Write(backbuffer);
+		}, [&]() { ++executed; });
+
+		graph.Compile();
+		graph.Execute();
+
+		ILLUMINO_CHECK(graph.IsPassCulled(debugPass));
+		ILLUMINO_CHECK(!graph.IsPassCulled(depthPass) && !graph.IsPassCulled(lightingPass));
+		ILLUMINO_CHECK(graph.GetExecutionOrder().size() == 2);
+		ILLUMINO_CHECK(graph.GetStats().PassCount == 2 && graph.GetStats().CulledPassCount == 1);
+		ILLUMINO_CHECK(!debugRan && executed == 2);
+
+		// The culled pass's output takes no memory
+		ILLUMINO_CHECK(graph.GetFirstUse(debug) == ~0u);
+		ILLUMINO_CHECK(graph.GetStats().TransientCount == 1);
+		ILLUMINO_CHECK(graph.GetStats().TransientMemory == graph.GetSize(depth));
+
+		// Side effects keep a pass alive even when nothing reads its output
+		graph.Reset();
+		const RenderGraphHandle readback = graph.CreateBuffer("Readback", 256);
+		const uint32_t readbackPass = graph.AddPass("Readback", [&](RenderGraphBuilder& builder)
+		{
+			builder.Write(readback, RenderGraphState::CopyDest);
+			builder.SetSideEffect();
+		}, {});
+		graph.Compile();
+		ILLUMINO_CHECK(!graph.IsPassCulled(readbackPass));
+	}
+
+	// Transients that are never alive at the same time share heap memory, the later one starts with an aliasing
+	// barrier against the one that used the memory before it. Transients alive together never overlap.
+	ILLUMINO_TEST(RenderGraphAliasesDisjointTransients)
+	{
+		RenderGraph graph;
+		const RenderGraphHandle backbuffer = graph.ImportTexture("Backbuffer", RenderGraphState::Present, RenderGraphState::Present);
+		const RenderGraphHandle first = graph.CreateTexture("First", { 1024, 1024, RenderGraphFormat::RGBA8 });
+		const RenderGraphHandle large = graph.CreateTexture("Large", { 1024, 1024, RenderGraphFormat::RGBA16F });
+		const RenderGraphHandle second = graph.CreateTexture("Second", { 1024, 1024, RenderGraphFormat::RGBA8 });
+
+		graph.AddPass("WriteFirst", [&](RenderGraphBuilder& builder) { builder.Write(first); }, {});
+		graph.AddPass("WriteLarge", [&](RenderGraphBuilder& builder)
+		{
+			builder.Read(first);
+			builder.Write(large);
+		}, {});
+		const uint32_t secondPass = graph.AddPass("WriteSecond", [&](RenderGraphBuilder& builder)
+		{
+			builder.Read(large);
+			builder.Write(second);
+		}, {});
+		graph.AddPass("Present", [&](RenderGraphBuilder& builder)
+		{
+			builder.Read(second);
+			builder.Write(backbuffer);
+		}, {});
+		graph.Compile();
+
+		ILLUMINO_CHECK(!LivesTogether(graph, first, second));
+		ILLUMINO_CHECK(graph.GetHeapOffset(first) == graph.GetHeapOffset(second));
+		ILLUMINO_CHECK(graph.GetHeapOffset(first) % RenderGraph::PlacementAlignment == 0);
+
+		ILLUMINO_CHECK(LivesTogether(graph, first, large) && !SharesMemory(graph, first, large));
+		ILLUMINO_CHECK(LivesTogether(graph, large, second) && !SharesMemory(graph, large, second));
+
+		const RenderGraphStats& stats = graph.GetStats();
+		ILLUMINO_CHECK(stats.TransientCount == 3);
+		ILLUMINO_CHECK(stats.UnaliasedMemory == graph.GetSize(first) + graph.GetSize(large) + graph.GetSize(second));
+		ILLUMINO_CHECK(stats.TransientMemory == graph.GetSize(first) + graph.GetSize(large));
+
+		// Exactly one aliasing barrier, recorded before the first use of the resource taking over the memory
+		const RenderGraphBarrier* barriers;
+		uint32_t count;
+		uint32_t aliasingCount = 0;
+		for (uint32_t pass : graph.GetExecutionOrder())
+		{
+			graph.GetPassBarriers(pass, barriers, count);
+			aliasingCount += CountBarriers(barriers, count, RenderGraphBarrier::Type::Aliasing);
+		}
+		ILLUMINO_CHECK(aliasingCount == 1);
+
+		graph.GetPassBarriers(secondPass, barriers, count);
+		bool aliased = false;
+		for (uint32_t i = 0; i < count; ++i)
+			aliased |= barriers[i].BarrierType == RenderGraphBarrier::Type::Aliasing && barriers[i].Resource == second && barriers[i].AliasedResource == first;
+		ILLUMINO_CHECK(aliased);
+	}
+
+	// Every state change is one transition, resources already in the state they are used in get none, imported
+	// resources only get a final barrier when they end up outside of their final state
+	ILLUMINO_TEST(RenderGraphMinimalBarriers)
+	{
+		RenderGraph graph;
+		const RenderGraphHandle backbuffer = graph.ImportTexture("Backbuffer", RenderGraphState::Present, RenderGraphState::Present);
+		const RenderGraphHandle history = graph.ImportTexture("History", RenderGraphState::ShaderResource, RenderGraphState::ShaderResource);
+		const RenderGraphHandle gbuffer = graph.CreateTexture("GBuffer", { 1920, 1080, RenderGraphFormat::RGBA8 });
+		const RenderGraphHandle depth = graph.CreateTexture("Depth", { 1920, 1080, RenderGraphFormat::D32 });
+		const RenderGraphHandle ao = graph.CreateTexture("AO", { 1920, 1080, RenderGraphFormat::R32F });
+
+		const uint32_t gbufferPass = graph.AddPass("GBuffer", [&](RenderGraphBuilder& builder)
+		{
+			builder.Write(gbuffer);
+			builder.Write(depth, RenderGraphState::DepthWrite);
+		}, {});
+		const uint32_t aoPass = graph.AddPass("AO", [&](RenderGraphBuilder& builder)
+		{
+			builder.Read(depth, RenderGraphState::DepthRead);
+			builder.Read(gbuffer);
+			builder.Write(ao, RenderGraphState::UnorderedAccess);
+		}, {});
+		const uint32_t lightingPass = graph.AddPass("Lighting", [&](RenderGraphBuilder& builder)
+		{
+			builder.Read(gbuffer);
+			builder.Read(ao);
+			builder.Read(history);
+			builder.Write(backbuffer);
+		}, {});
+		graph.Compile();
+
+		const RenderGraphBarrier* barriers;
+		uint32_t count;
+
+		graph.GetPassBarriers(gbufferPass, barriers, count);
+		ILLUMINO_CHECK(count == 2);
+		ILLUMINO_CHECK(HasTransition(barriers, count, gbuffer, RenderGraphState::Undefined, RenderGraphState::RenderTarget));
+		ILLUMINO_CHECK(HasTransition(barriers, count, depth, RenderGraphState::Undefined, RenderGraphState::DepthWrite));
+
+		graph.GetPassBarriers(aoPass, barriers, count);
+		ILLUMINO_CHECK(count == 3);
+		ILLUMINO_CHECK(HasTransition(barriers, count, depth, RenderGraphState::DepthWrite, RenderGraphState::DepthRead));
+		ILLUMINO_CHECK(HasTransition(barriers, count, gbuffer, RenderGraphState::RenderTarget, RenderGraphState::ShaderResource));
+		ILLUMINO_CHECK(HasTransition(barriers, count, ao, RenderGraphState::Undefined, RenderGraphState::UnorderedAccess));
+
+		// The gbuffer is still a shader resource and the history starts as one
+		graph.GetPassBarriers(lightingPass, barriers, count);
+		ILLUMINO_CHECK(count == 2);
+		ILLUMINO_CHECK(HasTransition(barriers, count, ao, RenderGraphState::UnorderedAccess, RenderGraphState::ShaderResource));
+		ILLUMINO_CHECK(HasTransition(barriers, count, backbuffer, RenderGraphState::Present, RenderGraphState::RenderTarget));
+
+		// All transients are alive together, none of them alias
+		ILLUMINO_CHECK(graph.GetStats().TransientMemory == graph.GetStats().UnaliasedMemory);
+
+		graph.GetFinalBarriers(barriers, count);
+		ILLUMINO_CHECK(count == 1);
+		ILLUMINO_CHECK(HasTransition(barriers, count, backbuffer, RenderGraphState::RenderTarget, RenderGraphState::Present));
+
+		// Execute hands the same batches to the backend, skipping passes without barriers
+		uint32_t batches = 0;
+		uint32_t executedBarriers = 0;
+		graph.Execute([&](const RenderGraphBarrier* batch, uint32_t batchCount)
+		{
+			++batches;
+			executedBarriers += batchCount;
+		});
+		ILLUMINO_CHECK(batches == 4);
+		ILLUMINO_CHECK(executedBarriers == graph.GetStats().BarrierCount && executedBarriers == 8);
+	}
+}
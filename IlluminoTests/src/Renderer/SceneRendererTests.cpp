@@ -0,0 +1,223 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+#include "TestAssets.h"
+#include "HeadlessEngine.h"
+
+#include "Platform/Null/NullGraphicsContext.h"
+
+namespace IlluminoEngine
+{
+	static Submesh CreateTestSubmesh(const Ref<Texture2D>& albedo)
+	{
+		float vertices[8 * 8] = {};
+		uint32_t indices[36] = {};
+
+		Submesh submesh;
+		submesh.Geometry = MeshBuffer::Create(vertices, indices, sizeof(vertices), sizeof(indices), 8 * sizeof(float));
+		submesh.Albedo = albedo;
+		submesh.Bounds = { glm::vec3(-0.5f), glm::vec3(0.5f) };
+		submesh.Sphere = { glm::vec3(0.0f), 0.87f };
+		return submesh;
+	}
+
+	// Copies of the same submesh are drawn with one instanced call each
+	ILLUMINO_TEST(SceneRendererInstancesSubmissions)
+	{
+		HeadlessEngine engine;
+		TestCamera camera;
+		camera.LookAt(glm::vec3(0.0f, 0.0f, 20.0f), glm::vec3(0.0f));
+
+		uint32_t white = 0xffffffff;
+		Ref<Texture2D> albedo = Texture2D::Create(1, 1, &white);
+		Submesh meshes[2] = { CreateTestSubmesh(albedo), CreateTestSubmesh(albedo) };
+
+		FrameVector<Entity> noLights;
+		for (uint32_t frame = 0; frame < 4; ++frame)
+		{
+			engine.BeginFrame();
+			SceneRenderer::BeginScene(camera, noLights, noLights, frame == 0);
+			for (uint32_t i = 0; i < 200; ++i)
+			{
+				glm::mat4 transform(1.0f);
+				transform[3] = glm::vec4((float)(i % 20) - 10.0f, (float)(i / 20) - 5.0f, 0.0f, 1.0f);
+				SceneRenderer::SubmitMesh(meshes[i % 2], transform, i, frame == 0);
+			}
+			SceneRenderer::EndScene();
+			engine.EndFrame();
+		}
+
+		const NullFrameStats& frame = NullGraphicsContext::GetLastFrameStats();
+		ILLUMINO_CHECK(frame.DrawCalls == 2);
+		ILLUMINO_CHECK(frame.Instances == 200);
+		ILLUMINO_CHECK(SceneRenderer::GetStats().DrawCalls == 2);
+		// Every container and job is warmed up after the first frames
+		ILLUMINO_CHECK(SceneRenderer::GetStats().HeapAllocations == 0);
+	}
+
+	// The LOD hysteresis belongs to the object, being culled for a while must not reset it to full detail
+	ILLUMINO_TEST(SceneRendererLODsSurviveCulling)
+	{
+		HeadlessEngine engine;
+		TestCamera camera;
+		SceneRenderer::SetViewportHeight(1080);
+		SceneRenderer::SetLODSettings(LODSettings());
+
+		// The coarser level is worth 9.88 / distance pixels with the test camera
+		MeshSource source = CreateBoxSource(glm::vec3(0.5f));
+		SubmeshLODSource lod;
+		lod.Vertices = source.Submeshes[0].Vertices;
+		lod.Indices = source.Submeshes[0].Indices;
+		lod.Error = 0.01f;
+		source.Submeshes[0].LODs.push_back(lod);
+		Ref<Mesh> box = CreateRef<Mesh>(source);
+		Ref<Mesh> plainBox = CreateBoxMesh(glm::vec3(0.5f));
+
+		Scene scene;
+		scene.CreateEntity("LOD Box").AddComponent<MeshComponent>().MeshGeometry = box;
+		for (uint32_t i = 0; i < 50; ++i)
+		{
+			Entity entity = scene.CreateEntity("Box");
+			entity.GetComponent<TransformComponent>().Translation = glm::vec3((float)i - 25.0f, 0.0f, 60.0f);
+			entity.AddComponent<MeshComponent>().MeshGeometry = plainBox;
+		}
+
+		auto render = [&](const glm::vec3& position, const glm::vec3& target)
+		{
+			engine.BeginFrame();
+			camera.LookAt(position, target);
+			scene.OnRenderEditor(camera);
+			engine.EndFrame();
+			return SceneRenderer::GetStats().ReducedLODMeshes;
+		};
+
+		// Far away the coarser level is used, closer in it is kept while the error stays inside the hysteresis band
+		ILLUMINO_CHECK(render(glm::vec3(0.0f, 0.0f, 34.0f), glm::vec3(0.0f)) == 1);
+		const glm::vec3 closeUp = glm::vec3(0.0f, 0.0f, 11.9f);
+		ILLUMINO_CHECK(render(closeUp, glm::vec3(0.0f)) == 1);
+
+		// Turning around culls the box and submits the others in its place
+		render(closeUp, closeUp + glm::vec3(0.0f, 0.0f, 1.0f));
+		ILLUMINO_CHECK(SceneRenderer::GetStats().VisibleMeshes == 50);
+
+		ILLUMINO_CHECK(render(closeUp, glm::vec3(0.0f)) == 1);
+	}
+
+	// A caster outside the camera's view still shadows what the camera sees, the scene submits it for the cascades only
+	ILLUMINO_TEST(SceneRendererShadowCastersOutsideView)
+	{
+		HeadlessEngine engine;
+		TestCamera camera;
+		camera.LookAt(glm::vec3(0.0f, 5.0f, 20.0f), glm::vec3(0.0f));
+
+		Scene scene;
+		Entity ground = scene.CreateEntity("Ground");
+		ground.AddComponent<MeshComponent>().MeshGeometry = CreateBoxMesh(glm::vec3(10.0f, 0.1f, 10.0f));
+
+		// Far above the ground and the camera's view, straight in the path of the light
+		Entity caster = scene.CreateEntity("Caster");
+		caster.GetComponent<TransformComponent>().Translation = glm::vec3(0.0f, 30.0f, 0.0f);
+		caster.AddComponent<MeshComponent>().MeshGeometry = CreateBoxMesh(glm::vec3(1.0f));
+
+		// Pointing straight down
+		Entity sun = scene.CreateEntity("Sun");
+		sun.GetComponent<TransformComponent>().Rotation.x = glm::radians(90.0f);
+		sun.AddComponent<DirectionalLightComponent>().CastShadows = true;
+
+		engine.BeginFrame();
+		scene.OnRenderEditor(camera);
+		engine.EndFrame();
+
+		const SceneRendererStats& stats = SceneRenderer::GetStats();
+		ILLUMINO_CHECK(stats.ShadowCascadeCount > 0);
+		ILLUMINO_CHECK(stats.VisibleMeshes == 1);
+		ILLUMINO_CHECK(stats.ShadowOnlyMeshes == 1);
+		ILLUMINO_CHECK(stats.CulledMeshes == 0);
+
+		uint32_t maxCasters = 0;
+		for (uint32_t cascade = 0; cascade < stats.ShadowCascadeCount; ++cascade)
+			maxCasters = eastl::max(maxCasters, stats.ShadowCasters[cascade]);
+		ILLUMINO_CHECK(maxCasters == 2);
+	}
+
+	// Only meshes used as occluders keep their triangles on the CPU, they are read back in once a component needs them
+	ILLUMINO_TEST(SceneRendererOccluderGeometryOnDemand)
+	{
+		HeadlessEngine engine;
+		TestCamera camera;
+		camera.LookAt(glm::vec3(0.0f, 0.0f, 20.0f), glm::vec3(0.0f));
+
+		Ref<Mesh> wallMesh = CreateRef<Mesh>(WriteBoxFile("OccluderWall", glm::vec3(5.0f, 5.0f, 0.5f)).c_str());
+		ILLUMINO_CHECK(!wallMesh->HasOccluderGeometry());
+		ILLUMINO_CHECK(wallMesh->GetSubmesh(0).Positions.empty());
+
+		Scene scene;
+		Entity wall = scene.CreateEntity("Wall");
+		wall.AddComponent<MeshComponent>().MeshGeometry = wallMesh;
+		Entity hidden = scene.CreateEntity("Hidden");
+		hidden.GetComponent<TransformComponent>().Translation = glm::vec3(0.0f, 0.0f, -10.0f);
+		hidden.AddComponent<MeshComponent>().MeshGeometry = CreateBoxMesh(glm::vec3(1.0f));
+
+		auto render = [&]()
+		{
+			engine.BeginFrame();
+			scene.OnRenderEditor(camera);
+			engine.EndFrame();
+			return SceneRenderer::GetStats();
+		};
+
+		ILLUMINO_CHECK(render().OccludedMeshes == 0);
+		ILLUMINO_CHECK(wallMesh->GetSubmesh(0).Positions.empty());
+
+		wall.PatchComponent<MeshComponent>().Occluder = true;
+		const SceneRendererStats stats = render();
+		ILLUMINO_CHECK(wallMesh->HasOccluderGeometry());
+		ILLUMINO_CHECK(stats.OccluderTriangles == 12);
+		ILLUMINO_CHECK(stats.OccludedMeshes == 1);
+	}
+
+	// Material parameters belong to the shared submesh, editing them re-uploads one material entry and no instances
+	ILLUMINO_TEST(SceneRendererSharedMaterialEdits)
+	{
+		HeadlessEngine engine;
+		TestCamera camera;
+		camera.LookAt(glm::vec3(0.0f, 0.0f, 20.0f), glm::vec3(0.0f));
+
+		Ref<Mesh> box = CreateBoxMesh(glm::vec3(0.5f));
+		Scene scene;
+		for (uint32_t i = 0; i < 10; ++i)
+		{
+			Entity entity = scene.CreateEntity("Box");
+			entity.GetComponent<TransformComponent>().Translation.x = (float)i * 2.0f - 10.0f;
+			entity.AddComponent<MeshComponent>().MeshGeometry = box;
+		}
+
+		auto render = [&]()
+		{
+			engine.BeginFrame();
+			scene.OnRenderEditor(camera);
+			engine.EndFrame();
+			return SceneRenderer::GetStats();
+		};
+
+		// Every frame in flight gets its copy once
+		for (uint32_t frame = 0; frame < g_QueueSlotCount; ++frame)
+			ILLUMINO_CHECK(render().UploadedMaterials == 1);
+		ILLUMINO_CHECK(render().UploadedMaterials == 0);
+
+		box->GetSubmesh(0).Roughness = 0.25f;
+		const SceneRendererStats stats = render();
+		ILLUMINO_CHECK(stats.UploadedMaterials == 1);
+		ILLUMINO_CHECK(stats.UploadedInstances == 0);
+
+		// A copy of the submesh is its own material
+		Submesh copy = box->GetSubmesh(0);
+		FrameVector<Entity> noLights;
+		engine.BeginFrame();
+		SceneRenderer::BeginScene(camera, noLights, noLights);
+		SceneRenderer::SubmitMesh(box->GetSubmesh(0), glm::mat4(1.0f), 0, false);
+		SceneRenderer::SubmitMesh(copy, glm::mat4(1.0f), 1, false);
+		SceneRenderer::EndScene();
+		engine.EndFrame();
+		ILLUMINO_CHECK(copy.MaterialIndex != box->GetSubmesh(0).MaterialIndex);
+	}
+}
@@ -0,0 +1,78 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+#include "HeadlessEngine.h"
+
+#include <cmath>
+#include <random>
+
+#include "Illumino/Renderer/FrustumCuller.h"
+#include "Illumino/Renderer/ShadowCascades.h"
+
+namespace IlluminoEngine
+{
+	// Cascade setup and per cascade caster culling for a low sun over 100k boxes of mixed sizes scattered on a
+	// 1 km wide terrain, the camera flies over it and looks toward the horizon
+	ILLUMINO_BENCHMARK(ShadowCascadesCasterCulling)
+	{
+		HeadlessEngine engine;
+
+		constexpr uint32_t objectCount = 100000;
+		constexpr uint32_t frameCount = 50;
+
+		FrustumCuller culler;
+		eastl::vector<uint8_t> visible;
+		std::mt19937 random(5);
+		std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+		std::uniform_real_distribution<float> size(0.25f, 8.0f);
+		eastl::vector<glm::mat4> transforms;
+		eastl::vector<AABB> bounds;
+		for (uint32_t i = 0; i < objectCount; ++i)
+		{
+			const float height = size(random);
+			transforms.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(position(random), height, position(random))));
+			bounds.push_back({ glm::vec3(-size(random), -height, -size(random)), glm::vec3(size(random), height, size(random)) });
+		}
+
+		TestCamera camera(1.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+		ShadowSettings settings;
+		ShadowCascades cascades;
+		const glm::vec3 sunDirection = glm::normalize(glm::vec3(0.6f, -0.35f, 0.4f));
+
+		ShadowTimings timings;
+		uint32_t casters[ShadowCascades::MaxCascades] = {};
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			const float t = (float)frame / frameCount;
+			const glm::vec3 eye = glm::vec3(-300.0f + 600.0f * t, 20.0f, -200.0f);
+			camera.LookAt(eye, eye + glm::vec3(std::sin(t * 3.0f), -0.15f, std::cos(t * 3.0f)));
+
+			// The scene fills the culler for the camera before the cascades cull against it
+			culler.Begin(camera.GetProjection() * camera.GetView(), objectCount);
+			for (uint32_t i = 0; i < objectCount; ++i)
+				culler.Add(bounds[i], transforms[i]);
+			culler.Cull(visible);
+
+			cascades.Update(camera.GetView(), camera.GetProjection(), sunDirection, settings);
+			cascades.CullCasters(culler);
+
+			timings.Setup += cascades.GetTimings().Setup / frameCount;
+			timings.CasterCulling += cascades.GetTimings().CasterCulling / frameCount;
+			for (uint32_t cascade = 0; cascade < cascades.GetCascadeCount(); ++cascade)
+				casters[cascade] += cascades.GetCascade(cascade).CasterCount;
+		}
+
+		ILLUMINO_CHECK(cascades.GetCascadeCount() == settings.CascadeCount);
+		for (uint32_t cascade = 0; cascade < cascades.GetCascadeCount(); ++cascade)
+		{
+			const ShadowCascade& data = cascades.GetCascade(cascade);
+			ILLUMINO_CHECK(data.CasterCount > 0 && data.CasterCount < objectCount);
+			ILLUMINO_CHECK(cascades.GetCasters(cascade).size() == data.CasterCount);
+			ILLUMINO_CHECK(cascade == 0 || data.SplitDepth > cascades.GetCascade(cascade - 1).SplitDepth);
+		}
+
+		ILLUMINO_INFO("{0} objects, {1} camera visible: setup {2:.3f} ms, caster culling {3:.3f} ms", objectCount, culler.GetVisibleCount(),
+			timings.Setup, timings.CasterCulling);
+		ILLUMINO_INFO("Average casters per cascade: {0}, {1}, {2}, {3}", casters[0] / frameCount, casters[1] / frameCount,
+			casters[2] / frameCount, casters[3] / frameCount);
+	}
+}
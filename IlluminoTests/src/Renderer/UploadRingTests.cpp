@@ -0,0 +1,95 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+
+#include "Illumino/Renderer/UploadRing.h"
+
+namespace IlluminoEngine
+{
+	// Padding in front of aligned allocations counts as used until the frame is reclaimed
+	ILLUMINO_TEST(UploadRingAlignment)
+	{
+		UploadRing ring(1024);
+
+		ILLUMINO_CHECK(ring.Allocate(10, 1) == 0);
+		ILLUMINO_CHECK(ring.Allocate(16, 256) == 256);
+		ILLUMINO_CHECK(ring.GetUsedBytes() == 256 + 16);
+
+		ILLUMINO_CHECK(ring.Allocate(8, 16) == 272);
+		ILLUMINO_CHECK(ring.GetUsedBytes() == 280);
+
+		ring.FinishFrame(1);
+		ring.Reclaim(0);
+		ILLUMINO_CHECK(ring.GetUsedBytes() == 280);
+		ring.Reclaim(1);
+		ILLUMINO_CHECK(ring.GetUsedBytes() == 0);
+
+		// Nothing in flight, the ring starts over at the beginning
+		ILLUMINO_CHECK(ring.Allocate(512, 512) == 0);
+		ILLUMINO_CHECK(ring.Allocate(2048, 1) == UploadRing::InvalidOffset);
+		ILLUMINO_CHECK(ring.GetGrowCapacity(2048, 1) == 4096);
+	}
+
+	// Allocations that don't fit in the space left at the end wrap to the front, the skipped bytes belong to the frame
+	// that wrapped. A full ring rejects everything until a frame is reclaimed.
+	ILLUMINO_TEST(UploadRingWrapAround)
+	{
+		UploadRing ring(1024);
+
+		ILLUMINO_CHECK(ring.Allocate(600, 1) == 0);
+		ring.FinishFrame(1);
+		ILLUMINO_CHECK(ring.Allocate(300, 1) == 600);
+		ring.FinishFrame(2);
+
+		// Frame 1 is still in flight, 124 bytes at the end and nothing at the front
+		ILLUMINO_CHECK(ring.Allocate(200, 1) == UploadRing::InvalidOffset);
+		ILLUMINO_CHECK(ring.GetUsedBytes() == 900);
+
+		ring.Reclaim(1);
+		ILLUMINO_CHECK(ring.GetUsedBytes() == 300);
+		// The front only has 600 bytes free
+		ILLUMINO_CHECK(ring.Allocate(700, 1) == UploadRing::InvalidOffset);
+		ILLUMINO_CHECK(ring.Allocate(200, 1) == 0);
+		ILLUMINO_CHECK(ring.GetUsedBytes() == 300 + 124 + 200);
+
+		// Fills the ring up to the tail exactly, head == tail is full and not empty
+		ILLUMINO_CHECK(ring.Allocate(400, 1) == 200);
+		ILLUMINO_CHECK(ring.GetUsedBytes() == ring.GetCapacity());
+		ILLUMINO_CHECK(ring.Allocate(1, 1) == UploadRing::InvalidOffset);
+		ring.FinishFrame(3);
+
+		ring.Reclaim(2);
+		ILLUMINO_CHECK(ring.GetUsedBytes() == 724);
+		// Only the 300 bytes of frame 2 are free, after the head
+		ILLUMINO_CHECK(ring.Allocate(400, 1) == UploadRing::InvalidOffset);
+		ILLUMINO_CHECK(ring.Allocate(300, 1) == 600);
+		ring.FinishFrame(4);
+
+		ring.Reclaim(4);
+		ILLUMINO_CHECK(ring.GetUsedBytes() == 0);
+	}
+
+	// Only eight frames can be in flight, the oldest two are merged and reclaimed together under the newer fence
+	ILLUMINO_TEST(UploadRingMergesOldestFrames)
+	{
+		UploadRing ring(1024);
+
+		for (uint64_t fence = 1; fence <= 9; ++fence)
+		{
+			ILLUMINO_CHECK(ring.Allocate(10, 1) == (fence - 1) * 10);
+			ring.FinishFrame(fence);
+		}
+		ILLUMINO_CHECK(ring.GetUsedBytes() == 90);
+
+		// Frames without allocations don't add a marker
+		ring.FinishFrame(10);
+
+		ring.Reclaim(1);
+		ILLUMINO_CHECK(ring.GetUsedBytes() == 90);
+		ring.Reclaim(2);
+		ILLUMINO_CHECK(ring.GetUsedBytes() == 70);
+		ring.Reclaim(8);
+		ILLUMINO_CHECK(ring.GetUsedBytes() == 10);
+		ring.Reclaim(10);
+		ILLUMINO_CHECK(ring.GetUsedBytes() == 0);
+	}
+}
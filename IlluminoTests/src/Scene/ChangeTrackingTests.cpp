@@ -0,0 +1,102 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+#include "TestAssets.h"
+#include "HeadlessEngine.h"
+
+namespace IlluminoEngine
+{
+	static uint32_t RenderFrame(HeadlessEngine& engine, Scene& scene, const Camera& camera)
+	{
+		engine.BeginFrame();
+		scene.OnRenderEditor(camera);
+		engine.EndFrame();
+		return SceneRenderer::GetStats().UploadedLights;
+	}
+
+	// Reading a component must not look like an edit, only PatchComponent reports one
+	ILLUMINO_TEST(GetComponentDoesNotMarkChanges)
+	{
+		HeadlessEngine engine;
+		TestCamera camera;
+		camera.LookAt(glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(0.0f));
+
+		// Lights are only uploaded on frames that draw something
+		Scene scene;
+		scene.CreateEntity("Box").AddComponent<MeshComponent>().MeshGeometry = CreateBoxMesh(glm::vec3(1.0f));
+
+		Entity light = scene.CreateEntity("Light");
+		light.AddComponent<PointLightComponent>();
+
+		// Every frame in flight uploads the new lights once
+		for (uint32_t frame = 0; frame < 4; ++frame)
+			RenderFrame(engine, scene, camera);
+
+		float intensity = 0.0f;
+		for (uint32_t frame = 0; frame < 4; ++frame)
+		{
+			intensity += light.GetComponent<PointLightComponent>().Intensity;
+			intensity += light.GetComponent<TransformComponent>().Translation.x;
+			ILLUMINO_CHECK(RenderFrame(engine, scene, camera) == 0);
+		}
+		ILLUMINO_CHECK(intensity == 4.0f);
+
+		light.GetComponent<PointLightComponent>().Intensity = 2.0f;
+		light.PatchComponent<PointLightComponent>();
+		ILLUMINO_CHECK(RenderFrame(engine, scene, camera) == 1);
+	}
+
+	static uint32_t RenderUploads(HeadlessEngine& engine, Scene& scene, const Camera& camera, uint32_t frames)
+	{
+		uint32_t uploads = 0;
+		for (uint32_t frame = 0; frame < frames; ++frame)
+		{
+			engine.BeginFrame();
+			scene.OnRenderEditor(camera);
+			engine.EndFrame();
+			uploads += SceneRenderer::GetStats().UploadedInstances;
+		}
+		return uploads;
+	}
+
+	// Entities keep their instance slot while they are culled, coming back into view does not upload them again
+	ILLUMINO_TEST(InstanceSlotsSurviveCulling)
+	{
+		HeadlessEngine engine;
+		TestCamera camera;
+
+		constexpr uint32_t count = 200;
+		Ref<Mesh> box = CreateBoxMesh(glm::vec3(0.5f));
+		Scene scene;
+		eastl::vector<Entity> entities;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			Entity entity = scene.CreateEntity("Box");
+			entity.GetComponent<TransformComponent>().Translation = glm::vec3((float)i - count * 0.5f, 0.0f, 0.0f);
+			entity.AddComponent<MeshComponent>().MeshGeometry = box;
+			entities.push_back(entity);
+		}
+
+		const glm::vec3 overview = glm::vec3(0.0f, 0.0f, 200.0f);
+		const glm::vec3 left = glm::vec3(-80.0f, 0.0f, 10.0f);
+		camera.LookAt(overview, glm::vec3(0.0f));
+		ILLUMINO_CHECK(RenderUploads(engine, scene, camera, g_QueueSlotCount) == count * g_QueueSlotCount);
+
+		camera.LookAt(left, left - glm::vec3(0.0f, 0.0f, 1.0f));
+		ILLUMINO_CHECK(RenderUploads(engine, scene, camera, g_QueueSlotCount) == 0);
+
+		// A culled entity that moved is uploaded once it is back in view
+		entities[count - 1].GetComponent<TransformComponent>().Translation.y = 1.0f;
+		entities[count - 1].PatchComponent<TransformComponent>();
+		ILLUMINO_CHECK(RenderUploads(engine, scene, camera, g_QueueSlotCount) == 0);
+
+		camera.LookAt(overview, glm::vec3(0.0f));
+		ILLUMINO_CHECK(RenderUploads(engine, scene, camera, g_QueueSlotCount) == g_QueueSlotCount);
+
+		// A freed slot is reused by the next entity and uploaded for its new owner
+		scene.DestroyEntity(entities[0]);
+		scene.FlushDestroyedEntities();
+		Entity replacement = scene.CreateEntity("Replacement");
+		replacement.AddComponent<MeshComponent>().MeshGeometry = box;
+		ILLUMINO_CHECK(RenderUploads(engine, scene, camera, g_QueueSlotCount) == g_QueueSlotCount);
+	}
+}
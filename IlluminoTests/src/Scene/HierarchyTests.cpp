@@ -0,0 +1,71 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+
+namespace IlluminoEngine
+{
+	ILLUMINO_TEST(HierarchyEffectiveState)
+	{
+		Scene scene;
+		Entity hidden = scene.CreateEntity("Hidden");
+		Entity inactive = scene.CreateEntity("Inactive");
+		Entity child = scene.CreateEntity("Child");
+		Entity grandchild = scene.CreateEntity("Grandchild");
+		scene.SetParent(grandchild, child);
+
+		scene.SetVisible(hidden, false);
+		scene.SetActive(inactive, false);
+
+		scene.SetParent(child, hidden);
+		ILLUMINO_CHECK(!scene.IsVisibleInHierarchy(grandchild) && scene.IsActiveInHierarchy(grandchild));
+
+		scene.SetParent(child, inactive);
+		ILLUMINO_CHECK(scene.IsVisibleInHierarchy(grandchild) && !scene.IsActiveInHierarchy(grandchild));
+
+		scene.RemoveParent(child);
+		ILLUMINO_CHECK(scene.IsVisibleInHierarchy(grandchild) && scene.IsActiveInHierarchy(grandchild));
+
+		// Entities pending destruction keep their state until they are flushed
+		scene.SetParent(child, hidden);
+		scene.DestroyEntity(child);
+		scene.SetVisible(hidden, true);
+		ILLUMINO_CHECK(!scene.IsVisibleInHierarchy(grandchild));
+		ILLUMINO_CHECK(hidden.GetComponent<RelationshipComponent>().Children.empty());
+		scene.FlushDestroyedEntities();
+		ILLUMINO_CHECK(scene.IsVisibleInHierarchy(hidden));
+	}
+
+	// A batch with parent indices creates the same hierarchy as creating and parenting the entities one by one
+	ILLUMINO_TEST(HierarchyCreateEntitiesBatch)
+	{
+		Scene scene;
+		Entity hidden = scene.CreateEntity("Hidden");
+		scene.SetVisible(hidden, false);
+
+		const eastl::vector<uint32_t> parents = { Scene::k_InvalidIndex, 0, 0, 1, Scene::k_InvalidIndex };
+		const eastl::vector<const char*> names = { "Root", "Left", "Right", "Leaf", "Sibling" };
+		eastl::vector<Entity> entities = scene.CreateEntities(parents, names, hidden);
+		ILLUMINO_CHECK(entities.size() == 5);
+		ILLUMINO_CHECK(scene.GetEntityMap().size() == 6);
+
+		for (uint32_t i = 0; i < 5; ++i)
+		{
+			ILLUMINO_CHECK(entities[i].GetComponent<TagComponent>().Tag == names[i]);
+			ILLUMINO_CHECK(scene.GetParent(entities[i]) == (parents[i] == Scene::k_InvalidIndex ? hidden : entities[parents[i]]));
+			ILLUMINO_CHECK(!scene.IsVisibleInHierarchy(entities[i]));
+		}
+
+		const auto& hiddenChildren = hidden.GetComponent<RelationshipComponent>().Children;
+		ILLUMINO_CHECK(hiddenChildren.size() == 2);
+		ILLUMINO_CHECK(hiddenChildren[0] == entities[0].GetComponent<IDComponent>().ID && hiddenChildren[1] == entities[4].GetComponent<IDComponent>().ID);
+		const auto& rootChildren = entities[0].GetComponent<RelationshipComponent>().Children;
+		ILLUMINO_CHECK(rootChildren.size() == 2 && rootChildren[1] == entities[2].GetComponent<IDComponent>().ID);
+
+		scene.SetVisible(hidden, true);
+		ILLUMINO_CHECK(scene.IsVisibleInHierarchy(entities[3]));
+
+		// Without names every entity gets the default one, without a parent the roots stay roots
+		eastl::vector<Entity> unnamed = scene.CreateEntities({ Scene::k_InvalidIndex, 0 }, {});
+		ILLUMINO_CHECK(unnamed[0].GetComponent<TagComponent>().Tag == "Entity");
+		ILLUMINO_CHECK(!scene.GetParent(unnamed[0]) && scene.GetParent(unnamed[1]) == unnamed[0]);
+	}
+}
@@ -0,0 +1,55 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+
+namespace IlluminoEngine
+{
+	// Components edited on an instance are overrides, propagating the prefab updates everything else
+	ILLUMINO_TEST(PrefabOverridesSurvivePropagation)
+	{
+		Scene scene;
+		Entity source = scene.CreateEntity("Lamp");
+		Entity bulb = scene.CreateEntity("Bulb");
+		bulb.AddComponent<PointLightComponent>().Intensity = 1.0f;
+		scene.SetParent(bulb, source);
+
+		Ref<Prefab> prefab = scene.CreatePrefab(source);
+		Entity edited = scene.InstantiatePrefab(prefab);
+		Entity untouched = scene.InstantiatePrefab(prefab);
+
+		auto getBulb = [&](Entity root)
+		{
+			return scene.GetEntityMap().at(root.GetComponent<RelationshipComponent>().Children[0]);
+		};
+
+		Entity editedBulb = getBulb(edited);
+		editedBulb.PatchComponent<PointLightComponent>().Intensity = 5.0f;
+		editedBulb.SetPrefabOverride(GetPrefabOverride<PointLightComponent>());
+
+		// Adding and removing components are overrides too
+		edited.AddComponent<DirectionalLightComponent>();
+		edited.SetPrefabOverride(GetPrefabOverride<DirectionalLightComponent>());
+		Entity strippedBulb = getBulb(untouched);
+		strippedBulb.RemoveComponent<PointLightComponent>();
+		strippedBulb.SetPrefabOverride(GetPrefabOverride<PointLightComponent>());
+		Entity third = scene.InstantiatePrefab(prefab);
+
+		bulb.PatchComponent<PointLightComponent>().Intensity = 2.0f;
+		bulb.PatchComponent<PointLightComponent>().Radius = 3.0f;
+		bulb.GetComponent<TagComponent>().Tag = "Warm Bulb";
+		scene.UpdatePrefab(prefab, source);
+
+		ILLUMINO_CHECK(editedBulb.GetComponent<PointLightComponent>().Intensity == 5.0f);
+		ILLUMINO_CHECK(editedBulb.GetComponent<PointLightComponent>().Radius != 3.0f);
+		ILLUMINO_CHECK(editedBulb.GetComponent<TagComponent>().Tag == "Warm Bulb");
+		ILLUMINO_CHECK(getBulb(third).GetComponent<PointLightComponent>().Intensity == 2.0f);
+		ILLUMINO_CHECK(getBulb(third).GetComponent<PointLightComponent>().Radius == 3.0f);
+		ILLUMINO_CHECK(edited.HasComponent<DirectionalLightComponent>());
+		ILLUMINO_CHECK(!strippedBulb.HasComponent<PointLightComponent>());
+		ILLUMINO_CHECK(strippedBulb.GetComponent<TagComponent>().Tag == "Warm Bulb");
+		ILLUMINO_CHECK(!third.HasComponent<DirectionalLightComponent>());
+
+		// Entities outside of prefabs have nothing to override
+		source.SetPrefabOverride(PrefabOverride_Transform);
+		ILLUMINO_CHECK(!source.HasComponent<PrefabInstanceComponent>());
+	}
+}
@@ -0,0 +1,49 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+
+namespace IlluminoEngine
+{
+	// Transform+mesh iteration through a multi-component view against the owning group Scene uses for
+	// render extraction. Meshes are added to every other entity in reverse order so the pools are
+	// ordered differently, like a scene that has been edited for a while.
+	ILLUMINO_BENCHMARK(RenderExtractionViewVsGroup)
+	{
+		constexpr uint32_t entityCount = 500000;
+
+		entt::registry viewRegistry;
+		entt::registry groupRegistry;
+		auto group = groupRegistry.group<TransformComponent, MeshComponent>();
+
+		for (entt::registry* registry : { &viewRegistry, &groupRegistry })
+		{
+			eastl::vector<entt::entity> entities(entityCount);
+			registry->create(entities.begin(), entities.end());
+			registry->insert<TransformComponent>(entities.begin(), entities.end());
+			for (int32_t i = entityCount - 1; i >= 0; i -= 2)
+				registry->emplace<MeshComponent>(entities[i]);
+		}
+
+		float sink = 0.0f;
+		const double viewTime = MeasureMs(20, [&]()
+		{
+			auto view = viewRegistry.view<TransformComponent, MeshComponent>();
+			for (entt::entity entity : view)
+			{
+				auto [transform, mesh] = view.get<TransformComponent, MeshComponent>(entity);
+				sink += transform.Translation.x + mesh.SubmeshIndex;
+			}
+		});
+
+		const double groupTime = MeasureMs(20, [&]()
+		{
+			for (entt::entity entity : group)
+			{
+				auto [transform, mesh] = group.get<TransformComponent, MeshComponent>(entity);
+				sink += transform.Translation.x + mesh.SubmeshIndex;
+			}
+		});
+
+		ILLUMINO_CHECK(group.size() == entityCount / 2);
+		ILLUMINO_INFO("{0} entities, {1} with a mesh: view {2:.3f} ms, owning group {3:.3f} ms ({4})", entityCount, group.size(), viewTime, groupTime, sink);
+	}
+}
@@ -0,0 +1,56 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+#include "TestAssets.h"
+#include "HeadlessEngine.h"
+
+namespace IlluminoEngine
+{
+	// Clone, snapshot and restore of a 100k entity scene: 1000 roots with 99 mesh children each, every mesh entity
+	// shares one box
+	ILLUMINO_BENCHMARK(SceneCloneSnapshot)
+	{
+		HeadlessEngine engine;
+
+		constexpr uint32_t rootCount = 1000;
+		constexpr uint32_t childCount = 99;
+		constexpr uint32_t entityCount = rootCount * (childCount + 1);
+		constexpr uint32_t iterations = 10;
+
+		Ref<Mesh> box = CreateBoxMesh(glm::vec3(0.5f));
+
+		Scene scene;
+		for (uint32_t i = 0; i < rootCount; ++i)
+		{
+			Entity root = scene.CreateEntity("Root");
+			root.PatchComponent<TransformComponent>().Translation = glm::vec3((float)i, 0.0f, 0.0f);
+			for (Entity child : scene.CreateEntities(childCount, root, "Child"))
+				child.AddComponent<MeshComponent>().MeshGeometry = box;
+		}
+		ILLUMINO_CHECK(scene.GetEntityMap().size() == entityCount);
+
+		Ref<Scene> clone;
+		const double cloneTime = MeasureMs(iterations, [&]()
+		{
+			clone = nullptr;
+			clone = scene.Clone();
+		});
+		ILLUMINO_CHECK(clone->GetEntityMap().size() == entityCount);
+		clone = nullptr;
+
+		Ref<SceneSnapshot> snapshot;
+		const double snapshotTime = MeasureMs(iterations, [&]()
+		{
+			snapshot = scene.CreateSnapshot();
+		});
+		ILLUMINO_CHECK(snapshot->GetEntityCount() == entityCount);
+
+		const double restoreTime = MeasureMs(iterations, [&]()
+		{
+			scene.RestoreSnapshot(*snapshot);
+		});
+		ILLUMINO_CHECK(scene.GetEntityMap().size() == entityCount);
+
+		ILLUMINO_INFO("{0} entities: clone {1:.3f} ms, snapshot {2:.3f} ms ({3:.2f} MB), restore {4:.3f} ms", entityCount, cloneTime,
+			snapshotTime, snapshot->GetMemoryUsage() / (1024.0 * 1024.0), restoreTime);
+	}
+}
@@ -0,0 +1,92 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+#include "TestAssets.h"
+#include "HeadlessEngine.h"
+
+namespace IlluminoEngine
+{
+	// Clones and restored snapshots keep UUIDs, the hierarchy and tags, and share mesh assets instead of copying them
+	ILLUMINO_TEST(SceneCloneAndSnapshot)
+	{
+		HeadlessEngine engine;
+
+		Ref<Mesh> box = CreateBoxMesh(glm::vec3(1.0f), "SharedBox");
+
+		Scene scene;
+		Entity root = scene.CreateEntity("Root");
+		Entity left = scene.CreateEntity("Left");
+		Entity right = scene.CreateEntity("Right");
+		Entity leaf = scene.CreateEntity("Leaf");
+		scene.SetParent(left, root);
+		scene.SetParent(right, root);
+		scene.SetParent(leaf, left);
+		left.AddComponent<MeshComponent>().MeshGeometry = box;
+		leaf.AddComponent<MeshComponent>().MeshGeometry = box;
+		leaf.PatchComponent<TransformComponent>().Translation = glm::vec3(1.0f, 2.0f, 3.0f);
+
+		const UUID rootID = root.GetComponent<IDComponent>().ID;
+		const UUID leftID = left.GetComponent<IDComponent>().ID;
+		const UUID rightID = right.GetComponent<IDComponent>().ID;
+		const UUID leafID = leaf.GetComponent<IDComponent>().ID;
+
+		auto checkScene = [&](Scene& checked)
+		{
+			const eastl::hash_map<UUID, Entity>& map = checked.GetEntityMap();
+			ILLUMINO_CHECK(map.size() == 4);
+			if (map.size() != 4 || map.find(rootID) == map.end() || map.find(leftID) == map.end() || map.find(rightID) == map.end() || map.find(leafID) == map.end())
+				return;
+
+			Entity r = map.at(rootID), l = map.at(leftID), rr = map.at(rightID), lf = map.at(leafID);
+			ILLUMINO_CHECK(r.GetComponent<TagComponent>().Tag == "Root");
+			ILLUMINO_CHECK(l.GetComponent<TagComponent>().Tag == "Left");
+			ILLUMINO_CHECK(rr.GetComponent<TagComponent>().Tag == "Right");
+			ILLUMINO_CHECK(lf.GetComponent<TagComponent>().Tag == "Leaf");
+
+			const RelationshipComponent& rootRelationship = r.GetComponent<RelationshipComponent>();
+			ILLUMINO_CHECK(!rootRelationship.Parent);
+			ILLUMINO_CHECK(rootRelationship.Children.size() == 2 && rootRelationship.Children[0] == leftID && rootRelationship.Children[1] == rightID);
+			ILLUMINO_CHECK(l.GetComponent<RelationshipComponent>().Parent == rootID);
+			ILLUMINO_CHECK(rr.GetComponent<RelationshipComponent>().Parent == rootID);
+			ILLUMINO_CHECK(lf.GetComponent<RelationshipComponent>().Parent == leftID);
+			ILLUMINO_CHECK(l.GetComponent<RelationshipComponent>().Children.size() == 1);
+			ILLUMINO_CHECK(checked.GetParent(lf) == l);
+
+			ILLUMINO_CHECK(l.GetComponent<MeshComponent>().MeshGeometry == box);
+			ILLUMINO_CHECK(lf.GetComponent<MeshComponent>().MeshGeometry == box);
+			ILLUMINO_CHECK(!rr.HasComponent<MeshComponent>());
+			ILLUMINO_CHECK(lf.GetComponent<TransformComponent>().Translation == glm::vec3(1.0f, 2.0f, 3.0f));
+		};
+
+		const long references = box.use_count();
+		Ref<Scene> clone = scene.Clone();
+		checkScene(*clone);
+		// Same handles as the source, in the clone's own registry
+		ILLUMINO_CHECK(clone->GetEntityMap().at(leafID) == Entity(leaf, clone.get()));
+		ILLUMINO_CHECK(box.use_count() == references + 2);
+
+		// Editing the clone leaves the source alone
+		clone->GetEntityMap().at(rightID).GetComponent<TagComponent>().Tag = "Edited";
+		clone->DeleteEntity(clone->GetEntityMap().at(leafID));
+		checkScene(scene);
+		clone = nullptr;
+		ILLUMINO_CHECK(box.use_count() == references);
+
+		Ref<SceneSnapshot> snapshot = scene.CreateSnapshot();
+		ILLUMINO_CHECK(snapshot->GetEntityCount() == 4);
+
+		// Undo everything done after the snapshot: renames, reparenting, deleting and new entities
+		right.GetComponent<TagComponent>().Tag = "Renamed";
+		scene.SetParent(leaf, right);
+		scene.DeleteEntity(left);
+		scene.CreateEntity("Added").AddComponent<MeshComponent>().MeshGeometry = CreateBoxMesh(glm::vec3(2.0f));
+
+		scene.RestoreSnapshot(*snapshot);
+		checkScene(scene);
+		ILLUMINO_CHECK(scene.GetEntityMap().at(leafID) == leaf);
+
+		// The snapshot holds the mesh for the restored components
+		ILLUMINO_CHECK(box.use_count() == references + 2);
+		snapshot = nullptr;
+		ILLUMINO_CHECK(box.use_count() == references);
+	}
+}
@@ -0,0 +1,81 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+
+namespace IlluminoEngine
+{
+	// Memory stats of a scene whose layout is known: 10000 entities created in one batch fill their pools exactly and
+	// span two sparse pages, a few of them get lights, children and tags too long for the small string buffer
+	ILLUMINO_TEST(SceneMemoryStatsKnownLayout)
+	{
+		constexpr size_t entityCount = 10000;
+		constexpr size_t entitiesPerPage = ENTT_PAGE_SIZE / sizeof(entt::entity);
+		static_assert(entityCount > entitiesPerPage && entityCount <= entitiesPerPage * 2, "The entities are expected to span two sparse pages");
+
+		Scene scene;
+		eastl::vector<Entity> entities = scene.CreateEntities(entityCount);
+
+		// Only the second sparse page of the light pool is allocated
+		entities[entitiesPerPage + 1].AddComponent<PointLightComponent>();
+		entities[entitiesPerPage + 2].AddComponent<PointLightComponent>();
+
+		for (uint32_t i = 1; i <= 10; ++i)
+			scene.SetParent(entities[i], entities[0]);
+		const char* longTag = "A tag that is far too long to fit in the string itself";
+		for (uint32_t i = 0; i < 4; ++i)
+			entities[i].GetComponent<TagComponent>().Tag = longTag;
+
+		const SceneMemoryStats stats = scene.GetMemoryStats();
+		auto find = [&stats](const char* name) -> const ComponentMemoryStats&
+		{
+			for (const ComponentMemoryStats& component : stats.Components)
+			{
+				if (strcmp(component.Name, name) == 0)
+					return component;
+			}
+			static ComponentMemoryStats missing;
+			ILLUMINO_CHECK(false);
+			return missing;
+		};
+
+		const size_t twoPages = 2 * ENTT_PAGE_SIZE + 2 * sizeof(void*);
+		auto checkBatchPool = [&](const char* name, size_t componentSize, size_t heapBytes)
+		{
+			const ComponentMemoryStats& component = find(name);
+			ILLUMINO_CHECK(component.Count == entityCount);
+			ILLUMINO_CHECK(component.DenseBytes == entityCount * (sizeof(entt::entity) + componentSize));
+			ILLUMINO_CHECK(component.SlackBytes == 0);
+			ILLUMINO_CHECK(component.SparseBytes == twoPages);
+			ILLUMINO_CHECK(component.HeapBytes == heapBytes);
+		};
+
+		const size_t childBytes = entities[0].GetComponent<RelationshipComponent>().Children.capacity() * sizeof(UUID);
+		const size_t tagBytes = 4 * (entities[0].GetComponent<TagComponent>().Tag.capacity() + 1);
+		ILLUMINO_CHECK(childBytes >= 10 * sizeof(UUID));
+		checkBatchPool("ID", sizeof(IDComponent), 0);
+		checkBatchPool("Relationship", sizeof(RelationshipComponent), childBytes);
+		checkBatchPool("Tag", sizeof(TagComponent), tagBytes);
+		checkBatchPool("Transform", sizeof(TransformComponent), 0);
+
+		// Pools that grew one component at a time may have unused capacity, the sparse array still has room for the first page
+		const ComponentMemoryStats& lights = find("PointLight");
+		const size_t lightSize = sizeof(entt::entity) + sizeof(PointLightComponent);
+		ILLUMINO_CHECK(lights.Count == 2);
+		ILLUMINO_CHECK(lights.DenseBytes >= 2 * lightSize && lights.DenseBytes == lights.SlackBytes + 2 * lightSize);
+		ILLUMINO_CHECK(lights.SparseBytes == ENTT_PAGE_SIZE + 2 * sizeof(void*));
+		ILLUMINO_CHECK(lights.HeapBytes == 0);
+
+		const ComponentMemoryStats& mesh = find("Mesh");
+		ILLUMINO_CHECK(mesh.Count == 0 && mesh.SparseBytes == 0 && mesh.HeapBytes == 0);
+
+		// Registry entity list and one node per entity in the UUID map plus its buckets
+		using EntityMapNode = eastl::hash_map<UUID, Entity>::node_type;
+		ILLUMINO_CHECK(stats.EntityBytes == entityCount * sizeof(entt::entity));
+		ILLUMINO_CHECK(stats.EntityMapBytes == entityCount * sizeof(EntityMapNode) + scene.GetEntityMap().bucket_count() * sizeof(EntityMapNode*));
+		ILLUMINO_CHECK(scene.GetEntityMap().bucket_count() >= entityCount);
+
+		size_t total = stats.EntityBytes + stats.EntityMapBytes;
+		for (const ComponentMemoryStats& component : stats.Components)
+			total += component.DenseBytes + component.SparseBytes + component.HeapBytes;
+		ILLUMINO_CHECK(stats.TotalBytes == total);
+	}
+}
@@ -0,0 +1,76 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+#include "TestAssets.h"
+#include "HeadlessEngine.h"
+
+#include <random>
+
+namespace IlluminoEngine
+{
+	// Frustum query through the scene's BVH against testing every mesh entity, on 100k boxes scattered in a
+	// 200 unit cube with a camera in the middle
+	ILLUMINO_BENCHMARK(SpatialIndexFrustumQuery)
+	{
+		HeadlessEngine engine;
+
+		constexpr uint32_t entityCount = 100000;
+
+		Ref<Mesh> box = CreateBoxMesh(glm::vec3(0.5f));
+		const AABB& bounds = box->GetSubmesh(0).Bounds;
+
+		Scene scene;
+		eastl::vector<Entity> entities;
+		entities.reserve(entityCount);
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+		for (uint32_t i = 0; i < entityCount; ++i)
+		{
+			Entity entity = scene.CreateEntity("Box");
+			entity.GetComponent<TransformComponent>().Translation = glm::vec3(distribution(random), distribution(random), distribution(random));
+			entity.AddComponent<MeshComponent>().MeshGeometry = box;
+			entities.push_back(entity);
+		}
+
+		TestCamera camera(1.0f, 16.0f / 9.0f, 0.1f, 60.0f);
+		camera.LookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.2f, 0.5f));
+		const Frustum frustum(camera.GetProjection() * camera.GetView());
+
+		// The first frame builds the tree and clears the change sets, later queries only walk it
+		const double buildTime = MeasureMs(1, [&]()
+		{
+			engine.BeginFrame();
+			scene.OnRenderEditor(camera);
+			engine.EndFrame();
+		});
+
+		uint32_t bruteForceCount = 0;
+		const double bruteForceTime = MeasureMs(10, [&]()
+		{
+			bruteForceCount = 0;
+			for (Entity entity : entities)
+			{
+				const AABB worldBounds = Math::TransformAABB(bounds, entity.GetComponent<TransformComponent>().GetTransform());
+				const glm::vec3 center = worldBounds.GetCenter();
+				const glm::vec3 extents = worldBounds.GetExtents();
+
+				bool inside = true;
+				for (const glm::vec4& plane : frustum.Planes)
+					inside &= glm::dot(glm::vec3(plane), center) + plane.w + glm::dot(glm::abs(glm::vec3(plane)), extents) >= 0.0f;
+				bruteForceCount += inside;
+			}
+		});
+
+		eastl::vector<Entity> result;
+		const double queryTime = MeasureMs(10, [&]()
+		{
+			result.clear();
+			scene.QueryFrustum(frustum, result);
+		});
+
+		ILLUMINO_INFO("Frustum query over {0} meshes: brute force {1} in {2:.3f} ms, BVH {3} in {4:.3f} ms, first frame {5:.3f} ms",
+			entityCount, bruteForceCount, bruteForceTime, result.size(), queryTime, buildTime);
+
+		// Leaves are fattened, the tree may return a few more boxes than the exact test but never less
+		ILLUMINO_CHECK(result.size() >= bruteForceCount && result.size() <= bruteForceCount * 11 / 10);
+	}
+}
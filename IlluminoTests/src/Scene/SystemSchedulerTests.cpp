@@ -0,0 +1,56 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+#include "HeadlessEngine.h"
+
+namespace IlluminoEngine
+{
+	// Chunks walk the component pools in place, every entity of the view is visited once and nothing is allocated
+	ILLUMINO_TEST(SystemSchedulerParallelEach)
+	{
+		HeadlessEngine engine(3);
+
+		constexpr uint32_t entityCount = 10000;
+
+		entt::registry registry;
+		eastl::vector<entt::entity> entities(entityCount);
+		registry.create(entities.begin(), entities.end());
+		registry.insert<TransformComponent>(entities.begin(), entities.end());
+
+		uint32_t expected = 0;
+		for (uint32_t i = 0; i < entityCount; i += 2)
+		{
+			registry.emplace<PointLightComponent>(entities[i]).Intensity = 0.0f;
+			if (i % 6 == 0)
+				registry.emplace<InactiveComponent>(entities[i]);
+			else if (i % 10 == 0)
+				registry.emplace<PendingDestroyComponent>(entities[i]);
+			else
+				++expected;
+		}
+
+		std::atomic<uint32_t> visited = 0;
+		auto run = [&]()
+		{
+			visited = 0;
+			SystemScheduler::ParallelEach<TransformComponent, PointLightComponent>(registry, [&visited](entt::entity entity, TransformComponent& transform, PointLightComponent& light)
+			{
+				light.Intensity += 1.0f;
+				visited.fetch_add(1, std::memory_order_relaxed);
+			}, 256);
+		};
+
+		run();
+		const uint64_t allocationsBefore = FrameAllocator::GetHeapAllocationCount();
+		run();
+		ILLUMINO_CHECK(FrameAllocator::GetHeapAllocationCount() == allocationsBefore);
+		ILLUMINO_CHECK(visited.load() == expected);
+
+		bool valid = true;
+		for (uint32_t i = 0; i < entityCount; i += 2)
+		{
+			const bool included = i % 6 != 0 && i % 10 != 0;
+			valid &= registry.get<PointLightComponent>(entities[i]).Intensity == (included ? 2.0f : 0.0f);
+		}
+		ILLUMINO_CHECK(valid);
+	}
+}
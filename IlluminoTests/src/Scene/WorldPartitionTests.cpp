@@ -0,0 +1,199 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+#include "TestAssets.h"
+#include "HeadlessEngine.h"
+
+#include <chrono>
+#include <thread>
+
+#include "Platform/Null/NullGraphicsContext.h"
+
+namespace IlluminoEngine
+{
+	// Flies a scripted camera across a streamed 512x512 level and reports the hitches. Meshes are imported from disk
+	// on the streaming thread, their GPU resources must only be created on the main thread.
+	ILLUMINO_TEST(WorldPartitionFlyThrough)
+	{
+		HeadlessEngine engine;
+		TestCamera camera;
+
+		constexpr uint32_t meshCount = 4;
+		constexpr uint32_t gridSize = 16;
+		constexpr float spacing = 32.0f;
+
+		Scene scene;
+		{
+			eastl::vector<Ref<Mesh>> meshes;
+			for (uint32_t i = 0; i < meshCount; ++i)
+			{
+				const eastl::string name(eastl::string::CtorSprintf(), "StreamedBox%u", i);
+				meshes.push_back(CreateRef<Mesh>(WriteBoxFile(name.c_str(), glm::vec3(1.0f + i)).c_str()));
+			}
+
+			for (uint32_t z = 0; z < gridSize; ++z)
+			{
+				for (uint32_t x = 0; x < gridSize; ++x)
+				{
+					Entity entity = scene.CreateEntity("Prop");
+					entity.GetComponent<TransformComponent>().Translation = glm::vec3((x + 0.5f) * spacing - 256.0f, 0.0f, (z + 0.5f) * spacing - 256.0f);
+					entity.AddComponent<MeshComponent>().MeshGeometry = meshes[(x + z) % meshCount];
+				}
+			}
+		}
+
+		WorldPartitionSpec spec;
+		spec.CellSize = 64.0f;
+		spec.LoadRadius = 96.0f;
+		spec.UnloadRadius = 128.0f;
+		WorldPartition partition(&scene, spec);
+		partition.Build();
+
+		const NullResourceStats& resources = NullGraphicsContext::GetResourceStats();
+		ILLUMINO_CHECK(partition.GetStats().CellCount == 64);
+		// The meshes the scene already had are kept for the first load of their cells
+		ILLUMINO_CHECK(resources.MeshBuffers == meshCount);
+
+		auto renderFrame = [&](const glm::vec3& position, const glm::vec3& target)
+		{
+			engine.BeginFrame();
+			partition.Update(position);
+			scene.OnUpdateEditor(1.0f / 60.0f);
+			camera.LookAt(position, target);
+			scene.OnRenderEditor(camera);
+			engine.EndFrame();
+		};
+
+		// Diagonal pass across the level and back along the edge
+		constexpr uint32_t frameCount = 600;
+		float maxFrameTime = 0.0f;
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			const float t = (float)frame / (frameCount - 1);
+			const glm::vec3 position = t < 0.5f
+				? glm::vec3(-240.0f + 960.0f * t, 10.0f, -240.0f + 960.0f * t)
+				: glm::vec3(240.0f, 10.0f, 240.0f - 960.0f * (t - 0.5f));
+			const glm::vec3 target = position + (t < 0.5f ? glm::vec3(1.0f, -0.2f, 1.0f) : glm::vec3(0.0f, -0.2f, -1.0f));
+
+			const auto start = std::chrono::high_resolution_clock::now();
+			renderFrame(position, target);
+			maxFrameTime = glm::max(maxFrameTime, std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+		}
+
+		// Let the last loads finish at the end of the path
+		const glm::vec3 end = glm::vec3(240.0f, 10.0f, -240.0f);
+		for (uint32_t i = 0; i < 500 && (partition.GetStats().LoadingCells > 0 || partition.GetStats().PendingIntegrations > 0); ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			renderFrame(end, end + glm::vec3(0.0f, -0.2f, -1.0f));
+		}
+
+		const WorldPartitionStats& stats = partition.GetStats();
+		ILLUMINO_INFO("Fly-through: {0} frames, {1} loads, {2} unloads, {3} hitches, max integration {4:.3f} ms, max frame {5:.3f} ms",
+			frameCount, stats.LoadsIssued, stats.Unloads, stats.Hitches, stats.MaxIntegrationTime, maxFrameTime);
+
+		ILLUMINO_CHECK(resources.OffThreadCreations == 0);
+		ILLUMINO_CHECK(stats.LoadsIssued > stats.ResidentCells);
+		ILLUMINO_CHECK(stats.Unloads > 0);
+		ILLUMINO_CHECK(stats.LoadingCells == 0);
+
+		// The corner cell and its neighbours inside the load radius are resident with all of their props, cells the
+		// camera left within the unload radius may still be around
+		eastl::vector<Entity> props;
+		scene.QueryBox({ glm::vec3(-1000.0f), glm::vec3(1000.0f) }, props);
+		ILLUMINO_CHECK(stats.ResidentCells >= 4 && stats.ResidentCells < stats.CellCount);
+		ILLUMINO_CHECK(props.size() == stats.ResidentCells * 4);
+
+		// Only the meshes used by resident cells are alive
+		ILLUMINO_CHECK(resources.MeshBuffers <= meshCount);
+	}
+
+	// Streamed roots may be deleted by the user while their cell is resident, unloading the cell skips them
+	ILLUMINO_TEST(WorldPartitionDeletedRoots)
+	{
+		HeadlessEngine engine;
+
+		Scene scene;
+		Ref<Mesh> box = CreateRef<Mesh>(WriteBoxFile("DeletedRootBox", glm::vec3(1.0f)).c_str());
+		for (uint32_t i = 0; i < 2; ++i)
+		{
+			Entity entity = scene.CreateEntity("Prop");
+			entity.GetComponent<TransformComponent>().Translation = glm::vec3(10.0f + i, 0.0f, 10.0f);
+			entity.AddComponent<MeshComponent>().MeshGeometry = box;
+		}
+
+		WorldPartition partition(&scene);
+		partition.Build();
+
+		for (uint32_t i = 0; i < 500 && partition.GetStats().ResidentCells == 0; ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			partition.Update(glm::vec3(0.0f));
+		}
+		ILLUMINO_CHECK(partition.GetStats().ResidentCells == 1);
+		ILLUMINO_CHECK(scene.GetEntityMap().size() == 2);
+
+		Entity deleted = scene.GetEntityMap().begin()->second;
+		scene.DestroyEntity(deleted);
+		scene.FlushDestroyedEntities();
+		ILLUMINO_CHECK(!scene.IsValid(deleted));
+
+		partition.Update(glm::vec3(10000.0f, 0.0f, 0.0f));
+		scene.FlushDestroyedEntities();
+		ILLUMINO_CHECK(partition.GetStats().Unloads == 1);
+		ILLUMINO_CHECK(scene.GetEntityMap().empty());
+	}
+
+	// Meshes the scene already had are streamed back in as they were, ones without a file on disk stay loaded
+	ILLUMINO_TEST(WorldPartitionKeepsLoadedMeshes)
+	{
+		HeadlessEngine engine;
+
+		Ref<Mesh> fileMesh = CreateRef<Mesh>(WriteBoxFile("KeptBox", glm::vec3(1.0f)).c_str());
+		fileMesh->GetSubmesh(0).Roughness = 0.25f;
+		Ref<Mesh> memoryMesh = CreateBoxMesh(glm::vec3(1.0f), "MemoryBox");
+
+		Scene scene;
+		Entity fileProp = scene.CreateEntity("File Prop");
+		fileProp.GetComponent<TransformComponent>().Translation = glm::vec3(10.0f, 0.0f, 10.0f);
+		fileProp.AddComponent<MeshComponent>().MeshGeometry = fileMesh;
+		Entity memoryProp = scene.CreateEntity("Memory Prop");
+		memoryProp.GetComponent<TransformComponent>().Translation = glm::vec3(12.0f, 0.0f, 10.0f);
+		memoryProp.AddComponent<MeshComponent>().MeshGeometry = memoryMesh;
+
+		WorldPartition partition(&scene);
+		partition.Build();
+		fileMesh = nullptr;
+
+		auto streamIn = [&]()
+		{
+			for (uint32_t i = 0; i < 500 && partition.GetStats().ResidentCells == 0; ++i)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				partition.Update(glm::vec3(0.0f));
+			}
+		};
+
+		auto findMesh = [&](const char* name)
+		{
+			for (auto [id, entity] : scene.GetEntityMap())
+			{
+				if (entity.GetComponent<TagComponent>().Tag == name)
+					return entity.GetComponent<MeshComponent>().MeshGeometry;
+			}
+			return Ref<Mesh>();
+		};
+
+		// The first load shares the edited mesh instead of importing the file again
+		streamIn();
+		ILLUMINO_CHECK(findMesh("File Prop") && findMesh("File Prop")->GetSubmesh(0).Roughness == 0.25f);
+		ILLUMINO_CHECK(findMesh("Memory Prop") == memoryMesh);
+
+		partition.Update(glm::vec3(10000.0f, 0.0f, 0.0f));
+		scene.FlushDestroyedEntities();
+		ILLUMINO_CHECK(scene.GetEntityMap().empty());
+
+		streamIn();
+		ILLUMINO_CHECK(findMesh("File Prop") && findMesh("File Prop")->GetSubmeshCount() == 1);
+		ILLUMINO_CHECK(findMesh("Memory Prop") == memoryMesh);
+	}
+}
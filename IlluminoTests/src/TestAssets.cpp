@@ -0,0 +1,66 @@
+#include <IlluminoEngine.h>
+#include "TestAssets.h"
+
+#include <cstdio>
+#include <filesystem>
+
+namespace IlluminoEngine
+{
+	static const glm::vec3 s_BoxCorners[8] =
+	{
+		{ -1.0f, -1.0f, -1.0f }, { 1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, -1.0f }, { -1.0f, 1.0f, -1.0f },
+		{ -1.0f, -1.0f,  1.0f }, { 1.0f, -1.0f,  1.0f }, { 1.0f, 1.0f,  1.0f }, { -1.0f, 1.0f,  1.0f },
+	};
+
+	static const uint32_t s_BoxIndices[36] =
+	{
+		0, 2, 1, 0, 3, 2,
+		4, 5, 6, 4, 6, 7,
+		0, 1, 5, 0, 5, 4,
+		3, 7, 6, 3, 6, 2,
+		0, 4, 7, 0, 7, 3,
+		1, 2, 6, 1, 6, 5,
+	};
+
+	MeshSource CreateBoxSource(const glm::vec3& halfExtents, const char* name)
+	{
+		MeshSource source;
+		source.Filepath = name;
+
+		SubmeshSource& submesh = source.Submeshes.push_back();
+		submesh.Name = name;
+		for (const glm::vec3& corner : s_BoxCorners)
+		{
+			MeshVertex vertex;
+			vertex.Position = corner * halfExtents;
+			vertex.Normal = glm::normalize(corner);
+			submesh.Vertices.push_back(vertex);
+		}
+		submesh.Indices.assign(eastl::begin(s_BoxIndices), eastl::end(s_BoxIndices));
+		submesh.Bounds = { -halfExtents, halfExtents };
+		submesh.Sphere = { glm::vec3(0.0f), glm::length(halfExtents) };
+
+		return source;
+	}
+
+	Ref<Mesh> CreateBoxMesh(const glm::vec3& halfExtents, const char* name)
+	{
+		return CreateRef<Mesh>(CreateBoxSource(halfExtents, name));
+	}
+
+	eastl::string WriteBoxFile(const char* name, const glm::vec3& halfExtents)
+	{
+		const std::filesystem::path directory = std::filesystem::temp_directory_path() / "IlluminoTests";
+		std::filesystem::create_directories(directory);
+		const std::string path = (directory / (std::string(name) + ".obj")).string();
+
+		FILE* file = fopen(path.c_str(), "w");
+		for (const glm::vec3& corner : s_BoxCorners)
+			fprintf(file, "v %f %f %f\n", corner.x * halfExtents.x, corner.y * halfExtents.y, corner.z * halfExtents.z);
+		for (uint32_t i = 0; i < 36; i += 3)
+			fprintf(file, "f %u %u %u\n", s_BoxIndices[i] + 1, s_BoxIndices[i + 1] + 1, s_BoxIndices[i + 2] + 1);
+		fclose(file);
+
+		return path.c_str();
+	}
+}
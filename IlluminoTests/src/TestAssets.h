@@ -0,0 +1,16 @@
+#pragma once
+
+#include <EASTL/string.h>
+#include <glm/glm.hpp>
+
+#include "Illumino/Renderer/Mesh.h"
+
+namespace IlluminoEngine
+{
+	// Box with 8 corners and 12 triangles centered on the origin, one submesh without textures
+	MeshSource CreateBoxSource(const glm::vec3& halfExtents, const char* name = "Box");
+	Ref<Mesh> CreateBoxMesh(const glm::vec3& halfExtents, const char* name = "Box");
+
+	// Writes the box as an OBJ file into the temp directory and returns its path, for tests that stream from disk
+	eastl::string WriteBoxFile(const char* name, const glm::vec3& halfExtents);
+}
@@ -0,0 +1,25 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+
+namespace IlluminoEngine
+{
+	static uint32_t s_FailureCount = 0;
+
+	eastl::vector<TestCase>& TestRegistry::GetTests()
+	{
+		// Function local so registrars in other translation units can run first
+		static eastl::vector<TestCase> tests;
+		return tests;
+	}
+
+	void TestRegistry::ReportFailure(const char* expression, const char* file, int line)
+	{
+		ILLUMINO_ERROR("Check failed: {0} ({1}:{2})", expression, file, line);
+		++s_FailureCount;
+	}
+
+	uint32_t TestRegistry::GetFailureCount()
+	{
+		return s_FailureCount;
+	}
+}
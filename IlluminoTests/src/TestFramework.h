@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <EASTL/vector.h>
+#include <stdint.h>
+
+namespace IlluminoEngine
+{
+	using TestFn = void(*)();
+
+	struct TestCase
+	{
+		const char* Name;
+		TestFn Fn;
+		// Benchmarks only run with --bench and report their numbers through the log
+		bool Benchmark;
+	};
+
+	class TestRegistry
+	{
+	public:
+		static eastl::vector<TestCase>& GetTests();
+
+		static void ReportFailure(const char* expression, const char* file, int line);
+		static uint32_t GetFailureCount();
+	};
+
+	struct TestRegistrar
+	{
+		TestRegistrar(const char* name, TestFn fn, bool benchmark) { TestRegistry::GetTests().push_back({ name, fn, benchmark }); }
+	};
+
+	// Average wall time of fn() in milliseconds
+	template<typename Fn>
+	double MeasureMs(uint32_t iterations, Fn&& fn)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		for (uint32_t i = 0; i < iterations; ++i)
+			fn();
+		return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / iterations;
+	}
+}
+
+#define ILLUMINO_TEST_CASE(name, benchmark)	static void name(); \
+											static ::IlluminoEngine::TestRegistrar name##Registrar(#name, name, benchmark); \
+											static void name()
+
+#define ILLUMINO_TEST(name)			ILLUMINO_TEST_CASE(name, false)
+#define ILLUMINO_BENCHMARK(name)	ILLUMINO_TEST_CASE(name, true)
+
+// Records the failure and keeps running the test
+#define ILLUMINO_CHECK(x)			do { if (!(x)) ::IlluminoEngine::TestRegistry::ReportFailure(#x, __FILE__, __LINE__); } while (false)
@@ -0,0 +1,51 @@
+#include <IlluminoEngine.h>
+#include "TestFramework.h"
+
+#include <cstring>
+
+#include "Illumino/Renderer/RendererAPI.h"
+
+// Usage: IlluminoTests [--bench] [name filter]
+int main(int argc, char** argv)
+{
+	using namespace IlluminoEngine;
+
+	Log::Init();
+	RendererAPI::SetAPI(RendererAPI::API::Null);
+
+	bool benchmarks = false;
+	const char* filter = nullptr;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--bench") == 0)
+			benchmarks = true;
+		else
+			filter = argv[i];
+	}
+
+	uint32_t failedTests = 0;
+	uint32_t runTests = 0;
+	for (const TestCase& test : TestRegistry::GetTests())
+	{
+		if (test.Benchmark != benchmarks || (filter && !strstr(test.Name, filter)))
+			continue;
+
+		ILLUMINO_INFO("[ RUN  ] {0}", test.Name);
+		const uint32_t failures = TestRegistry::GetFailureCount();
+		test.Fn();
+		++runTests;
+
+		if (TestRegistry::GetFailureCount() != failures)
+		{
+			++failedTests;
+			ILLUMINO_ERROR("[ FAIL ] {0}", test.Name);
+		}
+		else
+		{
+			ILLUMINO_INFO("[  OK  ] {0}", test.Name);
+		}
+	}
+
+	ILLUMINO_INFO("{0} of {1} {2} passed", runTests - failedTests, runTests, benchmarks ? "benchmarks" : "tests");
+	return failedTests == 0 ? 0 : 1;
+}
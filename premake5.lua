@@ -40,4 +40,9 @@ group "Dependencies"
 group ""
 
 include "IlluminoEngine"
-include "IlluminoEd"
+include "IlluminoTests"
+
+-- The editor needs a window and the D3D12 backend
+if os.istarget("windows") then
+	include "IlluminoEd"
+end